@@ -29,6 +29,7 @@ namespace bd
 
 GenericReaderOptions::GenericReaderOptions ()
   : m_prefix ("i"), m_group_prefix ("Input"), m_create_other_layers (true),
+    m_read_ahead_buffers (0),
     m_common_enable_text_objects (true),
     m_common_enable_properties (true),
     m_gds2_box_mode (1),
@@ -92,6 +93,12 @@ GenericReaderOptions::add_options (tl::CommandLineOptions &cmd)
                     "* A:1/0 B:2/0\n"
                     "  Maps named layer A to 1/0 and named layer B to 2/0"
                    )
+        << tl::arg (group +
+                    "#--" + m_long_prefix + "read-ahead=buffers", &m_read_ahead_buffers, "Reads the input in a separate thread",
+                    "If this option is given, a separate thread reads the input file into the given number of 1 MB buffers "
+                    "ahead of the reader. Reading and decompression then overlaps with parsing. This is beneficial "
+                    "for slow sources such as network file systems."
+                   )
       ;
   }
 
@@ -269,6 +276,7 @@ GenericReaderOptions::configure (db::LoadLayoutOptions &load_options) const
 {
   load_options.set_option_by_name ("layer_map", tl::Variant::make_variant (m_layer_map));
   load_options.set_option_by_name ("create_other_layers", m_create_other_layers);
+  load_options.set_option_by_name ("read_ahead_buffers", m_read_ahead_buffers);
   load_options.set_option_by_name ("text_enabled", m_common_enable_text_objects);
   load_options.set_option_by_name ("properties_enabled", m_common_enable_properties);
 
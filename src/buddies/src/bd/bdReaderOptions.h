@@ -99,6 +99,7 @@ private:
   //  generic
   db::LayerMap m_layer_map;
   bool m_create_other_layers;
+  unsigned int m_read_ahead_buffers;
 
   //  common GDS2+OASIS
   bool m_common_enable_text_objects;
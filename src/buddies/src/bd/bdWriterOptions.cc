@@ -35,6 +35,8 @@ GenericWriterOptions::GenericWriterOptions ()
     m_dont_write_empty_cells (false),
     m_keep_instances (false),
     m_write_context_info (true),
+    m_write_behind_buffers (0),
+    m_compression_threads (0),
     m_gds2_max_vertex_count (8000),
     m_gds2_no_zero_length_paths (false),
     m_gds2_multi_xy_records (false),
@@ -111,6 +113,19 @@ GenericWriterOptions::add_options (tl::CommandLineOptions &cmd, const std::strin
                    );
   }
 
+  cmd << tl::arg (group +
+                  "#--write-behind=buffers",  &m_write_behind_buffers, "Writes the output in a separate thread",
+                  "If this option is given, the output is collected in the given number of 1 MB buffers and "
+                  "a separate thread writes them to the file. Writing and compression then overlaps with producing "
+                  "the data. This is beneficial for slow targets such as network file systems."
+                 )
+      << tl::arg (group +
+                  "#--compression-threads=n", &m_compression_threads, "Compresses .gz output in parallel",
+                  "This option is effective together with --write-behind only. If given, .gz output is compressed "
+                  "by the given number of threads in parallel. Each buffer becomes a separate gzip member then. "
+                  "The resulting file is a valid gzip file."
+                 );
+
   cmd << tl::arg (group +
                   "#--write-cells=sel",       &m_cell_selection, "Specifies cells to write",
                   "This option specifies the cells to write. The value of this option is a sequence of "
@@ -328,6 +343,8 @@ GenericWriterOptions::configure (db::SaveLayoutOptions &save_options, const db::
   save_options.set_dont_write_empty_cells (m_dont_write_empty_cells);
   save_options.set_keep_instances (m_keep_instances);
   save_options.set_write_context_info (m_write_context_info);
+  save_options.set_write_behind_buffers (m_write_behind_buffers);
+  save_options.set_compression_threads (m_compression_threads);
 
   save_options.set_option_by_name ("gds2_max_vertex_count", m_gds2_max_vertex_count);
   save_options.set_option_by_name ("gds2_no_zero_length_paths", m_gds2_no_zero_length_paths);
@@ -110,6 +110,8 @@ private:
   bool m_dont_write_empty_cells;
   bool m_keep_instances;
   bool m_write_context_info;
+  unsigned int m_write_behind_buffers;
+  unsigned int m_compression_threads;
   std::string m_cell_selection;
 
   unsigned int m_gds2_max_vertex_count;
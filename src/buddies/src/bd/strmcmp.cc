@@ -23,7 +23,7 @@
 #include "bdReaderOptions.h"
 #include "dbLayout.h"
 #include "dbLayoutDiff.h"
-#include "dbReader.h"
+#include "dbMultiFileReader.h"
 #include "tlCommandLineParser.h"
 
 BD_PUBLIC int strmcmp (int argc, char *argv[])
@@ -140,21 +140,15 @@ BD_PUBLIC int strmcmp (int argc, char *argv[])
   db::Layout layout_b;
 
   {
-    db::LoadLayoutOptions load_options;
-    generic_reader_options_a.configure (load_options);
-
-    tl::InputStream stream (infile_a);
-    db::Reader reader (stream);
-    reader.read (layout_a, load_options);
-  }
-
-  {
-    db::LoadLayoutOptions load_options;
-    generic_reader_options_b.configure (load_options);
-
-    tl::InputStream stream (infile_b);
-    db::Reader reader (stream);
-    reader.read (layout_b, load_options);
+    db::LoadLayoutOptions load_options_a, load_options_b;
+    generic_reader_options_a.configure (load_options_a);
+    generic_reader_options_b.configure (load_options_b);
+
+    //  read both files concurrently
+    db::MultiFileReader reader;
+    reader.add_file (infile_a, &layout_a, load_options_a);
+    reader.add_file (infile_b, &layout_b, load_options_b);
+    reader.read ();
   }
 
   unsigned int flags = 0;
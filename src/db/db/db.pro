@@ -58,6 +58,7 @@ SOURCES = \
   dbPolygonGenerators.cc \
   dbPropertiesRepository.cc \
   dbReader.cc \
+  dbMultiFileReader.cc \
   dbRecursiveShapeIterator.cc \
   dbRegion.cc \
   dbSaveLayoutOptions.cc \
@@ -107,6 +108,7 @@ SOURCES = \
   gsiDeclDbPoint.cc \
   gsiDeclDbPolygon.cc \
   gsiDeclDbReader.cc \
+  gsiDeclDbMultiFileReader.cc \
   gsiDeclDbRecursiveShapeIterator.cc \
   gsiDeclDbRegion.cc \
   gsiDeclDbShape.cc \
@@ -232,6 +234,7 @@ HEADERS = \
   dbPolygonGenerators.h \
   dbPropertiesRepository.h \
   dbReader.h \
+  dbMultiFileReader.h \
   dbRecursiveShapeIterator.h \
   dbRegion.h \
   dbSaveLayoutOptions.h \
@@ -969,6 +969,45 @@ public:
     return m_objects.empty ();
   }
   
+  /**
+   *  @brief Gets the fraction of unused slots in the object vector
+   *
+   *  See tl::reuse_vector::fragmentation for details.
+   */
+  double fragmentation () const
+  {
+    return m_objects.fragmentation ();
+  }
+
+  /**
+   *  @brief Removes the holes left by erased objects
+   *
+   *  This will invalidate all iterators into the tree. The element
+   *  index is remapped, so a sorted tree stays sorted. If the index
+   *  refers to objects which have been erased after sorting, it is
+   *  discarded and the tree needs to be sorted again.
+   */
+  void compact ()
+  {
+    std::vector<size_type> index_map;
+    if (! m_objects.compact (&index_map)) {
+      return;
+    }
+
+    for (element_iterator e = m_elements.begin (); e != m_elements.end (); ++e) {
+      size_type ne = *e < index_map.size () ? index_map [*e] : std::numeric_limits<size_type>::max ();
+      if (ne == std::numeric_limits<size_type>::max ()) {
+        m_elements.clear ();
+        if (mp_root) {
+          delete mp_root;
+        }
+        mp_root = 0;
+        return;
+      }
+      *e = ne;
+    }
+  }
+
   /**
    *  @brief Sequential access begin iterator
    *
@@ -1882,6 +1921,26 @@ public:
     return m_objects.empty ();
   }
   
+  /**
+   *  @brief Gets the fraction of unused slots in the object vector
+   *
+   *  The unstable box tree does not leave holes, so this value is always 0.
+   */
+  double fragmentation () const
+  {
+    return 0.0;
+  }
+
+  /**
+   *  @brief Removes the holes left by erased objects
+   *
+   *  The unstable box tree does not leave holes, so this is a no-op.
+   */
+  void compact ()
+  {
+    //  .. nothing ..
+  }
+
   /** 
    *  @brief Empty the vector.
    */
@@ -353,6 +353,211 @@ void CellHullGenerator::generate_hull (const db::Cell &cell, std::vector <db::Po
   ep.process (pg, op);
 }
 
+// ----------------------------------------------------------------------------
+//  CellOccupancy implementation
+
+CellOccupancy::CellOccupancy ()
+  : m_box (), m_nx (0), m_ny (0), m_marked (0)
+{
+  //  .. nothing yet ..
+}
+
+CellOccupancy::CellOccupancy (const db::Box &box, unsigned int nx, unsigned int ny)
+  : m_box (box), m_nx (std::max ((unsigned int) 1, nx)), m_ny (std::max ((unsigned int) 1, ny)), m_marked (0)
+{
+  if (! m_box.empty ()) {
+    m_bits.resize (size_t (m_nx) * size_t (m_ny), false);
+  }
+}
+
+unsigned int
+CellOccupancy::bin_x (db::Coord x) const
+{
+  int64_t w = int64_t (m_box.right ()) - int64_t (m_box.left ());
+  if (w <= 0 || x <= m_box.left ()) {
+    return 0;
+  }
+  int64_t ix = ((int64_t (x) - int64_t (m_box.left ())) * int64_t (m_nx)) / w;
+  return (unsigned int) std::min (ix, int64_t (m_nx - 1));
+}
+
+unsigned int
+CellOccupancy::bin_y (db::Coord y) const
+{
+  int64_t h = int64_t (m_box.top ()) - int64_t (m_box.bottom ());
+  if (h <= 0 || y <= m_box.bottom ()) {
+    return 0;
+  }
+  int64_t iy = ((int64_t (y) - int64_t (m_box.bottom ())) * int64_t (m_ny)) / h;
+  return (unsigned int) std::min (iy, int64_t (m_ny - 1));
+}
+
+db::Box
+CellOccupancy::bin_box (unsigned int ix, unsigned int iy) const
+{
+  //  NOTE: the bin box is rounded outwards so it safely encloses all points mapped to this bin
+  int64_t w = int64_t (m_box.right ()) - int64_t (m_box.left ());
+  int64_t h = int64_t (m_box.top ()) - int64_t (m_box.bottom ());
+  db::Coord l = db::Coord (int64_t (m_box.left ()) + (int64_t (ix) * w) / int64_t (m_nx));
+  db::Coord r = db::Coord (int64_t (m_box.left ()) + (int64_t (ix + 1) * w + int64_t (m_nx) - 1) / int64_t (m_nx));
+  db::Coord b = db::Coord (int64_t (m_box.bottom ()) + (int64_t (iy) * h) / int64_t (m_ny));
+  db::Coord t = db::Coord (int64_t (m_box.bottom ()) + (int64_t (iy + 1) * h + int64_t (m_ny) - 1) / int64_t (m_ny));
+  return db::Box (l, b, r, t);
+}
+
+void
+CellOccupancy::add (const db::Box &box)
+{
+  if (! box.touches (m_box) || is_full ()) {
+    return;
+  }
+
+  unsigned int ix1 = bin_x (std::max (box.left (), m_box.left ()));
+  unsigned int ix2 = bin_x (std::min (box.right (), m_box.right ()));
+  unsigned int iy1 = bin_y (std::max (box.bottom (), m_box.bottom ()));
+  unsigned int iy2 = bin_y (std::min (box.top (), m_box.top ()));
+
+  for (unsigned int iy = iy1; iy <= iy2; ++iy) {
+    for (unsigned int ix = ix1; ix <= ix2; ++ix) {
+      std::vector<bool>::reference bit = m_bits [size_t (iy) * size_t (m_nx) + ix];
+      if (! bit) {
+        bit = true;
+        ++m_marked;
+      }
+    }
+  }
+}
+
+bool
+CellOccupancy::touches (const db::Box &box) const
+{
+  if (! box.touches (m_box)) {
+    return false;
+  } else if (is_full ()) {
+    return true;
+  }
+
+  unsigned int ix1 = bin_x (std::max (box.left (), m_box.left ()));
+  unsigned int ix2 = bin_x (std::min (box.right (), m_box.right ()));
+  unsigned int iy1 = bin_y (std::max (box.bottom (), m_box.bottom ()));
+  unsigned int iy2 = bin_y (std::min (box.top (), m_box.top ()));
+
+  for (unsigned int iy = iy1; iy <= iy2; ++iy) {
+    for (unsigned int ix = ix1; ix <= ix2; ++ix) {
+      if (m_bits [size_t (iy) * size_t (m_nx) + ix]) {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+void
+CellOccupancy::marked_boxes (std::vector<db::Box> &boxes) const
+{
+  if (m_box.empty ()) {
+    return;
+  } else if (is_full ()) {
+    boxes.push_back (m_box);
+    return;
+  }
+
+  for (unsigned int iy = 0; iy < m_ny; ++iy) {
+    for (unsigned int ix = 0; ix < m_nx; ++ix) {
+      if (m_bits [size_t (iy) * size_t (m_nx) + ix]) {
+        boxes.push_back (bin_box (ix, iy));
+      }
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+//  CellOccupancyCache implementation
+
+CellOccupancyCache::CellOccupancyCache (const db::Layout &layout, unsigned int bins)
+  : mp_layout (&layout), m_bins (bins)
+{
+  //  .. nothing yet ..
+}
+
+void
+CellOccupancyCache::clear ()
+{
+  tl::MutexLocker locker (&m_lock);
+  m_cache.clear ();
 }
 
+const CellOccupancy &
+CellOccupancyCache::occupancy (db::cell_index_type ci, unsigned int layer)
+{
+  std::pair<db::cell_index_type, unsigned int> key (ci, layer);
+
+  {
+    tl::MutexLocker locker (&m_lock);
+    std::map<std::pair<db::cell_index_type, unsigned int>, CellOccupancy>::const_iterator c = m_cache.find (key);
+    if (c != m_cache.end ()) {
+      return c->second;
+    }
+  }
+
+  //  NOTE: the grid is computed without holding the lock, so other threads are not blocked
+  //  meanwhile. If another thread computed the same grid in the meantime, its entry is kept.
+  //  References into the map stay valid on insert.
+  CellOccupancy occ;
+  compute_occupancy (ci, layer, occ);
+
+  tl::MutexLocker locker (&m_lock);
+  return m_cache.insert (std::make_pair (key, occ)).first->second;
+}
+
+void
+CellOccupancyCache::compute_occupancy (db::cell_index_type ci, unsigned int layer, CellOccupancy &occ)
+{
+  //  arrays with more members than this are represented by their bounding box
+  const size_t max_array_members = 16;
+
+  const db::Cell &cell = mp_layout->cell (ci);
+  occ = CellOccupancy (cell.bbox (layer), m_bins, m_bins);
+
+  if (! occ.box ().empty ()) {
+
+    for (db::ShapeIterator sh = cell.shapes (layer).begin (db::ShapeIterator::All); ! sh.at_end () && ! occ.is_full (); ++sh) {
+      occ.add (sh->bbox ());
+    }
+
+    db::box_convert<db::CellInst, true> bc (*mp_layout, layer);
+
+    std::vector<db::Box> boxes;
+    for (db::Cell::const_iterator inst = cell.begin (); ! inst.at_end () && ! occ.is_full (); ++inst) {
+
+      const db::CellInstArray &inst_array = inst->cell_inst ();
+      const CellOccupancy &child_occ = occupancy (inst_array.object ().cell_index (), layer);
+      if (child_occ.box ().empty ()) {
+        continue;
+      }
+
+      if (inst_array.size () > max_array_members) {
+        occ.add (inst_array.bbox (bc));
+        continue;
+      }
+
+      boxes.clear ();
+      child_occ.marked_boxes (boxes);
+
+      for (db::CellInstArray::iterator n = inst_array.begin (); ! n.at_end (); ++n) {
+        db::ICplxTrans t = inst_array.complex_trans (*n);
+        //  NOTE: non-trivial magnifications and rotations may round the boxes inwards
+        db::Coord e = (t.is_mag () || ! t.is_ortho ()) ? 1 : 0;
+        for (std::vector<db::Box>::const_iterator b = boxes.begin (); b != boxes.end (); ++b) {
+          occ.add (b->transformed (t).enlarged (db::Vector (e, e)));
+        }
+      }
+
+    }
+
+  }
+}
+
+}
 
@@ -27,6 +27,10 @@
 #include "dbLayout.h"
 #include "dbPolygon.h"
 #include "dbCommon.h"
+#include "tlThreads.h"
+
+#include <map>
+#include <vector>
 
 namespace db {
 
@@ -67,6 +71,119 @@ private:
   size_t m_complexity;
 };
 
+/**
+ *  @brief A coarse occupancy grid of a cell's layer
+ *
+ *  The occupancy grid divides the bounding box of a cell's layer into a number of bins.
+ *  Each bin is marked if any shape (including the ones from the child cells) is present
+ *  in that bin. The occupancy is conservative: if a bin is not marked, it is guaranteed
+ *  that there are no shapes in that bin.
+ *
+ *  This object is used for filtering out interaction candidates which are only implied
+ *  by overlapping bounding boxes.
+ */
+class DB_PUBLIC CellOccupancy
+{
+public:
+  /**
+   *  @brief Creates an empty occupancy object
+   */
+  CellOccupancy ();
+
+  /**
+   *  @brief Creates an occupancy object for the given box with the given number of bins
+   */
+  CellOccupancy (const db::Box &box, unsigned int nx, unsigned int ny);
+
+  /**
+   *  @brief Marks all bins touched by the given box
+   */
+  void add (const db::Box &box);
+
+  /**
+   *  @brief Returns true if the given box touches any of the marked bins
+   */
+  bool touches (const db::Box &box) const;
+
+  /**
+   *  @brief Gets the box covered by this object
+   */
+  const db::Box &box () const
+  {
+    return m_box;
+  }
+
+  /**
+   *  @brief Returns true if all bins are marked
+   */
+  bool is_full () const
+  {
+    return ! m_bits.empty () && m_marked == m_bits.size ();
+  }
+
+  /**
+   *  @brief Gets the boxes of the marked bins
+   */
+  void marked_boxes (std::vector<db::Box> &boxes) const;
+
+private:
+  db::Box m_box;
+  unsigned int m_nx, m_ny;
+  std::vector<bool> m_bits;
+  size_t m_marked;
+
+  unsigned int bin_x (db::Coord x) const;
+  unsigned int bin_y (db::Coord y) const;
+  db::Box bin_box (unsigned int ix, unsigned int iy) const;
+};
+
+/**
+ *  @brief A cache for the occupancy grids of the cells of a layout
+ *
+ *  The occupancy grids are computed on demand per cell and layer and are kept
+ *  until the cache is cleared. The cache is thread-safe.
+ *
+ *  The layout must not be modified on the cached layers while the cache is in use.
+ */
+class DB_PUBLIC CellOccupancyCache
+{
+public:
+  /**
+   *  @brief Creates a cache for the given layout
+   *
+   *  "bins" is the number of bins along each axis.
+   */
+  CellOccupancyCache (const db::Layout &layout, unsigned int bins = 16);
+
+  /**
+   *  @brief Gets the occupancy for the given cell and layer
+   */
+  const CellOccupancy &occupancy (db::cell_index_type ci, unsigned int layer);
+
+  /**
+   *  @brief Returns true if the given box (in the cell's coordinates) may touch shapes of the given cell and layer
+   */
+  bool touches (db::cell_index_type ci, unsigned int layer, const db::Box &box)
+  {
+    return occupancy (ci, layer).touches (box);
+  }
+
+  /**
+   *  @brief Clears the cache
+   *
+   *  This method must not be called while other threads use the cache.
+   */
+  void clear ();
+
+private:
+  const db::Layout *mp_layout;
+  unsigned int m_bins;
+  std::map<std::pair<db::cell_index_type, unsigned int>, CellOccupancy> m_cache;
+  tl::Mutex m_lock;
+
+  void compute_occupancy (db::cell_index_type ci, unsigned int layer, CellOccupancy &occ);
+};
+
 }
 
 #endif
@@ -23,18 +23,19 @@
 
 #include "dbCellVariants.h"
 #include "tlUtils.h"
+#include "tlLog.h"
 
 namespace db
 {
 
 VariantsCollectorBase::VariantsCollectorBase ()
-  : mp_red ()
+  : mp_red (), m_created_variants (0), m_avoided_variants (0)
 {
   //  .. nothing yet ..
 }
 
 VariantsCollectorBase::VariantsCollectorBase (const TransformationReducer *red)
-  : mp_red (red)
+  : mp_red (red), m_created_variants (0), m_avoided_variants (0)
 {
   //  .. nothing yet ..
 }
@@ -77,9 +78,32 @@ VariantsCollectorBase::collect (const db::Layout &layout, const db::Cell &top_ce
 
 void
 VariantsCollectorBase::separate_variants (db::Layout &layout, db::Cell &top_cell, std::map<db::cell_index_type, std::map<db::ICplxTrans, db::cell_index_type> > *var_table)
+{
+  do_separate_variants (layout, top_cell, 0, var_table);
+}
+
+void
+VariantsCollectorBase::separate_variants (db::Layout &layout, db::Cell &top_cell, unsigned int layer, std::map<db::cell_index_type, std::map<db::ICplxTrans, db::cell_index_type> > *var_table)
+{
+  //  only cells with shapes on this layer (also through their children) need to be separated -
+  //  NOTE: this needs to be determined before the layout is locked
+  std::set<db::cell_index_type> relevant_cells;
+  for (db::Layout::const_iterator c = layout.begin (); c != layout.end (); ++c) {
+    if (! c->bbox (layer).empty ()) {
+      relevant_cells.insert (c->cell_index ());
+    }
+  }
+
+  do_separate_variants (layout, top_cell, &relevant_cells, var_table);
+}
+
+void
+VariantsCollectorBase::do_separate_variants (db::Layout &layout, db::Cell &top_cell, const std::set<db::cell_index_type> *relevant_cells, std::map<db::cell_index_type, std::map<db::ICplxTrans, db::cell_index_type> > *var_table)
 {
   tl_assert (mp_red != 0);
 
+  size_t created_before = m_created_variants, avoided_before = m_avoided_variants;
+
   db::LayoutLocker locker (&layout);
 
   std::set<db::cell_index_type> called;
@@ -102,6 +126,18 @@ VariantsCollectorBase::separate_variants (db::Layout &layout, db::Cell &top_cell
     db::Cell &cell = layout.cell (*c);
 
     std::map<db::ICplxTrans, size_t> &vv = m_variants [*c];
+
+    if (vv.size () > 1 && relevant_cells && relevant_cells->find (*c) == relevant_cells->end ()) {
+
+      //  the cell does not contribute shapes: one representative variant is sufficient
+      m_avoided_variants += vv.size () - 1;
+
+      std::pair<db::ICplxTrans, size_t> v1 = *vv.begin ();
+      vv.clear ();
+      vv.insert (v1);
+
+    }
+
     if (vv.size () > 1) {
 
       std::map<db::ICplxTrans, db::cell_index_type> &vt = (*var_table) [*c];
@@ -127,6 +163,7 @@ VariantsCollectorBase::separate_variants (db::Layout &layout, db::Cell &top_cell
 
           ci_var = layout.add_cell (var_name.c_str ());
           copy_shapes (layout, ci_var, *c);
+          ++m_created_variants;
 
           //  a new entry for the variant
           m_variants [ci_var].insert (*v);
@@ -172,6 +209,10 @@ VariantsCollectorBase::separate_variants (db::Layout &layout, db::Cell &top_cell
     }
 
   }
+
+  if (tl::verbosity () >= 40) {
+    tl::info << "Cell variants: " << (m_created_variants - created_before) << " created, " << (m_avoided_variants - avoided_before) << " avoided";
+  }
 }
 
 void
@@ -203,6 +203,22 @@ public:
    */
   void separate_variants (db::Layout &layout, db::Cell &top_cell, std::map<db::cell_index_type, std::map<db::ICplxTrans, db::cell_index_type> > *var_table = 0);
 
+  /**
+   *  @brief Creates cell variants for singularization of the different variants for a specific layer
+   *
+   *  This version will only separate the cells which contribute shapes to the given layer
+   *  (either directly or through their child cells). Operations working on this layer only
+   *  won't see a difference, but the number of cell copies is reduced.
+   *  Cells which are not separated will keep one variant only (the first one) - the cell's shapes
+   *  on the given layer are empty in this case, so the variant does not matter.
+   *
+   *  The number of variants which did not need to be created is reported by "avoided_variants".
+   *
+   *  Note that cells which do carry shapes on the layer are still copied for each variant.
+   *  There is no shared canonical shape set with lazy materialization per variant.
+   */
+  void separate_variants (db::Layout &layout, db::Cell &top_cell, unsigned int layer, std::map<db::cell_index_type, std::map<db::ICplxTrans, db::cell_index_type> > *var_table = 0);
+
   /**
    *  @brief Commits the shapes for different variants to the current cell hierarchy
    *
@@ -225,9 +241,30 @@ public:
    */
   bool has_variants () const;
 
+  /**
+   *  @brief Gets the number of variant cells created by "separate_variants" so far
+   */
+  size_t created_variants () const
+  {
+    return m_created_variants;
+  }
+
+  /**
+   *  @brief Gets the number of variant cells which "separate_variants" did not need to create so far
+   *
+   *  This number is non-zero only if the layer-specific version of "separate_variants" is used.
+   */
+  size_t avoided_variants () const
+  {
+    return m_avoided_variants;
+  }
+
 private:
   std::map<db::cell_index_type, std::map<db::ICplxTrans, size_t> > m_variants;
   const TransformationReducer *mp_red;
+  size_t m_created_variants, m_avoided_variants;
+
+  void do_separate_variants (db::Layout &layout, db::Cell &top_cell, const std::set<db::cell_index_type> *relevant_cells, std::map<db::cell_index_type, std::map<db::ICplxTrans, db::cell_index_type> > *var_table);
 
   void add_variant (std::map<db::ICplxTrans, size_t> &variants, const db::CellInstArray &inst, bool tl_invariant) const;
   void add_variant_non_tl_invariant (std::map<db::ICplxTrans, size_t> &variants, const db::CellInstArray &inst) const;
@@ -24,6 +24,8 @@
 
 #include "dbCommonReader.h"
 #include "dbStream.h"
+#include "dbLayout.h"
+#include "dbCell.h"
 #include "tlXMLParser.h"
 
 namespace db
@@ -81,12 +83,154 @@ public:
       tl::make_member (&db::CommonReaderOptions::create_other_layers, "create-other-layers") +
       tl::make_member (&db::CommonReaderOptions::layer_map, "layer-map") +
       tl::make_member (&db::CommonReaderOptions::enable_properties, "enable-properties") +
-      tl::make_member (&db::CommonReaderOptions::enable_text_objects, "enable-text-objects")
+      tl::make_member (&db::CommonReaderOptions::enable_text_objects, "enable-text-objects") +
+      tl::make_member (&db::CommonReaderOptions::read_ahead_buffers, "read-ahead-buffers") +
+      tl::make_member (&db::CommonReaderOptions::read_ahead_buffer_size, "read-ahead-buffer-size")
     );
   }
 };
 
 static tl::RegisteredClass<db::StreamFormatDeclaration> reader_decl (new CommonFormatDeclaration (), 20, "Common");
 
+// ---------------------------------------------------------------
+//  Region of interest support
+
+void
+compute_cell_regions (const db::Layout &layout, const std::set<db::cell_index_type> &cells, const db::Box &region, std::map<db::cell_index_type, db::Box> &cell_regions)
+{
+  cell_regions.clear ();
+
+  //  the top cells receive the full region
+  for (std::set<db::cell_index_type>::const_iterator c = cells.begin (); c != cells.end (); ++c) {
+    const db::Cell &cell = layout.cell (*c);
+    bool is_top = true;
+    for (db::Cell::parent_cell_iterator p = cell.begin_parent_cells (); p != cell.end_parent_cells () && is_top; ++p) {
+      is_top = (cells.find (*p) == cells.end ());
+    }
+    if (is_top) {
+      cell_regions.insert (std::make_pair (*c, region));
+    }
+  }
+
+  db::box_convert<db::CellInst> bc (layout);
+
+  //  propagate the region top-down through the instances touching it
+  for (db::Layout::top_down_const_iterator c = layout.begin_top_down (); c != layout.end_top_down (); ++c) {
+
+    std::map<db::cell_index_type, db::Box>::const_iterator r = cell_regions.find (*c);
+    if (r == cell_regions.end () || r->second.empty ()) {
+      continue;
+    }
+
+    db::Box cell_region = r->second;
+
+    const db::Cell &cell = layout.cell (*c);
+    for (db::Cell::touching_iterator i = cell.begin_touching (cell_region); ! i.at_end (); ++i) {
+
+      const db::CellInstArray &inst = i->cell_inst ();
+      db::cell_index_type ci = inst.object ().cell_index ();
+      if (cells.find (ci) == cells.end ()) {
+        continue;
+      }
+
+      const db::Box &child_box = layout.cell (ci).bbox ();
+
+      for (db::CellInstArray::iterator a = inst.begin_touching (cell_region, bc); ! a.at_end (); ++a) {
+
+        db::Box child_region = cell_region;
+        if (child_region != db::Box::world ()) {
+          child_region.transform (inst.complex_trans (*a).inverted ());
+        }
+        child_region &= child_box;
+
+        if (! child_region.empty ()) {
+          cell_regions [ci] += child_region;
+        }
+
+      }
+
+    }
+
+  }
+}
+
+void
+restrict_to_region (db::Layout &layout, const std::set<db::cell_index_type> &cells, const db::Box &region)
+{
+  //  NOTE: the readers call this method while the layout is still under construction
+  layout.force_update ();
+
+  std::map<db::cell_index_type, db::Box> cell_regions;
+  compute_cell_regions (layout, cells, region, cell_regions);
+
+  db::box_convert<db::CellInst> bc (layout);
+
+  std::set<db::cell_index_type> cells_to_delete;
+
+  for (std::set<db::cell_index_type>::const_iterator c = cells.begin (); c != cells.end (); ++c) {
+
+    std::map<db::cell_index_type, db::Box>::const_iterator r = cell_regions.find (*c);
+    if (r == cell_regions.end ()) {
+      cells_to_delete.insert (*c);
+      continue;
+    }
+
+    const db::Box &cell_region = r->second;
+    db::Cell &cell = layout.cell (*c);
+
+    //  Drop the shapes not touching the region. Shapes cannot be erased from non-editable
+    //  containers, hence we rebuild the container if required.
+    for (db::Layout::layer_iterator l = layout.begin_layers (); l != layout.end_layers (); ++l) {
+
+      db::Shapes &shapes = cell.shapes ((*l).first);
+      if (shapes.empty () || shapes.bbox ().inside (cell_region)) {
+        continue;
+      }
+
+      db::Shapes kept (0, &cell, layout.is_editable ());
+      for (db::ShapeIterator s = shapes.begin (db::ShapeIterator::All); ! s.at_end (); ++s) {
+        if (s->bbox ().touches (cell_region)) {
+          kept.insert (*s);
+        }
+      }
+
+      shapes.swap (kept);
+
+    }
+
+    //  Drop the instances not touching the region or pointing to cells not contributing
+    std::vector<db::CellInstArrayWithProperties> kept_insts;
+    bool any_dropped = false;
+
+    for (db::Cell::const_iterator i = cell.begin (); ! i.at_end (); ++i) {
+
+      const db::CellInstArray &inst = i->cell_inst ();
+      db::cell_index_type ci = inst.object ().cell_index ();
+
+      bool keep = (cells.find (ci) == cells.end () || cell_regions.find (ci) != cell_regions.end ())
+                    && ! inst.begin_touching (cell_region, bc).at_end ();
+
+      if (keep) {
+        kept_insts.push_back (db::CellInstArrayWithProperties (inst, i->prop_id ()));
+      } else {
+        any_dropped = true;
+      }
+
+    }
+
+    if (any_dropped) {
+      cell.clear_insts ();
+      for (std::vector<db::CellInstArrayWithProperties>::const_iterator i = kept_insts.begin (); i != kept_insts.end (); ++i) {
+        cell.insert (*i);
+      }
+    }
+
+  }
+
+  if (! cells_to_delete.empty ()) {
+    layout.delete_cells (cells_to_delete);
+  }
+}
+
 }
 
@@ -26,6 +26,10 @@
 #define HDR_dbCommonReader
 
 #include "dbReader.h"
+#include "dbBox.h"
+
+#include <set>
+#include <map>
 
 
 namespace db
@@ -44,7 +48,9 @@ public:
   CommonReaderOptions ()
     : create_other_layers (true),
       enable_text_objects (true),
-      enable_properties (true)
+      enable_properties (true),
+      read_ahead_buffers (0),
+      read_ahead_buffer_size (1024 * 1024)
   {
     //  .. nothing yet ..
   }
@@ -83,6 +89,33 @@ public:
    */
   bool enable_properties;
 
+  /**
+   *  @brief The region of interest
+   *
+   *  If this box is not empty, only the parts of the layout touching this region
+   *  are read. The region is given in micrometer units in the coordinate system of
+   *  the top cells. Shapes not touching the region are dropped and so are
+   *  instances whose cell does not touch the region. Cells which do not contribute
+   *  to the region are not created at all. Readers skip as much of the file
+   *  as possible in this case.
+   */
+  db::DBox region;
+
+  /**
+   *  @brief The number of read-ahead buffers
+   *
+   *  If this value is not zero, the input stream is read by a separate thread
+   *  into a ring of buffers ahead of the reader. This overlaps I/O and decompression 
+   *  with parsing. This is beneficial for slow sources such as network file systems.
+   *  This option applies to all formats.
+   */
+  unsigned int read_ahead_buffers;
+
+  /**
+   *  @brief The size of each read-ahead buffer in bytes
+   */
+  size_t read_ahead_buffer_size;
+
   /** 
    *  @brief Implementation of FormatSpecificReaderOptions
    */
@@ -101,6 +134,30 @@ public:
   }
 };
 
+/**
+ *  @brief Computes the regions of interest per cell
+ *
+ *  The region is given in the coordinate system of the top cells among "cells".
+ *  It is propagated down the hierarchy through the instances touching it.
+ *  Only cells from the given set are considered. On return, "cell_regions" holds the
+ *  cells contributing to the region along with the bounding box of the region parts
+ *  in the cell's coordinate system. Top cells are always contained in "cell_regions".
+ *  The bounding boxes of the cells are taken from the layout, so the layout needs
+ *  to be updated.
+ */
+DB_PUBLIC void compute_cell_regions (const db::Layout &layout, const std::set<db::cell_index_type> &cells, const db::Box &region, std::map<db::cell_index_type, db::Box> &cell_regions);
+
+/**
+ *  @brief Restricts the given cells of the layout to a region of interest
+ *
+ *  "cells" are the cells to which the restriction applies - usually the ones created by
+ *  the reader. The region is given in database units in the coordinate system of the top
+ *  cells among "cells". Shapes and instances not touching the region are removed. Cells
+ *  which no longer contribute to the region are deleted (top cells are kept).
+ *  This method works on editable and non-editable layouts.
+ */
+DB_PUBLIC void restrict_to_region (db::Layout &layout, const std::set<db::cell_index_type> &cells, const db::Box &region);
+
 }
 
 #endif
@@ -27,6 +27,8 @@
 #include "dbDeepRegion.h"
 #include "dbCellMapping.h"
 #include "dbLayoutUtils.h"
+#include "dbCellVariants.h"
+#include "dbLocalOperationUtils.h"
 
 #include <sstream>
 
@@ -231,14 +233,67 @@ EdgePairsDelegate *DeepEdgePairs::add (const EdgePairs &other) const
 
 EdgePairsDelegate *DeepEdgePairs::filter_in_place (const EdgePairFilterBase &filter)
 {
-  //  TODO: implement
-  return AsIfFlatEdgePairs::filter_in_place (filter);
+  //  TODO: implement to be really in-place
+  return filtered (filter);
 }
 
 EdgePairsDelegate *DeepEdgePairs::filtered (const EdgePairFilterBase &filter) const
 {
-  //  TODO: implement
-  return AsIfFlatEdgePairs::filtered (filter);
+  std::auto_ptr<VariantsCollectorBase> vars;
+  if (filter.vars ()) {
+    vars.reset (new db::VariantsCollectorBase (filter.vars ()));
+    vars->collect (m_deep_layer.layout (), m_deep_layer.initial_cell ());
+  }
+
+  db::Layout &layout = const_cast<db::Layout &> (m_deep_layer.layout ());
+  std::map<db::cell_index_type, std::map<db::ICplxTrans, db::Shapes> > to_commit;
+
+  std::auto_ptr<db::DeepEdgePairs> res (new db::DeepEdgePairs (m_deep_layer.derived ()));
+  for (db::Layout::iterator c = layout.begin (); c != layout.end (); ++c) {
+
+    const db::Shapes &s = c->shapes (m_deep_layer.layer ());
+
+    if (vars.get ()) {
+
+      const std::map<db::ICplxTrans, size_t> &vv = vars->variants (c->cell_index ());
+      for (std::map<db::ICplxTrans, size_t>::const_iterator v = vv.begin (); v != vv.end (); ++v) {
+
+        db::Shapes *st;
+        if (vv.size () == 1) {
+          st = & c->shapes (res->deep_layer ().layer ());
+        } else {
+          st = & to_commit [c->cell_index ()] [v->first];
+        }
+
+        const db::ICplxTrans &tr = v->first;
+
+        for (db::Shapes::shape_iterator si = s.begin (db::ShapeIterator::EdgePairs); ! si.at_end (); ++si) {
+          if (filter.selected (si->edge_pair ().transformed (tr))) {
+            st->insert (*si);
+          }
+        }
+
+      }
+
+    } else {
+
+      db::Shapes &st = c->shapes (res->deep_layer ().layer ());
+
+      for (db::Shapes::shape_iterator si = s.begin (db::ShapeIterator::EdgePairs); ! si.at_end (); ++si) {
+        if (filter.selected (si->edge_pair ())) {
+          st.insert (*si);
+        }
+      }
+
+    }
+
+  }
+
+  if (! to_commit.empty () && vars.get ()) {
+    res->deep_layer ().commit_shapes (*vars, to_commit);
+  }
+
+  return res.release ();
 }
 
 RegionDelegate *DeepEdgePairs::polygons (db::Coord e) const
@@ -246,14 +301,46 @@ RegionDelegate *DeepEdgePairs::polygons (db::Coord e) const
   db::DeepLayer new_layer = m_deep_layer.derived ();
   db::Layout &layout = const_cast<db::Layout &> (m_deep_layer.layout ());
 
+  //  the enlargement is given in the top cell's units - hence we need magnification variants
+  std::auto_ptr<db::cell_variants_collector<db::MagnificationReducer> > vars;
+  if (e != 0) {
+    vars.reset (new db::cell_variants_collector<db::MagnificationReducer> ());
+    vars->collect (m_deep_layer.layout (), m_deep_layer.initial_cell ());
+  }
+
+  std::map<db::cell_index_type, std::map<db::ICplxTrans, db::Shapes> > to_commit;
+
   for (db::Layout::iterator c = layout.begin (); c != layout.end (); ++c) {
-    db::Shapes &output = c->shapes (new_layer.layer ());
-    for (db::Shapes::shape_iterator s = c->shapes (m_deep_layer.layer ()).begin (db::ShapeIterator::EdgePairs); ! s.at_end (); ++s) {
-      db::Polygon poly = s->edge_pair ().normalized ().to_polygon (e);
-      if (poly.vertices () >= 3) {
-        output.insert (poly);
+
+    std::map<db::ICplxTrans, size_t> unit_variant;
+    unit_variant.insert (std::make_pair (db::ICplxTrans (), size_t (1)));
+
+    const std::map<db::ICplxTrans, size_t> &vv = vars.get () ? vars->variants (c->cell_index ()) : unit_variant;
+    for (std::map<db::ICplxTrans, size_t>::const_iterator v = vv.begin (); v != vv.end (); ++v) {
+
+      db::Shapes *output;
+      if (vv.size () == 1) {
+        output = & c->shapes (new_layer.layer ());
+      } else {
+        output = & to_commit [c->cell_index ()] [v->first];
+      }
+
+      db::PolygonRefToShapesGenerator pr (&layout, output);
+      db::ICplxTrans trinv = v->first.inverted ();
+
+      for (db::Shapes::shape_iterator s = c->shapes (m_deep_layer.layer ()).begin (db::ShapeIterator::EdgePairs); ! s.at_end (); ++s) {
+        db::Polygon poly = s->edge_pair ().transformed (v->first).normalized ().to_polygon (e);
+        if (poly.vertices () >= 3) {
+          pr.put (poly.transformed (trinv));
+        }
       }
+
     }
+
+  }
+
+  if (! to_commit.empty () && vars.get ()) {
+    new_layer.commit_shapes (*vars, to_commit);
   }
 
   return new db::DeepRegion (new_layer);
@@ -131,8 +131,13 @@ DeepEdges::DeepEdges (const DeepEdges &other)
     m_merged_edges_valid (other.m_merged_edges_valid),
     m_is_merged (other.m_is_merged)
 {
-  if (m_merged_edges_valid) {
-    m_merged_edges = other.m_merged_edges;
+  //  NOTE: the merged edges are not shared with the original: merged_in_place makes the merged
+  //  edges the original layer which is then modified in place by add_in_place. Only if the 
+  //  original layer is merged already, we can use our copy of it.
+  if (m_merged_edges_valid && other.m_merged_edges == other.m_deep_layer) {
+    m_merged_edges = m_deep_layer;
+  } else {
+    m_merged_edges_valid = false;
   }
 }
 
@@ -241,7 +246,9 @@ DeepEdges::has_valid_edges () const
 bool
 DeepEdges::has_valid_merged_edges () const
 {
-  return merged_semantics ();
+  //  NOTE: the merged edges are delivered as transformed copies by DeepEdgesIterator, so
+  //  they are not addressable (see AddressableEdgeDelivery) - same as DeepRegion
+  return false;
 }
 
 const db::RecursiveShapeIterator *
@@ -781,7 +788,12 @@ EdgesDelegate *DeepEdges::and_with (const Edges &other) const
 
   } else if (! other_deep) {
 
-    return AsIfFlatEdges::and_with (other);
+    //  bring the flat edges into our hierarchy rather than flattening ourselves
+    std::auto_ptr<DeepEdges> other_tmp (DeepShapeStore::deep_from_flat (m_deep_layer, other));
+    if (! other_tmp.get ()) {
+      return AsIfFlatEdges::and_with (other);
+    }
+    return new DeepEdges (and_or_not_with (other_tmp.get (), true));
 
   } else {
 
@@ -794,19 +806,18 @@ EdgesDelegate *DeepEdges::and_with (const Region &other) const
 {
   const DeepRegion *other_deep = dynamic_cast <const DeepRegion *> (other.delegate ());
 
-  if (empty ()) {
+  if (empty () || other.empty ()) {
 
     //  Nothing to do
     return new EmptyEdges ();
 
-  } else if (other.empty ()) {
-
-    //  Nothing to do
-    return clone ();
-
   } else if (! other_deep) {
 
-    return AsIfFlatEdges::not_with (other);
+    std::auto_ptr<DeepRegion> other_tmp (DeepShapeStore::deep_from_flat (m_deep_layer, other));
+    if (! other_tmp.get ()) {
+      return AsIfFlatEdges::and_with (other);
+    }
+    return new DeepEdges (edge_region_op (other_tmp.get (), false /*outside*/, true /*include borders*/));
 
   } else {
 
@@ -831,7 +842,11 @@ EdgesDelegate *DeepEdges::not_with (const Edges &other) const
 
   } else if (! other_deep) {
 
-    return AsIfFlatEdges::not_with (other);
+    std::auto_ptr<DeepEdges> other_tmp (DeepShapeStore::deep_from_flat (m_deep_layer, other));
+    if (! other_tmp.get ()) {
+      return AsIfFlatEdges::not_with (other);
+    }
+    return new DeepEdges (and_or_not_with (other_tmp.get (), false));
 
   } else {
 
@@ -856,7 +871,11 @@ EdgesDelegate *DeepEdges::not_with (const Region &other) const
 
   } else if (! other_deep) {
 
-    return AsIfFlatEdges::not_with (other);
+    std::auto_ptr<DeepRegion> other_tmp (DeepShapeStore::deep_from_flat (m_deep_layer, other));
+    if (! other_tmp.get ()) {
+      return AsIfFlatEdges::not_with (other);
+    }
+    return new DeepEdges (edge_region_op (other_tmp.get (), true /*outside*/, true /*include borders*/));
 
   } else {
 
@@ -879,12 +898,17 @@ EdgesDelegate *DeepEdges::xor_with (const Edges &other) const
     //  Nothing to do
     return clone ();
 
-  } else if (! other_deep) {
-
-    return AsIfFlatEdges::xor_with (other);
-
   } else {
 
+    std::auto_ptr<DeepEdges> other_tmp;
+    if (! other_deep) {
+      other_tmp.reset (DeepShapeStore::deep_from_flat (m_deep_layer, other));
+      if (! other_tmp.get ()) {
+        return AsIfFlatEdges::xor_with (other);
+      }
+      other_deep = other_tmp.get ();
+    }
+
     //  Implement XOR as (A-B)+(B-A) - only this implementation
     //  is compatible with the local processor scheme
     DeepLayer n1 (and_or_not_with (other_deep, false));
@@ -946,19 +970,18 @@ EdgesDelegate *DeepEdges::inside_part (const Region &other) const
 {
   const DeepRegion *other_deep = dynamic_cast <const DeepRegion *> (other.delegate ());
 
-  if (empty ()) {
+  if (empty () || other.empty ()) {
 
     //  Nothing to do
     return new EmptyEdges ();
 
-  } else if (other.empty ()) {
-
-    //  Nothing to do
-    return clone ();
-
   } else if (! other_deep) {
 
-    return AsIfFlatEdges::not_with (other);
+    std::auto_ptr<DeepRegion> other_tmp (DeepShapeStore::deep_from_flat (m_deep_layer, other));
+    if (! other_tmp.get ()) {
+      return AsIfFlatEdges::inside_part (other);
+    }
+    return new DeepEdges (edge_region_op (other_tmp.get (), false /*outside*/, false /*include borders*/));
 
   } else {
 
@@ -983,7 +1006,11 @@ EdgesDelegate *DeepEdges::outside_part (const Region &other) const
 
   } else if (! other_deep) {
 
-    return AsIfFlatEdges::not_with (other);
+    std::auto_ptr<DeepRegion> other_tmp (DeepShapeStore::deep_from_flat (m_deep_layer, other));
+    if (! other_tmp.get ()) {
+      return AsIfFlatEdges::outside_part (other);
+    }
+    return new DeepEdges (edge_region_op (other_tmp.get (), true /*outside*/, false /*include borders*/));
 
   } else {
 
@@ -1238,8 +1265,14 @@ EdgesDelegate *
 DeepEdges::selected_interacting_generic (const Region &other, bool inverse) const
 {
   const db::DeepRegion *other_deep = dynamic_cast<const db::DeepRegion *> (other.delegate ());
+
+  std::auto_ptr<db::DeepRegion> other_tmp;
   if (! other_deep) {
-    return db::AsIfFlatEdges::selected_interacting_generic (other, inverse);
+    other_tmp.reset (DeepShapeStore::deep_from_flat (m_deep_layer, other));
+    if (! other_tmp.get ()) {
+      return db::AsIfFlatEdges::selected_interacting_generic (other, inverse);
+    }
+    other_deep = other_tmp.get ();
   }
 
   ensure_merged_edges_valid ();
@@ -1261,8 +1294,14 @@ EdgesDelegate *
 DeepEdges::selected_interacting_generic (const Edges &other, bool inverse) const
 {
   const db::DeepEdges *other_deep = dynamic_cast<const db::DeepEdges *> (other.delegate ());
+
+  std::auto_ptr<db::DeepEdges> other_tmp;
   if (! other_deep) {
-    return db::AsIfFlatEdges::selected_interacting_generic (other, inverse);
+    other_tmp.reset (DeepShapeStore::deep_from_flat (m_deep_layer, other));
+    if (! other_tmp.get ()) {
+      return db::AsIfFlatEdges::selected_interacting_generic (other, inverse);
+    }
+    other_deep = other_tmp.get ();
   }
 
   ensure_merged_edges_valid ();
@@ -1394,10 +1433,15 @@ EdgePairsDelegate *
 DeepEdges::run_check (db::edge_relation_type rel, const Edges *other, db::Coord d, bool whole_edges, metrics_type metrics, double ignore_angle, distance_type min_projection, distance_type max_projection) const
 {
   const db::DeepEdges *other_deep = 0;
+  std::auto_ptr<db::DeepEdges> other_tmp;
   if (other) {
     other_deep = dynamic_cast<const db::DeepEdges *> (other->delegate ());
     if (! other_deep) {
-      return db::AsIfFlatEdges::run_check (rel, other, d, whole_edges, metrics, ignore_angle, min_projection, max_projection);
+      other_tmp.reset (DeepShapeStore::deep_from_flat (m_deep_layer, *other));
+      if (! other_tmp.get ()) {
+        return db::AsIfFlatEdges::run_check (rel, other, d, whole_edges, metrics, ignore_angle, min_projection, max_projection);
+      }
+      other_deep = other_tmp.get ();
     }
   }
 
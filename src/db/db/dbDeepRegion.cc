@@ -1250,6 +1250,8 @@ DeepRegion::sized (coord_type d, unsigned int mode) const
     db::PolygonRefToShapesGenerator pr (&layout, &st);
     db::PolygonGenerator pg2 (pr, false /*don't resolve holes*/, true /*min. coherence*/);
     db::SizingPolygonFilter siz (pg2, d_with_mag, d_with_mag, mode);
+    siz.set_max_vertex_count (m_deep_layer.store ()->slice_vertex_count ());
+    siz.set_threads (m_deep_layer.store ()->threads ());
 
     for (db::Shapes::shape_iterator si = s.begin (db::ShapeIterator::All); ! si.at_end (); ++si) {
       db::Polygon poly;
@@ -1329,6 +1331,8 @@ DeepRegion::sized (coord_type dx, coord_type dy, unsigned int mode) const
     db::PolygonRefToShapesGenerator pr (&layout, &st);
     db::PolygonGenerator pg2 (pr, false /*don't resolve holes*/, true /*min. coherence*/);
     db::SizingPolygonFilter siz (pg2, dx_with_mag, dy_with_mag, mode);
+    siz.set_max_vertex_count (m_deep_layer.store ()->slice_vertex_count ());
+    siz.set_threads (m_deep_layer.store ()->threads ());
 
     for (db::Shapes::shape_iterator si = s.begin (db::ShapeIterator::All); ! si.at_end (); ++si) {
       db::Polygon poly;
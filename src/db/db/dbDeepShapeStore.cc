@@ -26,6 +26,8 @@
 #include "dbLayoutUtils.h"
 #include "dbRegion.h"
 #include "dbDeepRegion.h"
+#include "dbDeepEdges.h"
+#include "dbEdges.h"
 
 #include "tlTimer.h"
 
@@ -271,13 +273,13 @@ private:
 static size_t s_instance_count = 0;
 
 DeepShapeStore::DeepShapeStore ()
-  : m_threads (1), m_max_area_ratio (3.0), m_max_vertex_count (16), m_text_property_name (), m_text_enlargement (-1)
+  : m_threads (1), m_max_area_ratio (3.0), m_max_vertex_count (16), m_slice_vertex_count (0), m_text_property_name (), m_text_enlargement (-1)
 {
   ++s_instance_count;
 }
 
 DeepShapeStore::DeepShapeStore (const std::string &topcell_name, double dbu)
-  : m_threads (1), m_max_area_ratio (3.0), m_max_vertex_count (16), m_text_property_name (), m_text_enlargement (-1)
+  : m_threads (1), m_max_area_ratio (3.0), m_max_vertex_count (16), m_slice_vertex_count (0), m_text_property_name (), m_text_enlargement (-1)
 {
   ++s_instance_count;
 
@@ -343,11 +345,57 @@ DeepLayer DeepShapeStore::create_from_flat (const db::Region &region, bool for_n
   return dl;
 }
 
+DeepLayer DeepShapeStore::create_from_flat (const db::Edges &edges, const db::ICplxTrans &trans)
+{
+  //  reuse existing layer
+  std::pair<bool, DeepLayer> lff = layer_for_flat (tl::id_of (edges.delegate ()));
+  if (lff.first) {
+    return lff.second;
+  }
+
+  require_singular ();
+
+  unsigned int layer = layout ().insert_layer ();
+
+  db::Shapes *shapes = &initial_cell ().shapes (layer);
+  for (db::Edges::const_iterator e = edges.begin (); ! e.at_end (); ++e) {
+    shapes->insert (e->transformed (trans));
+  }
+
+  DeepLayer dl (this, 0 /*singular layout index*/, layer);
+  m_layers_for_flat [tl::id_of (edges.delegate ())] = std::make_pair (dl.layout_index (), dl.layer ());
+  m_flat_region_id [std::make_pair (dl.layout_index (), dl.layer ())] = tl::id_of (edges.delegate ());
+  return dl;
+}
+
+db::DeepRegion *DeepShapeStore::deep_from_flat (const DeepLayer &like, const db::Region &region)
+{
+  db::DeepShapeStore *store = const_cast<db::DeepShapeStore *> (like.store ());
+  if (! store->is_singular ()) {
+    return 0;
+  }
+  return new db::DeepRegion (store->create_from_flat (region, false));
+}
+
+db::DeepEdges *DeepShapeStore::deep_from_flat (const DeepLayer &like, const db::Edges &edges)
+{
+  db::DeepShapeStore *store = const_cast<db::DeepShapeStore *> (like.store ());
+  if (! store->is_singular ()) {
+    return 0;
+  }
+  return new db::DeepEdges (store->create_from_flat (edges));
+}
+
 std::pair<bool, DeepLayer> DeepShapeStore::layer_for_flat (const db::Region &region) const
 {
   return layer_for_flat (tl::id_of (region.delegate ()));
 }
 
+std::pair<bool, DeepLayer> DeepShapeStore::layer_for_flat (const db::Edges &edges) const
+{
+  return layer_for_flat (tl::id_of (edges.delegate ()));
+}
+
 std::pair<bool, DeepLayer> DeepShapeStore::layer_for_flat (size_t region_id) const
 {
   std::map<size_t, std::pair<unsigned int, unsigned int> >::const_iterator lff = m_layers_for_flat.find (region_id);
@@ -431,6 +479,11 @@ void DeepShapeStore::set_max_vertex_count (size_t n)
   m_max_vertex_count = n;
 }
 
+void DeepShapeStore::set_slice_vertex_count (size_t n)
+{
+  m_slice_vertex_count = n;
+}
+
 void DeepShapeStore::add_ref (unsigned int layout, unsigned int layer)
 {
   tl::MutexLocker locker (&m_lock);
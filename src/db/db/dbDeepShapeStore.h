@@ -41,6 +41,9 @@ namespace db {
 
 class DeepShapeStore;
 class Region;
+class Edges;
+class DeepRegion;
+class DeepEdges;
 
 /**
  *  @brief Represents a shape collection from the deep shape store
@@ -161,6 +164,8 @@ public:
 
   /**
    *  @brief Separates cell variants (see DeepShapeStore::separate_variants)
+   *
+   *  Only the cells carrying shapes on this layer are separated.
    */
   template <class VarCollector>
   void separate_variants (VarCollector &collector);
@@ -274,6 +279,34 @@ public:
    */
   DeepLayer create_from_flat (const db::Region &region, bool for_netlist, double max_area_ratio = 0.0, size_t max_vertex_count = 0, const db::ICplxTrans &trans = db::ICplxTrans ());
 
+  /**
+   *  @brief Creates a new layer from flat edges (or the edges are made flat)
+   *
+   *  This method is intended for use with singular-created DSS objects (see
+   *  singular constructor). The edges are put into the initial cell.
+   *
+   *  After a flat layer has been created for an edge collection, it can be retrieved
+   *  from the edge collection later with layer_for_flat (edges).
+   */
+  DeepLayer create_from_flat (const db::Edges &edges, const db::ICplxTrans &trans = db::ICplxTrans ());
+
+  /**
+   *  @brief Brings a flat region into the store of the given deep layer
+   *
+   *  This way, a flat operand can be used in hierarchical operations without having to
+   *  flatten the deep one. The polygons are put into the initial cell (see create_from_flat).
+   *  Returns 0 if the store isn't singular - in this case, the operation needs to be computed flat.
+   *  The caller takes ownership of the object returned.
+   */
+  static db::DeepRegion *deep_from_flat (const DeepLayer &like, const db::Region &region);
+
+  /**
+   *  @brief Brings flat edges into the store of the given deep layer
+   *
+   *  See the region version for details.
+   */
+  static db::DeepEdges *deep_from_flat (const DeepLayer &like, const db::Edges &edges);
+
   /**
    *  @brief Gets the layer for a given flat region.
    *
@@ -282,6 +315,14 @@ public:
    */
   std::pair<bool, DeepLayer> layer_for_flat (const db::Region &region) const;
 
+  /**
+   *  @brief Gets the layer for given flat edges.
+   *
+   *  If a layer has been created for flat edges with create_from_flat, it can be retrieved with this method.
+   *  The first return value is true in this case.
+   */
+  std::pair<bool, DeepLayer> layer_for_flat (const db::Edges &edges) const;
+
   /**
    *  @brief Same as layer_for_flat, but takes a region Id
    */
@@ -400,6 +441,27 @@ public:
     issue_variants (layout_index, var_map);
   }
 
+  /**
+   *  @brief Create cell variants from the given variant collector for a specific layer
+   *
+   *  This version will only separate the cells which carry shapes on the given layer.
+   *  This avoids cell copies for cells which do not contribute to the layer in question.
+   */
+  template <class VarCollector>
+  void separate_variants (unsigned int layout_index, unsigned int layer, VarCollector &coll)
+  {
+    tl_assert (is_valid_layout_index (layout_index));
+
+    std::map<db::cell_index_type, std::map<db::ICplxTrans, db::cell_index_type> > var_map;
+    coll.separate_variants (layout (layout_index), initial_cell (layout_index), layer, &var_map);
+    if (var_map.empty ()) {
+      //  nothing to do.
+      return;
+    }
+
+    issue_variants (layout_index, var_map);
+  }
+
   /**
    *  @brief Commits shapes for variants to the existing cell hierarchy
    *
@@ -535,6 +597,26 @@ public:
     return m_max_vertex_count;
   }
 
+  /**
+   *  @brief Sets the vertex count above which polygons are processed in slices
+   *
+   *  Sizing acts on merged polygons which may become very big. With this option,
+   *  polygons with more vertices than this value are sized in slices which are 
+   *  stitched together afterwards. Only sizing is sliced - boolean operations and
+   *  checks always work on the full polygons.
+   *  A value of 0 disables slicing. This is the default, because slicing may
+   *  change the result by rounding effects at the slice borders.
+   */
+  void set_slice_vertex_count (size_t n);
+
+  /**
+   *  @brief Gets the vertex count above which polygons are processed in slices
+   */
+  size_t slice_vertex_count () const
+  {
+    return m_slice_vertex_count;
+  }
+
   /**
    *  @brief Sets the max. area ratio for bounding box vs. polygon area
    *
@@ -616,6 +698,7 @@ private:
   int m_threads;
   double m_max_area_ratio;
   size_t m_max_vertex_count;
+  size_t m_slice_vertex_count;
   tl::Variant m_text_property_name;
   int m_text_enlargement;
   tl::Mutex m_lock;
@@ -653,7 +736,7 @@ template <class VarCollector>
 void DeepLayer::separate_variants (VarCollector &collector)
 {
   check_dss ();
-  mp_store->separate_variants (m_layout, collector);
+  mp_store->separate_variants (m_layout, m_layer, collector);
 }
 
 template <class VarCollector>
@@ -25,6 +25,7 @@
 #include "dbLayout.h"
 #include "dbEdgeProcessor.h"
 #include "dbReader.h"
+#include "dbHershey.h"
 #include "tlStream.h"
 #include "tlFileUtils.h"
 
@@ -39,6 +40,9 @@
 namespace db
 {
 
+//  the maximum number of scaled glyphs kept by a text generator
+const size_t max_scaled_glyphs = 10000;
+
 TextGenerator::TextGenerator ()
   : m_width (1000), m_height (1000), m_line_width (100), m_design_grid (10),
     m_dbu (0.001), m_lowercase_supported (false)
@@ -46,6 +50,37 @@ TextGenerator::TextGenerator ()
   //  .. nothing yet ..
 }
 
+TextGenerator::TextGenerator (const TextGenerator &other)
+  : m_width (1000), m_height (1000), m_line_width (100), m_design_grid (10),
+    m_dbu (0.001), m_lowercase_supported (false)
+{
+  operator= (other);
+}
+
+TextGenerator &
+TextGenerator::operator= (const TextGenerator &other)
+{
+  if (this != &other) {
+
+    //  NOTE: the scaled glyph cache is not copied
+    tl::MutexLocker locker (&m_lock);
+    m_scaled_glyphs.clear ();
+
+    m_data = other.m_data;
+    m_width = other.m_width;
+    m_height = other.m_height;
+    m_line_width = other.m_line_width;
+    m_design_grid = other.m_design_grid;
+    m_background = other.m_background;
+    m_description = other.m_description;
+    m_name = other.m_name;
+    m_dbu = other.m_dbu;
+    m_lowercase_supported = other.m_lowercase_supported;
+
+  }
+  return *this;
+}
+
 const std::vector<db::Polygon> &
 TextGenerator::glyph (char c) const
 {
@@ -58,6 +93,36 @@ TextGenerator::glyph (char c) const
   }
 }
 
+const std::vector<db::Polygon> &
+TextGenerator::scaled_glyph (char c, double m) const
+{
+  //  NOTE: m_lock needs to be locked by the caller
+
+  std::pair<char, double> key (m_lowercase_supported ? c : toupper (c), m);
+
+  std::map<std::pair<char, double>, std::vector<db::Polygon> >::const_iterator sg = m_scaled_glyphs.find (key);
+  if (sg != m_scaled_glyphs.end ()) {
+    return sg->second;
+  }
+
+  //  limit the memory used
+  if (m_scaled_glyphs.size () >= max_scaled_glyphs) {
+    m_scaled_glyphs.clear ();
+  }
+
+  std::vector<db::Polygon> &data = m_scaled_glyphs.insert (std::make_pair (key, std::vector<db::Polygon> ())).first->second;
+
+  db::ICplxTrans trans (m);
+
+  const std::vector<db::Polygon> &g = glyph (c);
+  data.reserve (g.size ());
+  for (std::vector<db::Polygon>::const_iterator d = g.begin (); d != g.end (); ++d) {
+    data.push_back (d->transformed (trans));
+  }
+
+  return data;
+}
+
 db::Region
 TextGenerator::glyph_as_region (char c) const
 {
@@ -105,9 +170,16 @@ TextGenerator::text (const std::string &t, double target_dbu, double mag, bool i
 
       db::ICplxTrans trans (m, 0.0, false, db::Vector (x, y));
 
-      const std::vector<db::Polygon> &g = glyph (c);
-      for (std::vector<db::Polygon>::const_iterator d = g.begin (); d != g.end (); ++d) {
-        data.push_back (d->transformed (trans));
+      {
+        //  the scaled glyph cache is shared. The polygons are copied out while the lock is held
+        //  because another thread may clear the cache and invalidate the reference.
+        tl::MutexLocker locker (&m_lock);
+
+        //  NOTE: as the displacement is integer, moving the scaled glyph is equivalent to transforming the original one
+        const std::vector<db::Polygon> &g = scaled_glyph (c, m);
+        for (std::vector<db::Polygon>::const_iterator d = g.begin (); d != g.end (); ++d) {
+          data.push_back (d->moved (db::Vector (x, y)));
+        }
       }
 
       bb += background ().transformed (trans);
@@ -199,6 +271,11 @@ TextGenerator::load_from_file (const std::string &filename)
 void
 TextGenerator::read_from_layout (const db::Layout &layout, unsigned int l1, unsigned int l2, unsigned int l3)
 {
+  {
+    tl::MutexLocker locker (&m_lock);
+    m_scaled_glyphs.clear ();
+  }
+
   m_dbu = layout.dbu ();
 
   //  try to read the comment
@@ -371,4 +448,255 @@ TextGenerator::generators ()
   return s_fonts;
 }
 
+// ---------------------------------------------------------------------------------
+//  GlyphCellLibrary implementation
+
+GlyphCellLibrary::GlyphCellLibrary (db::Layout &layout, unsigned int layer)
+  : mp_layout (&layout), m_layer (layer)
+{
+  //  .. nothing yet ..
+}
+
+db::Layout &
+GlyphCellLibrary::layout ()
+{
+  if (! mp_layout.get ()) {
+    throw tl::Exception (tl::to_string (tr ("The layout of the glyph cell library has been destroyed")));
+  }
+  return *mp_layout;
+}
+
+void
+GlyphCellLibrary::check_target (const db::Cell &target, bool flat)
+{
+  if (! flat && target.layout () != &layout ()) {
+    throw tl::Exception (tl::to_string (tr ("The target cell must be a cell of the glyph cell library's layout unless 'flat' is true")));
+  }
+}
+
+void
+GlyphCellLibrary::clear ()
+{
+  m_glyphs.clear ();
+  m_hershey_glyphs.clear ();
+}
+
+GlyphCellLibrary::Glyph &
+GlyphCellLibrary::glyph (const db::TextGenerator &gen, char c, double m)
+{
+  glyph_key key (&gen, std::make_pair (c, m));
+
+  std::map<glyph_key, Glyph>::iterator g = m_glyphs.find (key);
+  if (g != m_glyphs.end ()) {
+    return g->second;
+  }
+
+  Glyph &glyph = m_glyphs.insert (std::make_pair (key, Glyph ())).first->second;
+  glyph.name = "GLYPH_" + gen.name () + "_" + tl::sprintf ("%03d", int ((unsigned char) c));
+
+  db::ICplxTrans trans (m);
+
+  const std::vector<db::Polygon> &data = gen.glyph (c);
+  glyph.polygons.reserve (data.size ());
+  for (std::vector<db::Polygon>::const_iterator d = data.begin (); d != data.end (); ++d) {
+    glyph.polygons.push_back (d->transformed (trans));
+  }
+
+  return glyph;
+}
+
+GlyphCellLibrary::Glyph &
+GlyphCellLibrary::hershey_glyph (db::Font font, unsigned char c, double scale, db::Coord w)
+{
+  if (font < db::DefaultFont || font >= db::NFonts) {
+    font = db::DefaultFont;
+  }
+
+  hershey_glyph_key key (std::make_pair (int (font), c), std::make_pair (scale, w));
+
+  std::map<hershey_glyph_key, Glyph>::iterator g = m_hershey_glyphs.find (key);
+  if (g != m_hershey_glyphs.end ()) {
+    return g->second;
+  }
+
+  Glyph &glyph = m_hershey_glyphs.insert (std::make_pair (key, Glyph ())).first->second;
+  glyph.name = "HERSHEY" + tl::to_string (int (font)) + "_" + tl::sprintf ("%03d", int (c));
+
+  std::string s (1, char (c));
+  glyph.advance = db::hershey_text_box (s, (unsigned int) font).width ();
+
+  db::Hershey h (s, font);
+  h.scale (scale);
+
+  //  the strokes are converted into polygons if a line width is given
+  std::vector<db::Polygon> strokes;
+
+  for (db::Hershey::edge_iterator e = h.begin_edges (); ! e.at_end (); ++e) {
+    db::Edge edge = *e;
+    if (w > 0) {
+      db::Point pts [] = { edge.p1 (), edge.p2 () };
+      strokes.push_back (db::Path (pts, pts + 2, w, w / 2, w / 2).polygon ());
+    } else if (! edge.is_degenerate ()) {
+      glyph.edges.push_back (edge);
+    }
+  }
+
+  if (! strokes.empty ()) {
+    db::EdgeProcessor ep;
+    ep.merge (strokes, glyph.polygons, 0);
+  }
+
+  return glyph;
+}
+
+db::cell_index_type
+GlyphCellLibrary::cell_for (Glyph &g)
+{
+  if (! g.has_cell) {
+
+    db::Layout &ly = layout ();
+    g.cell_index = ly.add_cell (ly.uniquify_cell_name (g.name.c_str ()).c_str ());
+    g.has_cell = true;
+
+    db::Shapes &shapes = ly.cell (g.cell_index).shapes (m_layer);
+    for (std::vector<db::Polygon>::const_iterator p = g.polygons.begin (); p != g.polygons.end (); ++p) {
+      shapes.insert (*p);
+    }
+    for (std::vector<db::Edge>::const_iterator e = g.edges.begin (); e != g.edges.end (); ++e) {
+      shapes.insert (*e);
+    }
+
+  }
+
+  return g.cell_index;
+}
+
+void
+GlyphCellLibrary::place (Glyph &g, db::Cell &target, const db::Trans &trans, bool flat)
+{
+  if (g.polygons.empty () && g.edges.empty ()) {
+    //  blank glyphs do not need an instance
+    return;
+  }
+
+  if (flat) {
+
+    db::Shapes &shapes = target.shapes (m_layer);
+    for (std::vector<db::Polygon>::const_iterator p = g.polygons.begin (); p != g.polygons.end (); ++p) {
+      shapes.insert (p->transformed (trans));
+    }
+    for (std::vector<db::Edge>::const_iterator e = g.edges.begin (); e != g.edges.end (); ++e) {
+      shapes.insert (e->transformed (trans));
+    }
+
+  } else {
+    target.insert (db::CellInstArray (db::CellInst (cell_for (g)), trans));
+  }
+}
+
+db::cell_index_type
+GlyphCellLibrary::glyph_cell (const db::TextGenerator &gen, char c, double mag)
+{
+  return cell_for (glyph (gen, c, mag * gen.dbu () / layout ().dbu ()));
+}
+
+void
+GlyphCellLibrary::text (const db::TextGenerator &gen, const std::string &t, double mag, double char_spacing, double line_spacing, db::Cell &target, const db::Trans &trans, bool flat)
+{
+  //  NOTE: this follows the implementation of TextGenerator::text
+
+  check_target (target, flat);
+
+  double dbu = layout ().dbu ();
+  double m = mag * gen.dbu () / dbu;
+
+  db::Coord x = 0, y = 0;
+  db::Coord dx = db::coord_traits<db::Coord>::rounded (m * gen.width () + char_spacing / dbu);
+  db::Coord dy = db::coord_traits<db::Coord>::rounded (m * gen.height () + line_spacing / dbu);
+
+  for (const char *cp = t.c_str (); *cp; ++cp) {
+
+    char c = *cp;
+    if (c == '\\' && cp [1]) {
+      if (cp [1] == 'n') {
+        ++cp;
+        y -= dy;
+        x = 0;
+        c = 0;
+      } else {
+        ++cp;
+        c = *cp;
+      }
+    }
+
+    if (c) {
+      place (glyph (gen, c, m), target, trans * db::Trans (db::Vector (x, y)), flat);
+      x += dx;
+    }
+
+  }
+}
+
+db::cell_index_type
+GlyphCellLibrary::hershey_glyph_cell (db::Font font, unsigned char c, double height, double line_width)
+{
+  if (font < db::DefaultFont || font >= db::NFonts) {
+    font = db::DefaultFont;
+  }
+
+  double dbu = layout ().dbu ();
+  double scale = height / (dbu * db::hershey_font_height ((unsigned int) font));
+  return cell_for (hershey_glyph (font, c, scale, db::coord_traits<db::Coord>::rounded (line_width / dbu)));
+}
+
+void
+GlyphCellLibrary::hershey_text (db::Font font, const std::string &t, double height, double line_width, db::Cell &target, const db::Trans &trans, bool flat)
+{
+  if (font < db::DefaultFont || font >= db::NFonts) {
+    font = db::DefaultFont;
+  }
+
+  check_target (target, flat);
+
+  double dbu = layout ().dbu ();
+  double scale = height / (dbu * db::hershey_font_height ((unsigned int) font));
+  db::Coord w = db::coord_traits<db::Coord>::rounded (line_width / dbu);
+
+  //  the line starts with the bottom left corner of the text box at the origin
+  std::vector<db::DPoint> line_starts;
+  db::hershey_justify (t, (unsigned int) font, db::DBox (0.0, 0.0, 0.0, 0.0), db::HAlignLeft, db::VAlignBottom, line_starts);
+  if (line_starts.empty ()) {
+    return;
+  }
+
+  size_t line = 0;
+  db::DPoint pos = line_starts.front ();
+
+  for (const char *cp = t.c_str (); *cp; ++cp) {
+
+    unsigned char c = (unsigned char) *cp;
+
+    if (c == '\012' || c == '\015') {
+
+      if (c == '\015' && cp[1] == '\012') {
+        ++cp;
+      }
+
+      ++line;
+      pos = line_starts [std::min (line, line_starts.size () - 1)];
+
+    } else {
+
+      Glyph &g = hershey_glyph (font, c, scale, w);
+
+      db::Vector d (db::coord_traits<db::Coord>::rounded (pos.x () * scale), db::coord_traits<db::Coord>::rounded (pos.y () * scale));
+      place (g, target, trans * db::Trans (d), flat);
+
+      pos += db::DVector (g.advance, 0.0);
+
+    }
+
+  }
+}
+
 }
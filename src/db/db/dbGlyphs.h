@@ -27,6 +27,13 @@
 #include "dbPolygon.h"
 #include "dbBox.h"
 #include "dbRegion.h"
+#include "dbTrans.h"
+#include "dbTypes.h"
+#include "dbHersheyFont.h"
+#include "dbLayout.h"
+#include "tlThreads.h"
+#include "tlObject.h"
+#include "tlTypeTraits.h"
 
 #include <map>
 #include <vector>
@@ -36,6 +43,7 @@ namespace db
 {
 
 class Layout;
+class Cell;
 
 /**
  *  @brief A basic text field generator class
@@ -76,6 +84,16 @@ public:
    */
   TextGenerator ();
 
+  /**
+   *  @brief Copy constructor
+   */
+  TextGenerator (const TextGenerator &other);
+
+  /**
+   *  @brief Assignment
+   */
+  TextGenerator &operator= (const TextGenerator &other);
+
 #if defined(HAVE_QT)
   /**
    *  @brief Loads the font from the given resource
@@ -115,6 +133,10 @@ public:
    *  @param char_spacing Additional spacing between the characters in µm
    *  @param char_spacing Additional spacing between the lines in µm
    *  @param The resulting polygons will be put here (the vector will be cleared before)
+   *
+   *  The scaled glyphs are cached per character and magnification, so
+   *  producing many texts of the same size does not transform the glyphs
+   *  again for every character.
    */
   void text (const std::string &t, double target_dbu, double mag, bool inv, double bias, double char_spacing, double line_spacing, std::vector<db::Polygon> &polygons) const;
 
@@ -215,11 +237,174 @@ private:
   std::string m_name;
   double m_dbu;
   bool m_lowercase_supported;
+  mutable std::map<std::pair<char, double>, std::vector<db::Polygon> > m_scaled_glyphs;
+  mutable tl::Mutex m_lock;
 
+  const std::vector<db::Polygon> &scaled_glyph (char c, double m) const;
   void read_from_layout (const db::Layout &layout, unsigned int ldata, unsigned int lborder, unsigned int lbackground);
 };
 
+/**
+ *  @brief A library of glyph cells
+ *
+ *  The glyph cell library turns texts into cell hierarchies: each glyph
+ *  becomes a cell inside the given layout and a text is created as a set of
+ *  instances of these cells. The glyph cells are created once per font,
+ *  size and character and are reused by all texts produced with this library.
+ *  This is much more compact and faster than producing the polygons for
+ *  every text when many texts are to be generated.
+ *
+ *  Two kinds of fonts are supported: the fonts of db::TextGenerator and the
+ *  Hershey fonts (db::Font). Hershey glyphs are stroke fonts. With a line
+ *  width of 0, the glyph cells will hold the strokes as edges. Otherwise,
+ *  the strokes are converted into polygons with the given width.
+ *
+ *  Alternatively the texts can be produced as flat shapes. In that case,
+ *  the library keeps the polygons of each glyph and places them
+ *  into the target cell. No glyph cells are created then.
+ *
+ *  Shapes are produced on the layer given in the constructor.
+ */
+class DB_PUBLIC GlyphCellLibrary
+{
+public:
+  /**
+   *  @brief Constructor
+   *
+   *  @param layout The layout where the glyph cells are created
+   *  @param layer The layer on which the glyph shapes are produced
+   *
+   *  The library does not own the layout. If the layout is destroyed, using
+   *  the library will throw an exception.
+   */
+  GlyphCellLibrary (db::Layout &layout, unsigned int layer);
+
+  /**
+   *  @brief Gets the layout
+   *
+   *  Throws an exception if the layout has been destroyed.
+   */
+  db::Layout &layout ();
+
+  /**
+   *  @brief Gets the layer
+   */
+  unsigned int layer () const
+  {
+    return m_layer;
+  }
+
+  /**
+   *  @brief Gets the number of glyphs held by the library
+   */
+  size_t size () const
+  {
+    return m_glyphs.size () + m_hershey_glyphs.size ();
+  }
+
+  /**
+   *  @brief Forgets all glyphs
+   *
+   *  This method does not delete the glyph cells but new texts will use new cells.
+   */
+  void clear ();
+
+  /**
+   *  @brief Gets the glyph cell for a character of a TextGenerator font
+   *
+   *  @param gen The generator (font)
+   *  @param c The character
+   *  @param mag The magnification (1 = original size)
+   *
+   *  The generator must stay valid as long as the library is used.
+   */
+  db::cell_index_type glyph_cell (const db::TextGenerator &gen, char c, double mag);
+
+  /**
+   *  @brief Produces a text with a TextGenerator font
+   *
+   *  @param gen The generator (font)
+   *  @param t The text (see TextGenerator::text for the escape sequences)
+   *  @param mag The magnification (1 = original size)
+   *  @param char_spacing Additional spacing between the characters in µm
+   *  @param line_spacing Additional spacing between the lines in µm
+   *  @param target The cell where the text is produced
+   *  @param trans The transformation applied to the text
+   *  @param flat If true, polygons are produced in the target cell instead of glyph cell instances
+   *
+   *  Unless "flat" is true, the target cell must live in the library's layout.
+   *  The first character is placed at the origin. Inversion and bias are not supported.
+   *  Without transformation, the result is identical to TextGenerator::text.
+   */
+  void text (const db::TextGenerator &gen, const std::string &t, double mag, double char_spacing, double line_spacing, db::Cell &target, const db::Trans &trans = db::Trans (), bool flat = false);
+
+  /**
+   *  @brief Gets the glyph cell for a character of a Hershey font
+   *
+   *  @param font The Hershey font
+   *  @param c The character
+   *  @param height The height of the "M" character in µm
+   *  @param line_width The width of the strokes in µm (0 for edges)
+   */
+  db::cell_index_type hershey_glyph_cell (db::Font font, unsigned char c, double height, double line_width);
+
+  /**
+   *  @brief Produces a text with a Hershey font
+   *
+   *  @param font The Hershey font
+   *  @param t The text (line breaks are given by newline characters)
+   *  @param height The height of the "M" character in µm
+   *  @param line_width The width of the strokes in µm (0 for edges)
+   *  @param target The cell where the text is produced
+   *  @param trans The transformation applied to the text
+   *  @param flat If true, shapes are produced in the target cell instead of glyph cell instances
+   *
+   *  Unless "flat" is true, the target cell must live in the library's layout.
+   *  The bottom left corner of the text box is placed at the origin. As the
+   *  glyph positions are rounded to the database unit, the result may
+   *  differ by one database unit from the edges delivered by db::Hershey.
+   */
+  void hershey_text (db::Font font, const std::string &t, double height, double line_width, db::Cell &target, const db::Trans &trans = db::Trans (), bool flat = false);
+
+private:
+  struct Glyph
+  {
+    Glyph () : has_cell (false), cell_index (0), advance (0.0) { }
+
+    bool has_cell;
+    db::cell_index_type cell_index;
+    double advance;
+    std::string name;
+    std::vector<db::Polygon> polygons;
+    std::vector<db::Edge> edges;
+  };
+
+  typedef std::pair<const db::TextGenerator *, std::pair<char, double> > glyph_key;
+  typedef std::pair<std::pair<int, unsigned char>, std::pair<double, db::Coord> > hershey_glyph_key;
+
+  tl::weak_ptr<db::Layout> mp_layout;
+  unsigned int m_layer;
+  std::map<glyph_key, Glyph> m_glyphs;
+  std::map<hershey_glyph_key, Glyph> m_hershey_glyphs;
+
+  Glyph &glyph (const db::TextGenerator &gen, char c, double m);
+  Glyph &hershey_glyph (db::Font font, unsigned char c, double scale, db::Coord w);
+  db::cell_index_type cell_for (Glyph &g);
+  void place (Glyph &g, db::Cell &target, const db::Trans &trans, bool flat);
+  void check_target (const db::Cell &target, bool flat);
+};
+
+}
 
+namespace tl
+{
+  /**
+   *  @brief Type traits
+   */
+  template <> struct type_traits <db::GlyphCellLibrary> : public type_traits<void> {
+    typedef tl::false_tag has_copy_constructor;
+    typedef tl::false_tag has_default_constructor;
+  };
 }
 
 #endif
@@ -274,6 +274,17 @@ struct DB_PUBLIC_TEMPLATE hershey
     return hershey_edge_iterator<C> (m_string, (unsigned int) m_font, m_linestarts, m_scale);
   }  
 
+  /**
+   *  @brief Gets the start points of the lines
+   *
+   *  The line starts are computed by "justify" or "position". They are given
+   *  in font units, i.e. without the scaling applied.
+   */
+  const std::vector<db::DPoint> &line_starts () const
+  {
+    return m_linestarts;
+  }
+
   /**
    *  @brief Get font names
    *
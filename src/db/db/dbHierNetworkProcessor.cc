@@ -29,6 +29,7 @@
 #include "dbPolygonTools.h"
 #include "dbBoxScanner.h"
 #include "dbDeepRegion.h"
+#include "dbCellHullGenerator.h"
 #include "tlProgress.h"
 #include "tlLog.h"
 #include "tlTimer.h"
@@ -1022,12 +1023,34 @@ public:
   typedef db::simple_bbox_tag complexity;
   typedef typename hier_clusters<T>::box_type box_type;
 
-  cell_clusters_box_converter (const db::Layout &layout, const hier_clusters<T> &tree)
-    : mp_layout (&layout), mp_tree (&tree)
+  cell_clusters_box_converter (const db::Layout &layout, const hier_clusters<T> &tree, const db::Connectivity &conn)
+    : mp_layout (&layout), mp_tree (&tree), m_occupancy (layout), m_layers (conn.begin_layers (), conn.end_layers ())
   {
     //  .. nothing yet ..
   }
 
+  /**
+   *  @brief Returns true if the cell may have shapes on any of the connected layers inside the given box
+   *
+   *  The box is given in the coordinates of the parent and "trans" is the transformation of the cell
+   *  into the parent. The test is based on a coarse occupancy grid and is conservative: if
+   *  it returns false, the cell (including its children) does not have shapes inside the box.
+   */
+  bool may_interact (db::cell_index_type cell_index, const box_type &box, const db::ICplxTrans &trans) const
+  {
+    //  NOTE: complex transformations may round the box inwards
+    db::Coord e = (trans.is_mag () || ! trans.is_ortho ()) ? 1 : 0;
+    box_type b = box.transformed (trans.inverted ()).enlarged (db::Vector (e, e));
+
+    for (std::vector<unsigned int>::const_iterator l = m_layers.begin (); l != m_layers.end (); ++l) {
+      if (m_occupancy.touches (cell_index, *l, b)) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
   const box_type &operator() (const db::CellInst &cell_inst) const
   {
     return (*this) (cell_inst.cell_index ());
@@ -1060,6 +1083,8 @@ private:
   mutable std::map<db::cell_index_type, box_type> m_cache;
   const db::Layout *mp_layout;
   const hier_clusters<T> *mp_tree;
+  mutable db::CellOccupancyCache m_occupancy;
+  std::vector<unsigned int> m_layers;
 };
 
 // ------------------------------------------------------------------------------
@@ -1089,7 +1114,7 @@ void
 hier_clusters<T>::build (const db::Layout &layout, const db::Cell &cell, db::ShapeIterator::flags_type shape_flags, const db::Connectivity &conn, const tl::equivalence_clusters<unsigned int> *attr_equivalence)
 {
   clear ();
-  cell_clusters_box_converter<T> cbc (layout, *this);
+  cell_clusters_box_converter<T> cbc (layout, *this, conn);
   do_build (cbc, layout, cell, shape_flags, conn, attr_equivalence);
 }
 
@@ -1267,7 +1292,8 @@ private:
 
         box_type common12 = ib1 & ib2 & common;
 
-        if (! common12.empty ()) {
+        //  the occupancy test eliminates the candidates which are implied by overlapping bounding boxes only
+        if (! common12.empty () && mp_cbc->may_interact (i1.cell_index (), common12, tt1) && mp_cbc->may_interact (i2.cell_index (), common12, tt2)) {
 
           std::vector<ClusterInstElement> pp2;
           pp2.reserve (p2.size () + 1);
@@ -1288,7 +1314,7 @@ private:
 
       box_type common1 = ib1 & b2 & common;
 
-      if (! common1.empty ()) {
+      if (! common1.empty () && mp_cbc->may_interact (i1.cell_index (), common1, tt1)) {
 
         //  dive into cell of ii1
         const db::Cell &cell1 = mp_layout->cell (i1.cell_index ());
@@ -1480,7 +1506,7 @@ private:
       db::ICplxTrans tt2 = t2 * i2.complex_trans (*ii2);
       box_type ib2 = bb2.transformed (tt2);
 
-      if (b1.touches (ib2) && c1.interacts (cell2, tt2, *mp_conn)) {
+      if (b1.touches (ib2) && mp_cbc->may_interact (i2.cell_index (), b1 & ib2, tt2) && c1.interacts (cell2, tt2, *mp_conn)) {
 
         pp2.back () = ClusterInstElement (i2.cell_index (), i2.complex_trans (*ii2), i2.prop_id ());
         add_single_pair (c1, i2.cell_index (), pp2, tt2);
@@ -804,7 +804,7 @@ private:
 };
 
 static bool
-instances_interact (const db::Layout *layout1, const db::CellInstArray *inst1, unsigned int layer1, const db::Layout *layout2, const db::CellInstArray *inst2, unsigned int layer2, db::Coord dist)
+instances_interact (const db::Layout *layout1, const db::CellInstArray *inst1, unsigned int layer1, db::CellOccupancyCache *occ1, const db::Layout *layout2, const db::CellInstArray *inst2, unsigned int layer2, db::CellOccupancyCache *occ2, db::Coord dist)
 {
   //  TODO: this algorithm is not in particular effective for identical arrays
 
@@ -847,6 +847,13 @@ instances_interact (const db::Layout *layout1, const db::CellInstArray *inst1, u
 
           db::ICplxTrans tni2 = tn2.inverted ();
 
+          //  a quick check on the coarse occupancy grids first: this eliminates candidates
+          //  which are implied by overlapping bounding boxes only
+          if ((occ1 && ! occ1->touches (cell1.cell_index (), layer1, tni1 * cbox)) ||
+              (occ2 && ! occ2->touches (cell2.cell_index (), layer2, tni2 * cbox))) {
+            continue;
+          }
+
           //  not very strong, but already useful: the cells interact if there is a layer1 in cell1
           //  in the common box and a layer2 in the cell2 in the common box
           if (! db::RecursiveShapeIterator (*layout1, cell1, layer1, tni1 * cbox, true).at_end () &&
@@ -872,8 +879,8 @@ struct interaction_registration_inst2inst
 public:
   typedef std::pair<std::unordered_set<const db::CellInstArray *>, std::unordered_set<T> > interaction_value_type;
 
-  interaction_registration_inst2inst (const db::Layout *subject_layout, unsigned int subject_layer, const db::Layout *intruder_layout, unsigned int intruder_layer, db::Coord dist, std::unordered_map<const db::CellInstArray *, interaction_value_type> *result)
-    : mp_subject_layout (subject_layout), mp_intruder_layout (intruder_layout), m_subject_layer (subject_layer), m_intruder_layer (intruder_layer), m_dist (dist), mp_result (result)
+  interaction_registration_inst2inst (const db::Layout *subject_layout, unsigned int subject_layer, db::CellOccupancyCache *subject_occupancy, const db::Layout *intruder_layout, unsigned int intruder_layer, db::CellOccupancyCache *intruder_occupancy, db::Coord dist, std::unordered_map<const db::CellInstArray *, interaction_value_type> *result)
+    : mp_subject_layout (subject_layout), mp_intruder_layout (intruder_layout), m_subject_layer (subject_layer), m_intruder_layer (intruder_layer), mp_subject_occupancy (subject_occupancy), mp_intruder_occupancy (intruder_occupancy), m_dist (dist), mp_result (result)
   {
     //  nothing yet ..
   }
@@ -894,7 +901,7 @@ public:
         }
       }
 
-      if (! ignore && instances_interact (mp_subject_layout, inst1, m_subject_layer, mp_intruder_layout, inst2, m_intruder_layer, m_dist)) {
+      if (! ignore && instances_interact (mp_subject_layout, inst1, m_subject_layer, mp_subject_occupancy, mp_intruder_layout, inst2, m_intruder_layer, mp_intruder_occupancy, m_dist)) {
         (*mp_result) [inst1].first.insert (inst2);
       }
 
@@ -904,6 +911,7 @@ public:
 private:
   const db::Layout *mp_subject_layout, *mp_intruder_layout;
   unsigned int m_subject_layer, m_intruder_layer;
+  db::CellOccupancyCache *mp_subject_occupancy, *mp_intruder_occupancy;
   db::Coord m_dist;
   std::unordered_map<const db::CellInstArray *, std::pair<std::unordered_set<const db::CellInstArray *>, std::unordered_set<T> > > *mp_result;
   std::unordered_set<std::pair<unsigned int, unsigned int> > m_interactions;
@@ -911,7 +919,7 @@ private:
 
 template <class T>
 static bool
-instance_shape_interacts (const db::Layout *layout, const db::CellInstArray *inst, unsigned int layer, const T &ref, db::Coord dist)
+instance_shape_interacts (const db::Layout *layout, const db::CellInstArray *inst, unsigned int layer, db::CellOccupancyCache *occ, const T &ref, db::Coord dist)
 {
   const db::Cell &cell = layout->cell (inst->object ().cell_index ());
   db::box_convert <db::CellInst, true> inst_bc (*layout, layer);
@@ -926,6 +934,11 @@ instance_shape_interacts (const db::Layout *layout, const db::CellInstArray *ins
 
       db::ICplxTrans tni = tn.inverted ();
 
+      //  quick check on the coarse occupancy grid first
+      if (occ && ! occ->touches (cell.cell_index (), layer, tni * cbox)) {
+        continue;
+      }
+
       //  not very strong, but already useful: the cells interact if there is a layer in cell
       //  in the common box
       if (! db::RecursiveShapeIterator (*layout, cell, layer, tni * cbox, true).at_end ()) {
@@ -944,15 +957,15 @@ struct interaction_registration_inst2shape
   : db::box_scanner_receiver2<db::CellInstArray, unsigned int, T, unsigned int>
 {
 public:
-  interaction_registration_inst2shape (const db::Layout *subject_layout, unsigned int subject_layer, db::Coord dist, std::unordered_map<const db::CellInstArray *, std::pair<std::unordered_set<const db::CellInstArray *>, std::unordered_set<T> > > *result)
-    : mp_subject_layout (subject_layout), m_subject_layer (subject_layer), m_dist (dist), mp_result (result)
+  interaction_registration_inst2shape (const db::Layout *subject_layout, unsigned int subject_layer, db::CellOccupancyCache *subject_occupancy, db::Coord dist, std::unordered_map<const db::CellInstArray *, std::pair<std::unordered_set<const db::CellInstArray *>, std::unordered_set<T> > > *result)
+    : mp_subject_layout (subject_layout), m_subject_layer (subject_layer), mp_subject_occupancy (subject_occupancy), m_dist (dist), mp_result (result)
   {
     //  nothing yet ..
   }
 
   void add (const db::CellInstArray *inst, unsigned int, const T *ref, unsigned int)
   {
-    if (instance_shape_interacts (mp_subject_layout, inst, m_subject_layer, *ref, m_dist)) {
+    if (instance_shape_interacts (mp_subject_layout, inst, m_subject_layer, mp_subject_occupancy, *ref, m_dist)) {
       (*mp_result) [inst].second.insert (*ref);
     }
   }
@@ -960,6 +973,7 @@ public:
 private:
   const db::Layout *mp_subject_layout;
   unsigned int m_subject_layer;
+  db::CellOccupancyCache *mp_subject_occupancy;
   db::Coord m_dist;
   std::unordered_map<const db::CellInstArray *, std::pair<std::unordered_set<const db::CellInstArray *>, std::unordered_set<T> > > *mp_result;
 };
@@ -1100,6 +1114,15 @@ void local_processor<TS, TI, TR>::compute_contexts (local_processor_contexts<TS,
       mp_cc_job.reset (0);
     }
 
+    //  the occupancy grids are valid as long as the layouts are not modified - i.e. during the
+    //  context computation
+    mp_subject_occupancy.reset (new db::CellOccupancyCache (*mp_subject_layout));
+    if (mp_intruder_layout != mp_subject_layout) {
+      mp_intruder_occupancy.reset (new db::CellOccupancyCache (*mp_intruder_layout));
+    } else {
+      mp_intruder_occupancy.reset (0);
+    }
+
     contexts.clear ();
     contexts.set_intruder_layer (intruder_layer);
     contexts.set_subject_layer (subject_layer);
@@ -1112,12 +1135,24 @@ void local_processor<TS, TI, TR>::compute_contexts (local_processor_contexts<TS,
       mp_cc_job->wait ();
     }
 
+    mp_subject_occupancy.reset (0);
+    mp_intruder_occupancy.reset (0);
+
   } catch (...) {
     mp_cc_job.reset (0);
+    mp_subject_occupancy.reset (0);
+    mp_intruder_occupancy.reset (0);
     throw;
   }
 }
 
+template <class TS, class TI, class TR>
+db::CellOccupancyCache *local_processor<TS, TI, TR>::intruder_occupancy () const
+{
+  //  subject and intruder layouts share the cache if they are identical
+  return mp_intruder_occupancy.get () ? mp_intruder_occupancy.get () : mp_subject_occupancy.get ();
+}
+
 template <class TS, class TI, class TR>
 void local_processor<TS, TI, TR>::issue_compute_contexts (local_processor_contexts<TS, TI, TR> &contexts,
                                                  db::local_processor_cell_context<TS, TI, TR> *parent_context,
@@ -1228,7 +1263,7 @@ void local_processor<TS, TI, TR>::compute_contexts (local_processor_contexts<TS,
 //  TODO: can we shortcut this if interactions is empty?
     {
       db::box_scanner2<db::CellInstArray, int, db::CellInstArray, int> scanner;
-      interaction_registration_inst2inst<TI> rec (mp_subject_layout, contexts.subject_layer (), mp_intruder_layout, contexts.intruder_layer (), dist, &interactions);
+      interaction_registration_inst2inst<TI> rec (mp_subject_layout, contexts.subject_layer (), mp_subject_occupancy.get (), mp_intruder_layout, contexts.intruder_layer (), intruder_occupancy (), dist, &interactions);
 
       unsigned int id = 0;
 
@@ -1277,7 +1312,7 @@ void local_processor<TS, TI, TR>::compute_contexts (local_processor_contexts<TS,
 //  TODO: can we shortcut this if interactions is empty?
     {
       db::box_scanner2<db::CellInstArray, int, TI, int> scanner;
-      interaction_registration_inst2shape<TI> rec (mp_subject_layout, contexts.subject_layer (), dist, &interactions);
+      interaction_registration_inst2shape<TI> rec (mp_subject_layout, contexts.subject_layer (), mp_subject_occupancy.get (), dist, &interactions);
 
       for (db::Cell::const_iterator i = subject_cell->begin (); !i.at_end (); ++i) {
         if (! inst_bcs (i->cell_inst ()).empty ()) {
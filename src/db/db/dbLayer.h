@@ -344,6 +344,29 @@ struct layer
     m_tree_dirty = false;
   }
 
+  /**
+   *  @brief Gets the fraction of unused slots left by erased shapes
+   *
+   *  This value is 0 for a layer without holes and approaches 1
+   *  for a heavily fragmented layer.
+   */
+  double fragmentation () const
+  {
+    return m_box_tree.fragmentation ();
+  }
+
+  /**
+   *  @brief Removes the holes left by erased shapes
+   *
+   *  After this operation, all iterators into this layer are invalid.
+   *  The box tree index is remapped, so a sorted layer stays sorted
+   *  (a sorted layer does not refer to erased shapes).
+   */
+  void compact ()
+  {
+    m_box_tree.compact ();
+  }
+
   /**
    *  @brief A "flat" query (see box_tree::flat_iterator for a description)
    */
@@ -0,0 +1,345 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2019 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+
+#include "dbMultiFileReader.h"
+#include "dbReader.h"
+#include "dbLayout.h"
+#include "dbLayoutUtils.h"
+#include "dbCellMapping.h"
+#include "dbLayerMapping.h"
+#include "tlThreadedWorkers.h"
+#include "tlStream.h"
+#include "tlProgress.h"
+
+
+namespace db
+{
+
+// ---------------------------------------------------------------
+//  The reader task, worker and job
+
+namespace
+{
+
+/**
+ *  @brief Holds the reader of one file until the proxies have been restored
+ */
+struct MultiFileReaderState
+{
+  MultiFileReaderState ()
+    : stream (0), reader (0), layer_map (0)
+  {
+    //  .. nothing yet ..
+  }
+
+  ~MultiFileReaderState ()
+  {
+    delete reader;
+    reader = 0;
+    delete stream;
+    stream = 0;
+  }
+
+  tl::InputStream *stream;
+  db::Reader *reader;
+  const db::LayerMap *layer_map;
+};
+
+class MultiFileReaderTask
+  : public tl::Task
+{
+public:
+  MultiFileReaderTask (const std::string &path, const db::LoadLayoutOptions &options, db::Layout *layout, MultiFileReaderState *state)
+    : m_path (path), mp_options (&options), mp_layout (layout), mp_state (state)
+  {
+    //  .. nothing yet ..
+  }
+
+  void perform ()
+  {
+    mp_state->stream = new tl::InputStream (m_path);
+    mp_state->reader = new db::Reader (*mp_state->stream);
+    //  library and PCell proxies must not be created outside the main thread
+    mp_state->reader->set_defer_proxy_recovery (true);
+    mp_state->layer_map = &mp_state->reader->read (*mp_layout, *mp_options);
+  }
+
+private:
+  std::string m_path;
+  const db::LoadLayoutOptions *mp_options;
+  db::Layout *mp_layout;
+  MultiFileReaderState *mp_state;
+};
+
+class MultiFileReaderJob;
+
+class MultiFileReaderWorker
+  : public tl::Worker
+{
+public:
+  MultiFileReaderWorker (MultiFileReaderJob *job)
+    : tl::Worker (), mp_job (job)
+  {
+    //  .. nothing yet ..
+  }
+
+  void perform_task (tl::Task *task);
+
+private:
+  MultiFileReaderJob *mp_job;
+};
+
+class MultiFileReaderJob
+  : public tl::JobBase
+{
+public:
+  MultiFileReaderJob (int nworkers)
+    : tl::JobBase (nworkers), m_files_read (0)
+  {
+    //  .. nothing yet ..
+  }
+
+  void next_progress ()
+  {
+    tl::MutexLocker locker (&m_mutex);
+    ++m_files_read;
+  }
+
+  void update_progress (tl::RelativeProgress &progress)
+  {
+    size_t p;
+    {
+      tl::MutexLocker locker (&m_mutex);
+      p = m_files_read;
+    }
+
+    progress.set (p, true /*force yield*/);
+  }
+
+  virtual tl::Worker *create_worker ()
+  {
+    return new MultiFileReaderWorker (this);
+  }
+
+private:
+  size_t m_files_read;
+  tl::Mutex m_mutex;
+};
+
+void
+MultiFileReaderWorker::perform_task (tl::Task *task)
+{
+  static_cast<MultiFileReaderTask *> (task)->perform ();
+  mp_job->next_progress ();
+}
+
+}
+
+// ---------------------------------------------------------------
+//  MultiFileReader implementation
+
+MultiFileReader::MultiFileReader ()
+  : m_threads (0)
+{
+  //  .. nothing yet ..
+}
+
+void
+MultiFileReader::add_file (const std::string &path, db::Layout *layout, const db::LoadLayoutOptions &options)
+{
+  m_files.push_back (FileSpec ());
+  m_files.back ().path = path;
+  m_files.back ().layout.reset (layout);
+  m_files.back ().options = options;
+}
+
+void
+MultiFileReader::clear ()
+{
+  m_files.clear ();
+}
+
+void
+MultiFileReader::read ()
+{
+  std::vector<db::Layout *> layouts;
+  for (std::vector<FileSpec>::iterator f = m_files.begin (); f != m_files.end (); ++f) {
+    if (! f->layout.get ()) {
+      throw tl::Exception (tl::to_string (tr ("No target layout given for file: ")) + f->path);
+    }
+    layouts.push_back (f->layout.get ());
+  }
+
+  read_into (layouts);
+}
+
+void
+MultiFileReader::read_into (const std::vector<db::Layout *> &layouts)
+{
+  tl_assert (layouts.size () == m_files.size ());
+
+  if (m_files.empty ()) {
+    return;
+  }
+
+  MultiFileReaderJob job (m_threads > 0 ? m_threads : int (m_files.size ()));
+
+  //  NOTE: the states are not copied after this point
+  std::vector<MultiFileReaderState> states (m_files.size ());
+
+  for (size_t i = 0; i < m_files.size (); ++i) {
+    job.schedule (new MultiFileReaderTask (m_files [i].path, m_files [i].options, layouts [i], &states [i]));
+  }
+
+  //  The readers' progress objects live in the worker threads. Hence the progress is
+  //  reported here by the number of files read.
+  tl::RelativeProgress progress (tl::to_string (tr ("Reading layout files")), m_files.size (), 1);
+
+  try {
+    job.start ();
+    while (job.is_running ()) {
+      //  This may throw an exception, if the cancel button has been pressed.
+      job.update_progress (progress);
+      job.wait (100);
+    }
+  } catch (...) {
+    job.terminate ();
+    throw;
+  }
+
+  if (job.has_error ()) {
+    throw db::ReaderException (tl::to_string (tr ("Errors occured during reading the layout files. First error message says:\n")) + job.error_messages ().front ());
+  }
+
+  for (size_t i = 0; i < m_files.size (); ++i) {
+    FileSpec &f = m_files [i];
+    states [i].reader->restore_deferred_proxies (*layouts [i]);
+    //  restoring the proxies may have added layers
+    f.layer_map = *states [i].layer_map;
+    f.format = states [i].reader->format ();
+  }
+}
+
+void
+MultiFileReader::read_merged (db::Layout &layout, CellConflictResolution ccr)
+{
+  if (m_files.empty ()) {
+    return;
+  }
+
+  //  If the target layout is empty, the first file is read into it directly. The
+  //  other files are read into temporary layouts and merged afterwards.
+  bool first_direct = (layout.cells () == 0);
+
+  std::vector<db::Layout *> layouts;
+  std::vector<db::Layout *> temp_layouts;
+
+  try {
+
+    for (size_t i = 0; i < m_files.size (); ++i) {
+      if (i == 0 && first_direct) {
+        layouts.push_back (&layout);
+      } else {
+        temp_layouts.push_back (new db::Layout (false));
+        layouts.push_back (temp_layouts.back ());
+      }
+    }
+
+    read_into (layouts);
+
+    tl::RelativeProgress progress (tl::to_string (tr ("Merge layouts")), temp_layouts.size (), 1);
+
+    for (std::vector<db::Layout *>::iterator l = temp_layouts.begin (); l != temp_layouts.end (); ++l) {
+      ++progress;
+      merge_into (layout, **l, ccr);
+      delete *l;
+      *l = 0;
+    }
+
+  } catch (...) {
+    for (std::vector<db::Layout *>::const_iterator l = temp_layouts.begin (); l != temp_layouts.end (); ++l) {
+      delete *l;
+    }
+    throw;
+  }
+}
+
+void
+MultiFileReader::merge_into (db::Layout &target, const db::Layout &source, CellConflictResolution ccr)
+{
+  if (target.cells () == 0) {
+    target.dbu (source.dbu ());
+  }
+
+  db::ICplxTrans trans (source.dbu () / target.dbu ());
+
+  db::LayerMapping lm;
+  lm.create_full (target, source);
+
+  //  cells to combine with existing ones are mapped, merge_layouts creates the others
+  db::CellMapping cm;
+  if (ccr == AddToCell) {
+    for (db::Layout::const_iterator c = source.begin (); c != source.end (); ++c) {
+      std::pair<bool, db::cell_index_type> tc = target.cell_by_name (source.cell_name (c->cell_index ()));
+      if (tc.first) {
+        cm.map (c->cell_index (), tc.second);
+      }
+    }
+  }
+
+  std::vector<db::cell_index_type> source_cells (source.begin_top_down (), source.end_top_cells ());
+  std::map<db::cell_index_type, db::cell_index_type> final_cell_mapping;
+  db::merge_layouts (target, source, trans, source_cells, cm.table (), lm.table (), &final_cell_mapping);
+
+  //  merge_layouts takes the instances of mapped cells as present already. Here the
+  //  instances are added to the cells, so these need to be copied too.
+  db::PropertyMapper pm (target, source);
+
+  for (std::map<db::cell_index_type, db::cell_index_type>::const_iterator m = final_cell_mapping.begin (); m != final_cell_mapping.end (); ++m) {
+
+    const db::Cell &source_cell = source.cell (m->first);
+    db::Cell &target_cell = target.cell (m->second);
+
+    for (db::Cell::const_iterator inst = source_cell.begin (); ! inst.at_end (); ++inst) {
+
+      if (! cm.has_mapping (inst->cell_index ())) {
+        continue;
+      }
+
+      db::CellInstArray new_inst_array (inst->cell_inst ());
+      new_inst_array.transform_into (trans, 0 /*no array repository*/);
+      new_inst_array.object ().cell_index (cm.cell_mapping (inst->cell_index ()));
+
+      if (inst->has_prop_id ()) {
+        target_cell.insert (db::object_with_properties<db::CellInstArray> (new_inst_array, pm (inst->prop_id ())));
+      } else {
+        target_cell.insert (new_inst_array);
+      }
+
+    }
+
+  }
+}
+
+}
+
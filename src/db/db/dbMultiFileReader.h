@@ -0,0 +1,201 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2019 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+
+
+#ifndef HDR_dbMultiFileReader
+#define HDR_dbMultiFileReader
+
+#include "dbCommon.h"
+#include "dbLoadLayoutOptions.h"
+#include "dbStreamLayers.h"
+#include "dbLayout.h"
+
+#include "tlObject.h"
+
+#include <vector>
+#include <string>
+
+namespace db
+{
+
+/**
+ *  @brief A reader for multiple layout files
+ *
+ *  This object reads a set of layout files concurrently. Each file is read
+ *  by a reader of its own in a separate thread. Hence the time required is
+ *  determined by the largest file rather than by the sum of all files.
+ *
+ *  The files can be read into separate layouts or merged into a single one.
+ *
+ *  Usage is:
+ *
+ *  @code
+ *  db::MultiFileReader reader;
+ *  reader.add_file ("a.gds", &layout_a);
+ *  reader.add_file ("b.oas", &layout_b, options);
+ *  reader.read ();
+ *  @endcode
+ *
+ *  The layouts must not be used otherwise while the files are read.
+ *  Library and PCell proxies are restored on the calling thread after all
+ *  files have been read.
+ */
+class DB_PUBLIC MultiFileReader
+{
+public:
+  /**
+   *  @brief Specifies how to treat cells with the same name when merging files
+   */
+  enum CellConflictResolution
+  {
+    /**
+     *  @brief Cells with the same name are combined into one cell
+     */
+    AddToCell = 0,
+
+    /**
+     *  @brief Cells with names already present in the layout are renamed
+     */
+    RenameCell = 1
+  };
+
+  /**
+   *  @brief Constructor
+   */
+  MultiFileReader ();
+
+  /**
+   *  @brief Adds a file to read into the given layout
+   *
+   *  The path is a stream path as accepted by tl::InputStream. The options
+   *  are used for reading this file. The layout is the target for \read.
+   */
+  void add_file (const std::string &path, db::Layout *layout, const db::LoadLayoutOptions &options = db::LoadLayoutOptions ());
+
+  /**
+   *  @brief Adds a file to read without a target layout
+   *
+   *  Files without a target layout can only be read with \read_merged.
+   */
+  void add_file (const std::string &path, const db::LoadLayoutOptions &options = db::LoadLayoutOptions ())
+  {
+    add_file (path, 0, options);
+  }
+
+  /**
+   *  @brief Gets the number of files registered
+   */
+  size_t files () const
+  {
+    return m_files.size ();
+  }
+
+  /**
+   *  @brief Gets the path of the nth file
+   */
+  const std::string &path (size_t n) const
+  {
+    return m_files [n].path;
+  }
+
+  /**
+   *  @brief Removes all files
+   */
+  void clear ();
+
+  /**
+   *  @brief Sets the number of threads to use
+   *
+   *  The default is 0 which means to use one thread per file.
+   */
+  void set_threads (int n)
+  {
+    m_threads = n;
+  }
+
+  /**
+   *  @brief Gets the number of threads
+   */
+  int threads () const
+  {
+    return m_threads;
+  }
+
+  /**
+   *  @brief Reads the files into their layouts
+   *
+   *  Each file is read into the layout given in \add_file.
+   *  If one of the readers fails, an exception is thrown after all readers have finished.
+   */
+  void read ();
+
+  /**
+   *  @brief Reads the files into a single layout
+   *
+   *  The files are read concurrently and combined into the given layout in
+   *  the order they have been added. The layout may contain cells already.
+   *  Layers are identified by their layer properties.
+   *  If the database units differ, the files are scaled to the database unit
+   *  of the layout. If the layout is empty, it will take the database unit
+   *  of the first file.
+   *  "ccr" specifies how cells with the same name are treated.
+   */
+  void read_merged (db::Layout &layout, CellConflictResolution ccr = AddToCell);
+
+  /**
+   *  @brief Gets the layer map delivered by the reader of the nth file
+   */
+  const db::LayerMap &layer_map (size_t n) const
+  {
+    return m_files [n].layer_map;
+  }
+
+  /**
+   *  @brief Gets the format of the nth file
+   */
+  const std::string &format (size_t n) const
+  {
+    return m_files [n].format;
+  }
+
+private:
+  struct FileSpec
+  {
+    std::string path;
+    tl::weak_ptr<db::Layout> layout;
+    db::LoadLayoutOptions options;
+    db::LayerMap layer_map;
+    std::string format;
+  };
+
+  std::vector<FileSpec> m_files;
+  int m_threads;
+
+  void read_into (const std::vector<db::Layout *> &layouts);
+  void merge_into (db::Layout &target, const db::Layout &source, CellConflictResolution ccr);
+};
+
+}
+
+#endif
+
@@ -24,6 +24,8 @@
 #include "dbDeepShapeStore.h"
 #include "dbNetlistDeviceExtractor.h"
 
+#include "tlThreadedWorkers.h"
+
 namespace db
 {
 
@@ -33,18 +35,45 @@ NetlistExtractor::NetlistExtractor ()
   //  .. nothing yet ..
 }
 
-static void
-build_net_name_equivalence (const db::Layout *layout, db::property_names_id_type net_name_id, tl::equivalence_clusters<unsigned int> &eq)
+void
+NetlistExtractor::build_label_index (bool with_equivalence, tl::equivalence_clusters<unsigned int> &eq)
 {
+  //  A single pass over the properties repository delivers the label text per property ID
+  //  (the labels are the cluster attributes) and - if required - the label-based net name equivalence
+
+  m_labels_by_prop_id.clear ();
+
+  if (! m_text_annot_name_id.first) {
+    return;
+  }
+
+  db::property_names_id_type net_name_id = m_text_annot_name_id.second;
+
   std::map<std::string, std::set<unsigned int> > prop_by_name;
 
-  for (db::PropertiesRepository::iterator i = layout->properties_repository ().begin (); i != layout->properties_repository ().end (); ++i) {
+  for (db::PropertiesRepository::iterator i = mp_layout->properties_repository ().begin (); i != mp_layout->properties_repository ().end (); ++i) {
+
+    std::string labels;
+
     for (db::PropertiesRepository::properties_set::const_iterator p = i->second.begin (); p != i->second.end (); ++p) {
       if (p->first == net_name_id) {
         std::string nn = p->second.to_string ();
-        prop_by_name [nn].insert (i->first);
+        if (with_equivalence) {
+          prop_by_name [nn].insert (i->first);
+        }
+        if (! nn.empty ()) {
+          if (! labels.empty ()) {
+            labels += ",";
+          }
+          labels += nn;
+        }
       }
     }
+
+    if (! labels.empty ()) {
+      m_labels_by_prop_id.insert (std::make_pair (i->first, labels));
+    }
+
   }
 
   for (std::map<std::string, std::set<unsigned int> >::const_iterator pn = prop_by_name.begin (); pn != prop_by_name.end (); ++pn) {
@@ -57,6 +86,114 @@ build_net_name_equivalence (const db::Layout *layout, db::property_names_id_type
   }
 }
 
+namespace
+{
+
+/**
+ *  @brief A task collecting the labels for the clusters of one cell
+ */
+class LabelCollectorTask
+  : public tl::Task
+{
+public:
+  typedef NetlistExtractor::connected_clusters_type connected_clusters_type;
+  typedef NetlistExtractor::local_cluster_type local_cluster_type;
+  typedef std::map<db::properties_id_type, std::string> labels_by_prop_id_type;
+
+  LabelCollectorTask (const connected_clusters_type *clusters, const labels_by_prop_id_type *labels_by_prop_id, std::map<size_t, std::string> *labels_per_cluster)
+    : mp_clusters (clusters), mp_labels_by_prop_id (labels_by_prop_id), mp_labels_per_cluster (labels_per_cluster)
+  {
+    //  .. nothing yet ..
+  }
+
+  void perform ()
+  {
+    //  we know that the cluster attributes are property ID's because the
+    //  cluster processor converts shape property IDs to attributes
+
+    for (connected_clusters_type::const_iterator c = mp_clusters->begin (); c != mp_clusters->end (); ++c) {
+
+      std::string labels;
+
+      for (local_cluster_type::attr_iterator a = c->begin_attr (); a != c->end_attr (); ++a) {
+        labels_by_prop_id_type::const_iterator l = mp_labels_by_prop_id->find (*a);
+        if (l != mp_labels_by_prop_id->end ()) {
+          if (! labels.empty ()) {
+            labels += ",";
+          }
+          labels += l->second;
+        }
+      }
+
+      if (! labels.empty ()) {
+        mp_labels_per_cluster->insert (std::make_pair (c->id (), labels));
+      }
+
+    }
+  }
+
+private:
+  const connected_clusters_type *mp_clusters;
+  const labels_by_prop_id_type *mp_labels_by_prop_id;
+  std::map<size_t, std::string> *mp_labels_per_cluster;
+};
+
+class LabelCollectorWorker
+  : public tl::Worker
+{
+public:
+  LabelCollectorWorker ()
+    : tl::Worker ()
+  {
+    //  .. nothing yet ..
+  }
+
+  void perform_task (tl::Task *task)
+  {
+    static_cast<LabelCollectorTask *> (task)->perform ();
+  }
+};
+
+}
+
+void
+NetlistExtractor::collect_labels (int threads)
+{
+  m_labels_per_cluster_per_cell.clear ();
+
+  if (m_labels_by_prop_id.empty ()) {
+    return;
+  }
+
+  std::vector<LabelCollectorTask *> tasks;
+
+  for (db::Layout::bottom_up_const_iterator cid = mp_layout->begin_bottom_up (); cid != mp_layout->end_bottom_up (); ++cid) {
+    const connected_clusters_type &clusters = mp_clusters->clusters_per_cell (*cid);
+    if (! clusters.empty ()) {
+      tasks.push_back (new LabelCollectorTask (&clusters, &m_labels_by_prop_id, &m_labels_per_cluster_per_cell [*cid]));
+    }
+  }
+
+  if (threads > 0 && tasks.size () > 1) {
+
+    //  NOTE: the tasks only read the clusters and the label table and write into their own result map
+    tl::Job<LabelCollectorWorker> job (threads);
+    for (std::vector<LabelCollectorTask *>::const_iterator t = tasks.begin (); t != tasks.end (); ++t) {
+      job.schedule (*t);
+    }
+    job.start ();
+    job.wait ();
+
+  } else {
+
+    for (std::vector<LabelCollectorTask *>::const_iterator t = tasks.begin (); t != tasks.end (); ++t) {
+      (*t)->perform ();
+      delete *t;
+    }
+
+  }
+}
+
 void
 NetlistExtractor::extract_nets (const db::DeepShapeStore &dss, unsigned int layout_index, const db::Connectivity &conn, db::Netlist &nl, hier_clusters_type &clusters, bool join_nets_by_label)
 {
@@ -77,11 +214,12 @@ NetlistExtractor::extract_nets (const db::DeepShapeStore &dss, unsigned int layo
   //  the big part: actually extract the nets
 
   tl::equivalence_clusters<unsigned int> net_name_equivalence;
-  if (m_text_annot_name_id.first && join_nets_by_label) {
-    build_net_name_equivalence (mp_layout, m_text_annot_name_id.second, net_name_equivalence);
-  }
+  build_label_index (join_nets_by_label, net_name_equivalence);
   mp_clusters->build (*mp_layout, *mp_cell, db::ShapeIterator::Polygons, conn, &net_name_equivalence);
 
+  //  resolve the labels per cluster (this can be done in parallel as the clusters are final now)
+  collect_labels (dss.threads ());
+
   //  reverse lookup for Circuit vs. cell index
   std::map<db::cell_index_type, db::Circuit *> circuits;
 
@@ -123,6 +261,12 @@ NetlistExtractor::extract_nets (const db::DeepShapeStore &dss, unsigned int layo
 
     std::map<size_t, size_t> &c2p = pins_per_cluster_per_cell [*cid];
 
+    const std::map<size_t, std::string> *labels_per_cluster = 0;
+    std::map<db::cell_index_type, std::map<size_t, std::string> >::const_iterator lpc = m_labels_per_cluster_per_cell.find (*cid);
+    if (lpc != m_labels_per_cluster_per_cell.end ()) {
+      labels_per_cluster = &lpc->second;
+    }
+
     std::map<std::pair<db::cell_index_type, db::ICplxTrans>, db::SubCircuit *> subcircuits;
 
     for (connected_clusters_type::all_iterator c = clusters.begin_all (); ! c.at_end (); ++c) {
@@ -142,8 +286,13 @@ NetlistExtractor::extract_nets (const db::DeepShapeStore &dss, unsigned int layo
       //  connect devices
       connect_devices (circuit, clusters, *c, net);
 
-      //  collect labels to net names
-      collect_labels (clusters, *c, net);
+      //  attach the labels as net names
+      if (labels_per_cluster) {
+        std::map<size_t, std::string>::const_iterator l = labels_per_cluster->find (*c);
+        if (l != labels_per_cluster->end ()) {
+          assign_net_name (l->second, net);
+        }
+      }
 
       if (! clusters.is_root (*c)) {
         //  a non-root cluster makes a pin
@@ -154,6 +303,9 @@ NetlistExtractor::extract_nets (const db::DeepShapeStore &dss, unsigned int layo
     }
 
   }
+
+  m_labels_per_cluster_per_cell.clear ();
+  m_labels_by_prop_id.clear ();
 }
 
 void
@@ -181,28 +333,6 @@ NetlistExtractor::make_device_abstract_connections (db::DeviceAbstract *dm, cons
   }
 }
 
-void NetlistExtractor::collect_labels (const connected_clusters_type &clusters,
-                                       size_t cid,
-                                       db::Net *net)
-{
-  //  collect the properties - we know that the cluster attributes are property ID's because the
-  //  cluster processor converts shape property IDs to attributes
-
-  const local_cluster_type &lc = clusters.cluster_by_id (cid);
-  for (local_cluster_type::attr_iterator a = lc.begin_attr (); a != lc.end_attr (); ++a) {
-
-    const db::PropertiesRepository::properties_set &ps = mp_layout->properties_repository ().properties (*a);
-    for (db::PropertiesRepository::properties_set::const_iterator j = ps.begin (); j != ps.end (); ++j) {
-
-      if (m_text_annot_name_id.first && j->first == m_text_annot_name_id.second) {
-        assign_net_name (j->second.to_string (), net);
-      }
-
-    }
-
-  }
-}
-
 bool NetlistExtractor::instance_is_device (db::properties_id_type prop_id) const
 {
   if (! prop_id || ! m_device_annot_name_id.first) {
@@ -91,6 +91,8 @@ private:
   std::pair<bool, db::property_names_id_type> m_text_annot_name_id;
   std::pair<bool, db::property_names_id_type> m_device_annot_name_id;
   std::pair<bool, db::property_names_id_type> m_terminal_annot_name_id;
+  std::map<db::properties_id_type, std::string> m_labels_by_prop_id;
+  std::map<db::cell_index_type, std::map<size_t, std::string> > m_labels_per_cluster_per_cell;
 
   void assign_net_name (const std::string &n, db::Net *net);
   bool instance_is_device (db::properties_id_type prop_id) const;
@@ -143,15 +145,23 @@ private:
                         db::Net *net);
 
   /**
-   *  @brief Attaches net names from text properties
+   *  @brief Builds the label table
    *
    *  Texts (labels) are represented by special shapes. The texts are kept as properties.
-   *  This method will collect all these labels and attach them to the nets as (alternative)
-   *  names.
+   *  This method builds a lookup table for the label string per property ID. If "with_equivalence"
+   *  is true, it will also fill "eq" with the equivalences of property IDs carrying the same
+   *  label. This is used for joining nets by label.
    */
-  void collect_labels (const connected_clusters_type &clusters,
-                       size_t cid,
-                       db::Net *net);
+  void build_label_index (bool with_equivalence, tl::equivalence_clusters<unsigned int> &eq);
+
+  /**
+   *  @brief Collects the labels per cluster and cell
+   *
+   *  This method resolves the attributes of the clusters into the label strings to
+   *  attach as net names. The cells are processed in parallel with the given number
+   *  of threads. A thread count of 0 means synchronous operation.
+   */
+  void collect_labels (int threads);
 
   /**
    *  @brief Makes the terminal to cluster ID connections of the device abstract
@@ -25,6 +25,9 @@
 #include "dbNetlistDeviceClasses.h"
 
 #include "tlStream.h"
+#include "tlThreadedWorkers.h"
+#include "tlInternational.h"
+#include "tlException.h"
 
 #include <sstream>
 
@@ -93,7 +96,11 @@ void NetlistSpiceWriterDelegate::write_device (const db::Device &dev) const
   const db::DeviceClassMOS3Transistor *mos3 = dynamic_cast<const db::DeviceClassMOS3Transistor *> (dc);
   const db::DeviceClassMOS4Transistor *mos4 = dynamic_cast<const db::DeviceClassMOS4Transistor *> (dc);
 
+  //  NOTE: formatting the numbers directly with the "C" locale and 12 digits gives the same
+  //  result than "%.12g" with tl::sprintf, but is much faster
   std::ostringstream os;
+  os.imbue (std::locale::classic ());
+  os.precision (12);
 
   if (cap) {
 
@@ -101,7 +108,7 @@ void NetlistSpiceWriterDelegate::write_device (const db::Device &dev) const
     os << format_name (dev.expanded_name ());
     os << format_terminals (dev);
     os << " ";
-    os << tl::sprintf ("%.12g", dev.parameter_value (db::DeviceClassCapacitor::param_id_C));
+    os << dev.parameter_value (db::DeviceClassCapacitor::param_id_C);
 
   } else if (ind) {
 
@@ -109,7 +116,7 @@ void NetlistSpiceWriterDelegate::write_device (const db::Device &dev) const
     os << format_name (dev.expanded_name ());
     os << format_terminals (dev);
     os << " ";
-    os << tl::sprintf ("%.12g", dev.parameter_value (db::DeviceClassInductor::param_id_L));
+    os << dev.parameter_value (db::DeviceClassInductor::param_id_L);
 
   } else if (res) {
 
@@ -117,7 +124,7 @@ void NetlistSpiceWriterDelegate::write_device (const db::Device &dev) const
     os << format_name (dev.expanded_name ());
     os << format_terminals (dev);
     os << " ";
-    os << tl::sprintf ("%.12g", dev.parameter_value (db::DeviceClassResistor::param_id_R));
+    os << dev.parameter_value (db::DeviceClassResistor::param_id_R);
 
   } else if (diode) {
 
@@ -145,12 +152,12 @@ void NetlistSpiceWriterDelegate::write_device (const db::Device &dev) const
     os << " M";
     os << format_name (dev.device_class ()->name ());
 
-    os << " L=" << tl::sprintf ("%.12gU", dev.parameter_value (db::DeviceClassMOS3Transistor::param_id_L));
-    os << " W=" << tl::sprintf ("%.12gU", dev.parameter_value (db::DeviceClassMOS3Transistor::param_id_W));
-    os << " AS=" << tl::sprintf ("%.12gP", dev.parameter_value (db::DeviceClassMOS3Transistor::param_id_AS));
-    os << " AD=" << tl::sprintf ("%.12gP", dev.parameter_value (db::DeviceClassMOS3Transistor::param_id_AD));
-    os << " PS=" << tl::sprintf ("%.12gU", dev.parameter_value (db::DeviceClassMOS3Transistor::param_id_PS));
-    os << " PD=" << tl::sprintf ("%.12gU", dev.parameter_value (db::DeviceClassMOS3Transistor::param_id_PD));
+    os << " L=" << dev.parameter_value (db::DeviceClassMOS3Transistor::param_id_L) << "U";
+    os << " W=" << dev.parameter_value (db::DeviceClassMOS3Transistor::param_id_W) << "U";
+    os << " AS=" << dev.parameter_value (db::DeviceClassMOS3Transistor::param_id_AS) << "P";
+    os << " AD=" << dev.parameter_value (db::DeviceClassMOS3Transistor::param_id_AD) << "P";
+    os << " PS=" << dev.parameter_value (db::DeviceClassMOS3Transistor::param_id_PS) << "U";
+    os << " PD=" << dev.parameter_value (db::DeviceClassMOS3Transistor::param_id_PD) << "U";
 
   } else {
 
@@ -193,12 +200,17 @@ std::string NetlistSpiceWriterDelegate::format_params (const db::Device &dev) co
 
 // --------------------------------------------------------------------------------
 
-NetlistSpiceWriter::NetlistSpiceWriter (NetlistSpiceWriterDelegate *delegate)
-  : mp_netlist (0), mp_stream (0), mp_delegate (delegate)
+static NetlistSpiceWriterDelegate *std_delegate ()
 {
   static NetlistSpiceWriterDelegate std_delegate;
+  return &std_delegate;
+}
+
+NetlistSpiceWriter::NetlistSpiceWriter (NetlistSpiceWriterDelegate *delegate)
+  : mp_netlist (0), mp_stream (0), mp_delegate (delegate), m_threads (0)
+{
   if (! delegate) {
-    mp_delegate.reset (&std_delegate);
+    mp_delegate.reset (std_delegate ());
   }
 }
 
@@ -315,38 +327,158 @@ void NetlistSpiceWriter::do_write (const std::string &description)
     mp_delegate->write_device_intro (*dc);
   }
 
+  std::vector<const db::Circuit *> circuits;
   for (db::Netlist::const_top_down_circuit_iterator c = mp_netlist->begin_top_down (); c != mp_netlist->end_top_down (); ++c) {
+    circuits.push_back (*c);
+  }
 
-    const db::Circuit &circuit = **c;
-
-    //  assign internal node numbers to the nets
-    m_net_to_spice_id.clear ();
-    size_t nid = 0;
-    for (db::Circuit::const_net_iterator n = circuit.begin_nets (); n != circuit.end_nets (); ++n) {
-      m_net_to_spice_id.insert (std::make_pair (n.operator-> (), ++nid));
+  //  NOTE: custom delegates may be implemented in scripts, hence the circuits are formatted
+  //  in parallel only with the standard delegate
+  if (m_threads > 0 && circuits.size () > 1 && mp_delegate.get () == std_delegate ()) {
+    write_circuits_parallel (circuits);
+  } else {
+    for (std::vector<const db::Circuit *>::const_iterator c = circuits.begin (); c != circuits.end (); ++c) {
+      write_circuit (**c);
     }
+  }
+}
+
+/**
+ *  @brief A task formatting one circuit into a memory buffer
+ */
+class NetlistSpiceWriterCircuitTask
+  : public tl::Task
+{
+public:
+  NetlistSpiceWriterCircuitTask (const db::Circuit *circuit, tl::OutputMemoryStream *buffer)
+    : mp_circuit (circuit), mp_buffer (buffer)
+  {
+    //  .. nothing yet ..
+  }
 
-    write_circuit_header (circuit);
+  void perform ()
+  {
+    //  each task employs a private writer and delegate, so no state is shared between the tasks
+    NetlistSpiceWriterDelegate delegate;
+    NetlistSpiceWriter writer (&delegate);
 
-    for (db::Circuit::const_subcircuit_iterator i = circuit.begin_subcircuits (); i != circuit.end_subcircuits (); ++i) {
-      write_subcircuit_call (*i);
+    tl::OutputStream os (*mp_buffer);
+
+    writer.mp_stream = &os;
+    delegate.attach_writer (&writer);
+
+    try {
+      writer.write_circuit (*mp_circuit);
+    } catch (...) {
+      delegate.attach_writer (0);
+      writer.mp_stream = 0;
+      throw;
     }
 
-    for (db::Circuit::const_device_iterator i = circuit.begin_devices (); i != circuit.end_devices (); ++i) {
+    delegate.attach_writer (0);
+    writer.mp_stream = 0;
+
+    os.flush ();
+  }
+
+private:
+  const db::Circuit *mp_circuit;
+  tl::OutputMemoryStream *mp_buffer;
+};
+
+class NetlistSpiceWriterCircuitWorker
+  : public tl::Worker
+{
+public:
+  NetlistSpiceWriterCircuitWorker ()
+    : tl::Worker ()
+  {
+    //  .. nothing yet ..
+  }
+
+  void perform_task (tl::Task *task)
+  {
+    static_cast<NetlistSpiceWriterCircuitTask *> (task)->perform ();
+  }
+};
+
+void NetlistSpiceWriter::write_circuits_parallel (const std::vector<const db::Circuit *> &circuits)
+{
+  //  The circuits are formatted in batches to limit the memory required for the buffers.
+  //  The buffers of each batch are written to the stream in the original order.
+  size_t batch_size = size_t (m_threads) * 4;
+
+  std::vector<const db::Circuit *>::const_iterator c = circuits.begin ();
+  while (c != circuits.end ()) {
 
-      //  TODO: make this configurable?
-      std::string comment = "device instance " + i->expanded_name () + " " + i->position ().to_string () + " " + i->device_class ()->name ();
-      emit_comment (comment);
+    std::vector<const db::Circuit *>::const_iterator cend = c + std::min (batch_size, size_t (circuits.end () - c));
 
-      mp_delegate->write_device (*i);
+    tl::Job<NetlistSpiceWriterCircuitWorker> job (m_threads);
 
+    std::vector<tl::OutputMemoryStream *> batch;
+
+    try {
+
+      for ( ; c != cend; ++c) {
+        batch.push_back (new tl::OutputMemoryStream ());
+        job.schedule (new NetlistSpiceWriterCircuitTask (*c, batch.back ()));
+      }
+
+      job.start ();
+      job.wait ();
+
+      if (job.has_error ()) {
+        throw tl::Exception (tl::to_string (tr ("Errors occured during writing the netlist. First error message says:\n")) + job.error_messages ().front ());
+      }
+
+      for (std::vector<tl::OutputMemoryStream *>::const_iterator b = batch.begin (); b != batch.end (); ++b) {
+        if ((*b)->size () > 0) {
+          mp_stream->put ((*b)->data (), (*b)->size ());
+        }
+      }
+
+    } catch (...) {
+      for (std::vector<tl::OutputMemoryStream *>::const_iterator b = batch.begin (); b != batch.end (); ++b) {
+        delete *b;
+      }
+      throw;
     }
 
-    write_circuit_end (circuit);
+    for (std::vector<tl::OutputMemoryStream *>::const_iterator b = batch.begin (); b != batch.end (); ++b) {
+      delete *b;
+    }
 
   }
 }
 
+void NetlistSpiceWriter::write_circuit (const db::Circuit &circuit)
+{
+  //  assign internal node numbers to the nets
+  m_net_to_spice_id.clear ();
+  size_t nid = 0;
+  for (db::Circuit::const_net_iterator n = circuit.begin_nets (); n != circuit.end_nets (); ++n) {
+    m_net_to_spice_id.insert (std::make_pair (n.operator-> (), ++nid));
+  }
+
+  write_circuit_header (circuit);
+
+  for (db::Circuit::const_subcircuit_iterator i = circuit.begin_subcircuits (); i != circuit.end_subcircuits (); ++i) {
+    write_subcircuit_call (*i);
+  }
+
+  for (db::Circuit::const_device_iterator i = circuit.begin_devices (); i != circuit.end_devices (); ++i) {
+
+    //  TODO: make this configurable?
+    std::string comment = "device instance " + i->expanded_name () + " " + i->position ().to_string () + " " + i->device_class ()->name ();
+    emit_comment (comment);
+
+    mp_delegate->write_device (*i);
+
+  }
+
+  write_circuit_end (circuit);
+}
+
 void NetlistSpiceWriter::write_subcircuit_call (const db::SubCircuit &subcircuit) const
 {
   //  TODO: make this configurable?
@@ -29,6 +29,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 
 namespace db
 {
@@ -39,6 +40,7 @@ class Net;
 class NetlistSpiceWriter;
 class Circuit;
 class SubCircuit;
+class NetlistSpiceWriterCircuitTask;
 
 /**
  *  @brief A device writer delegate for the SPICE writer
@@ -66,6 +68,7 @@ public:
 
 private:
   friend class NetlistSpiceWriter;
+  friend class NetlistSpiceWriterCircuitTask;
 
   NetlistSpiceWriter *mp_writer;
 
@@ -86,15 +89,39 @@ public:
 
   virtual void write (tl::OutputStream &stream, const db::Netlist &netlist, const std::string &description);
 
+  /**
+   *  @brief Sets the number of threads to use for formatting the circuits
+   *
+   *  With a thread count larger than 0, the circuits are formatted in parallel into
+   *  buffers which are written to the stream in the original order. This is only
+   *  done with the standard delegate. The default is 0 (formatting in the writer's thread).
+   */
+  void set_threads (int n)
+  {
+    m_threads = n;
+  }
+
+  /**
+   *  @brief Gets the number of threads to use for formatting the circuits
+   */
+  int threads () const
+  {
+    return m_threads;
+  }
+
 private:
   friend class NetlistSpiceWriterDelegate;
+  friend class NetlistSpiceWriterCircuitTask;
 
   const db::Netlist *mp_netlist;
   tl::OutputStream *mp_stream;
   tl::weak_ptr<NetlistSpiceWriterDelegate> mp_delegate;
   std::map<const db::Net *, size_t> m_net_to_spice_id;
+  int m_threads;
 
   void do_write (const std::string &description);
+  void write_circuits_parallel (const std::vector<const db::Circuit *> &circuits);
+  void write_circuit (const db::Circuit &circuit);
 
   std::string net_to_string (const db::Net *net) const;
   void emit_line (const std::string &line) const;
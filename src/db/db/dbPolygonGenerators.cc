@@ -23,6 +23,7 @@
 
 
 #include "dbPolygonGenerators.h"
+#include "dbPolygonTools.h"
 
 #include <vector>
 #include <deque>
@@ -1113,6 +1114,24 @@ TrapezoidGenerator::put (const db::Edge &e)
 void 
 SizingPolygonFilter::put (const db::Polygon &polygon)
 {
+  if (m_max_vertex_count > 0 && polygon.vertices () > m_max_vertex_count) {
+
+    std::vector<db::Polygon> slices;
+    if (db::size_polygon_sliced (polygon, m_dx, m_dy, m_mode, m_max_vertex_count, slices, m_threads)) {
+
+      //  stitch the slices
+      m_sizing_processor.clear ();
+      m_sizing_processor.insert_sequence (slices.begin (), slices.end ());
+
+      db::SimpleMerge op;
+      m_sizing_processor.process (*mp_output, op);
+
+      return;
+
+    }
+
+  }
+
   m_sizing_processor.clear ();
   m_sizing_processor.insert (polygon.sized (m_dx, m_dy, m_mode));
 
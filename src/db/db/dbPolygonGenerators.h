@@ -506,9 +506,31 @@ public:
    *  @brief Constructor 
    */
   SizingPolygonFilter (EdgeSink &output, Coord dx, Coord dy, unsigned int mode)
-    : PolygonSink (), mp_output (&output), m_dx (dx), m_dy (dy), m_mode (mode)
+    : PolygonSink (), mp_output (&output), m_dx (dx), m_dy (dy), m_mode (mode), m_max_vertex_count (0), m_threads (0)
   { }
 
+  /**
+   *  @brief Sets the vertex count above which polygons are sized in slices
+   *
+   *  Polygons with more vertices are sized tile by tile and the results are
+   *  stitched together (see db::size_polygon_sliced). A value of 0 (the default)
+   *  disables slicing.
+   */
+  void set_max_vertex_count (size_t n)
+  {
+    m_max_vertex_count = n;
+  }
+
+  /**
+   *  @brief Sets the number of threads to use for sized slices
+   *
+   *  A value of 0 (the default) means the slices are processed synchronously.
+   */
+  void set_threads (int n)
+  {
+    m_threads = n;
+  }
+
   /**
    *  @brief Implementation of the PolygonSink interface
    */
@@ -519,6 +541,8 @@ private:
   EdgeSink *mp_output;
   Coord m_dx, m_dy;
   unsigned int m_mode;
+  size_t m_max_vertex_count;
+  int m_threads;
 };
 
 }
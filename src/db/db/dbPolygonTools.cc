@@ -25,12 +25,15 @@
 
 #include "dbPolygonTools.h"
 #include "dbPolygonGenerators.h"
+#include "dbClip.h"
 #include "tlLog.h"
 #include "tlInt128Support.h"
+#include "tlThreadedWorkers.h"
 
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <list>
 
 namespace db
 {
@@ -696,6 +699,211 @@ template DB_PUBLIC void split_polygon<> (const db::SimplePolygon &polygon, std::
 template DB_PUBLIC void split_polygon<> (const db::DPolygon &polygon, std::vector<db::DPolygon> &output);
 template DB_PUBLIC void split_polygon<> (const db::DSimplePolygon &polygon, std::vector<db::DSimplePolygon> &output);
 
+// -------------------------------------------------------------------------
+//  Implementation of size_polygon_sliced
+
+namespace
+{
+
+/**
+ *  @brief A slice: a tile and the part of the polygon inside the tile's window
+ */
+struct SizingSlice
+{
+  db::Box tile;
+  std::vector<db::Polygon> content;
+};
+
+/**
+ *  @brief Sizes the content of a slice and delivers the part inside the tile
+ */
+void
+size_slice (const SizingSlice &slice, db::Coord dx, db::Coord dy, unsigned int mode, std::vector<db::Polygon> &output)
+{
+  db::EdgeProcessor ep;
+  for (std::vector<db::Polygon>::const_iterator p = slice.content.begin (); p != slice.content.end (); ++p) {
+    ep.insert (p->sized (dx, dy, mode));
+  }
+
+  //  merge the resulting polygons to get the true outer contour (see SizingPolygonFilter)
+  std::vector<db::Polygon> sized;
+  db::PolygonContainer pc (sized);
+  db::PolygonGenerator pg (pc, false /*don't resolve holes*/, false /*min. coherence*/);
+  db::SimpleMerge op (1 /*wc>0*/);
+  ep.process (pg, op);
+
+  for (std::vector<db::Polygon>::const_iterator p = sized.begin (); p != sized.end (); ++p) {
+    if (p->box ().inside (slice.tile)) {
+      output.push_back (*p);
+    } else {
+      db::clip_poly (*p, slice.tile, output, false /*don't resolve holes*/);
+    }
+  }
+}
+
+class SizingSliceTask
+  : public tl::Task
+{
+public:
+  SizingSliceTask (const SizingSlice *slice, db::Coord dx, db::Coord dy, unsigned int mode, std::vector<db::Polygon> *output)
+    : mp_slice (slice), m_dx (dx), m_dy (dy), m_mode (mode), mp_output (output)
+  {
+    //  .. nothing yet ..
+  }
+
+  void perform ()
+  {
+    size_slice (*mp_slice, m_dx, m_dy, m_mode, *mp_output);
+  }
+
+private:
+  const SizingSlice *mp_slice;
+  db::Coord m_dx, m_dy;
+  unsigned int m_mode;
+  std::vector<db::Polygon> *mp_output;
+};
+
+class SizingSliceWorker
+  : public tl::Worker
+{
+public:
+  SizingSliceWorker ()
+    : tl::Worker ()
+  {
+    //  .. nothing yet ..
+  }
+
+  void perform_task (tl::Task *task)
+  {
+    static_cast<SizingSliceTask *> (task)->perform ();
+  }
+};
+
+/**
+ *  @brief Splits the tile until the content of the tile's window is small enough
+ */
+void
+collect_slices (const db::Box &tile, std::vector<db::Polygon> &content, db::Coord margin, size_t max_vertex_count, std::list<SizingSlice> &slices)
+{
+  size_t n = 0;
+  for (std::vector<db::Polygon>::const_iterator p = content.begin (); p != content.end (); ++p) {
+    n += p->vertices ();
+  }
+
+  //  don't make the tiles smaller than the window margin - this would just increase the overhead
+  if (n <= max_vertex_count || std::max (tile.width (), tile.height ()) <= 4 * (unsigned int) margin) {
+    slices.push_back (SizingSlice ());
+    slices.back ().tile = tile;
+    slices.back ().content.swap (content);
+    return;
+  }
+
+  db::Box tiles [2];
+  if (tile.width () > tile.height ()) {
+    db::Coord x = tile.center ().x ();
+    tiles [0] = db::Box (tile.left (), tile.bottom (), x, tile.top ());
+    tiles [1] = db::Box (x, tile.bottom (), tile.right (), tile.top ());
+  } else {
+    db::Coord y = tile.center ().y ();
+    tiles [0] = db::Box (tile.left (), tile.bottom (), tile.right (), y);
+    tiles [1] = db::Box (tile.left (), y, tile.right (), tile.top ());
+  }
+
+  for (unsigned int i = 0; i < 2; ++i) {
+
+    db::Box window = tiles [i].enlarged (db::Vector (margin, margin));
+
+    std::vector<db::Polygon> sub_content;
+    for (std::vector<db::Polygon>::const_iterator p = content.begin (); p != content.end (); ++p) {
+      if (p->box ().inside (window)) {
+        sub_content.push_back (*p);
+      } else if (window.touches (p->box ())) {
+        db::clip_poly (*p, window, sub_content, false /*don't resolve holes*/);
+      }
+    }
+
+    collect_slices (tiles [i], sub_content, margin, max_vertex_count, slices);
+
+  }
+}
+
+}
+
+double
+sizing_reach (db::Coord dx, db::Coord dy, unsigned int mode)
+{
+  //  see polygon_contour<C>::size for the corner extension per mode
+  double ext = 100.0;
+  if (mode == 0) {
+    ext = 0.0;
+  } else if (mode == 1) {
+    ext = sqrt (2.0) - 1.0;
+  } else if (mode == 2) {
+    ext = 1.0;
+  } else if (mode == 3) {
+    ext = sqrt (2.0) + 1.0;
+  } else if (mode == 4) {
+    ext = 10.0;
+  }
+
+  return std::max (std::abs (double (dx)), std::abs (double (dy))) * sqrt (1.0 + ext * ext);
+}
+
+bool
+size_polygon_sliced (const db::Polygon &polygon, db::Coord dx, db::Coord dy, unsigned int mode, size_t max_vertex_count, std::vector<db::Polygon> &output, int threads)
+{
+  //  slicing works for pure shrinking or pure growing only
+  if (max_vertex_count == 0 || polygon.vertices () <= max_vertex_count || (dx < 0) != (dy < 0) || (dx == 0 && dy == 0)) {
+    return false;
+  }
+
+  //  The result inside a tile depends on the polygon's features within the reach of the
+  //  sizing only. The cut lines of the windows also influence the result within this reach.
+  //  Hence a window margin of twice the reach isolates the tile from the cut lines.
+  double reach = sizing_reach (dx, dy, mode);
+  db::Coord margin = db::coord_traits<db::Coord>::rounded_up (2.0 * reach) + 2;
+  db::Coord ext = db::coord_traits<db::Coord>::rounded_up (reach) + 1;
+
+  std::list<SizingSlice> slices;
+  std::vector<db::Polygon> content;
+  content.push_back (polygon);
+  collect_slices (polygon.box ().enlarged (db::Vector (ext, ext)), content, margin, max_vertex_count, slices);
+
+  if (slices.size () < 2) {
+    return false;
+  }
+
+  std::vector<std::vector<db::Polygon> > results;
+  results.resize (slices.size ());
+
+  if (threads > 0) {
+
+    tl::Job<SizingSliceWorker> job (threads);
+
+    std::vector<std::vector<db::Polygon> >::iterator r = results.begin ();
+    for (std::list<SizingSlice>::const_iterator s = slices.begin (); s != slices.end (); ++s, ++r) {
+      job.schedule (new SizingSliceTask (s.operator-> (), dx, dy, mode, r.operator-> ()));
+    }
+
+    job.start ();
+    job.wait ();
+
+  } else {
+
+    std::vector<std::vector<db::Polygon> >::iterator r = results.begin ();
+    for (std::list<SizingSlice>::const_iterator s = slices.begin (); s != slices.end (); ++s, ++r) {
+      size_slice (*s, dx, dy, mode, *r);
+    }
+
+  }
+
+  for (std::vector<std::vector<db::Polygon> >::iterator r = results.begin (); r != results.end (); ++r) {
+    output.insert (output.end (), r->begin (), r->end ());
+  }
+
+  return true;
+}
+
 // -------------------------------------------------------------------------
 //  Smoothing tools
 
@@ -127,6 +127,36 @@ void cut_polygon (const PolygonType &input, const typename PolygonType::edge_typ
 template <class PolygonType>
 void DB_PUBLIC split_polygon (const PolygonType &polygon, std::vector<PolygonType> &output);
 
+/**
+ *  @brief Gets the maximum distance by which sizing may move a point
+ *
+ *  This value includes the corner extension of the given sizing mode.
+ */
+double DB_PUBLIC sizing_reach (db::Coord dx, db::Coord dy, unsigned int mode);
+
+/**
+ *  @brief Sizes a polygon with many vertices slice by slice
+ *
+ *  This function divides the bounding box of the sized polygon into tiles until the
+ *  part of the polygon relevant for each tile has no more than max_vertex_count vertices.
+ *  Each tile is sized separately using the polygon part inside a window around the
+ *  tile which is big enough to make the result inside the tile exact. The parts are
+ *  delivered clipped at the tiles and need to be merged to form the final result
+ *  ("stitching").
+ *
+ *  The tiles can be processed in parallel. A thread count of 0 means synchronous
+ *  operation.
+ *
+ *  Slicing is only employed if the polygon has more than max_vertex_count vertices,
+ *  the sizing is not anisotropic with different signs and the polygon can actually
+ *  be divided into more than one tile. This function returns false if no slicing
+ *  was done. In that case, "output" is not modified.
+ *
+ *  The output is equivalent to the merged result of polygon.sized (dx, dy, mode) except
+ *  for rounding effects at the tile borders.
+ */
+bool DB_PUBLIC size_polygon_sliced (const db::Polygon &polygon, db::Coord dx, db::Coord dy, unsigned int mode, size_t max_vertex_count, std::vector<db::Polygon> &output, int threads = 0);
+
 /**
  *  @brief Determines wheter a polygon and a box interact
  *
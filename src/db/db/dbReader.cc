@@ -23,8 +23,12 @@
 
 #include "dbReader.h"
 #include "dbStream.h"
+#include "dbCommonReader.h"
+#include "dbLayout.h"
 #include "tlClassRegistry.h"
 
+#include <memory>
+
 namespace db
 {
 
@@ -32,7 +36,7 @@ namespace db
 //  ReaderBase implementation
 
 ReaderBase::ReaderBase () 
-  : m_warnings_as_errors (false)
+  : m_warnings_as_errors (false), m_defer_proxy_recovery (false)
 { 
 }
 
@@ -46,17 +50,65 @@ ReaderBase::set_warnings_as_errors (bool f)
   m_warnings_as_errors = f;
 }
 
+void
+ReaderBase::set_defer_proxy_recovery (bool f)
+{
+  m_defer_proxy_recovery = f;
+}
+
+bool
+ReaderBase::recover_proxy_as (db::Layout &layout, db::cell_index_type cell_index, const std::vector<std::string> &context_info, db::ImportLayerMapping *layer_mapping)
+{
+  if (m_defer_proxy_recovery) {
+    m_deferred_proxies.push_back (std::make_pair (cell_index, context_info));
+    return false;
+  } else {
+    return layout.recover_proxy_as (cell_index, context_info.begin (), context_info.end (), layer_mapping);
+  }
+}
+
+void
+ReaderBase::restore_deferred_proxies (db::Layout &layout)
+{
+  std::auto_ptr<db::ImportLayerMapping> layer_mapping (create_proxy_layer_mapping (layout));
+
+  for (std::vector<std::pair<db::cell_index_type, std::vector<std::string> > >::const_iterator p = m_deferred_proxies.begin (); p != m_deferred_proxies.end (); ++p) {
+    //  the reader may have deleted the cell in the meantime
+    if (layout.is_valid_cell_index (p->first)) {
+      layout.recover_proxy_as (p->first, p->second.begin (), p->second.end (), layer_mapping.get ());
+    }
+  }
+
+  m_deferred_proxies.clear ();
+}
+
+db::ImportLayerMapping *
+ReaderBase::create_proxy_layer_mapping (db::Layout & /*layout*/)
+{
+  return 0;
+}
+
 // ---------------------------------------------------------------
 //  Reader implementation
 
+//  The number of bytes the format detectors get to see
+static const size_t detect_head_size = 65536;
+
 Reader::Reader (tl::InputStream &stream)
   : mp_actual_reader (0), m_stream (stream)
 {
-  //  Detect the format by asking all reader declarations
+  //  Detect the format by asking all reader declarations.
+  //  The detectors only see the head of the stream which is peeked once. Hence the 
+  //  original stream is not advanced and does not need to be reset which would mean to 
+  //  inflate .gz files again or is not possible at all for pipes.
+  m_stream.reset ();
+
+  tl::InputHeadStream head_delegate (m_stream, detect_head_size);
+  tl::InputStream head (head_delegate);
+
   for (tl::Registrar<db::StreamFormatDeclaration>::iterator rdr = tl::Registrar<db::StreamFormatDeclaration>::begin (); rdr != tl::Registrar<db::StreamFormatDeclaration>::end () && ! mp_actual_reader; ++rdr) {
-    m_stream.reset ();
-    if (rdr->detect (m_stream)) {
-      m_stream.reset ();
+    head.reset ();
+    if (rdr->detect (head)) {
       mp_actual_reader = rdr->create_reader (m_stream);
     }
   }
@@ -66,6 +118,15 @@ Reader::Reader (tl::InputStream &stream)
   }
 }
 
+void
+Reader::prepare_stream (const db::LoadLayoutOptions &options)
+{
+  const db::CommonReaderOptions &common_options = options.get_options<db::CommonReaderOptions> ();
+  if (common_options.read_ahead_buffers > 0) {
+    m_stream.set_read_ahead (common_options.read_ahead_buffers, common_options.read_ahead_buffer_size);
+  }
+}
+
 Reader::~Reader ()
 {
   if (mp_actual_reader) {
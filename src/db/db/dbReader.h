@@ -26,6 +26,7 @@
 #define HDR_dbReader
 
 #include "dbCommon.h"
+#include "dbTypes.h"
 
 #include "tlException.h"
 #include "tlInternational.h"
@@ -35,12 +36,14 @@
 #include "dbLoadLayoutOptions.h"
 
 #include <vector>
+#include <string>
 
 namespace db
 {
 
 class Layout;
 class ReaderBase;
+class ImportLayerMapping;
 
 /**
  *  @brief Generic base class of reader exceptions
@@ -81,8 +84,54 @@ public:
     return m_warnings_as_errors;
   }
 
+  /**
+   *  @brief Sets a flag indicating that proxy cells shall be restored later
+   *
+   *  Proxy cells (library references and PCell variants) are restored from the
+   *  context information stored in the file. This involves the library manager and
+   *  possibly PCell code, both of which must not be used outside the main thread.
+   *  If this flag is set, the reader will only record the context information and
+   *  read the cells like normal ones. The proxies are created by "restore_deferred_proxies".
+   */
+  void set_defer_proxy_recovery (bool f);
+
+  /**
+   *  @brief Gets a flag indicating that proxy cells shall be restored later
+   */
+  bool defer_proxy_recovery () const
+  {
+    return m_defer_proxy_recovery;
+  }
+
+  /**
+   *  @brief Creates the proxy cells recorded while reading with deferred proxy recovery
+   *
+   *  The layout must be the one the reader has read into.
+   */
+  void restore_deferred_proxies (db::Layout &layout);
+
+protected:
+  /**
+   *  @brief Restores a proxy cell from the given context information
+   *
+   *  Readers are supposed to use this method instead of Layout::recover_proxy_as.
+   *  If proxy recovery is deferred, the context information is recorded and false
+   *  is returned.
+   */
+  bool recover_proxy_as (db::Layout &layout, db::cell_index_type cell_index, const std::vector<std::string> &context_info, db::ImportLayerMapping *layer_mapping);
+
+  /**
+   *  @brief Creates the layer mapping for the deferred proxy recovery
+   *
+   *  The default implementation returns 0. In that case, the layers are looked up
+   *  or created by their properties.
+   */
+  virtual db::ImportLayerMapping *create_proxy_layer_mapping (db::Layout &layout);
+
 private:
   bool m_warnings_as_errors;
+  bool m_defer_proxy_recovery;
+  std::vector<std::pair<db::cell_index_type, std::vector<std::string> > > m_deferred_proxies;
 };
 
 /**
@@ -127,6 +176,7 @@ public:
    */
   const db::LayerMap &read (db::Layout &layout, const db::LoadLayoutOptions &options) 
   {
+    prepare_stream (options);
     return mp_actual_reader->read (layout, options);
   }
 
@@ -173,9 +223,36 @@ public:
     return mp_actual_reader->warnings_as_errors ();
   }
 
+  /**
+   *  @brief Sets a flag indicating that proxy cells shall be restored later
+   *  See ReaderBase::set_defer_proxy_recovery for details.
+   */
+  void set_defer_proxy_recovery (bool f)
+  {
+    mp_actual_reader->set_defer_proxy_recovery (f);
+  }
+
+  /**
+   *  @brief Gets a flag indicating that proxy cells shall be restored later
+   */
+  bool defer_proxy_recovery () const
+  {
+    return mp_actual_reader->defer_proxy_recovery ();
+  }
+
+  /**
+   *  @brief Creates the proxy cells recorded while reading with deferred proxy recovery
+   */
+  void restore_deferred_proxies (db::Layout &layout)
+  {
+    mp_actual_reader->restore_deferred_proxies (layout);
+  }
+
 private:
   ReaderBase *mp_actual_reader;
   tl::InputStream &m_stream;
+
+  void prepare_stream (const db::LoadLayoutOptions &options);
 };
 
 }
@@ -32,7 +32,8 @@ namespace db
 
 SaveLayoutOptions::SaveLayoutOptions ()
   : m_format ("GDS2"), m_all_layers (true), m_all_cells (true), m_dbu (0.0), m_scale_factor (1.0),
-    m_keep_instances (false), m_write_context_info (true), m_dont_write_empty_cells (false)
+    m_keep_instances (false), m_write_context_info (true), m_dont_write_empty_cells (false),
+    m_write_behind_buffers (0), m_write_behind_buffer_size (1024 * 1024), m_compression_threads (0)
 {
   // .. nothing yet ..
 }
@@ -63,6 +64,9 @@ SaveLayoutOptions::operator= (const SaveLayoutOptions &d)
     m_keep_instances = d.m_keep_instances;
     m_write_context_info = d.m_write_context_info;
     m_dont_write_empty_cells = d.m_dont_write_empty_cells;
+    m_write_behind_buffers = d.m_write_behind_buffers;
+    m_write_behind_buffer_size = d.m_write_behind_buffer_size;
+    m_compression_threads = d.m_compression_threads;
 
     release ();
     for (std::map <std::string, FormatSpecificWriterOptions *>::const_iterator o = d.m_options.begin (); o != d.m_options.end (); ++o) {
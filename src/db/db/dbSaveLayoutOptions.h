@@ -250,6 +250,60 @@ public:
     m_write_context_info = ctx_info;
   }
 
+  /**
+   *  @brief The number of write-behind buffers (getter)
+   *
+   *  If this number is larger than 0, a separate thread writes the data 
+   *  while the writer continues with the next buffer. 0 disables write-behind.
+   */
+  unsigned int write_behind_buffers () const
+  {
+    return m_write_behind_buffers;
+  }
+
+  /**
+   *  @brief The number of write-behind buffers (setter)
+   */
+  void set_write_behind_buffers (unsigned int n)
+  {
+    m_write_behind_buffers = n;
+  }
+
+  /**
+   *  @brief The size of a write-behind buffer (getter)
+   */
+  size_t write_behind_buffer_size () const
+  {
+    return m_write_behind_buffer_size;
+  }
+
+  /**
+   *  @brief The size of a write-behind buffer (setter)
+   */
+  void set_write_behind_buffer_size (size_t n)
+  {
+    m_write_behind_buffer_size = n;
+  }
+
+  /**
+   *  @brief The number of compression threads (getter)
+   *
+   *  In write-behind mode, .gz files are compressed by this number of
+   *  threads in parallel. 0 means the I/O thread compresses the data.
+   */
+  unsigned int compression_threads () const
+  {
+    return m_compression_threads;
+  }
+
+  /**
+   *  @brief The number of compression threads (setter)
+   */
+  void set_compression_threads (unsigned int n)
+  {
+    m_compression_threads = n;
+  }
+
   /**
    *  @brief Set the format (default) from the file name
    *
@@ -441,6 +495,9 @@ private:
   bool m_keep_instances;
   bool m_write_context_info;
   bool m_dont_write_empty_cells;
+  unsigned int m_write_behind_buffers;
+  size_t m_write_behind_buffer_size;
+  unsigned int m_compression_threads;
   std::map <std::string, FormatSpecificWriterOptions *> m_options;
 
   void release ();
@@ -962,6 +962,28 @@ void Shapes::sort ()
   }
 }
 
+double Shapes::fragmentation () const
+{
+  double f = 0.0;
+  for (tl::vector<LayerBase *>::const_iterator l = m_layers.begin (); l != m_layers.end (); ++l) {
+    f = std::max (f, (*l)->fragmentation ());
+  }
+  return f;
+}
+
+bool Shapes::compact (double threshold)
+{
+  bool any = false;
+  for (tl::vector<LayerBase *>::const_iterator l = m_layers.begin (); l != m_layers.end (); ++l) {
+    double f = (*l)->fragmentation ();
+    if (f > 0.0 && f >= threshold) {
+      (*l)->compact ();
+      any = true;
+    }
+  }
+  return any;
+}
+
 void 
 Shapes::redo (db::Op *op)
 {
@@ -452,6 +452,8 @@ public:
   virtual size_t size () const = 0;
   virtual bool empty () const = 0;
   virtual void sort () = 0;
+  virtual double fragmentation () const = 0;
+  virtual void compact () = 0;
   virtual void clear (Shapes *target, db::Manager *manager) = 0;
   virtual LayerBase *clone (Shapes *target, db::Manager *manager) const = 0;
   virtual void translate_into (Shapes *target, GenericRepository &rep, ArrayRepository &array_rep) const = 0;
@@ -1170,6 +1172,30 @@ public:
    */
   void sort ();
 
+  /**
+   *  @brief Gets the fragmentation of the shape containers
+   *
+   *  Erasing shapes in editable mode leaves holes in the shape containers
+   *  which are only reused by later inserts. This method returns the largest
+   *  fraction of unused slots over all shape types. 0 means there are no holes.
+   */
+  double fragmentation () const;
+
+  /**
+   *  @brief Removes the holes left by erased shapes
+   *
+   *  This method compacts the shape containers whose fragmentation exceeds the
+   *  given threshold (a value between 0 and 1). The box trees are remapped, so
+   *  no re-sorting is required. Compacting speeds up iteration and reduces
+   *  memory footprint after many shapes have been erased.
+   *
+   *  Compacting invalidates all shape references (db::Shape objects) and
+   *  shape iterators pointing into this container.
+   *
+   *  @return True, if any container has been compacted
+   */
+  bool compact (double threshold = 0.0);
+
   /**
    *  @brief Clears the collection
    */
@@ -141,6 +141,16 @@ public:
     m_layer.sort ();
   }
 
+  virtual double fragmentation () const
+  {
+    return m_layer.fragmentation ();
+  }
+
+  virtual void compact ()
+  {
+    m_layer.compact ();
+  }
+
   virtual void clear (Shapes *target, db::Manager *manager);
   virtual LayerBase *clone (Shapes *target, db::Manager *manager) const;
   virtual void translate_into (Shapes *target, GenericRepository &rep, ArrayRepository &array_rep) const;
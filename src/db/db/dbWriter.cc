@@ -55,7 +55,12 @@ void
 Writer::write (db::Layout &layout, tl::OutputStream &stream)
 {
   tl_assert (mp_writer != 0);
+
+  stream.set_write_behind (m_options.write_behind_buffers (), m_options.write_behind_buffer_size (), m_options.compression_threads ());
   mp_writer->write (layout, stream, m_options);
+
+  //  makes sure all data is written and errors are reported
+  stream.flush ();
 }
 
 }
@@ -26,6 +26,8 @@
 #include "dbLayout.h" 
 #include "tlString.h" 
 #include "tlAssert.h" 
+#include "tlException.h" 
+#include "tlInternational.h" 
 
 #include <map>
 #include <set>
@@ -200,6 +202,54 @@ WriterCellNameMap::cell_name (db::cell_index_type id) const
   return c->second;
 }
 
+// ---------------------------------------------------------------------------------
+//  register_new_layers implementation
+
+void
+register_new_layers (const db::Layout &layout, std::vector<std::pair<unsigned int, db::LayerProperties> > &layers)
+{
+  std::set<unsigned int> known_layers;
+  std::set<std::pair<int, int> > named_layer_numbers;
+  int max_layer = -1;
+
+  for (std::vector <std::pair <unsigned int, db::LayerProperties> >::const_iterator l = layers.begin (); l != layers.end (); ++l) {
+    known_layers.insert (l->first);
+    max_layer = std::max (max_layer, l->second.layer);
+    if (layout.is_valid_layer (l->first) && layout.get_properties (l->first).is_named ()) {
+      named_layer_numbers.insert (std::make_pair (l->second.layer, l->second.datatype));
+    }
+  }
+
+  //  the numbered layers are registered first, so named layers can't take the numbers
+  //  of numbered layers which appear at the same time
+  std::vector<size_t> named_layers;
+
+  for (db::Layout::layer_iterator l = layout.begin_layers (); l != layout.end_layers (); ++l) {
+
+    if (known_layers.find ((*l).first) != known_layers.end ()) {
+      continue;
+    }
+
+    const db::LayerProperties &lp = *(*l).second;
+    if (lp.is_named ()) {
+      named_layers.push_back (layers.size ());
+    } else {
+      if (named_layer_numbers.find (std::make_pair (lp.layer, lp.datatype)) != named_layer_numbers.end ()) {
+        throw tl::Exception (tl::to_string (tr ("Layer %s uses the number already given to a named layer - create numbered layers before named ones")), lp.to_string ());
+      }
+      max_layer = std::max (max_layer, lp.layer);
+    }
+
+    layers.push_back (std::make_pair ((*l).first, lp));
+
+  }
+
+  for (std::vector<size_t>::const_iterator i = named_layers.begin (); i != named_layers.end (); ++i) {
+    db::LayerProperties &lp = layers [*i].second;
+    lp.layer = ++max_layer;
+    lp.datatype = 0;
+  }
 }
 
+}
 
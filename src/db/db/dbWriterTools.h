@@ -27,16 +27,21 @@
 #include "dbCommon.h"
 
 #include "dbTypes.h" 
+#include "dbLayout.h"
+#include "dbSaveLayoutOptions.h"
+#include "tlStream.h"
+#include "tlException.h"
+#include "tlInternational.h"
 
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
+#include <memory>
 
 namespace db
 {
 
-class Layout;
-
 /**
  *  @brief A class for cell name transformations
  *
@@ -126,6 +131,14 @@ public:
    */
   const std::string &cell_name (db::cell_index_type id) const;
 
+  /**
+   *  @brief Returns a value indicating whether a name has been assigned for the given cell id already
+   */
+  bool has_cell_name (db::cell_index_type id) const
+  {
+    return m_map.find (id) != m_map.end ();
+  }
+
 private:
   std::map <db::cell_index_type, std::string> m_map;
   std::set <std::string> m_cell_names;
@@ -134,6 +147,201 @@ private:
   size_t m_max_cellname_length;
 };
 
+/**
+ *  @brief Registers the new layers of a layout which is written incrementally
+ *
+ *  "layers" is the list of layers registered so far (layer index and the layer
+ *  properties used for writing). Layers of "layout" which are not registered yet
+ *  are added in the order of their layer index. Numbered layers keep their layer and
+ *  datatype. Named layers without a number get the next free layer number and
+ *  datatype 0.
+ *
+ *  The number given to a named layer is final, as shapes on that layer may have been
+ *  written already. If a numbered layer with the same layer and datatype is 
+ *  registered later, an exception is thrown instead of merging both layers.
+ */
+DB_PUBLIC void register_new_layers (const db::Layout &layout, std::vector<std::pair<unsigned int, db::LayerProperties> > &layers);
+
+/**
+ *  @brief The common implementation of the push-style streaming writers
+ *
+ *  Writer is the format writer which needs to provide the incremental 
+ *  writer interface: "begin_write (layout, stream, options)", "write_cell (cell_index)"
+ *  and "end_write ()".
+ *
+ *  The streaming writer holds a scratch layout which provides the layers, the property 
+ *  repository and the cell directory. Only the content of the open cell is kept in memory.
+ */
+template <class Writer>
+class StreamWriterBase
+{
+public:
+  /**
+   *  @brief Creates a streaming writer for the given stream
+   *
+   *  The stream needs to stay valid until "close" has been called.
+   */
+  StreamWriterBase (tl::OutputStream &stream, double dbu, const db::SaveLayoutOptions &options)
+    : m_layout (false), mp_stream (&stream), mp_open_cell (0)
+  {
+    init (dbu, options);
+  }
+
+  /**
+   *  @brief Creates a streaming writer for the given file
+   */
+  StreamWriterBase (const std::string &path, double dbu, const db::SaveLayoutOptions &options)
+    : m_layout (false), mp_stream (0), mp_open_cell (0)
+  {
+    mp_own_stream.reset (new tl::OutputStream (path));
+    mp_stream = mp_own_stream.get ();
+    init (dbu, options);
+  }
+
+  /**
+   *  @brief Destructor
+   *
+   *  The destructor will close the file if required.
+   */
+  ~StreamWriterBase ()
+  {
+    try {
+      close ();
+    } catch (...) {
+      //  .. ignore exceptions in the destructor ..
+    }
+  }
+
+  /**
+   *  @brief Gets the layer index for the given layer properties
+   *
+   *  If the layer does not exist yet, it is created.
+   */
+  unsigned int layer (const db::LayerProperties &lp)
+  {
+    for (db::Layout::layer_iterator l = m_layout.begin_layers (); l != m_layout.end_layers (); ++l) {
+      if ((*l).second->log_equal (lp)) {
+        return (*l).first;
+      }
+    }
+
+    return m_layout.insert_layer (lp);
+  }
+
+  /**
+   *  @brief Gets the cell index for the given cell name
+   *
+   *  This method can be used to reference a cell before it is written.
+   */
+  db::cell_index_type cell_index (const std::string &name)
+  {
+    std::pair<bool, db::cell_index_type> cbn = m_layout.cell_by_name (name.c_str ());
+    if (cbn.first) {
+      return cbn.second;
+    } else {
+      return m_layout.add_cell (name.c_str ());
+    }
+  }
+
+  /**
+   *  @brief Opens a new cell
+   *
+   *  Shapes and instances can be put into the cell returned. A cell can only be written once.
+   */
+  db::Cell &begin_cell (const std::string &name)
+  {
+    if (! mp_stream) {
+      throw tl::Exception (tl::to_string (tr ("Streaming writer is already closed")));
+    }
+    if (mp_open_cell) {
+      throw tl::Exception (tl::to_string (tr ("Cell '%s' is still open - call 'end_cell' before opening a new cell")), m_layout.cell_name (mp_open_cell->cell_index ()));
+    }
+
+    db::cell_index_type ci = cell_index (name);
+    if (m_written.find (ci) != m_written.end ()) {
+      throw tl::Exception (tl::to_string (tr ("Cell '%s' has already been written")), name);
+    }
+
+    mp_open_cell = &m_layout.cell (ci);
+    return *mp_open_cell;
+  }
+
+  /**
+   *  @brief Writes the open cell and discards its content
+   */
+  void end_cell ()
+  {
+    if (! mp_open_cell) {
+      throw tl::Exception (tl::to_string (tr ("No cell is open - call 'begin_cell' first")));
+    }
+
+    db::Cell *cell = mp_open_cell;
+    mp_open_cell = 0;
+
+    m_writer.write_cell (cell->cell_index ());
+    m_written.insert (cell->cell_index ());
+
+    //  discard the content of the cell - it's not needed any longer
+    cell->clear_shapes ();
+    cell->clear_insts ();
+  }
+
+  /**
+   *  @brief Finishes the file
+   */
+  void close ()
+  {
+    if (! mp_stream) {
+      return;
+    }
+
+    if (mp_open_cell) {
+      end_cell ();
+    }
+
+    m_writer.end_write ();
+    mp_stream->flush ();
+
+    mp_stream = 0;
+    mp_own_stream.reset (0);
+  }
+
+  /**
+   *  @brief Gets the scratch layout
+   */
+  db::Layout &layout ()
+  {
+    return m_layout;
+  }
+
+  /**
+   *  @brief Gets a value indicating whether the writer is closed
+   */
+  bool is_closed () const
+  {
+    return mp_stream == 0;
+  }
+
+private:
+  db::Layout m_layout;
+  std::auto_ptr<tl::OutputStream> mp_own_stream;
+  tl::OutputStream *mp_stream;
+  Writer m_writer;
+  db::Cell *mp_open_cell;
+  std::set<db::cell_index_type> m_written;
+
+  //  no copying
+  StreamWriterBase (const StreamWriterBase &);
+  StreamWriterBase &operator= (const StreamWriterBase &);
+
+  void init (double dbu, const db::SaveLayoutOptions &options)
+  {
+    m_layout.dbu (dbu);
+    mp_stream->set_write_behind (options.write_behind_buffers (), options.write_behind_buffer_size (), options.compression_threads ());
+    m_writer.begin_write (m_layout, *mp_stream, options);
+  }
+};
+
 }
 
 #endif
@@ -84,6 +84,36 @@ static void set_properties_enabled (db::LoadLayoutOptions *options, bool l)
   options->get_options<db::CommonReaderOptions> ().enable_properties = l;
 }
 
+static db::DBox get_region (const db::LoadLayoutOptions *options)
+{
+  return options->get_options<db::CommonReaderOptions> ().region;
+}
+
+static void set_region (db::LoadLayoutOptions *options, const db::DBox &region)
+{
+  options->get_options<db::CommonReaderOptions> ().region = region;
+}
+
+static unsigned int get_read_ahead_buffers (const db::LoadLayoutOptions *options)
+{
+  return options->get_options<db::CommonReaderOptions> ().read_ahead_buffers;
+}
+
+static void set_read_ahead_buffers (db::LoadLayoutOptions *options, unsigned int n)
+{
+  options->get_options<db::CommonReaderOptions> ().read_ahead_buffers = n;
+}
+
+static size_t get_read_ahead_buffer_size (const db::LoadLayoutOptions *options)
+{
+  return options->get_options<db::CommonReaderOptions> ().read_ahead_buffer_size;
+}
+
+static void set_read_ahead_buffer_size (db::LoadLayoutOptions *options, size_t n)
+{
+  options->get_options<db::CommonReaderOptions> ().read_ahead_buffer_size = n;
+}
+
 //  extend lay::LoadLayoutOptions with the Common options
 static
 gsi::ClassExt<db::LoadLayoutOptions> common_reader_options (
@@ -154,6 +184,53 @@ gsi::ClassExt<db::LoadLayoutOptions> common_reader_options (
     "@param enabled True, if properties should be read."
     "\n"
     "Starting with version 0.25 this option only applies to GDS2 and OASIS format. Other formats provide their own configuration."
+  ) +
+  gsi::method_ext ("region", &get_region,
+    "@brief Gets the region of interest\n"
+    "See \\region= for details about this attribute.\n"
+    "\n"
+    "This attribute has been introduced in version 0.26."
+  ) +
+  gsi::method_ext ("region=", &set_region, gsi::arg ("region"),
+    "@brief Specifies a region of interest\n"
+    "If this box is not empty, only the parts of the layout touching the box are read. "
+    "The box is given in micrometer units in the coordinate system of the top cells. "
+    "Shapes not touching the region are skipped and so are instances whose cell does not touch the region. "
+    "Cells which do not contribute to the region are not created. "
+    "The GDS2 reader uses a fast scan pass to determine the cell extensions. The OASIS reader uses the "
+    "cell bounding boxes declared in the file's tables if available. Both skip the bodies of cells outside "
+    "the region. An empty box (the default) disables the region filter.\n"
+    "\n"
+    "This option only applies to GDS2 and OASIS format. "
+    "This attribute has been introduced in version 0.26."
+  ) +
+  gsi::method_ext ("read_ahead_buffers", &get_read_ahead_buffers,
+    "@brief Gets the number of read-ahead buffers\n"
+    "See \\read_ahead_buffers= for details about this attribute.\n"
+    "\n"
+    "This attribute has been introduced in version 0.26."
+  ) +
+  gsi::method_ext ("read_ahead_buffers=", &set_read_ahead_buffers, gsi::arg ("n"),
+    "@brief Enables read-ahead with the given number of buffers\n"
+    "If this value is not zero, a separate thread reads the file into a ring of buffers ahead of the reader. "
+    "Reading and decompression of .gz files then overlaps with parsing. This is beneficial for slow sources "
+    "such as network file systems. The size of each buffer is given by \\read_ahead_buffer_size=. "
+    "A value of 0 (the default) disables read-ahead.\n"
+    "\n"
+    "This option applies to all formats, but only to plain and .gz files. Other sources (i.e. HTTP) are "
+    "always read directly. "
+    "This attribute has been introduced in version 0.26."
+  ) +
+  gsi::method_ext ("read_ahead_buffer_size", &get_read_ahead_buffer_size,
+    "@brief Gets the size of each read-ahead buffer in bytes\n"
+    "\n"
+    "This attribute has been introduced in version 0.26."
+  ) +
+  gsi::method_ext ("read_ahead_buffer_size=", &set_read_ahead_buffer_size, gsi::arg ("size"),
+    "@brief Sets the size of each read-ahead buffer in bytes\n"
+    "The default size is 1 MB. See \\read_ahead_buffers= for details.\n"
+    "\n"
+    "This attribute has been introduced in version 0.26."
   ),
   ""
 );
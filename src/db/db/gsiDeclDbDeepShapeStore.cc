@@ -53,6 +53,23 @@ Class<db::DeepShapeStore> decl_dbDeepShapeStore ("db", "DeepShapeStore",
   gsi::method ("max_vertex_count", &db::DeepShapeStore::max_vertex_count,
     "@brief Gets the maximum vertex count.\n"
   ) +
+  gsi::method ("slice_vertex_count=", &db::DeepShapeStore::set_slice_vertex_count, gsi::arg ("count"),
+    "@brief Sets the vertex count above which merged polygons are sized in slices\n"
+    "\n"
+    "Sizing acts on merged polygons which may become very big. If this value is set, polygons with more vertices "
+    "than this value are sized in slices which are processed in parallel (see \\threads=) and "
+    "stitched together afterwards. A value of 0 disables slicing. Slicing is disabled by default, as "
+    "the result may differ slightly at the slice borders due to rounding.\n"
+    "\n"
+    "Only sizing is sliced. Boolean operations and checks are not affected by this setting.\n"
+    "\n"
+    "This attribute has been introduced in version 0.26.\n"
+  ) +
+  gsi::method ("slice_vertex_count", &db::DeepShapeStore::slice_vertex_count,
+    "@brief Gets the vertex count above which merged polygons are sized in slices.\n"
+    "\n"
+    "This attribute has been introduced in version 0.26.\n"
+  ) +
   gsi::method ("max_area_ratio=", &db::DeepShapeStore::set_max_area_ratio, gsi::arg ("ratio"),
     "@brief Sets the max. area ratio for bounding box vs. polygon area\n"
     "\n"
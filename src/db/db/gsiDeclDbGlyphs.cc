@@ -23,6 +23,7 @@
 #include "gsiDecl.h"
 
 #include "dbGlyphs.h"
+#include "dbLayout.h"
 
 namespace gsi
 {
@@ -226,4 +227,102 @@ Class<db::TextGenerator> decl_TextGenerator ("db", "TextGenerator",
   "This class has been introduced in version 0.25."
 );
 
+// -------------------------------------------------------------------
+//  db::GlyphCellLibrary declarations
+
+static db::GlyphCellLibrary *new_glyph_cell_library (db::Layout *layout, unsigned int layer)
+{
+  if (! layout) {
+    throw tl::Exception (tl::to_string (tr ("A layout is required for a glyph cell library")));
+  }
+  return new db::GlyphCellLibrary (*layout, layer);
+}
+
+static db::cell_index_type hershey_glyph_cell (db::GlyphCellLibrary *lib, int font, char c, double height, double line_width)
+{
+  return lib->hershey_glyph_cell (db::Font (font), (unsigned char) c, height, line_width);
+}
+
+static void hershey_text (db::GlyphCellLibrary *lib, int font, const std::string &t, double height, double line_width, db::Cell &target, const db::Trans &trans, bool flat)
+{
+  lib->hershey_text (db::Font (font), t, height, line_width, target, trans, flat);
+}
+
+Class<db::GlyphCellLibrary> decl_GlyphCellLibrary ("db", "GlyphCellLibrary",
+  constructor ("new", &new_glyph_cell_library, arg ("layout"), arg ("layer"),
+    "@brief Creates a glyph cell library for the given layout and layer\n"
+    "The glyph cells are created in the given layout and the glyph shapes are put on the given layer. "
+    "The library does not own the layout. If the layout is destroyed, the library's methods will raise an error."
+  ) +
+  method ("layout", &db::GlyphCellLibrary::layout,
+    "@brief Gets the layout in which the glyph cells are created\n"
+  ) +
+  method ("layer", &db::GlyphCellLibrary::layer,
+    "@brief Gets the layer on which the glyph shapes are produced\n"
+  ) +
+  method ("size", &db::GlyphCellLibrary::size,
+    "@brief Gets the number of glyphs held by the library\n"
+  ) +
+  method ("clear", &db::GlyphCellLibrary::clear,
+    "@brief Forgets all glyphs\n"
+    "The glyph cells are not deleted, but new texts will use new cells."
+  ) +
+  method ("glyph_cell", &db::GlyphCellLibrary::glyph_cell, arg ("generator"), arg ("char"), arg ("mag", 1.0),
+    "@brief Gets the glyph cell for a character of a \\TextGenerator font\n"
+    "@param generator The generator (font)\n"
+    "@param char The character\n"
+    "@param mag The magnification (1.0 for original size)\n"
+    "@return The index of the glyph cell\n"
+    "The cell is created on first use and shared by all texts using the same character and magnification. "
+    "The generator must stay valid as long as the library is used."
+  ) +
+  method ("text", &db::GlyphCellLibrary::text, arg ("generator"), arg ("text"), arg ("mag"), arg ("char_spacing"), arg ("line_spacing"), arg ("target"), arg ("trans", db::Trans (), "unity"), arg ("flat", false),
+    "@brief Produces a text with a \\TextGenerator font\n"
+    "@param generator The generator (font)\n"
+    "@param text The text string (see \\TextGenerator#text)\n"
+    "@param mag The magnification (1.0 for original size)\n"
+    "@param char_spacing Additional space between characters (in micron units)\n"
+    "@param line_spacing Additional space between lines (in micron units)\n"
+    "@param target The cell in which the text is produced\n"
+    "@param trans The transformation applied to the text\n"
+    "@param flat If true, polygons are produced in the target cell instead of glyph cell instances\n"
+    "The first character is placed at the origin. Inversion and bias are not supported. "
+    "Unless flat, the target cell must be a cell of the library's layout."
+  ) +
+  method_ext ("hershey_glyph_cell", &hershey_glyph_cell, arg ("font"), arg ("char"), arg ("height"), arg ("line_width", 0.0),
+    "@brief Gets the glyph cell for a character of a Hershey font\n"
+    "@param font The font (see \\Text#font)\n"
+    "@param char The character\n"
+    "@param height The height of the \"M\" character in micron units\n"
+    "@param line_width The width of the strokes in micron units (0 for edges)\n"
+    "@return The index of the glyph cell\n"
+  ) +
+  method_ext ("hershey_text", &hershey_text, arg ("font"), arg ("text"), arg ("height"), arg ("line_width"), arg ("target"), arg ("trans", db::Trans (), "unity"), arg ("flat", false),
+    "@brief Produces a text with a Hershey font\n"
+    "@param font The font (see \\Text#font)\n"
+    "@param text The text string (line breaks are given by newline characters)\n"
+    "@param height The height of the \"M\" character in micron units\n"
+    "@param line_width The width of the strokes in micron units (0 for edges)\n"
+    "@param target The cell in which the text is produced\n"
+    "@param trans The transformation applied to the text\n"
+    "@param flat If true, shapes are produced in the target cell instead of glyph cell instances\n"
+    "The bottom left corner of the text box is placed at the origin. "
+    "Unless flat, the target cell must be a cell of the library's layout."
+  ),
+  "@brief A library of glyph cells for producing texts in a layout\n"
+  "\n"
+  "Texts produced with this class use one cell per glyph which is instantiated for every occurance of "
+  "the character. This is much more compact than polygons when many texts are produced:\n"
+  "\n"
+  "@code\n"
+  "lib = RBA::GlyphCellLibrary::new(layout, layout.layer(1, 0))\n"
+  "gen = RBA::TextGenerator::default_generator\n"
+  "lib.text(gen, \"A TEXT\", 1.0, 0.0, 0.0, top_cell)\n"
+  "@/code\n"
+  "\n"
+  "Glyphs can be produced from \\TextGenerator fonts or from the Hershey fonts used for drawing texts.\n"
+  "\n"
+  "This class has been introduced in version 0.26."
+);
+
 } // namespace gsi
@@ -2146,6 +2146,47 @@ Class<db::SaveLayoutOptions> decl_SaveLayoutOptions ("db", "SaveLayoutOptions",
     "\n"
     "This method was introduced in version 0.23.\n"
   ) +
+  gsi::method ("write_behind_buffers=", &db::SaveLayoutOptions::set_write_behind_buffers, gsi::arg ("n"),
+    "@brief Sets the number of write-behind buffers\n"
+    "\n"
+    "If this number is larger than 0, the data is written to the file by a separate thread while the writer "
+    "continues to produce the next buffer. With two buffers, this is double buffering. "
+    "The default is 0 which disables write-behind.\n"
+    "\n"
+    "This attribute has been introduced in version 0.26."
+  ) +
+  gsi::method ("write_behind_buffers", &db::SaveLayoutOptions::write_behind_buffers,
+    "@brief Gets the number of write-behind buffers\n"
+    "See \\write_behind_buffers= for details.\n"
+    "\n"
+    "This attribute has been introduced in version 0.26."
+  ) +
+  gsi::method ("write_behind_buffer_size=", &db::SaveLayoutOptions::set_write_behind_buffer_size, gsi::arg ("size"),
+    "@brief Sets the size of each write-behind buffer in bytes\n"
+    "The default is 1M.\n"
+    "\n"
+    "This attribute has been introduced in version 0.26."
+  ) +
+  gsi::method ("write_behind_buffer_size", &db::SaveLayoutOptions::write_behind_buffer_size,
+    "@brief Gets the size of each write-behind buffer in bytes\n"
+    "\n"
+    "This attribute has been introduced in version 0.26."
+  ) +
+  gsi::method ("compression_threads=", &db::SaveLayoutOptions::set_compression_threads, gsi::arg ("n"),
+    "@brief Sets the number of threads used to compress .gz files\n"
+    "\n"
+    "This option is effective in write-behind mode only (see \\write_behind_buffers=). If larger than 0, "
+    "each buffer is compressed by one of these threads in parallel and is written as a separate gzip member. "
+    "The resulting file is a valid gzip file. The default is 0 which means the I/O thread compresses the data.\n"
+    "\n"
+    "This attribute has been introduced in version 0.26."
+  ) +
+  gsi::method ("compression_threads", &db::SaveLayoutOptions::compression_threads,
+    "@brief Gets the number of threads used to compress .gz files\n"
+    "See \\compression_threads= for details.\n"
+    "\n"
+    "This attribute has been introduced in version 0.26."
+  ) +
   gsi::method ("keep_instances=", &db::SaveLayoutOptions::set_keep_instances,
     "@brief Enables or disables instances for dropped cells\n"
     "@args flag\n"
@@ -0,0 +1,142 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2019 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+
+#include "gsiDecl.h"
+#include "dbMultiFileReader.h"
+
+namespace gsi
+{
+
+static void add_file_with_layout (db::MultiFileReader *reader, const std::string &path, db::Layout *layout, const db::LoadLayoutOptions &options)
+{
+  reader->add_file (path, layout, options);
+}
+
+static void add_file_without_layout (db::MultiFileReader *reader, const std::string &path, const db::LoadLayoutOptions &options)
+{
+  reader->add_file (path, options);
+}
+
+static void read_merged (db::MultiFileReader *reader, db::Layout *layout, int ccr)
+{
+  reader->read_merged (*layout, db::MultiFileReader::CellConflictResolution (ccr));
+}
+
+static db::LayerMap layer_map (const db::MultiFileReader *reader, size_t n)
+{
+  if (n >= reader->files ()) {
+    throw tl::Exception (tl::to_string (tr ("File index out of range")));
+  }
+  return reader->layer_map (n);
+}
+
+static std::string format (const db::MultiFileReader *reader, size_t n)
+{
+  if (n >= reader->files ()) {
+    throw tl::Exception (tl::to_string (tr ("File index out of range")));
+  }
+  return reader->format (n);
+}
+
+static int add_to_cell ()
+{
+  return int (db::MultiFileReader::AddToCell);
+}
+
+static int rename_cell ()
+{
+  return int (db::MultiFileReader::RenameCell);
+}
+
+Class<db::MultiFileReader> decl_MultiFileReader ("db", "MultiFileReader",
+  gsi::method_ext ("add_file", &add_file_with_layout, gsi::arg ("path"), gsi::arg ("layout"), gsi::arg ("options", db::LoadLayoutOptions (), "LoadLayoutOptions()"),
+    "@brief Adds a file to read into the given layout\n"
+    "The file is read into the layout by \\read. The options are the reader options for this file."
+  ) +
+  gsi::method_ext ("add_file", &add_file_without_layout, gsi::arg ("path"), gsi::arg ("options", db::LoadLayoutOptions (), "LoadLayoutOptions()"),
+    "@brief Adds a file to read without a target layout\n"
+    "Files without a target layout can only be read with \\read_merged."
+  ) +
+  gsi::method ("files", &db::MultiFileReader::files,
+    "@brief Gets the number of files registered\n"
+  ) +
+  gsi::method ("clear", &db::MultiFileReader::clear,
+    "@brief Removes all files\n"
+  ) +
+  gsi::method ("threads=", &db::MultiFileReader::set_threads, gsi::arg ("n"),
+    "@brief Sets the number of threads to use\n"
+    "The default is 0 which means one thread per file."
+  ) +
+  gsi::method ("threads", &db::MultiFileReader::threads,
+    "@brief Gets the number of threads to use\n"
+  ) +
+  gsi::method ("read", &db::MultiFileReader::read,
+    "@brief Reads the files into their layouts\n"
+    "The files are read concurrently. Each file is read into the layout given in \\add_file. "
+    "If one of the files cannot be read, an exception is raised after all readers have finished."
+  ) +
+  gsi::method_ext ("read_merged", &read_merged, gsi::arg ("layout"), gsi::arg ("mode", int (db::MultiFileReader::AddToCell), "AddToCell"),
+    "@brief Reads the files into a single layout\n"
+    "The files are read concurrently and combined into the given layout in the order they have been added. "
+    "The layout may contain cells already. Layers are identified by their layer properties. If the database units differ, "
+    "the files are scaled to the database unit of the layout. An empty layout takes the database unit of the first file.\n"
+    "\n"
+    "'mode' specifies how cells with the same name are treated. With \\AddToCell, such cells are combined into one cell. "
+    "With \\RenameCell, the cells coming later are given a new name."
+  ) +
+  gsi::method_ext ("layer_map", &layer_map, gsi::arg ("n"),
+    "@brief Gets the layer map delivered by the reader of the nth file\n"
+  ) +
+  gsi::method_ext ("format", &format, gsi::arg ("n"),
+    "@brief Gets the format of the nth file\n"
+  ) +
+  gsi::method ("AddToCell", &add_to_cell,
+    "@brief Specifies that cells with the same name are combined into one cell\n"
+    "This value is used as the mode parameter for \\read_merged."
+  ) +
+  gsi::method ("RenameCell", &rename_cell,
+    "@brief Specifies that cells with the name of an existing cell are renamed\n"
+    "This value is used as the mode parameter for \\read_merged."
+  ),
+  "@brief A reader for multiple layout files\n"
+  "\n"
+  "This object reads a set of layout files concurrently, each one with a reader of its own. Hence the time required "
+  "is determined by the largest file rather than by the sum of all files. "
+  "The files can be read into separate layouts or merged into a single one.\n"
+  "\n"
+  "@code\n"
+  "layout_a = RBA::Layout::new\n"
+  "layout_b = RBA::Layout::new\n"
+  "reader = RBA::MultiFileReader::new\n"
+  "reader.add_file(\"a.gds\", layout_a)\n"
+  "reader.add_file(\"b.oas\", layout_b)\n"
+  "reader.read\n"
+  "@/code\n"
+  "\n"
+  "The layouts must not be used otherwise while the files are read.\n"
+  "\n"
+  "This class has been introduced in version 0.26."
+);
+
+}
+
@@ -1168,6 +1168,14 @@ Class<db::NetlistSpiceWriter> db_NetlistSpiceWriter (db_NetlistWriter, "db", "Ne
   ) +
   gsi::constructor ("new", &new_spice_writer2,
     "@brief Creates a new writer with a delegate.\n"
+  ) +
+  gsi::method ("threads=", &db::NetlistSpiceWriter::set_threads, gsi::arg ("n"),
+    "@brief Sets the number of threads to use for formatting the circuits\n"
+    "With a value larger than 0, the circuits are formatted in parallel and written in the original order. "
+    "Parallel formatting is only available without a delegate. The default is 0 (no parallel formatting).\n"
+  ) +
+  gsi::method ("threads", &db::NetlistSpiceWriter::threads,
+    "@brief Gets the number of threads to use for formatting the circuits\n"
   ),
   "@brief Implements a netlist writer for the SPICE format.\n"
   "Provide a delegate for customizing the way devices are written.\n"
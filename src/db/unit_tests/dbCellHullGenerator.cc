@@ -266,3 +266,60 @@ TEST(2)
 
 
 
+TEST(3_Occupancy)
+{
+  db::CellOccupancy occ (db::Box (0, 0, 1600, 1600), 16, 16);
+  EXPECT_EQ (occ.is_full (), false);
+  EXPECT_EQ (occ.touches (db::Box (0, 0, 1600, 1600)), false);
+
+  occ.add (db::Box (0, 0, 50, 50));
+  occ.add (db::Box (1500, 1500, 1600, 1600));
+
+  EXPECT_EQ (occ.touches (db::Box (0, 0, 10, 10)), true);
+  EXPECT_EQ (occ.touches (db::Box (300, 300, 1300, 1300)), false);
+  EXPECT_EQ (occ.touches (db::Box (1550, 1550, 1700, 1700)), true);
+  EXPECT_EQ (occ.touches (db::Box (1700, 1700, 1800, 1800)), false);
+
+  std::vector<db::Box> boxes;
+  occ.marked_boxes (boxes);
+  EXPECT_EQ (boxes.size (), size_t (2));
+  EXPECT_EQ (boxes [0].to_string (), "(0,0;100,100)");
+  EXPECT_EQ (boxes [1].to_string (), "(1500,1500;1600,1600)");
+
+  occ.add (db::Box (0, 0, 1600, 1600));
+  EXPECT_EQ (occ.is_full (), true);
+  EXPECT_EQ (occ.touches (db::Box (300, 300, 1300, 1300)), true);
+}
+
+TEST(4_OccupancyCache)
+{
+  db::Layout ly;
+  unsigned int l1 = ly.insert_layer (db::LayerProperties (1, 0));
+  unsigned int l2 = ly.insert_layer (db::LayerProperties (2, 0));
+
+  //  a "standard cell" with shapes in two corners only
+  db::Cell &c1 = ly.cell (ly.add_cell ("C1"));
+  c1.shapes (l1).insert (db::Box (0, 0, 100, 100));
+  c1.shapes (l1).insert (db::Box (1500, 1500, 1600, 1600));
+  c1.shapes (l2).insert (db::Box (0, 0, 1600, 1600));
+
+  db::Cell &top = ly.cell (ly.add_cell ("TOP"));
+  top.insert (db::CellInstArray (db::CellInst (c1.cell_index ()), db::Trans (db::Vector (1000, 0))));
+  top.insert (db::CellInstArray (db::CellInst (c1.cell_index ()), db::Trans (db::Trans::r90, db::Vector (0, 5000))));
+
+  db::CellOccupancyCache cache (ly);
+
+  EXPECT_EQ (cache.occupancy (c1.cell_index (), l1).box ().to_string (), "(0,0;1600,1600)");
+  EXPECT_EQ (cache.touches (c1.cell_index (), l1, db::Box (300, 300, 1300, 1300)), false);
+  EXPECT_EQ (cache.touches (c1.cell_index (), l2, db::Box (300, 300, 1300, 1300)), true);
+
+  //  the child cell's occupancy is carried over into the parent
+  EXPECT_EQ (cache.occupancy (top.cell_index (), l1).box ().to_string (), "(-1600,0;2600,6600)");
+  EXPECT_EQ (cache.touches (top.cell_index (), l1, db::Box (1050, 50, 1060, 60)), true);
+  EXPECT_EQ (cache.touches (top.cell_index (), l1, db::Box (1500, 500, 2000, 1000)), false);
+  EXPECT_EQ (cache.touches (top.cell_index (), l1, db::Box (-1550, 6550, -1540, 6560)), true);
+  EXPECT_EQ (cache.touches (top.cell_index (), l1, db::Box (-1000, 5500, -600, 6000)), false);
+
+  //  no shapes at all
+  EXPECT_EQ (cache.touches (top.cell_index (), ly.insert_layer (db::LayerProperties (3, 0)), db::Box (0, 0, 1000, 1000)), false);
+}
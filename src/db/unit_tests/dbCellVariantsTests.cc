@@ -370,6 +370,43 @@ TEST(9_ComplexGridVariants)
   EXPECT_EQ (var2str (vb.variants (d.cell_index ())), "");
 }
 
+TEST(10_LayerSpecificSeparation)
+{
+  db::Layout ly;
+  unsigned int l1 = ly.insert_layer (db::LayerProperties (1, 0));
+  unsigned int l2 = ly.insert_layer (db::LayerProperties (2, 0));
+
+  db::Cell &a = ly.cell (ly.add_cell ("A"));
+  db::Cell &b = ly.cell (ly.add_cell ("B"));
+  db::Cell &c = ly.cell (ly.add_cell ("C"));
+  db::Cell &d = ly.cell (ly.add_cell ("D"));
+
+  //  B (via C) has shapes on l1, D has shapes on l2 only
+  c.shapes (l1).insert (db::Box (0, 0, 100, 200));
+  d.shapes (l2).insert (db::Box (0, 0, 100, 200));
+
+  a.insert (db::CellInstArray (db::CellInst (b.cell_index ()), db::Trans (0, false, db::Vector (1, 10))));
+  a.insert (db::CellInstArray (db::CellInst (b.cell_index ()), db::Trans (0, true, db::Vector (1, 100))));
+  a.insert (db::CellInstArray (db::CellInst (d.cell_index ()), db::Trans (0, false, db::Vector (1, 1000))));
+  a.insert (db::CellInstArray (db::CellInst (d.cell_index ()), db::Trans (0, true, db::Vector (1, 1100))));
+  b.insert (db::CellInstArray (db::CellInst (c.cell_index ()), db::Trans (0, false, db::Vector (0, 0))));
+
+  db::OrientationReducer red;
+  db::cell_variants_collector<db::OrientationReducer> vb (red);
+  vb.collect (ly, a);
+  EXPECT_EQ (var2str (vb.variants (d.cell_index ())), "m0 *1 0,0[1];r0 *1 0,0[1]");
+
+  std::map<db::cell_index_type, std::map<db::ICplxTrans, db::cell_index_type> > vm;
+  vb.separate_variants (ly, a, l1, &vm);
+  EXPECT_EQ (vm2str (ly, vm), "B:B[m0 *1 0,0],B$VAR1[r0 *1 0,0];C:C[m0 *1 0,0],C$VAR1[r0 *1 0,0]");
+  EXPECT_EQ (inst2str (ly, a), "B$VAR1:r0 *1 1,10;B:m0 *1 1,100;D:r0 *1 1,1000;D:m0 *1 1,1100");
+
+  //  D does not need to be separated as it does not have shapes on l1
+  EXPECT_EQ (var2str (vb.variants (d.cell_index ())), "m0 *1 0,0[1]");
+  EXPECT_EQ (vb.created_variants (), size_t (2));
+  EXPECT_EQ (vb.avoided_variants (), size_t (1));
+}
+
 TEST(100_OrientationVariantsWithLayout)
 {
   db::Layout ly;
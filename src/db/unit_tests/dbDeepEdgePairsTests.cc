@@ -28,6 +28,9 @@
 #include "dbDeepShapeStore.h"
 #include "dbRegion.h"
 #include "dbEdges.h"
+#include "dbDeepEdgePairs.h"
+#include "dbDeepRegion.h"
+#include "dbCellVariants.h"
 #include "tlUnitTest.h"
 #include "tlStream.h"
 
@@ -103,3 +106,96 @@ TEST(1_Basics)
   CHECKPOINT();
   db::compare_layouts (_this, target, tl::testsrc () + "/testdata/algo/deep_edge_pairs_au1.gds");
 }
+
+namespace
+{
+
+struct EPLengthFilter
+  : public db::EdgePairFilterBase
+{
+  EPLengthFilter (db::Edge::distance_type l)
+    : m_length (l)
+  {
+    //  .. nothing yet ..
+  }
+
+  bool selected (const db::EdgePair &ep) const
+  {
+    return ep.first ().length () < m_length;
+  }
+
+  const db::TransformationReducer *vars () const
+  {
+    return &m_vars;
+  }
+
+private:
+  db::Edge::distance_type m_length;
+  db::MagnificationReducer m_vars;
+};
+
+}
+
+TEST(2_FilterAndPolygons)
+{
+  db::Layout ly;
+  {
+    std::string fn (tl::testsrc ());
+    fn += "/testdata/algo/deep_region_l1.gds";
+    tl::InputStream stream (fn);
+    db::Reader reader (stream);
+    reader.read (ly);
+  }
+
+  //  turn boxes into edge pairs to produce a test case
+  for (db::Layout::layer_iterator l = ly.begin_layers (); l != ly.end_layers (); ++l) {
+    for (db::Layout::iterator c = ly.begin (); c != ly.end (); ++c) {
+      db::Shapes out (ly.is_editable ());
+      db::Shapes &in = c->shapes ((*l).first);
+      for (db::Shapes::shape_iterator s = in.begin (db::ShapeIterator::All); !s.at_end (); ++s) {
+        if (s->is_box ()) {
+          db::Box b = s->box ();
+          db::EdgePair ep (db::Edge (b.p1 (), b.upper_left ()), db::Edge (b.p2 (), b.lower_right ()));
+          out.insert (ep);
+        }
+      }
+      in.swap (out);
+    }
+  }
+
+  db::cell_index_type top_cell_index = *ly.begin_top_down ();
+  db::Cell &top_cell = ly.cell (top_cell_index);
+
+  db::DeepShapeStore dss;
+
+  unsigned int l2 = ly.get_layer (db::LayerProperties (2, 0));
+
+  db::EdgePairs ep2 (db::RecursiveShapeIterator (ly, top_cell, l2), dss);
+  db::EdgePairs ep2_flat (db::RecursiveShapeIterator (ly, top_cell, l2));
+
+  //  filters stay hierarchical
+  EPLengthFilter f1 (1000);
+  db::EdgePairs ep2f = ep2.filtered (f1);
+  EXPECT_EQ (dynamic_cast<const db::DeepEdgePairs *> (ep2f.delegate ()) != 0, true);
+  EXPECT_EQ (ep2f.size (), ep2_flat.filtered (f1).size ());
+  EXPECT_EQ (ep2f.size (), ep2.size ());
+  EXPECT_EQ (ep2f.empty (), false);
+
+  EPLengthFilter f2 (900);
+  ep2f = ep2.filtered (f2);
+  EXPECT_EQ (dynamic_cast<const db::DeepEdgePairs *> (ep2f.delegate ()) != 0, true);
+  EXPECT_EQ (ep2f.empty (), true);
+
+  //  polygons are delivered as polygon references, so they can be used in deep operations
+  db::Region p2, p2_flat;
+  ep2.polygons (p2, 10);
+  ep2_flat.polygons (p2_flat, 10);
+  EXPECT_EQ (dynamic_cast<const db::DeepRegion *> (p2.delegate ()) != 0, true);
+  EXPECT_EQ ((p2 ^ p2_flat).empty (), true);
+
+  db::Region p2_other, p2_other_flat;
+  ep2.polygons (p2_other, 0);
+  ep2_flat.polygons (p2_other_flat, 0);
+  EXPECT_EQ ((p2 & p2_other).area (), (p2_flat & p2_other_flat).area ());
+  EXPECT_EQ ((p2 & p2_other).empty (), false);
+}
@@ -28,6 +28,7 @@
 #include "dbRegion.h"
 #include "dbEdgesUtils.h"
 #include "dbDeepShapeStore.h"
+#include "dbDeepEdges.h"
 #include "tlUnitTest.h"
 #include "tlStream.h"
 
@@ -435,3 +436,143 @@ TEST(9_DRCChecks)
   }
 }
 
+
+TEST(10_FlatOperands)
+{
+  db::Layout ly;
+  {
+    std::string fn (tl::testsrc ());
+    fn += "/testdata/algo/deep_region_l1.gds";
+    tl::InputStream stream (fn);
+    db::Reader reader (stream);
+    reader.read (ly);
+  }
+
+  db::cell_index_type top_cell_index = *ly.begin_top_down ();
+  db::Cell &top_cell = ly.cell (top_cell_index);
+
+  db::DeepShapeStore dss;
+
+  unsigned int l2 = ly.get_layer (db::LayerProperties (2, 0));
+  unsigned int l3 = ly.get_layer (db::LayerProperties (3, 0));
+
+  db::Region r2 (db::RecursiveShapeIterator (ly, top_cell, l2), dss);
+  db::Region r3 (db::RecursiveShapeIterator (ly, top_cell, l3), dss);
+  db::Region r2_flat (db::RecursiveShapeIterator (ly, top_cell, l2));
+
+  db::Edges e2 = r2.edges ();
+  db::Edges e3 = r3.edges ();
+  db::Edges e2_flat = r2_flat.edges ();
+
+  //  flat operands are brought into the hierarchy: results stay deep and match the all-deep results
+  db::Edges res;
+
+  res = e3 & r2_flat;
+  EXPECT_EQ (dynamic_cast<const db::DeepEdges *> (res.delegate ()) != 0, true);
+  EXPECT_EQ ((res ^ (e3 & r2)).empty (), true);
+  EXPECT_EQ (res.empty (), false);
+
+  res = e3 - r2_flat;
+  EXPECT_EQ (dynamic_cast<const db::DeepEdges *> (res.delegate ()) != 0, true);
+  EXPECT_EQ ((res ^ (e3 - r2)).empty (), true);
+
+  res = e3.inside_part (r2_flat);
+  EXPECT_EQ (dynamic_cast<const db::DeepEdges *> (res.delegate ()) != 0, true);
+  EXPECT_EQ ((res ^ e3.inside_part (r2)).empty (), true);
+
+  res = e3.outside_part (r2_flat);
+  EXPECT_EQ (dynamic_cast<const db::DeepEdges *> (res.delegate ()) != 0, true);
+  EXPECT_EQ ((res ^ e3.outside_part (r2)).empty (), true);
+
+  res = e3.selected_interacting (r2_flat);
+  EXPECT_EQ (dynamic_cast<const db::DeepEdges *> (res.delegate ()) != 0, true);
+  EXPECT_EQ ((res ^ e3.selected_interacting (r2)).empty (), true);
+
+  res = e3 & e2_flat;
+  EXPECT_EQ (dynamic_cast<const db::DeepEdges *> (res.delegate ()) != 0, true);
+  EXPECT_EQ ((res ^ (e3 & e2)).empty (), true);
+
+  res = e3 - e2_flat;
+  EXPECT_EQ (dynamic_cast<const db::DeepEdges *> (res.delegate ()) != 0, true);
+  EXPECT_EQ ((res ^ (e3 - e2)).empty (), true);
+
+  res = e3 ^ e2_flat;
+  EXPECT_EQ (dynamic_cast<const db::DeepEdges *> (res.delegate ()) != 0, true);
+  EXPECT_EQ ((res ^ (e3 ^ e2)).empty (), true);
+
+  //  empty operands: same as flat
+  EXPECT_EQ ((e3 & db::Region ()).empty (), true);
+  EXPECT_EQ ((e2_flat & db::Region ()).empty (), true);
+  EXPECT_EQ (e3.inside_part (db::Region ()).empty (), true);
+  EXPECT_EQ (e2_flat.inside_part (db::Region ()).empty (), true);
+  EXPECT_EQ ((e3 - db::Region ()).size (), e3.size ());
+  EXPECT_EQ (e3.outside_part (db::Region ()).size (), e3.size ());
+
+  //  a non-singular store can't take flat operands: the result is computed flat
+  db::Layout ly2 (ly);
+  db::Region r2_other (db::RecursiveShapeIterator (ly2, ly2.cell (top_cell_index), l2), dss);
+  EXPECT_EQ (dss.is_singular (), false);
+
+  res = e3 & r2_flat;
+  EXPECT_EQ (dynamic_cast<const db::DeepEdges *> (res.delegate ()) != 0, false);
+  EXPECT_EQ ((res ^ (e3 & r2)).empty (), true);
+
+  res = e3 - e2_flat;
+  EXPECT_EQ (dynamic_cast<const db::DeepEdges *> (res.delegate ()) != 0, false);
+  EXPECT_EQ ((res ^ (e3 - e2)).empty (), true);
+
+  res = e3.selected_interacting (r2_flat);
+  EXPECT_EQ (dynamic_cast<const db::DeepEdges *> (res.delegate ()) != 0, false);
+  EXPECT_EQ (res.empty (), false);
+  EXPECT_EQ ((res ^ e3.selected_interacting (r2)).empty (), true);
+}
+
+TEST(11_MergedEdgesOfCopies)
+{
+  db::Layout ly;
+  {
+    std::string fn (tl::testsrc ());
+    fn += "/testdata/algo/deep_region_l1.gds";
+    tl::InputStream stream (fn);
+    db::Reader reader (stream);
+    reader.read (ly);
+  }
+
+  db::cell_index_type top_cell_index = *ly.begin_top_down ();
+  db::Cell &top_cell = ly.cell (top_cell_index);
+
+  db::DeepShapeStore dss;
+
+  unsigned int l2 = ly.get_layer (db::LayerProperties (2, 0));
+  unsigned int l3 = ly.get_layer (db::LayerProperties (3, 0));
+
+  db::Edges e2 = db::Region (db::RecursiveShapeIterator (ly, top_cell, l2), dss).edges ();
+  db::Edges e3 = db::Region (db::RecursiveShapeIterator (ly, top_cell, l3), dss).edges ();
+
+  db::Edges e3_merged = e3.merged ();
+  size_t n3 = e3_merged.size ();
+  EXPECT_EQ (n3 > 0, true);
+
+  //  the merged edges of a copy must not change when the original is modified in place
+
+  {
+    db::Edges a = e3;
+    a.merge ();
+    db::Edges b = a;
+    a += e2;
+    EXPECT_EQ (b.merged ().size (), n3);
+    EXPECT_EQ ((b.merged () ^ e3_merged).empty (), true);
+  }
+
+  {
+    //  not merged, so the merged edges are a separate layer
+    db::Edges a = e3;
+    a += e3;
+    EXPECT_EQ (a.merged ().size (), n3);
+    db::Edges b = a;
+    a.merge ();
+    a += e2;
+    EXPECT_EQ (b.merged ().size (), n3);
+    EXPECT_EQ ((b.merged () ^ e3_merged).empty (), true);
+  }
+}
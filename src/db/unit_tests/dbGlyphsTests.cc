@@ -0,0 +1,274 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2019 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+
+#include "dbGlyphs.h"
+#include "dbHershey.h"
+#include "dbLayout.h"
+#include "dbRegion.h"
+#include "dbEdges.h"
+#include "dbRecursiveShapeIterator.h"
+#include "tlUnitTest.h"
+#include "tlThreads.h"
+
+static db::TextGenerator std_font ()
+{
+  db::TextGenerator gen;
+  gen.load_from_file (tl::testsrc () + "/src/db/db/std_font.gds");
+  return gen;
+}
+
+static db::Region flat_region (const db::Layout &layout, const db::Cell &cell, unsigned int layer)
+{
+  db::Region r (db::RecursiveShapeIterator (layout, cell, layer));
+  r.merge ();
+  return r;
+}
+
+static db::Edges flat_edges (const db::Layout &layout, const db::Cell &cell, unsigned int layer)
+{
+  return db::Edges (db::RecursiveShapeIterator (layout, cell, layer));
+}
+
+//  TextGenerator basics and the scaled glyph cache
+TEST(1)
+{
+  db::TextGenerator gen = std_font ();
+
+  EXPECT_EQ (gen.name (), "std_font");
+  EXPECT_EQ (gen.width (), 600);
+  EXPECT_EQ (gen.height (), 800);
+
+  EXPECT_EQ (gen.text_as_region ("HO", 0.01, 1.0, false, 0.0, 0.0, 0.0).to_string (), "(0,0;0,70;10,70;10,40;40,40;40,70;50,70;50,0;40,0;40,30;10,30;10,0);(70,0;60,10;60,60;70,70;100,70;110,60;110,35;100,35;100,55;95,60;75,60;70,55;70,15;75,10;95,10;100,15;100,35;110,35;110,10;100,0)");
+  //  second time from the cache
+  EXPECT_EQ (gen.text_as_region ("HO", 0.01, 1.0, false, 0.0, 0.0, 0.0).to_string (), "(0,0;0,70;10,70;10,40;40,40;40,70;50,70;50,0;40,0;40,30;10,30;10,0);(70,0;60,10;60,60;70,70;100,70;110,60;110,35;100,35;100,55;95,60;75,60;70,55;70,15;75,10;95,10;100,15;100,35;110,35;110,10;100,0)");
+  EXPECT_EQ (gen.text_as_region ("H", 0.01, 2.0, false, 0.0, 0.0, 0.0).to_string (), "(0,0;0,140;20,140;20,80;80,80;80,140;100,140;100,0;80,0;80,60;20,60;20,0)");
+  EXPECT_EQ (gen.text_as_region ("--\\n--", 0.01, 1.0, false, 0.0, 0.1, 0.1).to_string (), "(5,30;5,40;45,40;45,30);(75,30;75,40;115,40;115,30);(5,-60;5,-50;45,-50;45,-60);(75,-60;75,-50;115,-50;115,-60)");
+
+  db::TextGenerator gen2 = gen;
+  EXPECT_EQ (gen2.text_as_region ("H", 0.01, 1.0, false, 0.0, 0.0, 0.0).to_string (), "(0,0;0,70;10,70;10,40;40,40;40,70;50,70;50,0;40,0;40,30;10,30;10,0)");
+}
+
+//  Glyph cells for TextGenerator fonts
+TEST(2)
+{
+  db::TextGenerator gen = std_font ();
+
+  db::Layout layout;
+  layout.dbu (0.01);
+  unsigned int l1 = layout.insert_layer (db::LayerProperties (1, 0));
+  db::Cell &top = layout.cell (layout.add_cell ("TOP"));
+
+  db::GlyphCellLibrary lib (layout, l1);
+  lib.text (gen, "HOH O\\nOH", 1.0, 0.1, 0.0, top);
+
+  //  one cell per glyph, blanks are not instantiated
+  EXPECT_EQ (lib.size (), size_t (3));
+  EXPECT_EQ (layout.cells (), size_t (3));
+  EXPECT_EQ (top.cell_instances (), size_t (6));
+  EXPECT_EQ (top.shapes (l1).empty (), true);
+  EXPECT_EQ (layout.cell_name (lib.glyph_cell (gen, 'H', 1.0)), std::string ("GLYPH_std_font_072"));
+  EXPECT_EQ (layout.cells (), size_t (3));
+
+  db::Region ref = gen.text_as_region ("HOH O\\nOH", 0.01, 1.0, false, 0.0, 0.1, 0.0);
+  ref.merge ();
+  EXPECT_EQ (flat_region (layout, top, l1).to_string (), ref.to_string ());
+
+  //  flat mode produces the same result without new cells
+  db::Cell &flat = layout.cell (layout.add_cell ("FLAT"));
+  lib.text (gen, "HOH O\\nOH", 1.0, 0.1, 0.0, flat, db::Trans (), true);
+  EXPECT_EQ (layout.cells (), size_t (4));
+  EXPECT_EQ (flat.cell_instances (), size_t (0));
+  EXPECT_EQ (flat_region (layout, flat, l1).to_string (), ref.to_string ());
+
+  //  a different size gives new glyph cells
+  db::Cell &big = layout.cell (layout.add_cell ("BIG"));
+  lib.text (gen, "HO", 2.0, 0.0, 0.0, big, db::Trans (1, false, db::Vector (1000, 0)));
+  EXPECT_EQ (lib.size (), size_t (5));
+  EXPECT_EQ (layout.cells (), size_t (7));
+  EXPECT_EQ (flat_region (layout, big, l1).to_string (), gen.text_as_region ("HO", 0.01, 2.0, false, 0.0, 0.0, 0.0).transformed (db::Trans (1, false, db::Vector (1000, 0))).merged ().to_string ());
+}
+
+//  Glyph cells for Hershey fonts
+TEST(3)
+{
+  db::Layout layout;
+  layout.dbu (0.001);
+  unsigned int l1 = layout.insert_layer (db::LayerProperties (1, 0));
+  db::Cell &top = layout.cell (layout.add_cell ("TOP"));
+  db::Cell &flat = layout.cell (layout.add_cell ("FLAT"));
+
+  db::GlyphCellLibrary lib (layout, l1);
+
+  //  stroke edges
+  lib.hershey_text (db::DefaultFont, "ABBA\nAB", 1.0, 0.0, top);
+  lib.hershey_text (db::DefaultFont, "ABBA\nAB", 1.0, 0.0, flat, db::Trans (), true);
+
+  EXPECT_EQ (lib.size (), size_t (2));
+  EXPECT_EQ (layout.cells (), size_t (4));
+  EXPECT_EQ (top.cell_instances (), size_t (6));
+  EXPECT_EQ (layout.cell_name (lib.hershey_glyph_cell (db::DefaultFont, 'A', 1.0, 0.0)), std::string ("HERSHEY0_065"));
+
+  db::Edges e1 = flat_edges (layout, top, l1);
+  db::Edges e2 = flat_edges (layout, flat, l1);
+  EXPECT_EQ (e1.size (), db::hershey_count_edges ("ABBA\nAB", 0));
+  EXPECT_EQ (e1.to_string (1000), e2.to_string (1000));
+
+  //  same extension than a Hershey text object of the same size
+  db::Hershey h ("ABBA\nAB", db::DefaultFont);
+  h.justify (db::Box (0, 0, 0, 1000), db::HAlignLeft, db::VAlignBottom);
+  db::Box hbox;
+  for (db::Hershey::edge_iterator e = h.begin_edges (); ! e.at_end (); ++e) {
+    hbox += (*e).bbox ();
+  }
+  db::Box bx = e1.bbox ();
+  EXPECT_EQ (std::abs (bx.left () - hbox.left ()) <= 1, true);
+  EXPECT_EQ (std::abs (bx.right () - hbox.right ()) <= 1, true);
+  EXPECT_EQ (std::abs (bx.bottom () - hbox.bottom ()) <= 1, true);
+  EXPECT_EQ (std::abs (bx.top () - hbox.top ()) <= 1, true);
+
+  //  stroke polygons
+  db::Cell &top2 = layout.cell (layout.add_cell ("TOP2"));
+  db::Cell &flat2 = layout.cell (layout.add_cell ("FLAT2"));
+  lib.hershey_text (db::DefaultFont, "ABBA\nAB", 1.0, 0.1, top2, db::Trans (db::Vector (0, 5000)));
+  lib.hershey_text (db::DefaultFont, "ABBA\nAB", 1.0, 0.1, flat2, db::Trans (db::Vector (0, 5000)), true);
+
+  EXPECT_EQ (lib.size (), size_t (4));
+  EXPECT_EQ (layout.cells (), size_t (8));
+  const db::Shapes &gs = layout.cell (lib.hershey_glyph_cell (db::DefaultFont, 'A', 1.0, 0.1)).shapes (l1);
+  EXPECT_EQ (gs.begin (db::ShapeIterator::Edges).at_end (), true);
+  EXPECT_EQ (gs.begin (db::ShapeIterator::Polygons).at_end (), false);
+
+  db::Region r1 = flat_region (layout, top2, l1);
+  EXPECT_EQ (r1.empty (), false);
+  EXPECT_EQ (r1.to_string (1000), flat_region (layout, flat2, l1).to_string (1000));
+  EXPECT_EQ (bx.moved (db::Vector (0, 5000)).inside (r1.bbox ().enlarged (db::Vector (-50, -50))), true);
+}
+
+//  Layout lifetime and target checks
+TEST(5)
+{
+  db::Layout other;
+  other.insert_layer (db::LayerProperties (1, 0));
+  db::Cell &other_top = other.cell (other.add_cell ("TOP"));
+
+  std::auto_ptr<db::Layout> layout (new db::Layout ());
+  unsigned int l1 = layout->insert_layer (db::LayerProperties (1, 0));
+
+  db::GlyphCellLibrary lib (*layout, l1);
+
+  //  instances can only be placed into the library's layout
+  try {
+    lib.hershey_text (db::DefaultFont, "AB", 1.0, 0.0, other_top);
+    EXPECT_EQ (true, false);
+  } catch (tl::Exception &ex) {
+    EXPECT_EQ (ex.msg (), "The target cell must be a cell of the glyph cell library's layout unless 'flat' is true");
+  }
+  EXPECT_EQ (other_top.cell_instances (), size_t (0));
+
+  //  flat output is possible into any layout
+  lib.hershey_text (db::DefaultFont, "AB", 1.0, 0.0, other_top, db::Trans (), true);
+  EXPECT_EQ (other_top.shapes (l1).empty (), false);
+
+  EXPECT_EQ (&lib.layout () == layout.get (), true);
+
+  layout.reset (0);
+
+  try {
+    lib.hershey_glyph_cell (db::DefaultFont, 'A', 1.0, 0.0);
+    EXPECT_EQ (true, false);
+  } catch (tl::Exception &ex) {
+    EXPECT_EQ (ex.msg (), "The layout of the glyph cell library has been destroyed");
+  }
+}
+
+namespace
+{
+
+class TextThread
+  : public tl::Thread
+{
+public:
+  TextThread (const db::TextGenerator *gen, const std::string *text, const std::vector<std::vector<db::Polygon> > *ref, int offset)
+    : mp_gen (gen), mp_text (text), mp_ref (ref), m_offset (offset), m_ok (true)
+  {
+    //  .. nothing yet ..
+  }
+
+  void run ()
+  {
+    std::vector<db::Polygon> data;
+    for (size_t i = 0; i < mp_ref->size (); ++i) {
+      size_t n = (i + m_offset) % mp_ref->size ();
+      mp_gen->text (*mp_text, 0.01, 1.0 + 0.1 * n, false, 0.0, 0.0, 0.0, data);
+      if (data != (*mp_ref) [n]) {
+        m_ok = false;
+      }
+    }
+  }
+
+  bool ok () const
+  {
+    return m_ok;
+  }
+
+private:
+  const db::TextGenerator *mp_gen;
+  const std::string *mp_text;
+  const std::vector<std::vector<db::Polygon> > *mp_ref;
+  int m_offset;
+  bool m_ok;
+};
+
+}
+
+//  Concurrent use of the scaled glyph cache, including clearing it when it is full
+TEST(4)
+{
+  db::TextGenerator gen = std_font ();
+
+  std::string text;
+  for (char c = 32; c < 127; ++c) {
+    if (c != '\\') {
+      text += c;
+    }
+  }
+
+  //  more glyph variants than the cache holds
+  std::vector<std::vector<db::Polygon> > ref (200);
+  for (size_t n = 0; n < ref.size (); ++n) {
+    gen.text (text, 0.01, 1.0 + 0.1 * n, false, 0.0, 0.0, 0.0, ref [n]);
+  }
+
+  std::vector<TextThread *> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.push_back (new TextThread (&gen, &text, &ref, i * 50));
+  }
+  for (std::vector<TextThread *>::const_iterator t = threads.begin (); t != threads.end (); ++t) {
+    (*t)->start ();
+  }
+  for (std::vector<TextThread *>::const_iterator t = threads.begin (); t != threads.end (); ++t) {
+    (*t)->wait ();
+    EXPECT_EQ ((*t)->ok (), true);
+    delete *t;
+  }
+}
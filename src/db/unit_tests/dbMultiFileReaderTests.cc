@@ -0,0 +1,276 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2019 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+
+#include "dbMultiFileReader.h"
+#include "dbLayout.h"
+#include "dbWriter.h"
+#include "dbSaveLayoutOptions.h"
+#include "dbReader.h"
+#include "dbLibrary.h"
+#include "dbLibraryManager.h"
+#include "tlUnitTest.h"
+#include "tlStream.h"
+
+#include <map>
+
+static void write_layout (db::Layout &layout, const std::string &fn)
+{
+  db::SaveLayoutOptions options;
+  options.set_format ("GDS2");
+  db::Writer writer (options);
+  tl::OutputStream stream (fn);
+  writer.write (layout, stream);
+}
+
+static std::string make_file (tl::TestBase *_this, const std::string &fn, const char *child_name, double dbu, int layer)
+{
+  db::Layout layout;
+  layout.dbu (dbu);
+  unsigned int l = layout.insert_layer (db::LayerProperties (layer, 0));
+
+  db::Cell &top = layout.cell (layout.add_cell ("TOP"));
+  db::Cell &child = layout.cell (layout.add_cell (child_name));
+  child.shapes (l).insert (db::Box (0, 0, 100, 200));
+  top.insert (db::CellInstArray (db::CellInst (child.cell_index ()), db::Trans (db::Vector (1000, 0))));
+
+  std::string path = _this->tmp_file (fn);
+  write_layout (layout, path);
+  return path;
+}
+
+static std::string layout_summary (const db::Layout &layout)
+{
+  //  sorted by cell name
+  std::map<std::string, std::string> cells;
+  for (db::Layout::const_iterator c = layout.begin (); c != layout.end (); ++c) {
+
+    std::string s;
+    for (db::Layout::layer_iterator l = layout.begin_layers (); l != layout.end_layers (); ++l) {
+      for (db::Shapes::shape_iterator sh = c->shapes ((*l).first).begin (db::ShapeIterator::All); ! sh.at_end (); ++sh) {
+        s += (*l).second->to_string () + ":" + sh->to_string () + ",";
+      }
+    }
+    for (db::Cell::const_iterator i = c->begin (); ! i.at_end (); ++i) {
+      s += std::string (layout.cell_name (i->cell_index ())) + ":" + i->cell_inst ().front ().to_string () + ",";
+    }
+
+    cells [layout.cell_name (c->cell_index ())] = s;
+
+  }
+
+  std::string s;
+  for (std::map<std::string, std::string>::const_iterator c = cells.begin (); c != cells.end (); ++c) {
+    s += c->first + "[" + c->second + "]";
+  }
+  return s;
+}
+
+TEST(1_SeparateLayouts)
+{
+  std::string fa = make_file (_this, "tmp_mfr_a.gds", "A", 0.001, 1);
+  std::string fb = make_file (_this, "tmp_mfr_b.gds", "B", 0.001, 2);
+
+  db::Layout la, lb;
+
+  db::MultiFileReader reader;
+  reader.add_file (fa, &la);
+  reader.add_file (fb, &lb);
+  EXPECT_EQ (reader.files (), size_t (2));
+  reader.read ();
+
+  EXPECT_EQ (reader.format (0), "GDS2");
+  EXPECT_EQ (reader.format (1), "GDS2");
+  EXPECT_EQ (reader.layer_map (1).mapping_str (0), "2/0 : 2/0");
+
+  EXPECT_EQ (layout_summary (la), "A[1/0:box (0,0;100,200),]TOP[A:r0 1000,0,]");
+  EXPECT_EQ (layout_summary (lb), "B[2/0:box (0,0;100,200),]TOP[B:r0 1000,0,]");
+
+  //  single-threaded gives the same result
+  db::Layout la2, lb2;
+  db::MultiFileReader reader2;
+  reader2.set_threads (1);
+  reader2.add_file (fa, &la2);
+  reader2.add_file (fb, &lb2);
+  reader2.read ();
+
+  EXPECT_EQ (layout_summary (la2), layout_summary (la));
+  EXPECT_EQ (layout_summary (lb2), layout_summary (lb));
+}
+
+TEST(2_Errors)
+{
+  std::string fa = make_file (_this, "tmp_mfr_a.gds", "A", 0.001, 1);
+
+  db::Layout la, lb;
+
+  db::MultiFileReader reader;
+  reader.add_file (fa, &la);
+  reader.add_file (_this->tmp_file ("doesnotexist.gds"), &lb);
+
+  bool error = false;
+  try {
+    reader.read ();
+  } catch (tl::Exception &) {
+    error = true;
+  }
+  EXPECT_EQ (error, true);
+
+  //  the good file has been read nevertheless
+  EXPECT_EQ (layout_summary (la), "A[1/0:box (0,0;100,200),]TOP[A:r0 1000,0,]");
+
+  //  a file without a layout cannot be read with "read"
+  db::MultiFileReader reader2;
+  reader2.add_file (fa);
+  error = false;
+  try {
+    reader2.read ();
+  } catch (tl::Exception &) {
+    error = true;
+  }
+  EXPECT_EQ (error, true);
+}
+
+TEST(3_Merged)
+{
+  std::string fa = make_file (_this, "tmp_mfr_a.gds", "A", 0.001, 1);
+  std::string fb = make_file (_this, "tmp_mfr_b.gds", "A", 0.001, 2);
+  std::string fc = make_file (_this, "tmp_mfr_c.gds", "C", 0.01, 1);
+
+  {
+    db::Layout layout;
+    db::MultiFileReader reader;
+    reader.add_file (fa);
+    reader.add_file (fb);
+    reader.add_file (fc);
+    reader.read_merged (layout, db::MultiFileReader::AddToCell);
+
+    EXPECT_EQ (layout.dbu (), 0.001);
+    EXPECT_EQ (layout_summary (layout),
+      "A[1/0:box (0,0;100,200),2/0:box (0,0;100,200),]"
+      "C[1/0:box (0,0;1000,2000),]"
+      "TOP[A:r0 1000,0,A:r0 1000,0,C:r0 10000,0,]"
+    );
+  }
+
+  {
+    db::Layout layout;
+    db::MultiFileReader reader;
+    reader.add_file (fa);
+    reader.add_file (fb);
+    reader.add_file (fc);
+    reader.read_merged (layout, db::MultiFileReader::RenameCell);
+
+    EXPECT_EQ (layout_summary (layout),
+      "A[1/0:box (0,0;100,200),]"
+      "A$1[2/0:box (0,0;100,200),]"
+      "C[1/0:box (0,0;1000,2000),]"
+      "TOP[A:r0 1000,0,]"
+      "TOP$1[A$1:r0 1000,0,]"
+      "TOP$2[C:r0 10000,0,]"
+    );
+  }
+
+  {
+    //  merging into a non-empty layout: the dbu of the layout is kept
+    db::Layout layout;
+    layout.dbu (0.0005);
+    unsigned int l = layout.insert_layer (db::LayerProperties (2, 0));
+    db::Cell &a = layout.cell (layout.add_cell ("A"));
+    a.shapes (l).insert (db::Box (0, 0, 10, 10));
+
+    db::MultiFileReader reader;
+    reader.add_file (fb);
+    reader.read_merged (layout);
+
+    EXPECT_EQ (layout.dbu (), 0.0005);
+    EXPECT_EQ (layout_summary (layout),
+      "A[2/0:box (0,0;10,10),2/0:box (0,0;200,400),]"
+      "TOP[A:r0 2000,0,]"
+    );
+  }
+}
+
+TEST(4_LibraryProxies)
+{
+  db::Library *lib = new db::Library ();
+  lib->set_name ("MFR_LIB");
+  unsigned int ll = lib->layout ().insert_layer (db::LayerProperties (1, 0));
+  db::cell_index_type lib_cell = lib->layout ().add_cell ("LIBCELL");
+  lib->layout ().cell (lib_cell).shapes (ll).insert (db::Box (0, 0, 50, 50));
+  db::LibraryManager::instance ().register_lib (lib);
+
+  try {
+
+    std::string fn = _this->tmp_file ("tmp_mfr_lib.gds");
+
+    {
+      db::Layout layout;
+      layout.dbu (0.001);
+      db::Cell &top = layout.cell (layout.add_cell ("TOP"));
+      db::cell_index_type lp = layout.get_lib_proxy (lib, lib_cell);
+      top.insert (db::CellInstArray (db::CellInst (lp), db::Trans (db::Vector (100, 0))));
+      write_layout (layout, fn);
+    }
+
+    //  with deferred proxy recovery, the reader leaves the proxies to restore_deferred_proxies
+    {
+      db::Layout layout;
+      tl::InputStream stream (fn);
+      db::Reader reader (stream);
+      reader.set_defer_proxy_recovery (true);
+      reader.read (layout);
+
+      std::pair<bool, db::cell_index_type> lc = layout.cell_by_name ("LIBCELL");
+      EXPECT_EQ (lc.first, true);
+      EXPECT_EQ (layout.cell (lc.second).is_proxy (), false);
+
+      reader.restore_deferred_proxies (layout);
+
+      lc = layout.cell_by_name ("LIBCELL");
+      EXPECT_EQ (lc.first, true);
+      EXPECT_EQ (layout.cell (lc.second).is_proxy (), true);
+      EXPECT_EQ (layout.display_name (lc.second), "MFR_LIB.LIBCELL");
+    }
+
+    {
+      db::Layout la, lb;
+      db::MultiFileReader reader;
+      reader.add_file (fn, &la);
+      reader.add_file (fn, &lb);
+      reader.read ();
+
+      EXPECT_EQ (layout_summary (la), "LIBCELL[1/0:box (0,0;50,50),]TOP[LIBCELL:r0 100,0,]");
+      EXPECT_EQ (layout_summary (lb), layout_summary (la));
+
+      std::pair<bool, db::cell_index_type> lc = lb.cell_by_name ("LIBCELL");
+      EXPECT_EQ (lc.first, true);
+      EXPECT_EQ (lb.display_name (lc.second), "MFR_LIB.LIBCELL");
+    }
+
+    db::LibraryManager::instance ().delete_lib (lib);
+
+  } catch (...) {
+    db::LibraryManager::instance ().delete_lib (lib);
+    throw;
+  }
+}
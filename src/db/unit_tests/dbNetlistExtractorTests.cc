@@ -576,7 +576,8 @@ all_net_names_unique (const db::Netlist &nl)
   return true;
 }
 
-TEST(3_DeviceAndNetExtractionWithImplicitConnections)
+static void
+run_implicit_connections_test (tl::TestBase *_this, unsigned int threads)
 {
   db::Layout ly;
   db::LayerMap lmap;
@@ -613,6 +614,7 @@ TEST(3_DeviceAndNetExtractionWithImplicitConnections)
   db::DeepShapeStore dss;
   dss.set_text_enlargement (1);
   dss.set_text_property_name (tl::Variant ("LABEL"));
+  dss.set_threads (threads);
 
   //  original layers
   db::Region rnwell (db::RecursiveShapeIterator (ly, tc, nwell), dss);
@@ -789,3 +791,14 @@ TEST(3_DeviceAndNetExtractionWithImplicitConnections)
   db::compare_layouts (_this, ly, au);
 }
 
+TEST(3_DeviceAndNetExtractionWithImplicitConnections)
+{
+  run_implicit_connections_test (_this, 1);
+}
+
+//  Same as TEST(3), but resolves the labels with multiple threads
+TEST(4_DeviceAndNetExtractionWithImplicitConnectionsMultiThreaded)
+{
+  run_implicit_connections_test (_this, 4);
+}
+
@@ -761,6 +761,25 @@ TEST(8_WriterSubcircuits)
                                tl::absolute_file_path (path),
                                tl::absolute_file_path (au_path)));
   }
+
+  //  parallel formatting of the circuits gives the same result
+
+  std::string path_mt = tmp_file ("tmp_nwriter8_mt.txt");
+  {
+    tl::OutputStream stream (path_mt);
+    db::NetlistSpiceWriter writer;
+    writer.set_threads (2);
+    writer.write (stream, nl, "written by unit test");
+  }
+
+  tl::InputStream is_mt (path_mt);
+  tl::InputStream is_au_mt (au_path);
+
+  if (is_mt.read_all () != is_au_mt.read_all ()) {
+    _this->raise (tl::sprintf ("Compare failed - see\n  actual: %s\n  golden: %s",
+                               tl::absolute_file_path (path_mt),
+                               tl::absolute_file_path (au_path)));
+  }
 }
 
 TEST(10_WriterLongLines)
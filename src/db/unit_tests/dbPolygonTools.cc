@@ -28,6 +28,8 @@
 #include "dbPolygonGenerators.h"
 #include "tlUnitTest.h"
 
+#include <cmath>
+
 TEST(1) 
 {
   db::Box box (0, 0, 1000, 1000);
@@ -2258,3 +2260,85 @@ TEST(404)
     EXPECT_EQ (sp[1].to_string (), "(0,832;176,874;390,925)");
   }
 }
+
+namespace
+{
+
+db::Polygon make_wiggly_ring (int n, db::Coord r1, db::Coord r2, db::Coord a)
+{
+  std::vector<db::Point> hull, hole;
+  for (int i = 0; i < n; ++i) {
+    double phi = 2.0 * M_PI * i / n;
+    double w = (i % 2) ? a : 0.0;
+    hull.push_back (db::Point (db::coord_traits<db::Coord>::rounded ((r2 + w) * cos (phi)), db::coord_traits<db::Coord>::rounded ((r2 + w) * sin (phi))));
+    hole.push_back (db::Point (db::coord_traits<db::Coord>::rounded ((r1 - w) * cos (phi)), db::coord_traits<db::Coord>::rounded ((r1 - w) * sin (phi))));
+  }
+
+  db::Polygon poly;
+  poly.assign_hull (hull.begin (), hull.end ());
+  poly.insert_hole (hole.begin (), hole.end ());
+  return poly;
+}
+
+//  Returns the parts of the XOR between sliced and unsliced sizing which are thicker than 2 dbu
+std::string sliced_sizing_deviation (const db::Polygon &poly, db::Coord d, unsigned int mode, int threads, size_t &nslices)
+{
+  std::vector<db::Polygon> slices;
+  nslices = 0;
+  if (! db::size_polygon_sliced (poly, d, d, mode, 500, slices, threads)) {
+    return "not sliced";
+  }
+  nslices = slices.size ();
+
+  db::EdgeProcessor ep;
+
+  std::vector<db::Polygon> ref;
+  ep.size (std::vector<db::Polygon> (1, poly), d, d, ref, mode, false, true);
+
+  std::vector<db::Polygon> res;
+  ep.merge (slices, res, 0, false, true);
+
+  std::vector<db::Polygon> x;
+  ep.boolean (ref, res, x, db::BooleanOp::Xor, false, true);
+
+  //  The only deviations allowed are the slivers created by rounding the points where
+  //  the tile borders cut the edges. These are less than one dbu wide.
+  std::vector<db::Polygon> xs;
+  ep.size (x, -1, -1, xs, 2, false, true);
+
+  std::string r;
+  for (std::vector<db::Polygon>::const_iterator p = xs.begin (); p != xs.end (); ++p) {
+    if (! r.empty ()) {
+      r += ";";
+    }
+    r += p->to_string ();
+  }
+  return r;
+}
+
+}
+
+//  sliced sizing of big polygons
+TEST(500)
+{
+  db::Polygon poly = make_wiggly_ring (10000, 1000000, 1200000, 500);
+  EXPECT_EQ (poly.vertices (), size_t (20000));
+
+  size_t nslices = 0;
+
+  //  too few vertices for slicing
+  std::vector<db::Polygon> out;
+  EXPECT_EQ (db::size_polygon_sliced (poly, 100, 100, 2, 100000, out), false);
+  EXPECT_EQ (out.empty (), true);
+
+  //  anisotropic sizing with different signs is not sliced
+  EXPECT_EQ (db::size_polygon_sliced (poly, 100, -100, 2, 500, out), false);
+
+  EXPECT_EQ (sliced_sizing_deviation (poly, 2000, 2, 0, nslices), "");
+  EXPECT_EQ (nslices > 1, true);
+  EXPECT_EQ (sliced_sizing_deviation (poly, 2000, 2, 2, nslices), "");
+  EXPECT_EQ (sliced_sizing_deviation (poly, -2000, 2, 0, nslices), "");
+  EXPECT_EQ (sliced_sizing_deviation (poly, -2000, 0, 2, nslices), "");
+  EXPECT_EQ (sliced_sizing_deviation (poly, 5000, 0, 0, nslices), "");
+  EXPECT_EQ (sliced_sizing_deviation (poly, 5000, 3, 0, nslices), "");
+}
@@ -3309,6 +3309,54 @@ TEST(23)
   EXPECT_EQ (shapes_to_string_norm (_this, s2), "edge_pair (0,0;1,1)/(10,10;11,11) #17\n");
 }
 
+//  compaction of fragmented shape containers
+TEST(24)
+{
+  db::Manager m;
+  db::Shapes s (&m, 0, true);
+
+  std::vector<db::Shape> shapes;
+  for (int i = 0; i < 100; ++i) {
+    shapes.push_back (s.insert (db::Box (i * 100, 0, i * 100 + 50, 50)));
+  }
+
+  EXPECT_EQ (s.fragmentation (), 0.0);
+  EXPECT_EQ (s.compact (), false);
+
+  for (int i = 0; i < 100; ++i) {
+    if (i % 10 != 5) {
+      s.erase_shape (shapes [i]);
+    }
+  }
+  shapes.clear ();
+
+  s.update ();
+  EXPECT_EQ (s.fragmentation () > 0.85, true);
+  EXPECT_EQ (s.compact (0.95), false);
+  EXPECT_EQ (s.compact (0.5), true);
+  EXPECT_EQ (s.fragmentation (), 0.0);
+  EXPECT_EQ (s.size (), size_t (10));
+
+  //  the box tree is remapped - no re-sorting required
+  size_t n = 0;
+  for (db::ShapeIterator si = s.begin_touching (db::Box (2000, 0, 4000, 100), db::ShapeIterator::All); ! si.at_end (); ++si) {
+    EXPECT_EQ (si->box ().left () % 1000, 500);
+    ++n;
+  }
+  EXPECT_EQ (n, size_t (2));
+
+  n = 0;
+  for (db::ShapeIterator si = s.begin (db::ShapeIterator::All); ! si.at_end (); ++si) {
+    ++n;
+  }
+  EXPECT_EQ (n, size_t (10));
+
+  s.insert (db::Box (0, 1000, 100, 1100));
+  s.update ();
+  s.update_bbox ();
+  EXPECT_EQ (s.bbox (), db::Box (0, 0, 9550, 1100));
+}
+
 //  Bug #107
 TEST(100)
 {
@@ -22,6 +22,7 @@
 
 
 #include "dbWriterTools.h"
+#include "dbLayout.h"
 #include "tlUnitTest.h"
 
 TEST(1) 
@@ -93,4 +94,46 @@ TEST(1)
   EXPECT_EQ (m.cell_name (304), "0BCDEFGH$1");
 }
 
-
+//  register_new_layers
+TEST(2)
+{
+  db::Layout layout;
+  std::vector<std::pair<unsigned int, db::LayerProperties> > layers;
+
+  //  named layers don't take the numbers of numbered layers registered at the same time
+  unsigned int named = layout.insert_layer (db::LayerProperties ("NAMED"));
+  unsigned int l1 = layout.insert_layer (db::LayerProperties (1, 0));
+  db::register_new_layers (layout, layers);
+
+  EXPECT_EQ (layers.size (), size_t (2));
+  EXPECT_EQ (layers [0].first, named);
+  EXPECT_EQ (layers [0].second.to_string (), "NAMED (2/0)");
+  EXPECT_EQ (layers [1].first, l1);
+  EXPECT_EQ (layers [1].second.to_string (), "1/0");
+
+  //  registered layers keep their numbers
+  unsigned int l5 = layout.insert_layer (db::LayerProperties (5, 1));
+  unsigned int named2 = layout.insert_layer (db::LayerProperties ("NAMED2"));
+  db::register_new_layers (layout, layers);
+
+  EXPECT_EQ (layers.size (), size_t (4));
+  EXPECT_EQ (layers [0].second.to_string (), "NAMED (2/0)");
+  EXPECT_EQ (layers [2].first, l5);
+  EXPECT_EQ (layers [2].second.to_string (), "5/1");
+  EXPECT_EQ (layers [3].first, named2);
+  EXPECT_EQ (layers [3].second.to_string (), "NAMED2 (6/0)");
+
+  //  a numbered layer may use a datatype other than the one of a named layer
+  layout.insert_layer (db::LayerProperties (2, 1));
+  db::register_new_layers (layout, layers);
+  EXPECT_EQ (layers.size (), size_t (5));
+
+  //  but a numbered layer must not collide with a number given to a named layer
+  layout.insert_layer (db::LayerProperties (2, 0));
+  try {
+    db::register_new_layers (layout, layers);
+    EXPECT_EQ (true, false);
+  } catch (tl::Exception &ex) {
+    EXPECT_EQ (ex.msg (), "Layer 2/0 uses the number already given to a named layer - create numbered layers before named ones");
+  }
+}
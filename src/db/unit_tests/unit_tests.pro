@@ -69,7 +69,9 @@ SOURCES = \
     dbNetlistWriterTests.cc \
     dbCellVariantsTests.cc \
     dbDeepEdgesTests.cc \
-    dbDeepEdgePairsTests.cc
+    dbDeepEdgePairsTests.cc \
+    dbMultiFileReaderTests.cc \
+    dbGlyphsTests.cc
 
 INCLUDEPATH += $$TL_INC $$DB_INC $$GSI_INC
 DEPENDPATH += $$TL_INC $$DB_INC $$GSI_INC
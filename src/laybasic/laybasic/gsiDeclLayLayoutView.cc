@@ -305,6 +305,11 @@ static void save_image_with_options (lay::LayoutView *view, const std::string &f
   view->save_image_with_options (fn, width, height, linewidth, oversampling, resolution, QColor (), QColor (), QColor (), target_box, monochrome); 
 }
 
+static size_t save_tiles (lay::LayoutView *view, const std::string &dir, unsigned int max_level, unsigned int tile_size, unsigned int min_level, int oversampling, int linewidth, int threads, const db::DBox &region)
+{
+  return view->save_tiles (dir, max_level, tile_size, min_level, oversampling, linewidth, threads, region);
+}
+
 static std::vector<std::string> 
 get_config_names (lay::LayoutView *view)
 {
@@ -940,6 +945,28 @@ Class<lay::LayoutView> decl_LayoutView (QT_EXTERNAL_BASE (QWidget) "lay", "Layou
     "\n"
     "This method has been introduced in 0.23.10.\n"
   ) +
+  gsi::method_ext ("save_tiles", &save_tiles, gsi::arg ("dir"), gsi::arg ("max_level"), gsi::arg ("tile_size", (unsigned int) 256), gsi::arg ("min_level", (unsigned int) 0), gsi::arg ("oversampling", 0), gsi::arg ("linewidth", 0), gsi::arg ("threads", 0), gsi::arg ("region", db::DBox (), "empty box"),
+    "@brief Saves the layout as a pyramid of PNG map tiles\n"
+    "\n"
+    "@param dir The directory to which to write the tiles.\n"
+    "@param max_level The highest level to render.\n"
+    "@param tile_size The width and height of a tile in pixels.\n"
+    "@param min_level The lowest level to render.\n"
+    "@param oversampling The oversampling factor (1..3) or 0 for default.\n"
+    "@param linewidth The width of a line in pixels (usually 1) or 0 for default.\n"
+    "@param threads The number of threads to use or 0 for the number of drawing workers.\n"
+    "@param region The region to render or an empty box for the full layout.\n"
+    "@return The number of tiles written.\n"
+    "\n"
+    "The tiles are written in the \"XYZ\" scheme used by web map viewers: on level z, the region is covered by "
+    "2^z x 2^z square tiles and the tile at column x and row y (counted from the top) is written to \"dir/z/x/y.png\". "
+    "Tiles completely outside the region are not written. "
+    "The layers are drawn in parallel and the drawing caches are kept while the tiles of one level are drawn. "
+    "The tiles are written by separate threads. "
+    "This method does not require a visible view, so it can be used in batch mode (\"klayout -z\").\n"
+    "\n"
+    "This method has been introduced in version 0.26.\n"
+  ) +
   gsi::method_ext ("#save_as", &save_as2, gsi::arg ("index"), gsi::arg ("filename"), gsi::arg ("gzip"), gsi::arg ("options"),
     "@brief Saves a layout to the given stream file\n"
     "\n"
@@ -24,6 +24,7 @@
 #include "layBitmap.h"
 #include "layBitmapRenderer.h"
 #include "layFixedFont.h"
+#include "layGlyphAtlas.h"
 #include "tlAlgorithm.h"
 
 namespace lay {
@@ -284,7 +285,7 @@ Bitmap::fill_pattern (int y, int x, const uint32_t *pp, unsigned int stride, uns
         return;
       }
       n -= y - m_height + 1;
-      pp += y - m_height + 1;
+      pp += (y - m_height + 1) * stride;
       y = m_height - 1;
     }
 
@@ -298,10 +299,12 @@ Bitmap::fill_pattern (int y, int x, const uint32_t *pp, unsigned int stride, uns
 
         if (x1 < 0) {
           if (x1 <= -32) {
-            return;
+            continue;
           }
           p >>= (unsigned int)-x1;
           x1 = 0;
+        } else if (x1 >= int (m_width)) {
+          continue;
         }
 
         if (p) {
@@ -760,7 +763,7 @@ Bitmap::render_contour (std::vector<lay::RenderEdge> &edges)
   }
 }
 
-static unsigned char next_char_latin1_from_utf8 (const char *&cp, const char *cpf = 0)
+unsigned char next_char_latin1_from_utf8 (const char *&cp, const char *cpf)
 {
   unsigned char c = *cp;
   if ((c & 0xe0) == 0xc0) {
@@ -796,84 +799,14 @@ Bitmap::render_text (const lay::RenderText &text)
 
     const lay::FixedFont &ff = lay::FixedFont::get_font (m_resolution);
 
-    //  count the lines and max. characters per line
+    std::vector<lay::GlyphAtlas::Placement> placements;
+    db::Box bbox;
+    lay::GlyphAtlas::place_fixed (text, m_resolution, placements, bbox);
 
-    unsigned int lines = 1;
-    for (const char *cp = text.text.c_str (); *cp; ++cp) {
-      if (*cp == '\012' || *cp == '\015') {
-        if (*cp == '\015' && cp[1] == '\012') {
-          ++cp;
-        }
-        ++lines;
-      }
-    }
-
-    //  compute the actual top left position
-    double y;
-    if (text.valign == db::VAlignBottom || text.valign == db::NoVAlign) {
-      y = text.b.bottom ();
-      y += double (ff.line_height () * (lines - 1) + ff.height ());
-    } else if (text.valign == db::VAlignCenter) {
-      y = text.b.center ().y ();
-      y += double ((ff.line_height () * (lines - 1) + ff.height ()) / 2);
-    } else {
-      y = text.b.top ();
-    }
-
-    //  start generating the characters
-
-    const char *cp1 = text.text.c_str ();
-    while (*cp1) {
-
-      unsigned int length = 0;
-      const char *cp = cp1; 
-      while (*cp && *cp != '\012' && *cp != '\015') {
-        next_char_latin1_from_utf8 (cp);
-        ++length;
-        ++cp; 
+    for (std::vector<lay::GlyphAtlas::Placement>::const_iterator p = placements.begin (); p != placements.end (); ++p) {
+      if (p->y >= 0 && p->y < int (height () + ff.height ()) - 1 && p->x >= -100 && p->x < int (width ())) {
+        fill_pattern (p->y, p->x, p->data, p->stride, p->height);
       }
-
-      double xx;
-      if (text.halign == db::HAlignRight) {
-        xx = text.b.right ();
-        xx -= double (ff.width () * length);
-      } else if (text.halign == db::HAlignCenter) {
-        xx = text.b.center ().x ();
-        xx -= double (ff.width () * length / 2);
-      } else {
-        xx = text.b.left ();
-      }
-      xx -= 0.5;
-
-      if (y > -0.5 && y < double (height () + ff.height () - 1) - 0.5) {
-
-        for ( ; cp1 != cp; ++cp1) {
-
-          unsigned char c = next_char_latin1_from_utf8 (cp1, cp);
-
-          size_t cc = c; // to suppress a compiler warning ..
-          if (c >= ff.first_char () && cc < size_t (ff.n_chars ()) + size_t (ff.first_char ())
-              && xx > -100.0 && xx < double (width ())) {
-            fill_pattern (int (y + 0.5), int (floor (xx)), ff.data () + (c - ff.first_char ()) * ff.height () * ff.stride (), ff.stride (), ff.height ());
-          }
-
-          xx += double (ff.width ());
-
-        }
-
-      } else {
-        cp1 = cp;
-      }
-
-      //  next line
-      if (*cp1 == '\012' || *cp1 == '\015') {
-        if (*cp1 == '\015' && cp1[1] == '\012') {
-          ++cp1;
-        }
-        ++cp1;
-        y -= double (ff.line_height ());
-      }
-
     }
 
   } else {
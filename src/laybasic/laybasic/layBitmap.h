@@ -117,6 +117,15 @@ private:
   double m_slope;
 };
 
+/**
+ *  @brief Gets the next character of an UTF-8 string as Latin-1 character
+ *
+ *  "cp" is advanced to the last byte of the character. "cpf" is the end of the
+ *  string (0 for a zero-terminated string). Characters outside the Latin-1
+ *  range are delivered as "?".
+ */
+LAYBASIC_PUBLIC unsigned char next_char_latin1_from_utf8 (const char *&cp, const char *cpf = 0);
+
 /**
  *  @brief A rendered text object
  */
@@ -299,18 +308,6 @@ public:
    */
   virtual void render_vertices (std::vector<lay::RenderEdge> &edges, int mode);
 
-private:
-  unsigned int m_width;
-  unsigned int m_height;
-  double m_resolution;
-  std::vector<uint32_t *> m_scanlines;
-  std::vector<uint32_t *> m_free;
-  uint32_t *m_empty_scanline;
-  unsigned int m_first_sl, m_last_sl;
-
-  void cleanup ();
-  void init (unsigned int w, unsigned int h);
-
   /**
    *  @brief Fill a bit pattern 
    *
@@ -328,6 +325,19 @@ private:
    *  @param n The height (number of lines)
    */
   void fill_pattern (int y, int x, const uint32_t *p, unsigned int stride, unsigned int n);
+
+private:
+  unsigned int m_width;
+  unsigned int m_height;
+  double m_resolution;
+  std::vector<uint32_t *> m_scanlines;
+  std::vector<uint32_t *> m_free;
+  uint32_t *m_empty_scanline;
+  unsigned int m_first_sl, m_last_sl;
+
+  void cleanup ();
+  void init (unsigned int w, unsigned int h);
+
 };
 
 inline bool
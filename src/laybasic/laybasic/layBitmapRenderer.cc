@@ -211,12 +211,88 @@ BitmapRenderer::add_xfill ()
   }
 }
 
-void 
+static bool
+is_occupied (const lay::Bitmap *bitmap, const db::Box &box)
+{
+  db::Box b = box & db::Box (0, 0, bitmap->width () - 1, bitmap->height () - 1);
+  if (b.empty ()) {
+    return false;
+  }
+
+  unsigned int x1 = (unsigned int) b.left (), x2 = (unsigned int) b.right ();
+  unsigned int w1 = x1 / 32, w2 = x2 / 32;
+  uint32_t m1 = (uint32_t) 0xffffffff << (x1 % 32);
+  uint32_t m2 = (uint32_t) 0xffffffff >> (31 - x2 % 32);
+
+  for (unsigned int y = (unsigned int) b.bottom (); y <= (unsigned int) b.top (); ++y) {
+
+    if (bitmap->is_scanline_empty (y)) {
+      continue;
+    }
+
+    const uint32_t *sl = bitmap->scanline (y);
+    if (w1 == w2) {
+      if ((sl [w1] & m1 & m2) != 0) {
+        return true;
+      }
+    } else {
+      if ((sl [w1] & m1) != 0 || (sl [w2] & m2) != 0) {
+        return true;
+      }
+      for (unsigned int w = w1 + 1; w < w2; ++w) {
+        if (sl [w] != 0) {
+          return true;
+        }
+      }
+    }
+
+  }
+
+  return false;
+}
+
+static void
+occupy (lay::Bitmap *bitmap, const db::Box &box)
+{
+  db::Box b = box & db::Box (0, 0, bitmap->width () - 1, bitmap->height () - 1);
+  if (! b.empty ()) {
+    for (unsigned int y = (unsigned int) b.bottom (); y <= (unsigned int) b.top (); ++y) {
+      bitmap->fill (y, (unsigned int) b.left (), (unsigned int) b.right () + 1);
+    }
+  }
+}
+
+void
 BitmapRenderer::render_texts (lay::CanvasPlane &plane)
 {
   lay::Bitmap *bitmap = static_cast<lay::Bitmap *> (&plane);
+
+  if (! mp_label_occupancy) {
+    for (std::vector<lay::RenderText>::const_iterator t = m_texts.begin (); t != m_texts.end (); ++t) {
+      bitmap->render_text (*t);
+    }
+    return;
+  }
+
+  db::Box window (0, 0, bitmap->width () - 1, bitmap->height () - 1);
+
   for (std::vector<lay::RenderText>::const_iterator t = m_texts.begin (); t != m_texts.end (); ++t) {
-    bitmap->render_text (*t);
+
+    db::Box tb = m_glyph_atlas.place (*t, bitmap->resolution (), m_placements);
+
+    //  skip texts outside the bitmap
+    if (tb.empty () || ! tb.touches (window)) {
+      continue;
+    }
+
+    //  skip texts overlapping others (keeping a gap of one pixel)
+    if (is_occupied (mp_label_occupancy, tb.enlarged (db::Vector (1, 1)))) {
+      continue;
+    }
+
+    occupy (mp_label_occupancy, tb);
+    lay::GlyphAtlas::render (m_placements, *bitmap);
+
   }
 }
 
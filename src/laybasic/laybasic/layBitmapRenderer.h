@@ -27,6 +27,7 @@
 
 #include "layRenderer.h"
 #include "layBitmap.h"
+#include "layGlyphAtlas.h"
 
 namespace lay
 {
@@ -150,6 +151,9 @@ public:
 
   /**
    *  @brief Render the texts of the object to the bitmap
+   *
+   *  If a label occupancy bitmap is set (see Renderer::set_label_occupancy),
+   *  the texts are culled, decimated and rendered from the glyph atlas.
    */
   void render_texts (lay::CanvasPlane &bitmap);
 
@@ -321,6 +325,8 @@ private:
   double m_xmin, m_xmax, m_ymin, m_ymax;
   bool m_ortho;
   std::vector<lay::RenderText> m_texts;
+  lay::GlyphAtlas m_glyph_atlas;
+  std::vector<lay::GlyphAtlas::Placement> m_placements;
 
   template <class Box, class Trans> bool simplify_box (Box &, const Trans &);
   static void render_dot (double x, double y, lay::CanvasPlane *plane);
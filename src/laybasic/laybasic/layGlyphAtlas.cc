@@ -0,0 +1,314 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2019 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+
+
+#include "layGlyphAtlas.h"
+#include "layBitmap.h"
+#include "layBitmapRenderer.h"
+#include "layFixedFont.h"
+#include "dbHershey.h"
+
+#include <cmath>
+
+namespace lay
+{
+
+//  the maximum number of glyphs kept in the atlas
+const size_t max_glyphs = 10000;
+
+// ---------------------------------------------------------------------------------
+//  GlyphAtlas implementation
+
+bool
+GlyphAtlas::GlyphKey::operator< (const GlyphKey &other) const
+{
+  if (font != other.font) {
+    return font < other.font;
+  }
+  if (c != other.c) {
+    return c < other.c;
+  }
+  if (rot != other.rot) {
+    return rot < other.rot;
+  }
+  if (scale != other.scale) {
+    return scale < other.scale;
+  }
+  return resolution < other.resolution;
+}
+
+GlyphAtlas::GlyphAtlas ()
+{
+  //  .. nothing yet ..
+}
+
+void
+GlyphAtlas::clear ()
+{
+  m_glyphs.clear ();
+}
+
+db::Box
+GlyphAtlas::place (const lay::RenderText &text, double resolution, std::vector<Placement> &placements)
+{
+  placements.clear ();
+
+  //  limit the memory used - the placements are invalidated here anyway
+  if (m_glyphs.size () > max_glyphs) {
+    m_glyphs.clear ();
+  }
+
+  db::Box bbox;
+  if (text.font == db::DefaultFont) {
+    place_fixed (text, resolution, placements, bbox);
+  } else {
+    place_hershey (text, resolution, placements, bbox);
+  }
+
+  return bbox;
+}
+
+void
+GlyphAtlas::place_fixed (const lay::RenderText &text, double resolution, std::vector<Placement> &placements, db::Box &bbox)
+{
+  const lay::FixedFont &ff = lay::FixedFont::get_font (resolution);
+
+  //  count the lines
+
+  unsigned int lines = 1;
+  for (const char *cp = text.text.c_str (); *cp; ++cp) {
+    if (*cp == '\012' || *cp == '\015') {
+      if (*cp == '\015' && cp[1] == '\012') {
+        ++cp;
+      }
+      ++lines;
+    }
+  }
+
+  //  compute the actual top left position
+  double y;
+  if (text.valign == db::VAlignBottom || text.valign == db::NoVAlign) {
+    y = text.b.bottom ();
+    y += double (ff.line_height () * (lines - 1) + ff.height ());
+  } else if (text.valign == db::VAlignCenter) {
+    y = text.b.center ().y ();
+    y += double ((ff.line_height () * (lines - 1) + ff.height ()) / 2);
+  } else {
+    y = text.b.top ();
+  }
+
+  const char *cp1 = text.text.c_str ();
+  while (*cp1) {
+
+    unsigned int length = 0;
+    const char *cp = cp1;
+    while (*cp && *cp != '\012' && *cp != '\015') {
+      next_char_latin1_from_utf8 (cp);
+      ++length;
+      ++cp;
+    }
+
+    double xx;
+    if (text.halign == db::HAlignRight) {
+      xx = text.b.right ();
+      xx -= double (ff.width () * length);
+    } else if (text.halign == db::HAlignCenter) {
+      xx = text.b.center ().x ();
+      xx -= double (ff.width () * length / 2);
+    } else {
+      xx = text.b.left ();
+    }
+    xx -= 0.5;
+
+    int iy = int (y + 0.5);
+
+    for ( ; cp1 != cp; ++cp1) {
+
+      unsigned char c = next_char_latin1_from_utf8 (cp1, cp);
+
+      size_t cc = c; // to suppress a compiler warning ..
+      if (c >= ff.first_char () && cc < size_t (ff.n_chars ()) + size_t (ff.first_char ())) {
+
+        Placement p;
+        p.x = int (floor (xx));
+        p.y = iy;
+        p.height = ff.height ();
+        p.stride = ff.stride ();
+        p.data = ff.data () + (c - ff.first_char ()) * ff.height () * ff.stride ();
+        placements.push_back (p);
+
+        bbox += db::Box (p.x, iy - int (ff.height ()) + 1, p.x + int (ff.width ()) - 1, iy);
+
+      }
+
+      xx += double (ff.width ());
+
+    }
+
+    //  next line
+    if (*cp1 == '\012' || *cp1 == '\015') {
+      if (*cp1 == '\015' && cp1[1] == '\012') {
+        ++cp1;
+      }
+      ++cp1;
+      y -= double (ff.line_height ());
+    }
+
+  }
+}
+
+void
+GlyphAtlas::place_hershey (const lay::RenderText &text, double resolution, std::vector<Placement> &placements, db::Box &bbox)
+{
+  //  NOTE: this follows the implementation of Bitmap::render_text
+
+  db::DHershey ht (text.text, text.font);
+  ht.justify (text.b.transformed (text.trans.inverted ()), text.halign, text.valign);
+
+  //  text becomes unreadable at a low scaling factor - don't draw then.
+  double scale = ht.scale_factor ();
+  if (scale <= 0.2) {
+    return;
+  }
+
+  const std::vector<db::DPoint> &line_starts = ht.line_starts ();
+  if (line_starts.empty ()) {
+    return;
+  }
+
+  size_t line = 0;
+  db::DPoint pos = line_starts.front ();
+
+  for (const char *cp = text.text.c_str (); *cp; ++cp) {
+
+    unsigned char c = (unsigned char) *cp;
+
+    if (c == '\012' || c == '\015') {
+
+      if (c == '\015' && cp[1] == '\012') {
+        ++cp;
+      }
+
+      ++line;
+      pos = line_starts [std::min (line, line_starts.size () - 1)];
+
+    } else {
+
+      const Glyph &g = hershey_glyph (text.font, c, scale, text.trans, resolution);
+
+      if (g.height > 0) {
+
+        db::DVector o = text.trans (db::DVector (pos.x () * scale, pos.y () * scale));
+        int ox = int (floor (o.x () + 0.5));
+        int oy = int (floor (o.y () + 0.5));
+
+        Placement p;
+        p.x = ox + g.x0;
+        p.y = oy + g.y0 + int (g.height) - 1;
+        p.height = g.height;
+        p.stride = g.stride;
+        p.data = &g.data.front ();
+        placements.push_back (p);
+
+        bbox += db::Box (p.x, oy + g.y0, p.x + int (g.width) - 1, p.y);
+
+      }
+
+      pos += db::DVector (g.advance, 0.0);
+
+    }
+
+  }
+}
+
+const GlyphAtlas::Glyph &
+GlyphAtlas::hershey_glyph (db::Font font, unsigned char c, double scale, db::DFTrans trans, double resolution)
+{
+  GlyphKey key (font, c, trans.rot (), scale, resolution);
+
+  std::map<GlyphKey, Glyph>::iterator g = m_glyphs.find (key);
+  if (g != m_glyphs.end ()) {
+    return g->second;
+  }
+
+  Glyph &glyph = m_glyphs.insert (std::make_pair (key, Glyph ())).first->second;
+
+  std::string s (1, char (c));
+  glyph.advance = db::hershey_text_box (s, (unsigned int) font).width ();
+  glyph.x0 = glyph.y0 = 0;
+  glyph.width = glyph.height = glyph.stride = 0;
+
+  //  collect the edges of the glyph with the origin at 0,0
+  db::DHershey hc (s, font);
+  hc.scale (scale);
+
+  std::vector<db::DEdge> edges;
+  db::DBox gbox;
+  for (db::DHershey::edge_iterator e = hc.begin_edges (); ! e.at_end (); ++e) {
+    edges.push_back ((*e).transformed (trans));
+    gbox += edges.back ().bbox ();
+  }
+
+  if (edges.empty ()) {
+    return glyph;
+  }
+
+  //  rasterize the glyph with one pixel of margin
+  glyph.x0 = int (floor (gbox.left () + 0.5)) - 1;
+  glyph.y0 = int (floor (gbox.bottom () + 0.5)) - 1;
+  glyph.width = (unsigned int) (int (floor (gbox.right () + 0.5)) + 2 - glyph.x0);
+  glyph.height = (unsigned int) (int (floor (gbox.top () + 0.5)) + 2 - glyph.y0);
+  glyph.stride = (glyph.width + 31) / 32;
+
+  lay::Bitmap bitmap (glyph.width, glyph.height, resolution);
+  lay::BitmapRenderer hr (glyph.width, glyph.height, resolution);
+  hr.reserve_edges (edges.size ());
+
+  db::DVector d (-glyph.x0, -glyph.y0);
+  for (std::vector<db::DEdge>::const_iterator e = edges.begin (); e != edges.end (); ++e) {
+    hr.insert (e->moved (d));
+  }
+
+  hr.render_contour (bitmap);
+
+  //  store the pattern, top row first
+  const lay::Bitmap &cbitmap = bitmap;
+  glyph.data.reserve (glyph.height * glyph.stride);
+  for (unsigned int y = glyph.height; y > 0; --y) {
+    const uint32_t *sl = cbitmap.scanline (y - 1);
+    glyph.data.insert (glyph.data.end (), sl, sl + glyph.stride);
+  }
+
+  return glyph;
+}
+
+void
+GlyphAtlas::render (const std::vector<Placement> &placements, lay::Bitmap &bitmap)
+{
+  for (std::vector<Placement>::const_iterator p = placements.begin (); p != placements.end (); ++p) {
+    bitmap.fill_pattern (p->y, p->x, p->data, p->stride, p->height);
+  }
+}
+
+}
+
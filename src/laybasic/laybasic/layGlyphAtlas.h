@@ -0,0 +1,150 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2019 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+
+
+#ifndef HDR_layGlyphAtlas
+#define HDR_layGlyphAtlas
+
+#include "laybasicCommon.h"
+#include "dbBox.h"
+#include "dbText.h"
+#include "dbTrans.h"
+
+#include <map>
+#include <vector>
+#include <stdint.h>
+
+namespace lay {
+
+class Bitmap;
+struct RenderText;
+
+/**
+ *  @brief A cache of pre-rasterized glyphs
+ *
+ *  The glyph atlas provides bitmap glyphs for rendering texts. For the default
+ *  font, these are the glyphs of the fixed font. For the Hershey fonts, the
+ *  glyphs are rasterized once per font, size and orientation and kept in the
+ *  atlas. A text is then rendered by placing the glyph bitmaps.
+ *
+ *  For Hershey fonts, the glyph origins are snapped to the pixel grid. Hence
+ *  the glyphs may be displaced by up to half a pixel compared to
+ *  lay::Bitmap::render_text.
+ *
+ *  The atlas is not thread-safe. Each renderer holds its own atlas.
+ */
+class LAYBASIC_PUBLIC GlyphAtlas
+{
+public:
+  /**
+   *  @brief A glyph placed on the bitmap
+   *
+   *  "x" is the leftmost pixel and "y" the top scanline of the glyph pattern.
+   *  The pattern consists of "height" rows of "stride" words each, top row first.
+   */
+  struct Placement
+  {
+    int x, y;
+    unsigned int height, stride;
+    const uint32_t *data;
+  };
+
+  /**
+   *  @brief Default constructor
+   */
+  GlyphAtlas ();
+
+  /**
+   *  @brief Clears the atlas
+   */
+  void clear ();
+
+  /**
+   *  @brief Gets the number of cached glyphs
+   */
+  size_t size () const
+  {
+    return m_glyphs.size ();
+  }
+
+  /**
+   *  @brief Computes the glyph placements for the given text
+   *
+   *  @param text The text to render
+   *  @param resolution The resolution of the target bitmap (selects the fixed font)
+   *  @param placements Receives the placements
+   *  @return The box of pixels covered by the text (inclusive coordinates). The box is empty if nothing is drawn.
+   *
+   *  The placements refer to the glyphs of the atlas. They are valid until the next call of "place" or "clear".
+   */
+  db::Box place (const lay::RenderText &text, double resolution, std::vector<Placement> &placements);
+
+  /**
+   *  @brief Renders the placements to the given bitmap
+   */
+  static void render (const std::vector<Placement> &placements, lay::Bitmap &bitmap);
+
+  /**
+   *  @brief Computes the glyph placements for a text in the default (fixed) font
+   *
+   *  The placements are appended to "placements" and "bbox" is enlarged by the
+   *  pixels covered. The glyphs are taken from the fixed font directly, so
+   *  this method does not need an atlas. This layout is shared with lay::Bitmap::render_text.
+   */
+  static void place_fixed (const lay::RenderText &text, double resolution, std::vector<Placement> &placements, db::Box &bbox);
+
+private:
+  struct GlyphKey
+  {
+    GlyphKey (db::Font _font, unsigned char _c, int _rot, double _scale, double _resolution)
+      : font (_font), c (_c), rot (_rot), scale (_scale), resolution (_resolution)
+    {
+      //  .. nothing yet ..
+    }
+
+    bool operator< (const GlyphKey &other) const;
+
+    db::Font font;
+    unsigned char c;
+    int rot;
+    double scale, resolution;
+  };
+
+  struct Glyph
+  {
+    int x0, y0;
+    unsigned int width, height, stride;
+    double advance;
+    std::vector<uint32_t> data;
+  };
+
+  std::map<GlyphKey, Glyph> m_glyphs;
+
+  const Glyph &hershey_glyph (db::Font font, unsigned char c, double scale, db::DFTrans trans, double resolution);
+  void place_hershey (const lay::RenderText &text, double resolution, std::vector<Placement> &placements, db::Box &bbox);
+};
+
+}
+
+#endif
+
@@ -778,6 +778,15 @@ LayoutCanvas::image (unsigned int width, unsigned int height)
 
 QImage 
 LayoutCanvas::image_with_options (unsigned int width, unsigned int height, int linewidth, int oversampling, double resolution, QColor background, QColor foreground, QColor active, const db::DBox &target_box, bool is_mono) 
+{
+  BitmapRedrawThreadCanvas rd_canvas;
+  lay::RedrawThread redraw_thread (&rd_canvas, mp_view);
+
+  return image_with_options (width, height, linewidth, oversampling, resolution, background, foreground, active, target_box, is_mono, redraw_thread, rd_canvas, 0 /*synchroneous*/);
+}
+
+QImage 
+LayoutCanvas::image_with_options (unsigned int width, unsigned int height, int linewidth, int oversampling, double resolution, QColor background, QColor foreground, QColor active, const db::DBox &target_box, bool is_mono, lay::RedrawThread &redraw_thread, lay::BitmapRedrawThreadCanvas &rd_canvas, int workers) 
 {
   if (oversampling <= 0) {
     oversampling = m_oversampling;
@@ -813,8 +822,7 @@ LayoutCanvas::image_with_options (unsigned int width, unsigned int height, int l
     img.fill (background.rgb ());
   }
 
-  //  provide canvas objects for the layout bitmaps and the foreground/background objects
-  BitmapRedrawThreadCanvas rd_canvas;
+  //  provide a canvas object for the foreground/background objects
   DetachedViewObjectCanvas vo_canvas (background, foreground, active, width * oversampling, height * oversampling, resolution, &img);
 
   //  compute the new viewport 
@@ -832,10 +840,9 @@ LayoutCanvas::image_with_options (unsigned int width, unsigned int height, int l
     }
   }
 
-  lay::RedrawThread redraw_thread (&rd_canvas, mp_view);
-
   //  render the layout
-  redraw_thread.start (0 /*synchroneous*/, m_layers, vp, resolution, true);
+  redraw_thread.start (workers, m_layers, vp, resolution, true);
+  redraw_thread.wait ();
   redraw_thread.stop (); // safety
 
   //  paint the background objects. It uses "img" to paint on.
@@ -169,6 +169,16 @@ public:
   QImage image (unsigned int width, unsigned int height);
   QImage image_with_options (unsigned int width, unsigned int height, int linewidth, int oversampling, double resolution, QColor background, QColor foreground, QColor active_color, const db::DBox &target_box, bool monochrome);
 
+  /**
+   *  @brief Gets an image using the given redraw thread
+   *
+   *  This version allows drawing a series of images with the same redraw thread
+   *  and hence with the same drawing caches (see RedrawThread::set_keep_caches).
+   *  "redraw_thread" must have been created with "rd_canvas". "workers" is the
+   *  number of drawing threads - 0 for synchronous drawing.
+   */
+  QImage image_with_options (unsigned int width, unsigned int height, int linewidth, int oversampling, double resolution, QColor background, QColor foreground, QColor active_color, const db::DBox &target_box, bool monochrome, lay::RedrawThread &redraw_thread, lay::BitmapRedrawThreadCanvas &rd_canvas, int workers);
+
   void update_image ();
 
   virtual void paintEvent (QPaintEvent *);
@@ -64,6 +64,7 @@
 #include "layBrowser.h"
 #include "layRedrawThread.h"
 #include "layRedrawThreadWorker.h"
+#include "layTileRenderer.h"
 #include "layParsedLayerSource.h"
 #include "layBookmarkManagementForm.h"
 #include "dbLayout.h"
@@ -379,7 +380,9 @@ LayoutView::init (db::Manager *mgr, lay::PluginRoot *root, QWidget * /*parent*/)
   m_text_visible = true;
   m_default_font_size = lay::FixedFont::default_font_size ();
   m_text_lazy_rendering = true;
+  m_text_label_culling = false;
   m_bitmap_caching = true;
+  m_multi_layer_redraw = false;
   m_show_properties = false;
   m_apply_text_trans = true;
   m_default_text_size = 0.1;
@@ -1137,6 +1140,13 @@ LayoutView::configure (const std::string &name, const std::string &value)
     bitmap_caching (flag);
     return true;
 
+  } else if (name == cfg_multi_layer_redraw) {
+
+    bool flag;
+    tl::from_string (value, flag);
+    multi_layer_redraw (flag);
+    return true;
+
   } else if (name == cfg_text_lazy_rendering) {
 
     bool flag;
@@ -1144,6 +1154,13 @@ LayoutView::configure (const std::string &name, const std::string &value)
     text_lazy_rendering (flag);
     return true;
 
+  } else if (name == cfg_text_label_culling) {
+
+    bool flag;
+    tl::from_string (value, flag);
+    text_label_culling (flag);
+    return true;
+
   } else if (name == cfg_show_properties) {
 
     bool flag;
@@ -2803,6 +2820,20 @@ LayoutView::save_image_with_options (const std::string &fn,
   tl::log << "Saved screen shot to " << fn;
 }
 
+size_t
+LayoutView::save_tiles (const std::string &dir, unsigned int max_level, unsigned int tile_size, unsigned int min_level, int oversampling, int linewidth, int threads, const db::DBox &region)
+{
+  lay::TileRenderer renderer (this, mp_canvas);
+  renderer.set_tile_size (tile_size);
+  renderer.set_levels (min_level, max_level);
+  renderer.set_oversampling (oversampling);
+  renderer.set_linewidth (linewidth);
+  renderer.set_threads (threads);
+  renderer.set_region (region);
+
+  return renderer.render (dir);
+}
+
 void
 LayoutView::reload_layout (unsigned int cv_index)
 {
@@ -4839,6 +4870,15 @@ LayoutView::bitmap_caching (bool l)
   }
 }
 
+void 
+LayoutView::multi_layer_redraw (bool l)
+{
+  if (m_multi_layer_redraw != l) {
+    m_multi_layer_redraw = l;
+    redraw ();
+  }
+}
+
 void 
 LayoutView::text_lazy_rendering (bool l)
 {
@@ -4848,6 +4888,15 @@ LayoutView::text_lazy_rendering (bool l)
   }
 }
 
+void 
+LayoutView::text_label_culling (bool l)
+{
+  if (m_text_label_culling != l) {
+    m_text_label_culling = l;
+    redraw ();
+  }
+}
+
 void 
 LayoutView::cell_box_visible (bool vis)
 {
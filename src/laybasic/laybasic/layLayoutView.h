@@ -848,6 +848,24 @@ public:
    */
   void save_image_with_options (const std::string &fn, unsigned int width, unsigned int height, int linewidth, int oversampling, double resolution, QColor background, QColor foreground, QColor active_color, const db::DBox &target_box, bool monochrome);
 
+  /**
+   *  @brief Save the layout as a pyramid of PNG map tiles
+   *
+   *  The tiles are written to "dir/<level>/<x>/<y>.png" for the levels from min_level to max_level.
+   *  See lay::TileRenderer for details.
+   *
+   *  @param dir The directory to write the tiles to
+   *  @param max_level The highest level to render
+   *  @param tile_size The width and height of a tile in pixels
+   *  @param min_level The lowest level to render
+   *  @param oversampling The oversampling factor (1..3) or 0 for default
+   *  @param linewidth The width of a line in pixels (usually 1) or 0 for default
+   *  @param threads The number of threads to use or 0 for the number of drawing workers
+   *  @param region The region to render or db::DBox() for the full layout
+   *  @return The number of tiles written
+   */
+  size_t save_tiles (const std::string &dir, unsigned int max_level, unsigned int tile_size, unsigned int min_level, int oversampling, int linewidth, int threads, const db::DBox &region);
+
   /**
    *  @brief Get the screen content as a QImage object with the given width and height
    */
@@ -1028,6 +1046,23 @@ public:
     return m_bitmap_caching;
   }
 
+  /** 
+   *  @brief Enable or disable the multi-layer redraw mode
+   *
+   *  In this mode, layers sharing the same cellview, transformations and
+   *  hierarchy levels are drawn in a single traversal of the hierarchy.
+   *  This saves time when many layers are shown.
+   */
+  void multi_layer_redraw (bool en);
+
+  /** 
+   *  @brief Gets a value indicating whether multi-layer redraw mode is enabled
+   */
+  bool multi_layer_redraw () const
+  {
+    return m_multi_layer_redraw;
+  }
+
   /** 
    *  @brief Lazy rendering of text objects
    */
@@ -1041,6 +1076,22 @@ public:
     return m_text_lazy_rendering;
   }
 
+  /** 
+   *  @brief Enable or disable label culling
+   *
+   *  With label culling, texts overlapping texts drawn before on the same layer
+   *  are dropped and the glyphs are taken from pre-rendered bitmaps.
+   */
+  void text_label_culling (bool en);
+
+  /** 
+   *  @brief Gets a value indicating whether label culling is enabled
+   */
+  bool text_label_culling () const
+  {
+    return m_text_label_culling;
+  }
+
   /**
    *  @brief Text object font setter
    */
@@ -2683,7 +2734,9 @@ private:
   int m_default_font_size;
   bool m_text_visible;
   bool m_text_lazy_rendering;
+  bool m_text_label_culling;
   bool m_bitmap_caching;
+  bool m_multi_layer_redraw;
   bool m_show_properties;
   QColor m_text_color;
   bool m_apply_text_trans;
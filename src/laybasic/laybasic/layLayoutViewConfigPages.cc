@@ -551,9 +551,15 @@ LayoutViewConfigPage3f::setup (lay::PluginRoot *root)
   root->config_get (cfg_text_lazy_rendering, flag);
   mp_ui->text_lazy_rendering_cbx->setChecked (flag);
 
+  root->config_get (cfg_text_label_culling, flag);
+  mp_ui->text_label_culling_cbx->setChecked (flag);
+
   root->config_get (cfg_bitmap_caching, flag);
   mp_ui->bitmap_caching_cbx->setChecked (flag);
 
+  root->config_get (cfg_multi_layer_redraw, flag);
+  mp_ui->multi_layer_redraw_cbx->setChecked (flag);
+
   n = 0;
   root->config_get (cfg_image_cache_size, n);
   mp_ui->image_cache_size_spbx->setValue (int (n));
@@ -576,7 +582,9 @@ LayoutViewConfigPage3f::commit (lay::PluginRoot *root)
   root->config_set (cfg_array_border_instances, mp_ui->array_border_insts_cbx->isChecked ());
 
   root->config_set (cfg_text_lazy_rendering, mp_ui->text_lazy_rendering_cbx->isChecked ());
+  root->config_set (cfg_text_label_culling, mp_ui->text_label_culling_cbx->isChecked ());
   root->config_set (cfg_bitmap_caching, mp_ui->bitmap_caching_cbx->isChecked ());
+  root->config_set (cfg_multi_layer_redraw, mp_ui->multi_layer_redraw_cbx->isChecked ());
 
   root->config_set (cfg_image_cache_size, mp_ui->image_cache_size_spbx->value ());
 }
@@ -1490,7 +1498,9 @@ public:
     options.push_back (std::pair<std::string, std::string> (cfg_text_color, "auto"));
     options.push_back (std::pair<std::string, std::string> (cfg_text_visible, "true"));
     options.push_back (std::pair<std::string, std::string> (cfg_text_lazy_rendering, "true"));
+    options.push_back (std::pair<std::string, std::string> (cfg_text_label_culling, "false"));
     options.push_back (std::pair<std::string, std::string> (cfg_bitmap_caching, "true"));
+    options.push_back (std::pair<std::string, std::string> (cfg_multi_layer_redraw, "false"));
     options.push_back (std::pair<std::string, std::string> (cfg_show_properties, "false"));
     options.push_back (std::pair<std::string, std::string> (cfg_apply_text_trans, "true"));
     options.push_back (std::pair<std::string, std::string> (cfg_global_trans, "r0"));
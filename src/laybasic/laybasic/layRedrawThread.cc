@@ -32,6 +32,8 @@
 #include "dbShape.h"
 
 #include <memory>
+#include <map>
+#include <algorithm>
 
 namespace lay 
 {
@@ -52,6 +54,7 @@ RedrawThread::RedrawThread (lay::RedrawThreadCanvas *canvas, lay::LayoutView *vi
   m_boxes_already_drawn = false;
   m_custom_already_drawn = false;
   m_nlayers = 0;
+  m_keep_caches = false;
   m_clock = tl::Clock::current ();
 }
 
@@ -68,6 +71,31 @@ void RedrawThread::layout_changed ()
 
   //  if something changed on the layouts we observe, stop the redraw thread
   stop ();
+
+  //  the drawing caches are no longer valid
+  m_drawing_caches.clear ();
+}
+
+void
+RedrawThread::set_keep_caches (bool f)
+{
+  if (f != m_keep_caches) {
+    stop ();
+    m_keep_caches = f;
+    m_drawing_caches.clear ();
+  }
+}
+
+LayerDrawingCache *
+RedrawThread::drawing_cache (int id)
+{
+  if (! m_keep_caches) {
+    return 0;
+  }
+
+  //  NOTE: the entries are created in do_start, so this method does not modify the map
+  std::map<int, LayerDrawingCache>::iterator c = m_drawing_caches.find (id);
+  return c != m_drawing_caches.end () ? &c->second : 0;
 }
 
 void
@@ -260,6 +288,15 @@ RedrawThread::do_start (bool clear, const db::Vector *shift_vector, const std::v
 
     m_nlayers = int (m_layers.size ());
 
+    //  create the cache entries here, so the workers don't need to
+    if (m_keep_caches) {
+      for (int i = 0; i < m_nlayers; ++i) {
+        if (m_drawing_caches.find (i) == m_drawing_caches.end ()) {
+          m_drawing_caches.insert (std::make_pair (i, LayerDrawingCache ()));
+        }
+      }
+    }
+
     if (mp_view->cellviews () > 0) {
 
       if (clear) {
@@ -306,9 +343,13 @@ RedrawThread::do_start (bool clear, const db::Vector *shift_vector, const std::v
         schedule (new RedrawThreadTask (draw_custom_queue_entry));
       }
 
-      for (int i = 0; i < m_nlayers; ++i) {
-        if (m_layers [i].needs_drawing ()) {
-          schedule (new RedrawThreadTask (i));
+      if (mp_view->multi_layer_redraw ()) {
+        schedule_layer_groups ();
+      } else {
+        for (int i = 0; i < m_nlayers; ++i) {
+          if (m_layers [i].needs_drawing ()) {
+            schedule (new RedrawThreadTask (i));
+          }
         }
       }
 
@@ -341,6 +382,93 @@ RedrawThread::do_start (bool clear, const db::Vector *shift_vector, const std::v
   m_start_recursion_sentinel = false;
 }
 
+namespace
+{
+
+/**
+ *  @brief The key by which layers are grouped for single-pass drawing
+ */
+struct LayerGroupKey
+{
+  LayerGroupKey (const lay::RedrawLayerInfo &li)
+    : cellview_index (li.cellview_index), hier_levels (li.hier_levels), trans (li.trans)
+  { }
+
+  bool operator< (const LayerGroupKey &other) const
+  {
+    if (cellview_index != other.cellview_index) {
+      return cellview_index < other.cellview_index;
+    }
+    if (hier_levels != other.hier_levels) {
+      return hier_levels < other.hier_levels;
+    }
+    if (trans.size () != other.trans.size ()) {
+      return trans.size () < other.trans.size ();
+    }
+    for (size_t i = 0; i < trans.size (); ++i) {
+      if (! trans [i].equal (other.trans [i])) {
+        return trans [i].less (other.trans [i]);
+      }
+    }
+    return false;
+  }
+
+  int cellview_index;
+  lay::HierarchyLevelSelection hier_levels;
+  std::vector<db::DCplxTrans> trans;
+};
+
+}
+
+void
+RedrawThread::schedule_layer_groups ()
+{
+  //  Layers from the same cellview, with the same transformations and hierarchy levels and 
+  //  without a property selection are drawn in a single pass through the hierarchy.
+  //  The groups are split into one chunk per worker, so the workers are kept busy.
+  std::map<LayerGroupKey, size_t> group_index;
+  std::vector<std::vector<int> > groups;
+
+  for (int i = 0; i < m_nlayers; ++i) {
+
+    const lay::RedrawLayerInfo &li = m_layers [i];
+    if (! li.needs_drawing ()) {
+      continue;
+    }
+
+    if (li.layer_index < 0 || ! li.prop_sel.empty () || ! li.inverse_prop_sel) {
+      schedule (new RedrawThreadTask (i));
+      continue;
+    }
+
+    LayerGroupKey key (li);
+    std::map<LayerGroupKey, size_t>::const_iterator g = group_index.find (key);
+    if (g == group_index.end ()) {
+      g = group_index.insert (std::make_pair (key, groups.size ())).first;
+      groups.push_back (std::vector<int> ());
+    }
+    groups [g->second].push_back (i);
+
+  }
+
+  size_t nchunks = size_t (std::max (1, num_workers ()));
+
+  for (std::vector<std::vector<int> >::const_iterator g = groups.begin (); g != groups.end (); ++g) {
+
+    size_t chunk_size = (g->size () + nchunks - 1) / nchunks;
+
+    for (size_t i = 0; i < g->size (); i += chunk_size) {
+      if (chunk_size == 1) {
+        schedule (new RedrawThreadTask ((*g) [i]));
+      } else {
+        std::vector<int> ids (g->begin () + i, g->begin () + std::min (g->size (), i + chunk_size));
+        schedule (new RedrawThreadTask (ids));
+      }
+    }
+
+  }
+}
+
 void
 RedrawThread::start ()
 {
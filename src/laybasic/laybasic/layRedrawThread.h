@@ -26,6 +26,7 @@
 
 #include <vector>
 #include <set>
+#include <map>
 #include <memory>
 
 #include <QThread>
@@ -38,6 +39,7 @@
 #include "layRenderer.h"
 #include "layLayoutView.h"
 #include "layRedrawThreadCanvas.h"
+#include "layRedrawThreadWorker.h"
 #include "layRedrawLayerInfo.h"
 #include "layCanvasPlane.h"
 #include "tlTimer.h"
@@ -83,6 +85,31 @@ public:
 
   void task_finished (int id);
 
+  /**
+   *  @brief Enables or disables keeping the drawing caches over multiple redraws
+   *
+   *  If enabled, the cell bitmap caches and the micro instance caches of the layers
+   *  are kept when the thread is started again with the same layers. This is useful 
+   *  when a series of images is drawn, for example the tiles of a tile pyramid.
+   *  The caches are dropped when this feature is disabled or the layout changes.
+   */
+  void set_keep_caches (bool f);
+
+  /**
+   *  @brief Gets a value indicating whether the drawing caches are kept
+   */
+  bool keep_caches () const
+  {
+    return m_keep_caches;
+  }
+
+  /**
+   *  @brief Gets the drawing cache for the layer with the given id
+   *
+   *  Returns 0 if the caches are not kept. This method is called from the workers.
+   */
+  LayerDrawingCache *drawing_cache (int id);
+
 protected:
   tl::Worker *create_worker ();
   void setup_worker (tl::Worker *worker);
@@ -93,6 +120,7 @@ private:
   void start ();
   void do_start (bool clear, const db::Vector *shift_vector, const std::vector <lay::RedrawLayerInfo> *layers, const std::vector<int> &restart, int workers);
   void done ();
+  void schedule_layer_groups ();
 
   void layout_changed ();
 
@@ -119,6 +147,9 @@ private:
   lay::LayoutView *mp_view;
   bool m_start_recursion_sentinel;
 
+  bool m_keep_caches;
+  std::map<int, LayerDrawingCache> m_drawing_caches;
+
   tl::Clock m_clock;
   QMutex m_initial_wait_lock;
   QWaitCondition m_initial_wait_cond;
@@ -24,6 +24,8 @@
 #include "layRedrawThreadWorker.h"
 #include "layRedrawThread.h"
 
+#include <algorithm>
+
 namespace lay
 {
 
@@ -38,6 +40,7 @@ RedrawThreadWorker::RedrawThreadWorker (RedrawThread *redraw_thread)
 {
   mp_layout = 0;
   mp_cell_var_cache = 0;
+  mp_group_layers = 0;
   m_cache_hits = 0;
   m_cache_misses = 0;
   m_cv_index = -1;
@@ -54,6 +57,7 @@ RedrawThreadWorker::RedrawThreadWorker (RedrawThread *redraw_thread)
   m_text_font = 0;
   m_text_visible = false;
   m_text_lazy_rendering = false;
+  m_text_label_culling = false;
   m_bitmap_caching = false;
   m_show_properties = false;
   m_apply_text_trans = false;
@@ -102,6 +106,24 @@ RedrawThreadWorker::perform_task (tl::Task *task)
 
   int task_id = redraw_thread_task->id ();
 
+  if (! redraw_thread_task->layer_group ().empty ()) {
+    draw_layer_group (redraw_thread_task->layer_group ());
+    return;
+  }
+
+  //  take over the caches kept from previous redraws if there are some.
+  //  The cell cache is only valid for the same magnification.
+  lay::LayerDrawingCache *drawing_cache = mp_redraw_thread->drawing_cache (task_id);
+  if (drawing_cache) {
+    if (fabs (drawing_cache->mag - m_vp_trans.mag ()) > 1e-10 * m_vp_trans.mag ()) {
+      drawing_cache->cell_cache.clear ();
+      drawing_cache->mag = m_vp_trans.mag ();
+    }
+    m_cell_cache.swap (drawing_cache->cell_cache);
+    m_mi_cache.swap (drawing_cache->mi_cache);
+    m_mi_text_cache.swap (drawing_cache->mi_text_cache);
+  }
+
   if (task_id >= 0) {
 
     //  draw a layer
@@ -451,6 +473,16 @@ RedrawThreadWorker::perform_task (tl::Task *task)
     }
   }
 
+  //  hand the caches back if they are kept.
+  //  NOTE: an interrupted task leaves through the TaskTerminatedException thrown by checkpoint ()
+  //  and does not get here. The kept entry then holds the empty caches swapped in above and
+  //  the incomplete ones are dropped when the next task starts.
+  if (drawing_cache) {
+    m_cell_cache.swap (drawing_cache->cell_cache);
+    m_mi_cache.swap (drawing_cache->mi_cache);
+    m_mi_text_cache.swap (drawing_cache->mi_text_cache);
+  }
+
   m_cell_cache.clear ();
 
   mp_redraw_thread->task_finished (task_id);
@@ -513,6 +545,7 @@ RedrawThreadWorker::setup (LayoutView *view, RedrawThreadCanvas *canvas, const s
   m_text_font = view->text_font ();
   m_text_visible = view->text_visible ();
   m_text_lazy_rendering = view->text_lazy_rendering ();
+  m_text_label_culling = view->text_label_culling ();
   m_bitmap_caching = view->bitmap_caching ();
   m_show_properties = view->show_properties_as_text ();
   m_apply_text_trans = view->apply_text_trans ();
@@ -1002,6 +1035,12 @@ RedrawThreadWorker::draw_box_properties (bool drawing_context, db::cell_index_ty
  */
 bool 
 RedrawThreadWorker::any_shapes (db::cell_index_type cell_index, unsigned int levels)
+{
+  return any_shapes (m_layer, m_mi_cache, cell_index, levels);
+}
+
+bool 
+RedrawThreadWorker::any_shapes (unsigned int layer, micro_instance_cache_t &mi_cache, db::cell_index_type cell_index, unsigned int levels)
 {
   //  if the cell is "hidden", it does not need to be drawn
   if (int (m_hidden_cells.size ()) > m_cv_index) {
@@ -1011,21 +1050,21 @@ RedrawThreadWorker::any_shapes (db::cell_index_type cell_index, unsigned int lev
   }
 
   //  the cache contains all cells that are visited already
-  RedrawThreadWorker::micro_instance_cache_t::const_iterator c = m_mi_cache.find (std::make_pair (cell_index, levels));
-  if (c == m_mi_cache.end ()) {
+  RedrawThreadWorker::micro_instance_cache_t::const_iterator c = mi_cache.find (std::make_pair (cell_index, levels));
+  if (c == mi_cache.end ()) {
 
     int ret = false;
 
     const db::Cell &cell = mp_layout->cell (cell_index);
-    if (! cell.shapes (m_layer).begin (db::ShapeIterator::Polygons | db::ShapeIterator::Edges | db::ShapeIterator::Paths | db::ShapeIterator::Boxes, mp_prop_sel, m_inv_prop_sel).at_end ()) {
+    if (! cell.shapes (layer).begin (db::ShapeIterator::Polygons | db::ShapeIterator::Edges | db::ShapeIterator::Paths | db::ShapeIterator::Boxes, mp_prop_sel, m_inv_prop_sel).at_end ()) {
       ret = true;
     } else if (levels > 1) {
       for (db::Cell::child_cell_iterator cc = cell.begin_child_cells (); !cc.at_end () && !ret; ++cc) {
-        ret = any_shapes (*cc, levels - 1);
+        ret = any_shapes (layer, mi_cache, *cc, levels - 1);
       }
     }
 
-    c = m_mi_cache.insert (std::make_pair (std::make_pair (cell_index, levels), ret)).first;
+    c = mi_cache.insert (std::make_pair (std::make_pair (cell_index, levels), ret)).first;
 
   }
 
@@ -1245,9 +1284,26 @@ RedrawThreadWorker::draw_text_layer (bool drawing_context, db::cell_index_type c
     opt_bitmap.reset (new lay::Bitmap (vertex_bitmap->width (), vertex_bitmap->height (), vertex_bitmap->resolution ()));
   }
 
-  for (std::vector<db::Box>::const_iterator b = vp.begin (); b != vp.end (); ++b) {
-    draw_text_layer (drawing_context, ci, trans, *b, level, fill, frame, vertex, text, opt_bitmap.get ());
+  //  with label culling, overlapping labels are dropped: the label boxes are
+  //  recorded in this bitmap
+  std::auto_ptr<lay::Bitmap> label_bitmap;
+  lay::Bitmap *text_bitmap = dynamic_cast<lay::Bitmap *> (text);
+  if (m_text_label_culling && text_bitmap) {
+    label_bitmap.reset (new lay::Bitmap (text_bitmap->width (), text_bitmap->height (), text_bitmap->resolution ()));
   }
+
+  mp_renderer->set_label_occupancy (label_bitmap.get ());
+
+  try {
+    for (std::vector<db::Box>::const_iterator b = vp.begin (); b != vp.end (); ++b) {
+      draw_text_layer (drawing_context, ci, trans, *b, level, fill, frame, vertex, text, opt_bitmap.get ());
+    }
+  } catch (...) {
+    mp_renderer->set_label_occupancy (0);
+    throw;
+  }
+
+  mp_renderer->set_label_occupancy (0);
 }
 
 void
@@ -1379,6 +1435,9 @@ RedrawThreadWorker::draw_text_layer (bool drawing_context, db::cell_index_type c
           bool anything = false;
           db::cell_index_type last_ci = std::numeric_limits<db::cell_index_type>::max ();
 
+          //  the text plane used for the current quad (0 if the labels would be dropped anyway)
+          CanvasPlane *quad_text = text;
+
           db::Cell::touching_iterator inst = cell.begin_touching (*v); 
           while (! inst.at_end ()) {
 
@@ -1388,6 +1447,16 @@ RedrawThreadWorker::draw_text_layer (bool drawing_context, db::cell_index_type c
             if (m_text_lazy_rendering && qid != current_quad_id) {
               current_quad_id = qid;
               skip = opt_bitmap && skip_quad (inst.quad_box () & bbox, opt_bitmap, trans);
+              quad_text = text;
+              if (! skip && text && r.label_occupancy ()) {
+                //  labels anchored in a quad fully covered by other labels would be dropped anyway,
+                //  so only the text origins are drawn there
+                db::Coord d = db::coord_traits<db::Coord>::rounded (3.0 / trans.mag ());
+                if (skip_quad ((inst.quad_box () & bbox).enlarged (db::Vector (d, d)), r.label_occupancy (), trans)) {
+                  quad_text = 0;
+                  skip = (vertex == 0 && frame == 0);
+                }
+              }
             }  
 
             if (skip) {
@@ -1458,7 +1527,7 @@ RedrawThreadWorker::draw_text_layer (bool drawing_context, db::cell_index_type c
 
                       db::ICplxTrans t (cell_inst.complex_trans (*p));
                       db::Box new_vp = db::Box (t.inverted () * *v);
-                      draw_text_layer (drawing_context, new_ci, trans * t, new_vp, level + 1, fill, frame, vertex, text, opt_bitmap);
+                      draw_text_layer (drawing_context, new_ci, trans * t, new_vp, level + 1, fill, frame, vertex, quad_text, opt_bitmap);
 
                     } 
 
@@ -1556,76 +1625,67 @@ bool draw_array_simplified (lay::Renderer *r, const db::Shape &array_shape, lay:
 }
  
 void
-RedrawThreadWorker::draw_layer_wo_cache (int from_level, int to_level, db::cell_index_type ci, const db::CplxTrans &trans, const std::vector<db::Box> &vv, int level,
-                                         lay::CanvasPlane *fill, lay::CanvasPlane *frame, lay::CanvasPlane *vertex, lay::CanvasPlane *text, const UpdateSnapshotCallback *update_snapshot)
+RedrawThreadWorker::draw_shapes (const db::Cell &cell, unsigned int layer, const db::CplxTrans &trans, const std::vector<db::Box> &vv,
+                                 lay::CanvasPlane *fill, lay::CanvasPlane *frame, lay::CanvasPlane *vertex, lay::CanvasPlane *text, const UpdateSnapshotCallback *update_snapshot)
 {
-  const db::Cell &cell = mp_layout->cell (ci);
-
-  lay::Renderer &r = *mp_renderer;
-  const db::Box &bbox = cell.bbox (m_layer);
-
+  const db::Box &bbox = cell.bbox (layer);
   const lay::Bitmap *vertex_bitmap = dynamic_cast<const lay::Bitmap *> (vertex);
 
-  //  draw this level
-  if (level >= from_level && level < to_level) {
+  //  draw the shapes or insert into the cell cache.
+  for (std::vector<db::Box>::const_iterator v = vv.begin (); v != vv.end (); ++v) {
 
-    //  draw the shapes or insert into the cell cache.
-    for (std::vector<db::Box>::const_iterator v = vv.begin (); v != vv.end (); ++v) {
-
-      if (v->empty ()) {
-        continue;
-      }
+    if (v->empty ()) {
+      continue;
+    }
 
-      const db::Shapes &shapes = cell.shapes (m_layer);
-      db::Shape last_array;
+    const db::Shapes &shapes = cell.shapes (layer);
+    db::Shape last_array;
 
-      size_t current_quad_id = 0;
-      db::ShapeIterator shape (shapes.begin_touching (*v, db::ShapeIterator::Boxes | db::ShapeIterator::Polygons | db::ShapeIterator::Edges | db::ShapeIterator::Paths, mp_prop_sel, m_inv_prop_sel));
-      while (! shape.at_end ()) {
+    size_t current_quad_id = 0;
+    db::ShapeIterator shape (shapes.begin_touching (*v, db::ShapeIterator::Boxes | db::ShapeIterator::Polygons | db::ShapeIterator::Edges | db::ShapeIterator::Paths, mp_prop_sel, m_inv_prop_sel));
+    while (! shape.at_end ()) {
 
-        test_snapshot (update_snapshot); 
+      test_snapshot (update_snapshot); 
 
-        //  skip this quad if we have drawn something here already
-        size_t qid = shape.quad_id ();
-        bool skip = false;
-        if (vertex_bitmap && qid != current_quad_id) {
-          current_quad_id = qid;
-          skip = skip_quad (shape.quad_box () & bbox, vertex_bitmap, trans);
-        }
+      //  skip this quad if we have drawn something here already
+      size_t qid = shape.quad_id ();
+      bool skip = false;
+      if (vertex_bitmap && qid != current_quad_id) {
+        current_quad_id = qid;
+        skip = skip_quad (shape.quad_box () & bbox, vertex_bitmap, trans);
+      }
 
-        if (skip) {
+      if (skip) {
 
-          shape.skip_quad ();
+        shape.skip_quad ();
 
-        } else {
+      } else {
 
-          bool simplified = false;
+        bool simplified = false;
 
-          if (shape.in_array () && last_array != shape.array ()) {
+        if (shape.in_array () && last_array != shape.array ()) {
 
-            last_array = shape.array ();
-
-            if (last_array.type () == db::Shape::PolygonPtrArray) {
-              simplified = draw_array_simplified<db::Shape::polygon_ptr_array_type> (mp_renderer.get (), last_array, frame, vertex, trans);
-            } else if (last_array.type () == db::Shape::SimplePolygonPtrArray) {
-              simplified = draw_array_simplified<db::Shape::simple_polygon_ptr_array_type> (mp_renderer.get (), last_array, frame, vertex, trans);
-            } else if (last_array.type () == db::Shape::PathPtrArray) {
-              simplified = draw_array_simplified<db::Shape::path_ptr_array_type> (mp_renderer.get (), last_array, frame, vertex, trans);
-            } else if (last_array.type () == db::Shape::BoxArray) {
-              simplified = draw_array_simplified<db::Shape::box_array_type> (mp_renderer.get (), last_array, frame, vertex, trans);
-            } else if (last_array.type () == db::Shape::ShortBoxArray) {
-              simplified = draw_array_simplified<db::Shape::short_box_array_type> (mp_renderer.get (), last_array, frame, vertex, trans);
-            }
+          last_array = shape.array ();
 
+          if (last_array.type () == db::Shape::PolygonPtrArray) {
+            simplified = draw_array_simplified<db::Shape::polygon_ptr_array_type> (mp_renderer.get (), last_array, frame, vertex, trans);
+          } else if (last_array.type () == db::Shape::SimplePolygonPtrArray) {
+            simplified = draw_array_simplified<db::Shape::simple_polygon_ptr_array_type> (mp_renderer.get (), last_array, frame, vertex, trans);
+          } else if (last_array.type () == db::Shape::PathPtrArray) {
+            simplified = draw_array_simplified<db::Shape::path_ptr_array_type> (mp_renderer.get (), last_array, frame, vertex, trans);
+          } else if (last_array.type () == db::Shape::BoxArray) {
+            simplified = draw_array_simplified<db::Shape::box_array_type> (mp_renderer.get (), last_array, frame, vertex, trans);
+          } else if (last_array.type () == db::Shape::ShortBoxArray) {
+            simplified = draw_array_simplified<db::Shape::short_box_array_type> (mp_renderer.get (), last_array, frame, vertex, trans);
           }
 
-          if (simplified) {
-            shape.finish_array ();
-          } else {
-            mp_renderer->draw (*shape, trans, fill, frame, vertex, text);
-            ++shape;
-          }
+        }
 
+        if (simplified) {
+          shape.finish_array ();
+        } else {
+          mp_renderer->draw (*shape, trans, fill, frame, vertex, text);
+          ++shape;
         }
 
       }
@@ -1633,6 +1693,23 @@ RedrawThreadWorker::draw_layer_wo_cache (int from_level, int to_level, db::cell_
     }
 
   }
+}
+
+void
+RedrawThreadWorker::draw_layer_wo_cache (int from_level, int to_level, db::cell_index_type ci, const db::CplxTrans &trans, const std::vector<db::Box> &vv, int level,
+                                         lay::CanvasPlane *fill, lay::CanvasPlane *frame, lay::CanvasPlane *vertex, lay::CanvasPlane *text, const UpdateSnapshotCallback *update_snapshot)
+{
+  const db::Cell &cell = mp_layout->cell (ci);
+
+  lay::Renderer &r = *mp_renderer;
+  const db::Box &bbox = cell.bbox (m_layer);
+
+  const lay::Bitmap *vertex_bitmap = dynamic_cast<const lay::Bitmap *> (vertex);
+
+  //  draw this level
+  if (level >= from_level && level < to_level) {
+    draw_shapes (cell, m_layer, trans, vv, fill, frame, vertex, text, update_snapshot);
+  }
 
   //  dive down into the hierarchy ..
   if (level + 1 < to_level) {
@@ -1999,6 +2076,632 @@ RedrawThreadWorker::draw_layer (bool drawing_context, db::cell_index_type ci, co
   }
 }
 
+void
+RedrawThreadWorker::draw_layer_group (const std::vector<int> &task_ids)
+{
+  //  NOTE: all layers of a group share the cellview, the transformations and the
+  //  hierarchy levels and don't have a property selection (see RedrawThread::do_start)
+  const RedrawLayerInfo &li0 = mp_redraw_thread->get_layer_info (task_ids.front ());
+
+  std::vector<GroupLayer> layers (task_ids.size ());
+  std::vector<std::vector<db::Box> > text_redraw_regions (task_ids.size (), m_redraw_region);
+
+  try {
+
+    m_buffers.clear ();
+
+    for (size_t n = 0; n < task_ids.size (); ++n) {
+
+      GroupLayer &gl = layers [n];
+      const RedrawLayerInfo &li = mp_redraw_thread->get_layer_info (task_ids [n]);
+
+      gl.task_id = task_ids [n];
+      gl.layer = (unsigned int) li.layer_index;
+      gl.xfill = li.xfill;
+
+      for (unsigned int i = 0; i < (unsigned int) planes_per_layer; ++i) {
+        gl.planes [i] = mp_canvas->create_drawing_plane ();
+      }
+
+      //  HINT: the plane order must be the same than for single layers (see perform_task)
+      for (unsigned int i = 0; i < (unsigned int) planes_per_layer / 3; ++i) {
+
+        //  context level planes
+        unsigned int i1 = gl.task_id * (planes_per_layer / 3) + special_planes_before + i;
+        mp_canvas->initialize_plane (gl.planes [i], i1); 
+        m_buffers.push_back (std::make_pair (i1, gl.planes [i]));
+
+        //  child level planes (if used)
+        unsigned int i2 = (gl.task_id + m_nlayers) * (planes_per_layer / 3) + special_planes_before + i;
+        mp_canvas->initialize_plane (gl.planes [i + planes_per_layer / 3], i2); 
+        m_buffers.push_back (std::make_pair (i2, gl.planes [i + planes_per_layer / 3]));
+
+        //  current level planes
+        unsigned int i3 = (gl.task_id + m_nlayers * 2) * (planes_per_layer / 3) + special_planes_before + i;
+        mp_canvas->initialize_plane (gl.planes [i + 2 * (planes_per_layer / 3)], i3); 
+        m_buffers.push_back (std::make_pair (i3, gl.planes [i + 2 * (planes_per_layer / 3)]));
+
+      }
+
+      //  if there are non-empty text planes, redraw the whole area for texts
+      bool text_planes_empty = true;
+      for (unsigned int i = 0; i < (unsigned int) planes_per_layer && text_planes_empty; i += (unsigned int) planes_per_layer / 3) {
+        lay::Bitmap *text = dynamic_cast<lay::Bitmap *> (gl.planes [i + 2]);
+        if (text && ! text->empty ()) {
+          text_planes_empty = false;
+        }
+      }
+
+      if (! text_planes_empty) {
+        text_redraw_regions [n].clear ();
+        text_redraw_regions [n].push_back (db::Box (0, 0, mp_canvas->canvas_width (), mp_canvas->canvas_height ()));
+        for (unsigned int i = 0; i < (unsigned int) planes_per_layer; i += (unsigned int) planes_per_layer / 3) {
+          lay::Bitmap *text = dynamic_cast<lay::Bitmap *> (gl.planes [i + 2]);
+          if (text) {
+            text->clear ();
+          }
+        }
+      }
+
+      //  take over the caches kept from previous redraws if there are some.
+      gl.drawing_cache = mp_redraw_thread->drawing_cache (gl.task_id);
+      if (gl.drawing_cache) {
+        if (fabs (gl.drawing_cache->mag - m_vp_trans.mag ()) > 1e-10 * m_vp_trans.mag ()) {
+          gl.drawing_cache->cell_cache.clear ();
+          gl.drawing_cache->mag = m_vp_trans.mag ();
+        }
+        gl.cell_cache.swap (gl.drawing_cache->cell_cache);
+        gl.mi_cache.swap (gl.drawing_cache->mi_cache);
+        gl.mi_text_cache.swap (gl.drawing_cache->mi_text_cache);
+      }
+
+    }
+
+    const lay::CellView &cv = m_cellviews [li0.cellview_index];
+    if (cv.is_valid () && ! cv->layout ().under_construction () && ! (cv->layout ().manager () && cv->layout ().manager ()->transacting ())) {
+
+      mp_layout = &cv->layout ();
+      m_cv_index = li0.cellview_index;
+      db::cell_index_type ci = cv.cell_index ();
+
+      int ctx_path_length = int (m_cellviews [m_cv_index].specific_path ().size ());
+
+      if (li0.hier_levels.has_from_level ()) {
+        m_from_level = li0.hier_levels.from_level (ctx_path_length, m_from_level);
+      }
+      if (li0.hier_levels.has_to_level ()) {
+        m_to_level = li0.hier_levels.to_level (ctx_path_length, m_to_level);
+      }
+
+      mp_prop_sel = 0;
+      m_inv_prop_sel = false;
+
+      {
+        if (tl::verbosity () >= 40) {
+          tl::info << tl::to_string (QObject::tr ("Drawing layers in one pass: ")) << task_ids.size ();
+        }
+        tl::SelfTimer timer (tl::verbosity () >= 41, tl::to_string (QObject::tr ("Drawing layers")));
+
+        //  configure renderer ..
+        mp_renderer->draw_texts (m_text_visible);
+        mp_renderer->draw_properties (m_show_properties);
+        mp_renderer->draw_description_property (false);
+        mp_renderer->default_text_size (db::Coord (m_default_text_size / mp_layout->dbu ()));
+        mp_renderer->set_font (db::Font (m_text_font));
+        mp_renderer->apply_text_trans (m_apply_text_trans);
+
+        //  draw the shapes of all layers in a single traversal
+        mp_group_layers = &layers;
+        for (std::vector<db::DCplxTrans>::const_iterator t = li0.trans.begin (); t != li0.trans.end (); ++t) {
+          db::CplxTrans trans = m_vp_trans * *t * db::CplxTrans (mp_layout->dbu ());
+          iterate_variants (m_redraw_region, ci, trans, &RedrawThreadWorker::draw_layer_group);
+        }
+        mp_group_layers = 0;
+      }
+
+      //  draw the texts layer by layer: they use the text planes only and are drawn
+      //  with the standard scheme.
+      lay::CanvasPlane *planes_saved [planes_per_layer];
+      std::copy (m_planes, m_planes + planes_per_layer, planes_saved);
+
+      try {
+
+        for (size_t n = 0; n < layers.size (); ++n) {
+
+          GroupLayer &gl = layers [n];
+
+          std::copy (gl.planes, gl.planes + planes_per_layer, m_planes);
+          m_layer = gl.layer;
+          m_xfill = gl.xfill;
+          mp_renderer->set_xfill (m_xfill);
+
+          m_mi_text_cache.swap (gl.mi_text_cache);
+          for (std::vector<db::DCplxTrans>::const_iterator t = li0.trans.begin (); t != li0.trans.end (); ++t) {
+            db::CplxTrans trans = m_vp_trans * *t * db::CplxTrans (mp_layout->dbu ());
+            iterate_variants (text_redraw_regions [n], ci, trans, &RedrawThreadWorker::draw_text_layer);
+          }
+          m_mi_text_cache.swap (gl.mi_text_cache);
+
+        }
+
+        std::copy (planes_saved, planes_saved + planes_per_layer, m_planes);
+
+      } catch (...) {
+        std::copy (planes_saved, planes_saved + planes_per_layer, m_planes);
+        throw;
+      }
+
+    }
+
+    transfer ();
+    m_buffers.clear ();
+
+  } catch (...) {
+
+    mp_group_layers = 0;
+    m_buffers.clear ();
+
+    for (std::vector<GroupLayer>::iterator gl = layers.begin (); gl != layers.end (); ++gl) {
+      for (unsigned int i = 0; i < (unsigned int) planes_per_layer; ++i) {
+        delete gl->planes [i];
+      }
+    }
+
+    throw;
+
+  }
+
+  for (std::vector<GroupLayer>::iterator gl = layers.begin (); gl != layers.end (); ++gl) {
+
+    //  hand the caches back if they are kept
+    if (gl->drawing_cache) {
+      gl->cell_cache.swap (gl->drawing_cache->cell_cache);
+      gl->mi_cache.swap (gl->drawing_cache->mi_cache);
+      gl->mi_text_cache.swap (gl->drawing_cache->mi_text_cache);
+    }
+
+    for (unsigned int i = 0; i < (unsigned int) planes_per_layer; ++i) {
+      delete gl->planes [i];
+    }
+
+  }
+
+  for (std::vector<int>::const_iterator id = task_ids.begin (); id != task_ids.end (); ++id) {
+    mp_redraw_thread->task_finished (*id);
+  }
+}
+
+void
+RedrawThreadWorker::make_group_targets (int plane_group, std::vector<GroupTarget> &targets)
+{
+  targets.clear ();
+  targets.reserve (mp_group_layers->size ());
+
+  for (std::vector<GroupLayer>::iterator gl = mp_group_layers->begin (); gl != mp_group_layers->end (); ++gl) {
+    targets.push_back (GroupTarget (&*gl, 
+                                    gl->planes [0 + plane_group * (planes_per_layer / 3)], 
+                                    gl->planes [1 + plane_group * (planes_per_layer / 3)], 
+                                    gl->planes [3 + plane_group * (planes_per_layer / 3)], 
+                                    gl->planes [2 + plane_group * (planes_per_layer / 3)]));
+  }
+}
+
+void
+RedrawThreadWorker::draw_layer_group (bool drawing_context, db::cell_index_type ci, const db::CplxTrans &trans, const std::vector<db::Box> &redraw_regions, int level)
+{
+  std::vector<GroupTarget> targets;
+
+  //  NOTE: the plane groups correspond to the ones used in draw_layer
+  if (drawing_context) {
+
+    if (m_to_level > m_from_level) {
+      make_group_targets (0, targets);
+      draw_layer_group (m_from_level, m_to_level, ci, trans, redraw_regions, level, targets, 0);
+    }
+
+  } else if (! m_child_context_enabled) {
+
+    if (m_to_level > m_from_level) {
+      make_group_targets (2, targets);
+      draw_layer_group (m_from_level, m_to_level, ci, trans, redraw_regions, level, targets, 0);
+    }
+
+  } else {
+
+    if (1 > m_from_level) {
+      make_group_targets (2, targets);
+      draw_layer_group (m_from_level, 1, ci, trans, redraw_regions, level, targets, 0);
+    }
+
+    if (m_to_level > 1) {
+      make_group_targets (1, targets);
+      draw_layer_group (1, m_to_level, ci, trans, redraw_regions, level, targets, 0);
+    }
+
+  }
+}
+
+/**
+ *  @brief A snapshot update callback for a set of cached cell bitmaps drawn in parallel
+ */
+class UpdateSnapshotWithCacheGroup 
+  : public UpdateSnapshotCallback
+{
+public:
+  UpdateSnapshotWithCacheGroup (const UpdateSnapshotCallback *parent)
+    : mp_parent (parent)
+  {
+    //  .. nothing yet ..
+  }
+
+  void add (const UpdateSnapshotWithCache &update)
+  {
+    m_updates.push_back (update);
+  }
+
+  void trigger () const
+  {
+    if (mp_parent) {
+      mp_parent->trigger ();
+    }
+
+    for (std::vector<UpdateSnapshotWithCache>::const_iterator u = m_updates.begin (); u != m_updates.end (); ++u) {
+      u->trigger ();
+    }
+  }
+
+private:
+  const UpdateSnapshotCallback *mp_parent;
+  std::vector<UpdateSnapshotWithCache> m_updates;
+};
+
+void
+RedrawThreadWorker::draw_layer_group (int from_level, int to_level, db::cell_index_type ci, const db::CplxTrans &trans, const std::vector<db::Box> &vp, int level,
+                                      const std::vector<GroupTarget> &targets, const UpdateSnapshotCallback *update_snapshot)
+{
+  //  do not draw, if there is nothing to draw
+  if (mp_layout->cells () <= ci || vp.empty () || targets.empty ()) {
+    return;
+  }
+  if (cell_var_cached (ci, trans)) {
+    return;
+  }
+
+  for (std::vector<db::Box>::const_iterator b = vp.begin (); b != vp.end (); ++b) {
+    draw_layer_group (from_level, to_level, ci, trans, *b, level, targets, update_snapshot);
+  }
+}
+
+void
+RedrawThreadWorker::draw_layer_group (int from_level, int to_level, db::cell_index_type ci, const db::CplxTrans &trans, const db::Box &vp, int level,
+                                      const std::vector<GroupTarget> &targets, const UpdateSnapshotCallback *update_snapshot)
+{
+  test_snapshot (update_snapshot);
+
+  const db::Cell &cell = mp_layout->cell (ci);
+  db::Box cell_bbox = cell.bbox ();
+
+  //  select the layers with something to draw here
+  std::vector<GroupTarget> active;
+  active.reserve (targets.size ());
+  for (std::vector<GroupTarget>::const_iterator t = targets.begin (); t != targets.end (); ++t) {
+    const db::Box &bbox = cell.bbox (t->layer->layer);
+    if (! bbox.empty () && bbox.touches (vp)) {
+      active.push_back (*t);
+    }
+  }
+
+  //  Nothing to draw
+  if (active.empty ()) {
+    return;
+  }
+
+  //  For small bboxes, the cell outline can be reduced ..
+  if (m_drop_small_cells && drop_cell (cell, trans)) {
+    return;
+  }
+
+  //  Don't draw hidden cells
+  bool hidden = (m_cv_index < int (m_hidden_cells.size ()) && m_hidden_cells [m_cv_index].find (ci) != m_hidden_cells [m_cv_index].end ());
+  if (hidden) {
+    return;
+  }
+
+  //  draw this level
+  if (level >= from_level && level < to_level) {
+
+    //  optimize very small cells
+    std::vector<GroupTarget> remaining;
+    remaining.reserve (active.size ());
+
+    for (std::vector<GroupTarget>::const_iterator t = active.begin (); t != active.end (); ++t) {
+
+      db::DBox dbbox = trans * cell.bbox (t->layer->layer);
+      if ((dbbox.width () < 2.5 && dbbox.height () < 1.5) || 
+          (dbbox.width () < 1.5 && dbbox.height () < 2.5)) {
+
+        bool anything = true;
+        if (level == 0 && cell_bbox.inside (vp)) {
+          anything = any_shapes (t->layer->layer, t->layer->mi_cache, ci, m_to_level - level);
+        }
+
+        if (anything) {
+          //  any shapes here: paint bbox for simplification
+          mp_renderer->set_xfill (t->layer->xfill);
+          mp_renderer->draw (dbbox, 0, t->frame, t->vertex, 0);
+        } 
+
+      } else {
+        remaining.push_back (*t);
+      }
+
+    }
+
+    if (remaining.empty ()) {
+      return;
+    }
+
+    //  create a set of boxes to look into
+    std::vector<db::Box> vv = search_regions (cell_bbox, vp, level);
+
+    //  the caching conditions are the same than for single layers (see draw_layer)
+    bool can_cache = (m_bitmap_caching && dynamic_cast<lay::Bitmap *> (remaining.front ().fill) != 0);
+
+    if (vv.size () > 1 || ! cell_bbox.inside (vv.front ())) {
+      can_cache = false;
+    }
+
+    if (can_cache && level > 0) {
+      db::Cell::parent_inst_iterator p = cell.begin_parent_insts ();
+      size_t n;
+      for (n = 0; !p.at_end () && n < 2; ++n) 
+        ;
+      if (n <= 1) {
+        can_cache = false;
+      }
+    }
+
+    if (can_cache) {
+
+      db::CplxTrans trans_wo_disp = trans;
+      trans_wo_disp.disp (db::DVector ());
+
+      db::DBox cell_box_trans = trans_wo_disp * cell_bbox;
+
+      //  Hint: this rounding scheme guarantees a integer-pixel shift vector at least for the first instance
+      db::DPoint d = cell_box_trans.lower_left () + trans.disp ();
+      d = db::DPoint (floor (d.x ()), floor (d.y ()));
+      db::DPoint offset = d - trans.disp ();
+      db::CplxTrans drawing_trans = trans_wo_disp;
+      drawing_trans.disp (db::DPoint () - offset);
+
+      int width = int (cell_box_trans.width () + 3);    //  +3 = one pixel for a one-pixel frame at both sides and one for safety
+      int height = int (cell_box_trans.height () + 3);
+
+      CellCacheKey key (to_level - level, ci, trans_wo_disp);
+
+      //  the layers which don't have the cell cached yet are drawn into their caches together
+      std::vector<CellCacheInfo *> cached (remaining.size (), (CellCacheInfo *) 0);
+      std::vector<GroupTarget> to_cache;
+      UpdateSnapshotWithCacheGroup update_cached_snapshot (update_snapshot);
+
+      for (size_t n = 0; n < remaining.size (); ++n) {
+
+        const GroupTarget &t = remaining [n];
+
+        cell_cache_t::iterator cached_cell = t.layer->cell_cache.find (key);
+        if (cached_cell == t.layer->cell_cache.end ()) {
+
+          cached_cell = t.layer->cell_cache.insert (std::make_pair (key, CellCacheInfo ())).first;
+
+          cached_cell->second.offset = offset;
+          cached_cell->second.fill   = new lay::Bitmap (width, height, 1.0);
+          cached_cell->second.frame  = new lay::Bitmap (width, height, 1.0);
+          cached_cell->second.vertex = new lay::Bitmap (width, height, 1.0);
+          cached_cell->second.text   = new lay::Bitmap (width, height, 1.0);
+
+          to_cache.push_back (GroupTarget (t.layer, cached_cell->second.fill, cached_cell->second.frame, cached_cell->second.vertex, cached_cell->second.text));
+          update_cached_snapshot.add (UpdateSnapshotWithCache (0, &trans, &cached_cell->second, t.fill, t.frame, t.vertex, t.text));
+
+        }
+
+        cached [n] = &cached_cell->second;
+
+      }
+
+      if (! to_cache.empty ()) {
+        draw_layer_group_wo_cache (from_level, to_level, ci, drawing_trans, vv, level, to_cache, &update_cached_snapshot);
+      }
+
+      for (size_t n = 0; n < remaining.size (); ++n) {
+
+        const GroupTarget &t = remaining [n];
+        CellCacheInfo *info = cached [n];
+        info->hits++;
+
+        db::Point tp = db::Point (info->offset + trans.disp ());
+
+        copy_bitmap (info->fill,   dynamic_cast<lay::Bitmap *> (t.fill),   tp.x (), tp.y ());
+        copy_bitmap (info->frame,  dynamic_cast<lay::Bitmap *> (t.frame),  tp.x (), tp.y ());
+        copy_bitmap (info->vertex, dynamic_cast<lay::Bitmap *> (t.vertex), tp.x (), tp.y ());
+        copy_bitmap (info->text,   dynamic_cast<lay::Bitmap *> (t.text),   tp.x (), tp.y ());
+
+      }
+
+    } else {
+      draw_layer_group_wo_cache (from_level, to_level, ci, trans, vv, level, remaining, update_snapshot);
+    }
+
+  } else {
+
+    //  draw stuff below (not on this level)
+    std::vector<db::Box> vv;
+    vv.push_back (vp);
+    draw_layer_group_wo_cache (from_level, to_level, ci, trans, vv, level, active, update_snapshot);
+
+  }
+}
+
+void
+RedrawThreadWorker::draw_layer_group_wo_cache (int from_level, int to_level, db::cell_index_type ci, const db::CplxTrans &trans, const std::vector<db::Box> &vv, int level,
+                                               const std::vector<GroupTarget> &targets, const UpdateSnapshotCallback *update_snapshot)
+{
+  const db::Cell &cell = mp_layout->cell (ci);
+
+  lay::Renderer &r = *mp_renderer;
+
+  //  draw this level: the shapes of each layer 
+  if (level >= from_level && level < to_level) {
+    for (std::vector<GroupTarget>::const_iterator t = targets.begin (); t != targets.end (); ++t) {
+      r.set_xfill (t->layer->xfill);
+      draw_shapes (cell, t->layer->layer, trans, vv, t->fill, t->frame, t->vertex, t->text, update_snapshot);
+    }
+  }
+
+  //  dive down into the hierarchy once for all layers ..
+  if (level + 1 < to_level) {
+
+    std::vector<const lay::Bitmap *> vertex_bitmaps;
+    std::vector<db::Box> layer_bboxes;
+    vertex_bitmaps.reserve (targets.size ());
+    layer_bboxes.reserve (targets.size ());
+    for (std::vector<GroupTarget>::const_iterator t = targets.begin (); t != targets.end (); ++t) {
+      vertex_bitmaps.push_back (dynamic_cast<const lay::Bitmap *> (t->vertex));
+      layer_bboxes.push_back (cell.bbox (t->layer->layer));
+    }
+
+    //  NOTE: the array members are selected by the full cell boxes. The layers are selected 
+    //  by their boxes on the next level.
+    db::box_convert <db::CellInst> bc (*mp_layout);
+
+    std::vector<GroupTarget> child_targets;
+    child_targets.reserve (targets.size ());
+
+    for (std::vector<db::Box>::const_iterator v = vv.begin (); v != vv.end (); ++v) {
+
+      if (v->empty ()) {
+        continue;
+      }
+
+      size_t current_quad_id = 0;
+
+      db::Cell::touching_iterator inst = cell.begin_touching (*v); 
+      while (! inst.at_end ()) {
+
+        test_snapshot (update_snapshot); 
+
+        //  skip this quad if we have drawn something here already on all layers
+        size_t qid = inst.quad_id ();
+        bool skip = false;
+        if (qid != current_quad_id) {
+          current_quad_id = qid;
+          skip = true;
+          for (size_t n = 0; n < targets.size () && skip; ++n) {
+            skip = skip_quad (inst.quad_box () & layer_bboxes [n], vertex_bitmaps [n], trans);
+          }
+        }  
+
+        if (skip) {
+
+          //  move on to the next quad
+          inst.skip_quad ();
+
+        } else {
+
+          const db::CellInstArray &cell_inst = inst->cell_inst ();
+          ++inst;
+
+          db::cell_index_type new_ci = cell_inst.object ().cell_index ();
+          bool hidden = (m_cv_index < int (m_hidden_cells.size ()) && m_hidden_cells [m_cv_index].find (new_ci) != m_hidden_cells [m_cv_index].end ());
+          if (hidden) {
+            continue;
+          }
+
+          const db::Cell &new_cell = mp_layout->cell (new_ci);
+
+          db::Vector a, b;
+          unsigned long amax = 0, bmax = 0; 
+          bool is_regular = cell_inst.is_regular_array (a, b, amax, bmax);
+
+          child_targets.clear ();
+
+          for (std::vector<GroupTarget>::const_iterator t = targets.begin (); t != targets.end (); ++t) {
+
+            db::Box new_cell_box = new_cell.bbox (t->layer->layer);
+            if (new_cell_box.empty ()) {
+              continue;
+            }
+
+            //  Hint: don't use any_text_shapes on partially visible cells because that will degrade performance 
+            if (new_cell_box.inside (*v) && ! any_shapes (t->layer->layer, t->layer->mi_cache, new_ci, to_level - (level + 1))) {
+              continue;
+            }
+
+            bool simplify = false;
+
+            if (is_regular) {
+
+              db::DBox inst_box;
+              if (cell_inst.is_complex ()) {
+                inst_box = trans * (cell_inst.complex_trans () * new_cell_box);
+              } else {
+                inst_box = trans * new_cell_box;
+              }
+
+              if (((a.x () == 0 && b.y () == 0) || (a.y () == 0 && b.x () == 0)) && 
+                  inst_box.width () < 1.5 && inst_box.height () < 1.5 && 
+                  (amax <= 1 || trans.ctrans (a.length ()) < 1.5) &&
+                  (bmax <= 1 || trans.ctrans (b.length ()) < 1.5)) {
+                simplify = true;
+              }
+
+            }
+
+            if (simplify) {
+
+              //  The array can be simplified ..
+
+              db::Box bbox = cell_inst.bbox (db::box_convert <db::CellInst> (*mp_layout, t->layer->layer));
+              r.set_xfill (t->layer->xfill);
+              if (t->frame) {
+                r.draw (bbox, trans, t->frame, t->frame, 0, 0);
+              }
+              if (t->vertex) {
+                r.draw (bbox, trans, t->vertex, t->vertex, 0, 0);
+              }
+
+            } else {
+              child_targets.push_back (*t);
+            }
+
+          }
+
+          if (! child_targets.empty ()) {
+
+            for (db::CellInstArray::iterator p = cell_inst.begin_touching (*v, bc); ! p.at_end (); ++p) {
+
+              if (! m_draw_array_border_instances || 
+                  p.index_a () <= 0 || (unsigned long)p.index_a () == amax - 1 || p.index_b () <= 0 || (unsigned long)p.index_b () == bmax - 1) {
+
+                db::ICplxTrans t (cell_inst.complex_trans (*p));
+                db::Box new_vp = db::Box (t.inverted () * *v);
+                draw_layer_group (from_level, to_level, new_ci, trans * t, new_vp, level + 1, child_targets, update_snapshot);
+
+              } 
+
+            }
+
+          }
+
+        }
+
+      }
+
+    }
+
+  }
+}
+
 bool
 RedrawThreadWorker::drop_cell (const db::Cell &cell, const db::CplxTrans &trans)
 {
@@ -79,13 +79,31 @@ public:
     : m_id (id)
   { }
 
+  /**
+   *  @brief Creates a task drawing a group of layers in a single pass
+   */
+  RedrawThreadTask (const std::vector<int> &ids)
+    : m_id (ids.front ()), m_layer_group (ids)
+  { }
+
   int id () const
   {
     return m_id;
   }
 
+  /**
+   *  @brief Gets the layers to draw in a single pass
+   *
+   *  This list is empty for tasks drawing a single layer or special entries.
+   */
+  const std::vector<int> &layer_group () const
+  {
+    return m_layer_group;
+  }
+
 private:
   int m_id;
+  std::vector<int> m_layer_group;
 };
 
 /**
@@ -144,6 +162,25 @@ public:
   lay::Bitmap *fill, *frame, *vertex, *text;
 };
 
+/**
+ *  @brief The drawing caches of one layer
+ *
+ *  These caches can be kept over multiple redraws (see RedrawThread::set_keep_caches).
+ *  The cell cache is valid for one magnification only while the micro instance caches
+ *  don't depend on the viewport.
+ */
+struct LayerDrawingCache
+{
+public:
+  LayerDrawingCache ()
+    : mag (0.0)
+  { }
+
+  std::map<CellCacheKey, CellCacheInfo> cell_cache;
+  std::map<std::pair<db::cell_index_type, unsigned int>, bool> mi_cache, mi_text_cache;
+  double mag;
+};
+
 /**
  *  @brief A callback class which is triggered when a snapshot is taken
  */
@@ -175,10 +212,52 @@ protected:
   void perform_task (tl::Task *task);
 
 private:
+  /**
+   *  @brief The state of one layer while a group of layers is drawn in a single pass
+   */
+  struct GroupLayer
+  {
+    GroupLayer ()
+      : task_id (0), layer (0), xfill (false), drawing_cache (0)
+    {
+      for (unsigned int i = 0; i < (unsigned int) planes_per_layer; ++i) {
+        planes [i] = 0;
+      }
+    }
+
+    int task_id;
+    unsigned int layer;
+    bool xfill;
+    lay::CanvasPlane *planes [planes_per_layer];
+    micro_instance_cache_t mi_cache, mi_text_cache;
+    cell_cache_t cell_cache;
+    LayerDrawingCache *drawing_cache;
+  };
+
+  /**
+   *  @brief The planes one layer of a group is drawn into
+   */
+  struct GroupTarget
+  {
+    GroupTarget (GroupLayer *l, lay::CanvasPlane *fi, lay::CanvasPlane *fr, lay::CanvasPlane *v, lay::CanvasPlane *t)
+      : layer (l), fill (fi), frame (fr), vertex (v), text (t)
+    { }
+
+    GroupLayer *layer;
+    lay::CanvasPlane *fill, *frame, *vertex, *text;
+  };
+
   void draw_layer (bool drawing_context, db::cell_index_type ci, const db::CplxTrans &trans, const std::vector <db::Box> &redraw_regions, int level);
   void draw_layer (int from_level, int to_level, db::cell_index_type ci, const db::CplxTrans &trans, const std::vector <db::Box> &redraw_regions, int level, lay::CanvasPlane *fill, lay::CanvasPlane *frame, lay::CanvasPlane *vertex, lay::CanvasPlane *text, const UpdateSnapshotCallback *update_snapshot);
   void draw_layer (int from_level, int to_level, db::cell_index_type ci, const db::CplxTrans &trans, const db::Box &redraw_box, int level, lay::CanvasPlane *fill, lay::CanvasPlane *frame, lay::CanvasPlane *vertex, lay::CanvasPlane *text, const UpdateSnapshotCallback *update_snapshot);
   void draw_layer_wo_cache (int from_level, int to_level, db::cell_index_type ci, const db::CplxTrans &trans, const std::vector<db::Box> &vv, int level, lay::CanvasPlane *fill, lay::CanvasPlane *frame, lay::CanvasPlane *vertex, lay::CanvasPlane *text, const UpdateSnapshotCallback *update_snapshot);
+  void draw_shapes (const db::Cell &cell, unsigned int layer, const db::CplxTrans &trans, const std::vector<db::Box> &vv, lay::CanvasPlane *fill, lay::CanvasPlane *frame, lay::CanvasPlane *vertex, lay::CanvasPlane *text, const UpdateSnapshotCallback *update_snapshot);
+  void draw_layer_group (const std::vector<int> &task_ids);
+  void draw_layer_group (bool drawing_context, db::cell_index_type ci, const db::CplxTrans &trans, const std::vector <db::Box> &redraw_regions, int level);
+  void draw_layer_group (int from_level, int to_level, db::cell_index_type ci, const db::CplxTrans &trans, const std::vector <db::Box> &redraw_regions, int level, const std::vector<GroupTarget> &targets, const UpdateSnapshotCallback *update_snapshot);
+  void draw_layer_group (int from_level, int to_level, db::cell_index_type ci, const db::CplxTrans &trans, const db::Box &redraw_box, int level, const std::vector<GroupTarget> &targets, const UpdateSnapshotCallback *update_snapshot);
+  void make_group_targets (int plane_group, std::vector<GroupTarget> &targets);
+  void draw_layer_group_wo_cache (int from_level, int to_level, db::cell_index_type ci, const db::CplxTrans &trans, const std::vector<db::Box> &vv, int level, const std::vector<GroupTarget> &targets, const UpdateSnapshotCallback *update_snapshot);
   void draw_text_layer (bool drawing_context, db::cell_index_type ci, const db::CplxTrans &trans, const std::vector <db::Box> &redraw_regions, int level);
   void draw_text_layer (bool drawing_context, db::cell_index_type ci, const db::CplxTrans &trans, const db::Box &redraw_region, int level, lay::CanvasPlane *fill, lay::CanvasPlane *frame, lay::CanvasPlane *vertex, lay::CanvasPlane *text, Bitmap *opt_bitmap);
   void draw_boxes (bool drawing_context, db::cell_index_type ci, const db::CplxTrans &trans, const std::vector <db::Box> &redraw_regions, int level);
@@ -197,6 +276,7 @@ private:
   bool drop_cell (const db::Cell &cell, const db::CplxTrans &trans);
   std::vector<db::Box> search_regions (const db::Box &cell_bbox, const db::Box &vp, int level);
   bool any_shapes (db::cell_index_type cell_index, unsigned int levels);
+  bool any_shapes (unsigned int layer, micro_instance_cache_t &mi_cache, db::cell_index_type cell_index, unsigned int levels);
   bool any_text_shapes (db::cell_index_type cell_index, unsigned int levels);
   bool any_cell_box (db::cell_index_type cell_index, unsigned int levels);
 
@@ -215,6 +295,7 @@ private:
   unsigned int m_text_font;
   bool m_text_visible;
   bool m_text_lazy_rendering;
+  bool m_text_label_culling;
   bool m_bitmap_caching;
   bool m_show_properties;
   bool m_apply_text_trans;
@@ -228,6 +309,7 @@ private:
 
   micro_instance_cache_t m_mi_cache, m_mi_text_cache, m_mi_cell_box_cache;
   cell_cache_t m_cell_cache;
+  std::vector<GroupLayer> *mp_group_layers;
   std::set <std::pair <db::CplxTrans, db::cell_index_type>, lay::CellVariantCacheCompare> *mp_cell_var_cache;
   unsigned int m_cache_hits, m_cache_misses;
   std::set <std::pair <db::DCplxTrans, int> > m_box_variants;
@@ -46,6 +46,7 @@ Renderer::Renderer (unsigned int width, unsigned int height, double resolution)
     m_precise (false),
     m_xfill (false),
     m_font (db::DefaultFont),
+    mp_label_occupancy (0),
     m_width (width), m_height (height),
     m_resolution (resolution)
 {
@@ -44,6 +44,7 @@ namespace lay
 {
 
 class CanvasPlane;
+class Bitmap;
 
 /**
  *  @brief A edge set and text rendering object
@@ -179,6 +180,29 @@ public:
     return m_apply_text_trans;
   }
 
+  /**
+   *  @brief Sets the label occupancy bitmap
+   *
+   *  If an occupancy bitmap is set, texts are rendered in a fast mode: texts
+   *  outside the bitmap are skipped and texts overlapping other texts rendered
+   *  before are dropped. The boxes of the texts rendered are recorded in the
+   *  occupancy bitmap, which must have the size of the text planes. The
+   *  glyphs are taken from pre-rendered bitmaps.
+   *  Set the occupancy bitmap to 0 to render all texts precisely.
+   */
+  void set_label_occupancy (lay::Bitmap *occupancy)
+  {
+    mp_label_occupancy = occupancy;
+  }
+
+  /**
+   *  @brief Gets the label occupancy bitmap
+   */
+  lay::Bitmap *label_occupancy () const
+  {
+    return mp_label_occupancy;
+  }
+
   /**
    *  @brief Render a generic shape into a set of bitmaps
    *
@@ -410,6 +434,7 @@ protected:
   bool m_precise;
   bool m_xfill;
   db::Font m_font;
+  lay::Bitmap *mp_label_occupancy;
   unsigned int m_width, m_height;
   double m_resolution;
 };
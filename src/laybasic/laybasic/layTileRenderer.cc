@@ -0,0 +1,221 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2019 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+
+#include "layTileRenderer.h"
+#include "layLayoutView.h"
+#include "layLayoutCanvas.h"
+#include "layRedrawThread.h"
+#include "layRedrawThreadCanvas.h"
+#include "tlThreadedWorkers.h"
+#include "tlFileUtils.h"
+#include "tlProgress.h"
+#include "tlTimer.h"
+#include "tlLog.h"
+#include "tlString.h"
+#include "tlInternational.h"
+#include "tlDeferredExecution.h"
+
+#include <QImage>
+#include <QImageWriter>
+
+#include <vector>
+#include <cmath>
+
+namespace lay
+{
+
+// ---------------------------------------------------------------
+//  The tile writer task and worker
+
+namespace
+{
+
+class TileWriterTask
+  : public tl::Task
+{
+public:
+  TileWriterTask (const QImage &image, const std::string &path)
+    : m_image (image), m_path (path)
+  {
+    //  .. nothing yet ..
+  }
+
+  void perform ()
+  {
+    QImageWriter writer (tl::to_qstring (m_path), QByteArray ("PNG"));
+    if (! writer.write (m_image)) {
+      throw tl::Exception (tl::to_string (QObject::tr ("Unable to write tile to file: %s (%s)")), m_path, tl::to_string (writer.errorString ()));
+    }
+  }
+
+private:
+  QImage m_image;
+  std::string m_path;
+};
+
+class TileWriterWorker
+  : public tl::Worker
+{
+public:
+  TileWriterWorker ()
+    : tl::Worker ()
+  {
+    //  .. nothing yet ..
+  }
+
+  void perform_task (tl::Task *task)
+  {
+    static_cast<TileWriterTask *> (task)->perform ();
+  }
+};
+
+}
+
+// ---------------------------------------------------------------
+//  TileRenderer implementation
+
+TileRenderer::TileRenderer (lay::LayoutView *view, lay::LayoutCanvas *canvas)
+  : mp_view (view), mp_canvas (canvas), m_tile_size (256), m_min_level (0), m_max_level (0), m_threads (0), m_oversampling (0), m_linewidth (0)
+{
+  //  .. nothing yet ..
+}
+
+static void
+flush_tiles (tl::Job<TileWriterWorker> &job, std::vector<TileWriterTask *> &pending)
+{
+  job.wait ();
+  if (job.has_error ()) {
+    for (std::vector<TileWriterTask *>::const_iterator t = pending.begin (); t != pending.end (); ++t) {
+      delete *t;
+    }
+    pending.clear ();
+    throw tl::Exception (tl::to_string (QObject::tr ("Errors occured during writing the tiles. First error message says:\n")) + job.error_messages ().front ());
+  }
+
+  if (! pending.empty ()) {
+    for (std::vector<TileWriterTask *>::const_iterator t = pending.begin (); t != pending.end (); ++t) {
+      job.schedule (*t);
+    }
+    pending.clear ();
+    job.start ();
+  }
+}
+
+size_t
+TileRenderer::render (const std::string &dir)
+{
+  tl::SelfTimer timer (tl::verbosity () >= 11, tl::to_string (QObject::tr ("Render tiles")));
+
+  db::DBox region (m_region);
+  if (region.empty ()) {
+    region = mp_view->full_box ();
+  }
+  if (region.empty () || m_tile_size == 0 || m_min_level > m_max_level) {
+    return 0;
+  }
+
+  int threads = m_threads > 0 ? m_threads : mp_view->drawing_workers ();
+
+  //  Execute all deferred methods - ensure there are no pending tasks
+  tl::DeferredMethodScheduler::execute ();
+
+  //  The pyramid covers a square anchored at the top left corner of the region
+  double side = std::max (region.width (), region.height ());
+  db::DPoint top_left (region.left (), region.top ());
+
+  size_t ntiles = 0;
+  for (unsigned int z = m_min_level; z <= m_max_level; ++z) {
+    double ts = side / double (1 << z);
+    ntiles += size_t (std::ceil (region.width () / ts - 1e-10)) * size_t (std::ceil (region.height () / ts - 1e-10));
+  }
+
+  tl::RelativeProgress progress (tl::to_string (QObject::tr ("Rendering tiles")), ntiles, 1);
+
+  //  A single redraw thread is used for all tiles: this way, the drawing caches are kept.
+  //  Since the cell caches are valid for one magnification only, the levels are rendered
+  //  one after another.
+  lay::BitmapRedrawThreadCanvas rd_canvas;
+  lay::RedrawThread redraw_thread (&rd_canvas, mp_view);
+  redraw_thread.set_keep_caches (true);
+
+  //  The tiles are written in batches while the next batch is rendered.
+  tl::Job<TileWriterWorker> job (std::max (1, threads));
+  std::vector<TileWriterTask *> pending;
+  size_t batch_size = size_t (std::max (1, threads)) * 4;
+
+  size_t written = 0;
+
+  try {
+
+    for (unsigned int z = m_min_level; z <= m_max_level; ++z) {
+
+      double ts = side / double (1 << z);
+      unsigned int nx = (unsigned int) std::ceil (region.width () / ts - 1e-10);
+      unsigned int ny = (unsigned int) std::ceil (region.height () / ts - 1e-10);
+
+      for (unsigned int x = 0; x < nx; ++x) {
+
+        std::string xdir = tl::combine_path (tl::combine_path (dir, tl::to_string (z)), tl::to_string (x));
+        if (! tl::mkpath (xdir)) {
+          throw tl::Exception (tl::to_string (QObject::tr ("Unable to create directory: %s")), xdir);
+        }
+
+        for (unsigned int y = 0; y < ny; ++y) {
+
+          ++progress;
+
+          db::DBox tile (top_left + db::DVector (x * ts, -(y + 1.0) * ts), top_left + db::DVector ((x + 1.0) * ts, -(y * ts)));
+
+          QImage img = mp_canvas->image_with_options (m_tile_size, m_tile_size, m_linewidth, m_oversampling, 0.0, QColor (), QColor (), QColor (), tile, false, redraw_thread, rd_canvas, threads);
+          pending.push_back (new TileWriterTask (img, tl::combine_path (xdir, tl::to_string (y) + ".png")));
+          ++written;
+
+          if (pending.size () >= batch_size) {
+            flush_tiles (job, pending);
+          }
+
+        }
+
+      }
+
+    }
+
+    //  start the last batch and wait for it
+    flush_tiles (job, pending);
+    flush_tiles (job, pending);
+
+  } catch (...) {
+    job.stop ();
+    for (std::vector<TileWriterTask *>::const_iterator t = pending.begin (); t != pending.end (); ++t) {
+      delete *t;
+    }
+    throw;
+  }
+
+  tl::log << "Saved " << written << " tiles to " << dir;
+
+  return written;
+}
+
+}
+
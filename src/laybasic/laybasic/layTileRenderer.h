@@ -0,0 +1,140 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2019 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+
+#ifndef HDR_layTileRenderer
+#define HDR_layTileRenderer
+
+#include "laybasicCommon.h"
+#include "dbBox.h"
+
+#include <string>
+
+namespace lay
+{
+
+class LayoutView;
+class LayoutCanvas;
+
+/**
+ *  @brief A renderer for map tile pyramids
+ *
+ *  This object renders the content of a layout view into a pyramid of PNG
+ *  tiles as used by web map viewers ("XYZ" scheme). On level z, the region
+ *  is covered by 2^z x 2^z square tiles. Tile (x, y) of level z is written
+ *  to "<dir>/<z>/<x>/<y>.png". x runs from left to right and y from top to
+ *  bottom. Tiles outside the region are not written.
+ *
+ *  The tiles are rendered level by level with a single redraw thread. The
+ *  layers are drawn in parallel and the drawing caches are kept over all
+ *  tiles, so the cells need to be drawn only once per level. The PNG tiles
+ *  are encoded and written by separate threads while the next tiles are
+ *  rendered.
+ *
+ *  The renderer does not need a visible view.
+ */
+class LAYBASIC_PUBLIC TileRenderer
+{
+public:
+  /**
+   *  @brief Constructor
+   *
+   *  Use LayoutView::save_tiles to render tiles from a view.
+   */
+  TileRenderer (lay::LayoutView *view, lay::LayoutCanvas *canvas);
+
+  /**
+   *  @brief Sets the tile size in pixels (default: 256)
+   */
+  void set_tile_size (unsigned int size)
+  {
+    m_tile_size = size;
+  }
+
+  /**
+   *  @brief Sets the range of levels to render (default: 0 to 0)
+   */
+  void set_levels (unsigned int min_level, unsigned int max_level)
+  {
+    m_min_level = min_level;
+    m_max_level = max_level;
+  }
+
+  /**
+   *  @brief Sets the region to render
+   *
+   *  By default, the full field box of the view is rendered. The region is
+   *  extended to a square at the top left corner.
+   */
+  void set_region (const db::DBox &region)
+  {
+    m_region = region;
+  }
+
+  /**
+   *  @brief Sets the number of threads
+   *
+   *  This is the number of drawing threads and the number of threads writing the tiles.
+   *  0 (the default) means to use the number of drawing workers of the view.
+   */
+  void set_threads (int n)
+  {
+    m_threads = n;
+  }
+
+  /**
+   *  @brief Sets the oversampling factor (0 for the view's default)
+   */
+  void set_oversampling (int os)
+  {
+    m_oversampling = os;
+  }
+
+  /**
+   *  @brief Sets the line width (0 for default)
+   */
+  void set_linewidth (int lw)
+  {
+    m_linewidth = lw;
+  }
+
+  /**
+   *  @brief Renders the tiles into the given directory
+   *
+   *  Returns the number of tiles written.
+   */
+  size_t render (const std::string &dir);
+
+private:
+  lay::LayoutView *mp_view;
+  lay::LayoutCanvas *mp_canvas;
+  unsigned int m_tile_size;
+  unsigned int m_min_level, m_max_level;
+  db::DBox m_region;
+  int m_threads;
+  int m_oversampling, m_linewidth;
+};
+
+}
+
+#endif
+
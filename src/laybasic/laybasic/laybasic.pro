@@ -83,6 +83,7 @@ SOURCES = \
   layAnnotationShapes.cc \
   layBitmap.cc \
   layBitmapRenderer.cc \
+  layGlyphAtlas.cc \
   layBitmapsToImage.cc \
   layBookmarkList.cc \
   layBookmarkManagementForm.cc \
@@ -143,6 +144,7 @@ SOURCES = \
   layStipplePalette.cc \
   layStream.cc \
   layTechnology.cc \
+  layTileRenderer.cc \
   layTipDialog.cc \
   layViewObject.cc \
   layViewOp.cc \
@@ -167,6 +169,7 @@ HEADERS = \
   layAnnotationShapes.h \
   layBitmap.h \
   layBitmapRenderer.h \
+  layGlyphAtlas.h \
   layBitmapsToImage.h \
   layBookmarkList.h \
   layBookmarkManagementForm.h \
@@ -227,6 +230,7 @@ HEADERS = \
   layStipplePalette.h \
   layStream.h \
   layTechnology.h \
+  layTileRenderer.h \
   layTipDialog.h \
   layViewObject.h \
   layViewOp.h \
@@ -80,7 +80,9 @@ static const std::string cfg_cell_box_visible ("inst-visible");
 static const std::string cfg_text_color ("text-color");
 static const std::string cfg_text_visible ("text-visible");
 static const std::string cfg_text_lazy_rendering ("text-lazy-rendering");
+static const std::string cfg_text_label_culling ("text-label-culling");
 static const std::string cfg_bitmap_caching ("bitmap-caching");
+static const std::string cfg_multi_layer_redraw ("multi-layer-redraw");
 static const std::string cfg_show_properties ("show-properties");
 static const std::string cfg_apply_text_trans ("apply-text-trans");
 static const std::string cfg_global_trans ("global-trans");
@@ -0,0 +1,215 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2019 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+
+
+#include "layGlyphAtlas.h"
+#include "layBitmapRenderer.h"
+#include "layBitmap.h"
+#include "tlUnitTest.h"
+
+static bool
+bit (const lay::Bitmap &bm, int x, int y)
+{
+  if (x < 0 || y < 0 || x >= int (bm.width ()) || y >= int (bm.height ())) {
+    return false;
+  }
+  return (bm.scanline (y)[x / 32] & (1 << (x % 32))) != 0;
+}
+
+static size_t
+count_bits (const lay::Bitmap &bm)
+{
+  size_t n = 0;
+  for (unsigned int y = 0; y < bm.height (); ++y) {
+    for (unsigned int x = 0; x < bm.width (); ++x) {
+      if (bit (bm, x, y)) {
+        ++n;
+      }
+    }
+  }
+  return n;
+}
+
+static bool
+equals (const lay::Bitmap &a, const lay::Bitmap &b)
+{
+  for (unsigned int y = 0; y < a.height (); ++y) {
+    for (unsigned int x = 0; x < a.width (); ++x) {
+      if (bit (a, x, y) != bit (b, x, y)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+//  Returns true if every pixel of a has a pixel of b in its 3x3 neighborhood
+static bool
+near (const lay::Bitmap &a, const lay::Bitmap &b)
+{
+  for (unsigned int y = 0; y < a.height (); ++y) {
+    for (unsigned int x = 0; x < a.width (); ++x) {
+      if (bit (a, x, y)) {
+        bool found = false;
+        for (int dy = -1; dy <= 1 && ! found; ++dy) {
+          for (int dx = -1; dx <= 1 && ! found; ++dx) {
+            found = bit (b, int (x) + dx, int (y) + dy);
+          }
+        }
+        if (! found) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+static lay::RenderText
+make_text (const db::DBox &b, const std::string &s, db::Font font, db::HAlign halign, db::VAlign valign, db::DFTrans trans = db::DFTrans ())
+{
+  lay::RenderText t;
+  t.b = b;
+  t.text = s;
+  t.font = font;
+  t.halign = halign;
+  t.valign = valign;
+  t.trans = trans;
+  return t;
+}
+
+//  Fixed font: the atlas renders the same pixels than Bitmap::render_text
+TEST(1)
+{
+  lay::GlyphAtlas atlas;
+  std::vector<lay::GlyphAtlas::Placement> placements;
+
+  db::HAlign ha[] = { db::HAlignLeft, db::HAlignCenter, db::HAlignRight };
+  db::VAlign va[] = { db::VAlignBottom, db::VAlignCenter, db::VAlignTop };
+
+  for (unsigned int i = 0; i < 3; ++i) {
+    for (unsigned int j = 0; j < 3; ++j) {
+
+      lay::RenderText t = make_text (db::DBox (db::DPoint (40.3, 30.6), db::DPoint (40.3, 50.6)), "Hello,\nW\303\266rld!", db::DefaultFont, ha [i], va [j]);
+
+      lay::Bitmap ref (100, 80, 1.0);
+      ref.render_text (t);
+
+      lay::Bitmap bm (100, 80, 1.0);
+      db::Box bx = atlas.place (t, 1.0, placements);
+      lay::GlyphAtlas::render (placements, bm);
+
+      EXPECT_EQ (count_bits (bm) > 0, true);
+      EXPECT_EQ (equals (bm, ref), true);
+
+      //  all pixels are inside the box
+      for (unsigned int y = 0; y < bm.height (); ++y) {
+        for (unsigned int x = 0; x < bm.width (); ++x) {
+          if (bit (bm, x, y)) {
+            EXPECT_EQ (bx.contains (db::Point (x, y)), true);
+          }
+        }
+      }
+
+    }
+  }
+
+  //  the fixed font glyphs are not cached
+  EXPECT_EQ (atlas.size (), size_t (0));
+}
+
+//  Hershey font: glyphs are cached and match Bitmap::render_text within one pixel
+TEST(2)
+{
+  lay::GlyphAtlas atlas;
+  std::vector<lay::GlyphAtlas::Placement> placements;
+
+  db::DFTrans tr[] = { db::DFTrans (db::DFTrans::r0), db::DFTrans (db::DFTrans::r90), db::DFTrans (db::DFTrans::m45) };
+
+  for (unsigned int i = 0; i < sizeof (tr) / sizeof (tr [0]); ++i) {
+
+    atlas.clear ();
+
+    lay::RenderText t = make_text (db::DBox (db::DPoint (120.0, 110.0), db::DPoint (120.0, 130.0)), "ABBA\nAB", db::Font (1), db::HAlignCenter, db::VAlignCenter, tr [i]);
+
+    lay::Bitmap ref (240, 240, 1.0);
+    ref.render_text (t);
+
+    lay::Bitmap bm (240, 240, 1.0);
+    db::Box bx = atlas.place (t, 1.0, placements);
+    lay::GlyphAtlas::render (placements, bm);
+
+    EXPECT_EQ (atlas.size (), size_t (2));
+    EXPECT_EQ (placements.size (), size_t (6));
+    EXPECT_EQ (bx.empty (), false);
+    EXPECT_EQ (count_bits (bm) > 500, true);
+    EXPECT_EQ (near (bm, ref), true);
+    EXPECT_EQ (near (ref, bm), true);
+
+  }
+
+  //  small texts are not drawn
+  lay::RenderText t = make_text (db::DBox (db::DPoint (10.0, 10.0), db::DPoint (10.0, 12.0)), "ABBA", db::Font (1), db::HAlignLeft, db::VAlignBottom);
+  EXPECT_EQ (atlas.place (t, 1.0, placements).empty (), true);
+  EXPECT_EQ (placements.empty (), true);
+}
+
+//  Label culling and decimation in BitmapRenderer
+TEST(3)
+{
+  lay::Bitmap occupancy (100, 50, 1.0);
+  lay::Bitmap bm (100, 50, 1.0);
+  lay::BitmapRenderer r (100, 50, 1.0);
+  r.set_label_occupancy (&occupancy);
+
+  r.insert (db::DBox (db::DPoint (10.0, 10.0), db::DPoint (10.0, 10.0)), "ABC", db::DefaultFont, db::HAlignLeft, db::VAlignBottom, db::DFTrans ());
+  r.render_texts (bm);
+  size_t n1 = count_bits (bm);
+  EXPECT_EQ (n1 > 0, true);
+  EXPECT_EQ (count_bits (occupancy) > n1, true);
+
+  //  overlapping: dropped
+  r.clear ();
+  r.insert (db::DBox (db::DPoint (14.0, 12.0), db::DPoint (14.0, 12.0)), "XYZ", db::DefaultFont, db::HAlignLeft, db::VAlignBottom, db::DFTrans ());
+  r.render_texts (bm);
+  EXPECT_EQ (count_bits (bm), n1);
+
+  //  outside: culled
+  r.clear ();
+  r.insert (db::DBox (db::DPoint (-100.0, 10.0), db::DPoint (-100.0, 10.0)), "XYZ", db::DefaultFont, db::HAlignLeft, db::VAlignBottom, db::DFTrans ());
+  r.render_texts (bm);
+  EXPECT_EQ (count_bits (bm), n1);
+
+  //  separate: drawn
+  r.clear ();
+  r.insert (db::DBox (db::DPoint (60.0, 30.0), db::DPoint (60.0, 30.0)), "ABC", db::DefaultFont, db::HAlignLeft, db::VAlignBottom, db::DFTrans ());
+  r.render_texts (bm);
+  EXPECT_EQ (count_bits (bm), n1 * 2);
+
+  //  without occupancy, all texts are drawn
+  r.set_label_occupancy (0);
+  r.clear ();
+  r.insert (db::DBox (db::DPoint (14.0, 12.0), db::DPoint (14.0, 12.0)), "XYZ", db::DefaultFont, db::HAlignLeft, db::VAlignBottom, db::DFTrans ());
+  r.render_texts (bm);
+  EXPECT_EQ (count_bits (bm) > n1 * 2, true);
+}
@@ -10,6 +10,7 @@ SOURCES = \
   layAnnotationShapes.cc \
   layBitmap.cc \
   layBitmapsToImage.cc \
+  layGlyphAtlas.cc \
   layLayerProperties.cc \
   layParsedLayerSource.cc \
   layRenderer.cc \
@@ -43,6 +43,7 @@ namespace db
 
 CIFReader::CIFReader (tl::InputStream &s)
   : m_stream (s),
+    mp_ptr (0), mp_end (0), m_line (1),
     m_progress (tl::to_string (tr ("Reading CIF file")), 1000),
     m_dbu (0.001), m_wire_mode (0)
 {
@@ -86,7 +87,7 @@ CIFReader::read (db::Layout &layout)
 void 
 CIFReader::error (const std::string &msg)
 {
-  throw CIFReaderException (msg, m_stream.line_number (), m_cellname);
+  throw CIFReaderException (msg, m_line, m_cellname);
 }
 
 void 
@@ -94,11 +95,50 @@ CIFReader::warn (const std::string &msg)
 {
   // TODO: compress
   tl::warn << msg 
-           << tl::to_string (tr (" (line=")) << m_stream.line_number ()
+           << tl::to_string (tr (" (line=")) << m_line
            << tl::to_string (tr (", cell=")) << m_cellname
            << ")";
 }
 
+/**
+ *  @brief Fetches the next block of characters from the stream
+ *
+ *  The characters are taken directly from the stream's buffer. They stay valid until 
+ *  the next call of this method.
+ */
+bool
+CIFReader::fill_buffer ()
+{
+  const char *b = m_stream.get (1);
+  if (! b) {
+    mp_ptr = mp_end = 0;
+    return false;
+  }
+
+  mp_ptr = b;
+  mp_end = b + 1;
+
+  //  take everything that is available in the stream's buffer already
+  size_t n = m_stream.is_inflating () ? 0 : m_stream.blen ();
+  if (n > 0 && m_stream.get (n) != 0) {
+    mp_end += n;
+  }
+
+  m_progress.set (m_line);
+  return true;
+}
+
+/**
+ *  @brief Skips white space characters
+ */
+void 
+CIFReader::skip_spaces ()
+{
+  while (! at_end () && isspace (*mp_ptr)) {
+    next_char ();
+  }
+}
+
 /**
  *  @brief Skip blanks in the sense of CIF
  *  A blank in CIF is "any ASCII character except digit, upperChar, '-', '(', ')', or ';'"
@@ -106,12 +146,12 @@ CIFReader::warn (const std::string &msg)
 void 
 CIFReader::skip_blanks()
 {
-  while (! m_stream.at_end ()) {
-    char c = m_stream.peek_char ();
+  while (! at_end ()) {
+    char c = peek_char ();
     if (isupper (c) || isdigit (c) || c == '-' || c == '(' || c == ')' || c == ';') {
       return;
     }
-    m_stream.get_char ();
+    next_char ();
   }
 }
 
@@ -121,12 +161,12 @@ CIFReader::skip_blanks()
 void 
 CIFReader::skip_sep ()
 {
-  while (! m_stream.at_end ()) {
-    char c = m_stream.peek_char ();
+  while (! at_end ()) {
+    char c = peek_char ();
     if (isdigit (c) || c == '-' || c == '(' || c == ')' || c == ';') {
       return;
     }
-    m_stream.get_char ();
+    next_char ();
   }
 }
 
@@ -140,7 +180,7 @@ CIFReader::skip_comment ()
 {
   char c;
   int bl = 0;
-  while (! m_stream.at_end () && ((c = m_stream.get_char ()) != ')' || bl > 0)) {
+  while (! at_end () && ((c = next_char ()) != ')' || bl > 0)) {
     // check for nested comments (bl is the nesting level)
     if (c == '(') {
       ++bl;
@@ -156,11 +196,11 @@ CIFReader::skip_comment ()
 char 
 CIFReader::get_char ()
 {
-  if (m_stream.at_end ()) {
+  if (at_end ()) {
     error ("Unexpected end of file");
     return 0;
   } else {
-    return m_stream.get_char ();
+    return next_char ();
   }
 }
 
@@ -171,7 +211,7 @@ bool
 CIFReader::test_semi ()
 {
   skip_blanks ();
-  if (! m_stream.at_end () && m_stream.peek_char () == ';') {
+  if (! at_end () && peek_char () == ';') {
     return true;
   } else {
     return false;
@@ -197,7 +237,7 @@ CIFReader::expect_semi ()
 void
 CIFReader::skip_to_end ()
 {
-  while (! m_stream.at_end () && m_stream.get_char () != ';') {
+  while (! at_end () && next_char () != ';') {
     ;
   }
 }
@@ -208,26 +248,39 @@ CIFReader::skip_to_end ()
 int 
 CIFReader::read_integer_digits ()
 {
-  if (m_stream.at_end () || ! isdigit (m_stream.peek_char ())) {
+  if (at_end () || ! isdigit (*mp_ptr)) {
     error ("Digit expected");
   }
 
   int i = 0;
-  while (! m_stream.at_end () && isdigit (m_stream.peek_char ())) {
+  while (! at_end ()) {
 
-    if (i > std::numeric_limits<int>::max () / 10) {
+    //  scan the digits available in the buffer directly
+    const char *p = mp_ptr;
+    while (p != mp_end && *p >= '0' && *p <= '9') {
+
+      if (i > std::numeric_limits<int>::max () / 10) {
+
+        mp_ptr = p;
+        error ("Integer overflow");
+        while (! at_end () && isdigit (peek_char ())) {
+          next_char ();
+        }
+
+        return 0;
 
-      error ("Integer overflow");
-      while (! m_stream.at_end () && isdigit (m_stream.peek_char ())) {
-        m_stream.get_char ();
       }
 
-      return 0;
+      i = i * 10 + int (*p - '0');
+      ++p;
 
     }
 
-    char c = m_stream.get_char ();
-    i = i * 10 + int (c - '0');
+    bool more = (p == mp_end);
+    mp_ptr = p;
+    if (! more) {
+      break;
+    }
 
   }
 
@@ -253,8 +306,8 @@ CIFReader::read_sinteger ()
   skip_sep ();
 
   bool neg = false;
-  if (m_stream.peek_char () == '-') {
-    m_stream.get_char ();
+  if (peek_char () == '-') {
+    next_char ();
     neg = true;
   }
 
@@ -271,13 +324,13 @@ CIFReader::read_name ()
   skip_blanks ();
 
   m_cmd_buffer.clear ();
-  if (m_stream.at_end ()) {
+  if (at_end ()) {
     return m_cmd_buffer;
   }
 
   //  Note: officially only upper and digits are allowed in names. But we allow lower case and "_" too ...
-  while (! m_stream.at_end () && (isupper (m_stream.peek_char ()) || islower (m_stream.peek_char ()) || m_stream.peek_char () == '_' || isdigit (m_stream.peek_char ()))) {
-    m_cmd_buffer += m_stream.get_char ();
+  while (! at_end () && (isupper (peek_char ()) || islower (peek_char ()) || peek_char () == '_' || isdigit (peek_char ()))) {
+    m_cmd_buffer += next_char ();
   }
 
   return m_cmd_buffer;
@@ -289,35 +342,35 @@ CIFReader::read_name ()
 const std::string &
 CIFReader::read_string ()
 {
-  m_stream.skip ();
+  skip_spaces ();
 
   m_cmd_buffer.clear ();
-  if (m_stream.at_end ()) {
+  if (at_end ()) {
     return m_cmd_buffer;
   }
 
-  char q = m_stream.peek_char ();
+  char q = peek_char ();
   if (q == '"' || q == '\'') {
 
     get_char ();
 
     //  read a quoted string (KLayout extension)
-    while (! m_stream.at_end () && m_stream.peek_char () != q) {
-      char c = m_stream.get_char ();
-      if (c == '\\' && ! m_stream.at_end ()) {
-        c = m_stream.get_char ();
+    while (! at_end () && peek_char () != q) {
+      char c = next_char ();
+      if (c == '\\' && ! at_end ()) {
+        c = next_char ();
       }
       m_cmd_buffer += c;
     }
 
-    if (! m_stream.at_end ()) {
+    if (! at_end ()) {
       get_char ();
     }
 
   } else {
 
-    while (! m_stream.at_end () && !isspace (m_stream.peek_char ()) && m_stream.peek_char () != ';') {
-      m_cmd_buffer += m_stream.get_char ();
+    while (! at_end () && !isspace (peek_char ()) && peek_char () != ';') {
+      m_cmd_buffer += next_char ();
     }
 
   }
@@ -331,12 +384,12 @@ CIFReader::read_string ()
 double
 CIFReader::read_double ()
 {
-  m_stream.skip ();
+  skip_spaces ();
 
   //  read a quoted string (KLayout extension)
   m_cmd_buffer.clear ();
-  while (! m_stream.at_end () && (isdigit (m_stream.peek_char ()) || m_stream.peek_char () == '.' || m_stream.peek_char () == '-' || m_stream.peek_char () == 'e' || m_stream.peek_char () == 'E')) {
-    m_cmd_buffer += m_stream.get_char ();
+  while (! at_end () && (isdigit (peek_char ()) || peek_char () == '.' || peek_char () == '-' || peek_char () == 'e' || peek_char () == 'E')) {
+    m_cmd_buffer += next_char ();
   }
 
   double v = 0.0;
@@ -716,7 +769,7 @@ CIFReader::read_cell (db::Layout &layout, db::Cell &cell, double sf, int level)
 
     } else if (isdigit (c)) {
 
-      char cc = m_stream.peek_char ();
+      char cc = peek_char ();
       if (c == '9' && cc == '3') {
 
         get_char ();
@@ -840,7 +893,7 @@ CIFReader::do_read (db::Layout &layout)
 
     skip_blanks ();
 
-    if (! m_stream.at_end ()) {
+    if (! at_end ()) {
       warn ("E command is followed by more text");
     }
 
@@ -132,7 +132,9 @@ public:
   virtual void warn (const std::string &txt);
 
 private:
-  tl::TextInputStream m_stream;
+  tl::InputStream &m_stream;
+  const char *mp_ptr, *mp_end;
+  size_t m_line;
   tl::AbsoluteProgress m_progress;
   double m_dbu;
   unsigned int m_wire_mode;
@@ -142,6 +144,32 @@ private:
 
   void do_read (db::Layout &layout);
 
+  bool fill_buffer ();
+
+  bool at_end ()
+  {
+    return mp_ptr == mp_end && ! fill_buffer ();
+  }
+
+  char peek_char ()
+  {
+    return at_end () ? 0 : *mp_ptr;
+  }
+
+  char next_char ()
+  {
+    if (at_end ()) {
+      return 0;
+    }
+    char c = *mp_ptr++;
+    if (c == '\n') {
+      ++m_line;
+    }
+    return c;
+  }
+
+  void skip_spaces ();
+
   const char *fetch_command ();
   bool read_cell (db::Layout &layout, db::Cell &cell, double sf, int level);
   void skip_blanks();
@@ -44,17 +44,86 @@ CIFWriter::CIFWriter ()
   m_progress.set_unit (1024 * 1024);
 }
 
+//  The output is collected in a buffer which is flushed when it exceeds this size
+const size_t cif_buffer_size = 65536;
+
+void
+CIFWriter::put (const char *s, size_t n)
+{
+  m_buffer.insert (m_buffer.end (), s, s + n);
+  if (m_buffer.size () >= cif_buffer_size) {
+    flush_buffer ();
+  }
+}
+
+void
+CIFWriter::flush_buffer ()
+{
+  if (! m_buffer.empty ()) {
+    mp_stream->put (&m_buffer.front (), m_buffer.size ());
+    m_buffer.clear ();
+  }
+}
+
+void
+CIFWriter::put_unsigned (unsigned long n, bool neg)
+{
+  //  formats the number directly (this is much faster than tl::to_string)
+  char b [32];
+  char *p = b + sizeof (b);
+  do {
+    *--p = char ('0' + n % 10);
+    n /= 10;
+  } while (n > 0);
+  if (neg) {
+    *--p = '-';
+  }
+  put (p, b + sizeof (b) - p);
+}
+
 CIFWriter &
 CIFWriter::operator<<(const char *s)
 {
-  mp_stream->put(s, strlen(s));
+  put (s, strlen (s));
   return *this;
 }
 
 CIFWriter &
 CIFWriter::operator<<(const std::string &s)
 {
-  mp_stream->put(s.c_str(), s.size());
+  put (s.c_str (), s.size ());
+  return *this;
+}
+
+CIFWriter &
+CIFWriter::operator<<(int n)
+{
+  return *this << long (n);
+}
+
+CIFWriter &
+CIFWriter::operator<<(unsigned int n)
+{
+  put_unsigned (n, false);
+  return *this;
+}
+
+CIFWriter &
+CIFWriter::operator<<(long n)
+{
+  if (n < 0) {
+    //  NOTE: this formulation avoids an overflow for the smallest long value
+    put_unsigned ((unsigned long) (-(n + 1)) + 1, true);
+  } else {
+    put_unsigned ((unsigned long) n, false);
+  }
+  return *this;
+}
+
+CIFWriter &
+CIFWriter::operator<<(unsigned long n)
+{
+  put_unsigned (n, false);
   return *this;
 }
 
@@ -81,6 +150,9 @@ CIFWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::SaveLa
   m_options = options.get_options<CIFWriterOptions> ();
   mp_stream = &stream;
 
+  m_buffer.clear ();
+  m_buffer.reserve (cif_buffer_size + 1024);
+
   //  compute the scale factor to get to the 10 nm basic database unit of CIF
   double tl_scale = options.scale_factor () * layout.dbu () / 0.01;
 
@@ -243,6 +315,8 @@ CIFWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::SaveLa
   //  end of file
   *this << "E" << endl;
 
+  flush_buffer ();
+
   m_progress.set (mp_stream->pos ());
 
 }
@@ -32,6 +32,8 @@
 #include "dbSaveLayoutOptions.h"
 #include "tlProgress.h"
 
+#include <vector>
+
 namespace tl
 {
   class OutputStream;
@@ -70,15 +72,25 @@ private:
   db::LayerProperties m_layer;
   bool m_needs_emit;
   
+  std::vector<char> m_buffer;
+
   CIFWriter &operator<<(const char *s);
   CIFWriter &operator<<(const std::string &s);
   CIFWriter &operator<<(endl_tag); 
+  CIFWriter &operator<<(int n);
+  CIFWriter &operator<<(unsigned int n);
+  CIFWriter &operator<<(long n);
+  CIFWriter &operator<<(unsigned long n);
 
   template<class X> CIFWriter &operator<<(const X &x) 
   {
     return (*this << tl::to_string(x));
   }
 
+  void put (const char *s, size_t n);
+  void put_unsigned (unsigned long n, bool neg);
+  void flush_buffer ();
+
   void write_texts (const db::Layout &layout, const db::Cell &cell, unsigned int layer, double tl_scale);
   void write_polygons (const db::Layout &layout, const db::Cell &cell, unsigned int layer, double tl_scale);
   void write_polygon (const db::Polygon &polygon, double tl_scale);
@@ -25,6 +25,7 @@
 #include "dbLayoutDiff.h"
 #include "dbWriter.h"
 #include "dbCIFWriter.h"
+#include "dbTextWriter.h"
 #include "tlUnitTest.h"
 
 #include <stdlib.h>
@@ -189,3 +190,116 @@ TEST(lasi)
   run_test (_this, tl::testsrc (), "lasi.cif.gz", "lasi_au.gds.gz");
 }
 
+
+static std::string read_cif_string (const char *cif)
+{
+  tl::InputMemoryStream ims (cif, strlen (cif));
+  tl::InputStream is (ims);
+  db::Layout layout;
+  db::CIFReader reader (is);
+  reader.read (layout);
+
+  tl::OutputStringStream os;
+  tl::OutputStream stream (os);
+  db::TextWriter textwriter (stream);
+  textwriter.write (layout);
+  return os.string ();
+}
+
+TEST(10_Scanner)
+{
+  const char *cif = 
+    "(a comment (nested) ;);\n"
+    "DS 1 1 1;\n"
+    "9 CELL_A;\n"
+    "L L1;\n"
+    "B 200 100 -100,50;\n"
+    "P 0 0 0 2147483 100 100;\n"
+    "98 0;\n"
+    "W 20 0 0 1000 -1000;\n"
+    "94 \"a label\" -10 20;\n"
+    "DF;\n"
+    "DS 2;\n"
+    "9 TOP;\n"
+    "C 1 MX R 0,1 T 1000 -2000;\n"
+    "DF;\n"
+    "C 2;\n"
+    "E\n"
+  ;
+
+  EXPECT_EQ (read_cif_string (cif),
+    "begin_lib 0.001\n"
+    "begin_cell {CELL_A}\n"
+    "boundary 1 0 {0 0} {0 21474830} {1000 1000} {0 0}\n"
+    "box 1 0 {-2000 0} {0 1000}\n"
+    "path 1 0 200 0 0 {0 0} {10000 -10000}\n"
+    "text 1 0 0 0 {-100 200} {a label}\n"
+    "end_cell\n"
+    "begin_cell {TOP}\n"
+    "sref {CELL_A} 270 1 1 {10000 -20000}\n"
+    "end_cell\n"
+    "end_lib\n"
+  );
+}
+
+TEST(11_ScannerErrors)
+{
+  const char *cif = 
+    "DS 1;\n"
+    "L L1;\n"
+    "B 200 100\n"
+    "  99999999999 0;\n"
+    "DF;\n"
+    "E\n"
+  ;
+
+  std::string msg;
+  try {
+    read_cif_string (cif);
+  } catch (tl::Exception &ex) {
+    msg = ex.msg ();
+  }
+  EXPECT_EQ (msg, "Integer overflow (line=4, cell=C1)");
+}
+
+TEST(12_WriterFormat)
+{
+  db::Layout layout;
+  unsigned int l1 = layout.insert_layer (db::LayerProperties ("L1"));
+  db::Cell &a = layout.cell (layout.add_cell ("A"));
+  a.shapes (l1).insert (db::Box (-1000, -2000, 3000, 4000));
+  db::Point pts[] = { db::Point (-2147483640, 0), db::Point (0, 1000), db::Point (1000, -10) };
+  db::Polygon poly;
+  poly.assign_hull (pts, pts + 3);
+  a.shapes (l1).insert (poly);
+  a.shapes (l1).insert (db::Path (pts + 1, pts + 3, 20, 0, 0, false));
+  db::Cell &top = layout.cell (layout.add_cell ("TOP"));
+  top.insert (db::CellInstArray (db::CellInst (a.cell_index ()), db::Trans (1, true, db::Vector (-10, 20))));
+
+  tl::OutputStringStream os;
+  {
+    tl::OutputStream stream (os);
+    db::CIFWriter writer;
+    writer.write (layout, stream, db::SaveLayoutOptions ());
+  }
+
+  std::string s = os.string ();
+  //  skip the header line with the time stamp
+  s = std::string (s, s.find ("\n") + 1);
+
+  EXPECT_EQ (s,
+    "DS 1 1 10;\n"
+    "9 A;\n"
+    "L L1;\n"
+    "P 1000,-10 -2147483640,0 0,1000;\n"
+    "98 0;\n"
+    "W 20 0,1000 1000,-10;\n"
+    "B 4000 6000 1000,1000;\n"
+    "DF;\n"
+    "DS 2 1 10;\n"
+    "9 TOP;\n"
+    "C1 MY R0,1 T-10,20;\n"
+    "DF;\n"
+    "E\n"
+  );
+}
@@ -64,7 +64,7 @@ GDS2Reader::read (db::Layout &layout, const db::LoadLayoutOptions &options)
   --m_recnum;
   m_reclen = 0;
 
-  return basic_read (layout, m_common_options.layer_map, m_common_options.create_other_layers, m_common_options.enable_text_objects, m_common_options.enable_properties, m_options.allow_multi_xy_records, m_options.box_mode);
+  return basic_read (layout, m_common_options.layer_map, m_common_options.create_other_layers, m_common_options.enable_text_objects, m_common_options.enable_properties, m_options.allow_multi_xy_records, m_options.box_mode, m_common_options.region);
 }
 
 const LayerMap &
@@ -73,6 +73,26 @@ GDS2Reader::read (db::Layout &layout)
   return read (layout, db::LoadLayoutOptions ());
 }
 
+bool
+GDS2Reader::can_rewind () const
+{
+  //  pipes for example can be read once only
+  return m_stream.supports_reset ();
+}
+
+void
+GDS2Reader::rewind ()
+{
+  m_stream.reset ();
+
+  m_recnum = 0;
+  --m_recnum;
+  m_reclen = 0;
+  m_recptr = 0;
+  mp_rec_buf = 0;
+  m_stored_rec = 0;
+}
+
 void 
 GDS2Reader::unget_record (short rec_id)
 {  
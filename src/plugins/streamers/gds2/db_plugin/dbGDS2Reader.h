@@ -135,6 +135,8 @@ private:
   virtual void get_time (unsigned int *mod_time, unsigned int *access_time);
   virtual GDS2XY *get_xy_data (unsigned int &length);
   virtual void progress_checkpoint ();
+  virtual bool can_rewind () const;
+  virtual void rewind ();
 };
 
 }
@@ -24,6 +24,7 @@
 #include "dbGDS2ReaderBase.h"
 #include "dbGDS2.h"
 #include "dbArray.h"
+#include "dbCommonReader.h"
 
 #include "tlException.h"
 #include "tlString.h"
@@ -73,7 +74,10 @@ GDS2ReaderBase::GDS2ReaderBase ()
     m_read_texts (true),
     m_read_properties (true),
     m_allow_multi_xy_records (false),
-    m_box_mode (0)
+    m_box_mode (0),
+    m_bbox_only (false),
+    m_bbox_layer (0),
+    m_filter_cells (false)
 {
   // .. nothing yet ..
 }
@@ -84,7 +88,7 @@ GDS2ReaderBase::~GDS2ReaderBase ()
 }
 
 const LayerMap &
-GDS2ReaderBase::basic_read (db::Layout &layout, const LayerMap &layer_map, bool create_other_layers, bool enable_text_objects, bool enable_properties, bool allow_multi_xy_records, unsigned int box_mode)
+GDS2ReaderBase::basic_read (db::Layout &layout, const LayerMap &layer_map, bool create_other_layers, bool enable_text_objects, bool enable_properties, bool allow_multi_xy_records, unsigned int box_mode, const db::DBox &region)
 {
   m_layer_map = layer_map;
   m_layer_map.prepare (layout);
@@ -95,8 +99,63 @@ GDS2ReaderBase::basic_read (db::Layout &layout, const LayerMap &layer_map, bool
   m_box_mode = box_mode;
   m_create_layers = create_other_layers;
 
+  m_cell_regions.clear ();
+  m_read_cells.clear ();
+
   layout.start_changes ();
-  do_read (layout);
+
+  if (! region.empty () && can_rewind ()) {
+
+    //  Scan pass: determine the bounding boxes of the cells without storing any shapes.
+    //  A scratch layout receives the instances and one box per cell representing its shapes.
+    {
+      db::Layout scratch;
+      m_bbox_layer = scratch.insert_layer ();
+
+      m_bbox_only = true;
+      try {
+        do_read (scratch);
+        m_bbox_only = false;
+      } catch (...) {
+        m_bbox_only = false;
+        throw;
+      }
+
+      std::set<db::cell_index_type> all_cells;
+      for (db::Layout::const_iterator c = scratch.begin (); c != scratch.end (); ++c) {
+        all_cells.insert (c->cell_index ());
+      }
+
+      scratch.update ();
+
+      std::map<db::cell_index_type, db::Box> cell_regions;
+      compute_cell_regions (scratch, all_cells, db::CplxTrans (scratch.dbu ()).inverted () * region, cell_regions);
+      for (std::map<db::cell_index_type, db::Box>::const_iterator r = cell_regions.begin (); r != cell_regions.end (); ++r) {
+        m_cell_regions.insert (std::make_pair (tl::string (scratch.cell_name (r->first)), r->second));
+      }
+    }
+
+    //  Read pass: read the cells contributing to the region only
+    rewind ();
+
+    m_filter_cells = true;
+    try {
+      do_read (layout);
+      m_filter_cells = false;
+    } catch (...) {
+      m_filter_cells = false;
+      throw;
+    }
+
+  } else {
+    do_read (layout);
+  }
+
+  //  Removes the shapes, instances and cells not covered by the region of interest
+  if (! region.empty ()) {
+    restrict_to_region (layout, m_read_cells, db::CplxTrans (layout.dbu ()).inverted () * region);
+  }
+
   layout.end_changes ();
 
   return m_layer_map;
@@ -173,6 +232,12 @@ GDS2ReaderBase::finish_element (db::PropertiesRepository &rep)
 }
 
 
+db::ImportLayerMapping *
+GDS2ReaderBase::create_proxy_layer_mapping (db::Layout &layout)
+{
+  return new GDS2ReaderLayerMapping (this, &layout, m_create_layers);
+}
+
 std::pair <bool, unsigned int> 
 GDS2ReaderBase::open_dl (db::Layout &layout, const LDPair &dl, bool create) 
 {
@@ -201,6 +266,28 @@ GDS2ReaderBase::open_dl (db::Layout &layout, const LDPair &dl, bool create)
   }
 }
 
+std::pair <bool, unsigned int>
+GDS2ReaderBase::open_shape_dl (db::Layout &layout, const LDPair &dl)
+{
+  if (m_bbox_only) {
+    //  the scan pass does not create layers
+    return std::make_pair (m_create_layers || m_layer_map.logical (dl).first, m_bbox_layer);
+  } else {
+    return open_dl (layout, dl, m_create_layers);
+  }
+}
+
+bool
+GDS2ReaderBase::take_shape (const db::Box &box)
+{
+  if (m_bbox_only) {
+    m_cell_bbox += box;
+    return false;
+  } else {
+    return ! m_filter_cells || box.touches (m_cell_region);
+  }
+}
+
 inline db::Point 
 pt_conv (const GDS2XY &p) 
 {
@@ -349,16 +436,29 @@ GDS2ReaderBase::do_read (db::Layout &layout)
 
       read_context_info_cell ();
 
+    } else if (m_filter_cells && m_context_info.find (m_cellname) == m_context_info.end () && m_cell_regions.find (m_cellname) == m_cell_regions.end ()) {
+
+      //  the cell does not contribute to the region of interest: skip its body
+      while ((rec_id = get_record ()) != sENDSTR) {
+        progress_checkpoint ();
+      }
+
     } else {
 
       db::cell_index_type cell_index = make_cell (layout, m_cellname.c_str (), false);
 
+      m_cell_bbox = db::Box ();
+      if (m_filter_cells) {
+        std::map <tl::string, db::Box>::const_iterator r = m_cell_regions.find (m_cellname);
+        m_cell_region = (r != m_cell_regions.end () ? r->second : db::Box::world ());
+      }
+
       db::Cell *cell = &layout.cell (cell_index);
 
       std::map <tl::string, std::vector <std::string> >::const_iterator ctx = m_context_info.find (m_cellname);
-      if (ctx != m_context_info.end ()) {
+      if (ctx != m_context_info.end () && ! m_bbox_only) {
         GDS2ReaderLayerMapping layer_mapping (this, &layout, m_create_layers);
-        if (layout.recover_proxy_as (cell_index, ctx->second.begin (), ctx->second.end (), &layer_mapping)) {
+        if (recover_proxy_as (layout, cell_index, ctx->second, &layer_mapping)) {
           //  ignore everything in that cell since it is created by the import:
           cell = 0;
           //  marks the cell for begin addressed by REF's despite being a proxy:
@@ -442,6 +542,11 @@ GDS2ReaderBase::do_read (db::Layout &layout)
         cell->prop_id (layout.properties_repository ().properties_id (cell_properties));
       }
 
+      //  the scan pass represents the cell's shapes by their bounding box
+      if (m_bbox_only && ! m_cell_bbox.empty ()) {
+        cell->shapes (m_bbox_layer).insert (m_cell_bbox);
+      }
+
     }
 
     m_cellname = "";
@@ -550,7 +655,7 @@ GDS2ReaderBase::read_boundary (db::Layout &layout, db::Cell &cell, bool from_box
   unsigned int xy_length = 0;
   GDS2XY *xy_data = get_xy_data (xy_length);
 
-  std::pair<bool, unsigned int> ll = open_dl (layout, ld, m_create_layers);
+  std::pair<bool, unsigned int> ll = open_shape_dl (layout, ld);
   if (ll.first) {
 
     //  create a box object if possible
@@ -583,7 +688,9 @@ GDS2ReaderBase::read_boundary (db::Layout &layout, db::Cell &cell, bool from_box
       }
 
       std::pair<bool, db::properties_id_type> pp = finish_element (layout.properties_repository ());
-      if (pp.first) {
+      if (! take_shape (db::Box (p1, p2))) {
+        //  not stored
+      } else if (pp.first) {
         cell.shapes (ll.second).insert (db::BoxWithProperties (db::Box (p1, p2), pp.second));
       } else {
         cell.shapes (ll.second).insert (db::Box (p1, p2));
@@ -642,7 +749,9 @@ GDS2ReaderBase::read_boundary (db::Layout &layout, db::Cell &cell, bool from_box
       } else {
         //  this will copy the polyon:
         std::pair<bool, db::properties_id_type> pp = finish_element (layout.properties_repository ());
-        if (pp.first) {
+        if (! take_shape (poly.box ())) {
+          //  not stored
+        } else if (pp.first) {
           cell.shapes (ll.second).insert (db::SimplePolygonRefWithProperties (db::SimplePolygonRef (poly, layout.shape_repository ()), pp.second));
         } else {
           cell.shapes (ll.second).insert (db::SimplePolygonRef (poly, layout.shape_repository ()));
@@ -731,7 +840,7 @@ GDS2ReaderBase::read_path (db::Layout &layout, db::Cell &cell)
   unsigned int xy_length = 0;
   GDS2XY *xy_data = get_xy_data (xy_length);
 
-  std::pair<bool, unsigned int> ll = open_dl (layout, ld, m_create_layers);
+  std::pair<bool, unsigned int> ll = open_shape_dl (layout, ld);
   if (ll.first) {
 
     //  this will copy the path:
@@ -779,7 +888,9 @@ GDS2ReaderBase::read_path (db::Layout &layout, db::Cell &cell)
         warn (tl::to_string (tr ("PATH with less than two points encountered - interpretation may be different in other tools")));
       }
       std::pair<bool, db::properties_id_type> pp = finish_element (layout.properties_repository ());
-      if (pp.first) {
+      if (! take_shape (path.box ())) {
+        //  not stored
+      } else if (pp.first) {
         cell.shapes (ll.second).insert (db::PathRefWithProperties (db::PathRef (path, layout.shape_repository ()), pp.second));
       } else {
         cell.shapes (ll.second).insert (db::PathRef (path, layout.shape_repository ()));
@@ -822,7 +933,7 @@ GDS2ReaderBase::read_text (db::Layout &layout, db::Cell &cell)
   std::pair<bool, unsigned int> ll (false, 0);
 
   if (m_read_texts) {
-    ll = open_dl (layout, ld, m_create_layers);
+    ll = open_shape_dl (layout, ld);
   }
 
   rec_id = get_record ();
@@ -915,7 +1026,9 @@ GDS2ReaderBase::read_text (db::Layout &layout, db::Cell &cell)
     db::Text text (get_string (), t, size, font, ha, va);
 
     std::pair<bool, db::properties_id_type> pp = finish_element (layout.properties_repository ());
-    if (pp.first) {
+    if (! take_shape (text.box ())) {
+      //  not stored
+    } else if (pp.first) {
       cell.shapes (ll.second).insert (db::TextRefWithProperties (db::TextRef (text, layout.shape_repository ()), pp.second));
     } else {
       cell.shapes (ll.second).insert (db::TextRef (text, layout.shape_repository ()));
@@ -944,7 +1057,7 @@ GDS2ReaderBase::read_box (db::Layout &layout, db::Cell &cell)
   }
   ld.datatype = get_ushort ();
 
-  std::pair<bool, unsigned int> ll = open_dl (layout, ld, m_create_layers);
+  std::pair<bool, unsigned int> ll = open_shape_dl (layout, ld);
 
   if (get_record () != sXY) {
     error (tl::to_string (tr ("XY record expected")));
@@ -962,7 +1075,7 @@ GDS2ReaderBase::read_box (db::Layout &layout, db::Cell &cell)
     }
 
     std::pair<bool, db::properties_id_type> pp = finish_element (layout.properties_repository ());
-    if (! box.empty ()) {
+    if (! box.empty () && take_shape (box)) {
       if (pp.first) {
         cell.shapes (ll.second).insert (db::BoxWithProperties (box, pp.second));
       } else {
@@ -1020,6 +1133,10 @@ GDS2ReaderBase::make_cell (db::Layout &layout, const char *cn, bool for_instance
 
   }
 
+  if (! m_bbox_only) {
+    m_read_cells.insert (ci);
+  }
+
   return ci;
 }
 
@@ -36,6 +36,8 @@
 #include "tlString.h"
 #include "tlStream.h"
 
+#include <set>
+
 namespace db
 {
 
@@ -86,9 +88,13 @@ protected:
    *  @param enable_properties A flag indicating whether to read user properties
    *  @param allow_multi_xy_records If true, tries to check for multiple XY records for BOUNDARY elements
    *  @param box_mode How to treat BOX records (0: ignore, 1: as rectangles, 2: as boundaries, 3: error)
+   *  @param region The region of interest in micrometer units (an empty box for "read everything")
    *  @return The LayerMap object that tells where which layer was loaded
+   *
+   *  If a region is given and the stream can be rewound, the reader will first scan the
+   *  file for the cell bounding boxes and then read the cells required for the region only.
    */
-  const LayerMap &basic_read (db::Layout &layout, const LayerMap &layer_map, bool create_other_layers, bool enable_text_objects, bool enable_properties, bool allow_multi_xy_records, unsigned int box_mode);
+  const LayerMap &basic_read (db::Layout &layout, const LayerMap &layer_map, bool create_other_layers, bool enable_text_objects, bool enable_properties, bool allow_multi_xy_records, unsigned int box_mode, const db::DBox &region = db::DBox ());
 
   /**
    *  @brief Accessor method to the current cellname
@@ -110,6 +116,13 @@ private:
   std::map <tl::string, std::vector<std::string> > m_context_info;
   std::vector <db::Point> m_all_points;
   std::map <tl::string, tl::string> m_mapped_cellnames;
+  bool m_bbox_only;
+  unsigned int m_bbox_layer;
+  db::Box m_cell_bbox;
+  bool m_filter_cells;
+  db::Box m_cell_region;
+  std::map <tl::string, db::Box> m_cell_regions;
+  std::set <db::cell_index_type> m_read_cells;
 
   void read_context_info_cell ();
   void read_boundary (db::Layout &layout, db::Cell &cell, bool from_box_record);
@@ -122,6 +135,9 @@ private:
   void do_read (db::Layout &layout);
 
   std::pair <bool, unsigned int> open_dl (db::Layout &layout, const LDPair &dl, bool create);
+  virtual db::ImportLayerMapping *create_proxy_layer_mapping (db::Layout &layout);
+  std::pair <bool, unsigned int> open_shape_dl (db::Layout &layout, const LDPair &dl);
+  bool take_shape (const db::Box &box);
   std::pair <bool, db::properties_id_type> finish_element (db::PropertiesRepository &rep);
   void finish_element ();
 
@@ -139,6 +155,16 @@ private:
   virtual void get_time (unsigned int *mod_time, unsigned int *access_time) = 0;
   virtual GDS2XY *get_xy_data (unsigned int &xy_length) = 0;
   virtual void progress_checkpoint () = 0;
+
+  /**
+   *  @brief Returns a value indicating whether the stream can be read again from the beginning
+   */
+  virtual bool can_rewind () const { return false; }
+
+  /**
+   *  @brief Restarts reading from the beginning of the stream
+   */
+  virtual void rewind () { }
 };
 
 }
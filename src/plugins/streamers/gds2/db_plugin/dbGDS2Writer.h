@@ -27,8 +27,12 @@
 #include "dbPluginCommon.h"
 #include "dbGDS2WriterBase.h"
 #include "dbWriterTools.h"
+#include "dbLayout.h"
+#include "dbSaveLayoutOptions.h"
 #include "tlProgress.h"
 
+#include <memory>
+
 namespace db
 {
 
@@ -114,7 +118,53 @@ private:
   tl::AbsoluteProgress m_progress;
 };
 
+/**
+ *  @brief A push-style streaming GDS2 writer
+ *
+ *  This writer does not need the full layout in memory. Cells are built one at a time:
+ *  "begin_cell" opens a cell into which shapes and instances are inserted. "end_cell" 
+ *  writes this cell as a STRUCTURE and discards its content. Cells can be referenced 
+ *  before they are written by using "cell_index". "close" finishes the file.
+ *
+ *  The writer holds a scratch layout which provides the layers, the property 
+ *  repository and the cell directory. Only the content of the open cell is kept in memory.
+ */
+class DB_PLUGIN_PUBLIC GDS2StreamWriter
+  : public db::StreamWriterBase<db::GDS2Writer>
+{
+public:
+  /**
+   *  @brief Creates a streaming writer for the given stream
+   *
+   *  The stream needs to stay valid until "close" has been called.
+   */
+  GDS2StreamWriter (tl::OutputStream &stream, double dbu, const db::SaveLayoutOptions &options = db::SaveLayoutOptions ())
+    : db::StreamWriterBase<db::GDS2Writer> (stream, dbu, options)
+  {
+    //  .. nothing yet ..
+  }
+
+  /**
+   *  @brief Creates a streaming writer for the given file
+   */
+  GDS2StreamWriter (const std::string &path, double dbu, const db::SaveLayoutOptions &options = db::SaveLayoutOptions ())
+    : db::StreamWriterBase<db::GDS2Writer> (path, dbu, options)
+  {
+    //  .. nothing yet ..
+  }
+};
+
 } // namespace db
 
+namespace tl
+{
+  template <>
+  struct type_traits<db::GDS2StreamWriter> : public type_traits<void>
+  {
+    typedef tl::false_tag has_default_constructor;
+    typedef tl::false_tag has_copy_constructor;
+  };
+}
+
 #endif
 
@@ -47,7 +47,13 @@ namespace db
 //  GDS2WriterBase implementation
 
 GDS2WriterBase::GDS2WriterBase ()
+  : m_sf (1.0), m_dbu (0.001), m_multi_xy (false), m_max_vertex_count (8000), m_no_zero_length_paths (false), m_write_cell_properties (false),
+    mp_incremental_layout (0)
 {
+  for (unsigned int i = 0; i < 6; ++i) {
+    m_time_data [i] = 0;
+  }
+
   // .. nothing yet ..
 }
 
@@ -107,35 +113,13 @@ GDS2WriterBase::write (db::Layout &layout, tl::OutputStream &stream, const db::S
   }
 
   //  get current time
-  short time_data [6] = { 0, 0, 0, 0, 0, 0 };
-  if (gds2_options.write_timestamps) {
-    time_t ti = 0;
-    time (&ti);
-    const struct tm *t = localtime (&ti);
-    if (t) {
-      time_data[0] = t->tm_year + 1900;
-      time_data[1] = t->tm_mon + 1;
-      time_data[2] = t->tm_mday;
-      time_data[3] = t->tm_hour;
-      time_data[4] = t->tm_min;
-      time_data[5] = t->tm_sec;
-    }
-  }
+  init_time_data (gds2_options);
 
-  std::string str_time = tl::sprintf ("%d/%d/%d %d:%02d:%02d", time_data[1], time_data[2], time_data[0], time_data[3], time_data[4], time_data[5]); 
+  std::string str_time = tl::sprintf ("%d/%d/%d %d:%02d:%02d", m_time_data[1], m_time_data[2], m_time_data[0], m_time_data[3], m_time_data[4], m_time_data[5]); 
   layout.add_meta_info (MetaInfo ("mod_time", tl::to_string (tr ("Modification Time")), str_time));
   layout.add_meta_info (MetaInfo ("access_time", tl::to_string (tr ("Access Time")), str_time));
 
-  bool multi_xy = gds2_options.multi_xy_records;
-  size_t max_cellname_length = std::max (gds2_options.max_cellname_length, (unsigned int)8);
-  size_t max_vertex_count = std::max (gds2_options.max_vertex_count, (unsigned int)4);
-  bool no_zero_length_paths = gds2_options.no_zero_length_paths;
-
-  m_cell_name_map = db::WriterCellNameMap (max_cellname_length);
-  m_cell_name_map.replacement ('$');
-  m_cell_name_map.disallow_all ();
-  //  TODO: restrict character set, i.e allow_standard and "$"
-  m_cell_name_map.allow_all_printing ();
+  init_options (gds2_options, sf, dbu);
 
   //  For keep instances we need to map all cells since all can be present as instances.
   //  We use top-down assignment to make "upper cells less modified".
@@ -151,29 +135,7 @@ GDS2WriterBase::write (db::Layout &layout, tl::OutputStream &stream, const db::S
     }
   }
 
-  //  write header
-
-  write_record_size (6);
-  write_record (sHEADER);
-  write_short (600);
-
-  write_record_size (4 + 12 * 2);
-  write_record (sBGNLIB);
-  write_time (time_data);
-  write_time (time_data);
-
-  write_string_record (sLIBNAME, gds2_options.libname);
-
-  write_record_size (4 + 8 * 2);
-  write_record (sUNITS);
-  write_double (dbu / std::max (1e-9, gds2_options.user_units));
-  write_double (dbu * 1e-6);
-
-  //  layout properties 
-
-  if (gds2_options.write_file_properties && layout.prop_id () != 0) {
-    write_properties (layout, layout.prop_id ());
-  }
+  write_lib_header (layout, gds2_options, dbu);
 
   //  write context info
   
@@ -192,8 +154,8 @@ GDS2WriterBase::write (db::Layout &layout, tl::OutputStream &stream, const db::S
 
     write_record_size (4 + 12 * 2);
     write_record (sBGNSTR);
-    write_time (time_data);
-    write_time (time_data);
+    write_time (m_time_data);
+    write_time (m_time_data);
 
     write_string_record (sSTRNAME, "$$$CONTEXT_INFO$$$");
 
@@ -251,109 +213,257 @@ GDS2WriterBase::write (db::Layout &layout, tl::OutputStream &stream, const db::S
   for (std::vector<db::cell_index_type>::const_iterator cell = cells.begin (); cell != cells.end (); ++cell) {
 
     progress_checkpoint ();
+    write_structure (layout, *cell, options.keep_instances () ? 0 : &cell_set, layers);
+
+  }
 
-    const db::Cell &cref (layout.cell (*cell));
+  write_record_size (4);
+  write_record (sENDLIB);
 
-    //  don't write ghost cells unless they are not empty (any more)
-    //  also don't write proxy cells which are not employed
-    if ((! cref.is_ghost_cell () || ! cref.empty ()) && (! cref.is_proxy () || ! cref.is_top ())) {
+  progress_checkpoint ();
+}
 
-      //  cell header 
+void
+GDS2WriterBase::init_time_data (const db::GDS2WriterOptions &gds2_options)
+{
+  for (unsigned int i = 0; i < 6; ++i) {
+    m_time_data [i] = 0;
+  }
 
-      write_record_size (4 + 12 * 2);
-      write_record (sBGNSTR);
-      write_time (time_data);
-      write_time (time_data);
+  if (gds2_options.write_timestamps) {
+    time_t ti = 0;
+    time (&ti);
+    const struct tm *t = localtime (&ti);
+    if (t) {
+      m_time_data[0] = t->tm_year + 1900;
+      m_time_data[1] = t->tm_mon + 1;
+      m_time_data[2] = t->tm_mday;
+      m_time_data[3] = t->tm_hour;
+      m_time_data[4] = t->tm_min;
+      m_time_data[5] = t->tm_sec;
+    }
+  }
+}
 
-      write_string_record (sSTRNAME, m_cell_name_map.cell_name (*cell));
+void
+GDS2WriterBase::init_options (const db::GDS2WriterOptions &gds2_options, double sf, double dbu)
+{
+  m_sf = sf;
+  m_dbu = dbu;
+  m_multi_xy = gds2_options.multi_xy_records;
+  m_max_vertex_count = std::max (gds2_options.max_vertex_count, (unsigned int)4);
+  m_no_zero_length_paths = gds2_options.no_zero_length_paths;
+  m_write_cell_properties = gds2_options.write_cell_properties;
 
-      //  cell body 
+  size_t max_cellname_length = std::max (gds2_options.max_cellname_length, (unsigned int)8);
 
-      if (gds2_options.write_cell_properties && cref.prop_id () != 0) {
-        write_properties (layout, cref.prop_id ());
-      }
+  m_cell_name_map = db::WriterCellNameMap (max_cellname_length);
+  m_cell_name_map.replacement ('$');
+  m_cell_name_map.disallow_all ();
+  //  TODO: restrict character set, i.e allow_standard and "$"
+  m_cell_name_map.allow_all_printing ();
+}
 
-      //  instances
-      
-      for (db::Cell::const_iterator inst = cref.begin (); ! inst.at_end (); ++inst) {
+void
+GDS2WriterBase::write_lib_header (const db::Layout &layout, const db::GDS2WriterOptions &gds2_options, double dbu)
+{
+  //  write header
 
-        //  write only instances to selected cells
-        if (options.keep_instances () || cell_set.find (inst->cell_index ()) != cell_set.end ()) {
+  write_record_size (6);
+  write_record (sHEADER);
+  write_short (600);
 
-          progress_checkpoint ();
-          write_inst (sf, *inst, true /*normalize*/, layout, inst->prop_id ());
+  write_record_size (4 + 12 * 2);
+  write_record (sBGNLIB);
+  write_time (m_time_data);
+  write_time (m_time_data);
 
-        }
+  write_string_record (sLIBNAME, gds2_options.libname);
+
+  write_record_size (4 + 8 * 2);
+  write_record (sUNITS);
+  write_double (dbu / std::max (1e-9, gds2_options.user_units));
+  write_double (dbu * 1e-6);
+
+  //  layout properties 
+
+  if (gds2_options.write_file_properties && layout.prop_id () != 0) {
+    write_properties (layout, layout.prop_id ());
+  }
+}
+
+void
+GDS2WriterBase::write_structure (const db::Layout &layout, db::cell_index_type ci, const std::set <db::cell_index_type> *cell_set, const std::vector <std::pair <unsigned int, db::LayerProperties> > &layers)
+{
+  const db::Cell &cref (layout.cell (ci));
+
+  //  don't write ghost cells unless they are not empty (any more)
+  //  also don't write proxy cells which are not employed
+  if ((! cref.is_ghost_cell () || ! cref.empty ()) && (! cref.is_proxy () || ! cref.is_top ())) {
+
+    //  cell header 
+
+    write_record_size (4 + 12 * 2);
+    write_record (sBGNSTR);
+    write_time (m_time_data);
+    write_time (m_time_data);
+
+    write_string_record (sSTRNAME, m_cell_name_map.cell_name (ci));
+
+    //  cell body 
+
+    if (m_write_cell_properties && cref.prop_id () != 0) {
+      write_properties (layout, cref.prop_id ());
+    }
+
+    //  instances
+    
+    for (db::Cell::const_iterator inst = cref.begin (); ! inst.at_end (); ++inst) {
+
+      //  write only instances to selected cells
+      if (! cell_set || cell_set->find (inst->cell_index ()) != cell_set->end ()) {
+
+        progress_checkpoint ();
+        write_inst (m_sf, inst->cell_inst (), true /*normalize*/, layout, inst->prop_id ());
 
       }
 
-      //  shapes
-
-      for (std::vector <std::pair <unsigned int, db::LayerProperties> >::const_iterator l = layers.begin (); l != layers.end (); ++l) {
-   
-        if (layout.is_valid_layer (l->first)) {
-
-          int layer = l->second.layer;
-          int datatype = l->second.datatype;
-
-          db::ShapeIterator shape (cref.shapes (l->first).begin (db::ShapeIterator::Boxes | db::ShapeIterator::Polygons | db::ShapeIterator::Edges | db::ShapeIterator::EdgePairs | db::ShapeIterator::Paths | db::ShapeIterator::Texts));
-          while (! shape.at_end ()) {
-
-            progress_checkpoint ();
-
-            if (shape->is_text ()) {
-              write_text (layer, datatype, sf, dbu, *shape, layout, shape->prop_id ());
-            } else if (shape->is_polygon ()) {
-              write_polygon (layer, datatype, sf, *shape, multi_xy, max_vertex_count, layout, shape->prop_id ());
-            } else if (shape->is_edge ()) {
-              write_edge (layer, datatype, sf, *shape, layout, shape->prop_id ());
-            } else if (shape->is_edge_pair ()) {
-              write_edge (layer, datatype, sf, shape->edge_pair ().first (), layout, shape->prop_id ());
-              write_edge (layer, datatype, sf, shape->edge_pair ().second (), layout, shape->prop_id ());
-            } else if (shape->is_path ()) {
-              if (no_zero_length_paths && (shape->path_length () - shape->path_extensions ().first - shape->path_extensions ().second) == 0) {
-                //  eliminate the zero-width path
-                db::Polygon poly;
-                shape->polygon (poly);
-                write_polygon (layer, datatype, sf, poly, multi_xy, max_vertex_count, layout, shape->prop_id (), false);
-              } else {
-                write_path (layer, datatype, sf, *shape, multi_xy, layout, shape->prop_id ());
-              }
-            } else if (shape->is_box ()) {
-              write_box (layer, datatype, sf, *shape, layout, shape->prop_id ());
-            }
+    }
+
+    //  shapes
+
+    for (std::vector <std::pair <unsigned int, db::LayerProperties> >::const_iterator l = layers.begin (); l != layers.end (); ++l) {
+ 
+      if (layout.is_valid_layer (l->first)) {
 
-            ++shape;
+        int layer = l->second.layer;
+        int datatype = l->second.datatype;
 
+        db::ShapeIterator shape (cref.shapes (l->first).begin (db::ShapeIterator::Boxes | db::ShapeIterator::Polygons | db::ShapeIterator::Edges | db::ShapeIterator::EdgePairs | db::ShapeIterator::Paths | db::ShapeIterator::Texts));
+        while (! shape.at_end ()) {
+
+          progress_checkpoint ();
+
+          if (shape->is_text ()) {
+            write_text (layer, datatype, m_sf, m_dbu, *shape, layout, shape->prop_id ());
+          } else if (shape->is_polygon ()) {
+            write_polygon (layer, datatype, m_sf, *shape, m_multi_xy, m_max_vertex_count, layout, shape->prop_id ());
+          } else if (shape->is_edge ()) {
+            write_edge (layer, datatype, m_sf, *shape, layout, shape->prop_id ());
+          } else if (shape->is_edge_pair ()) {
+            write_edge (layer, datatype, m_sf, shape->edge_pair ().first (), layout, shape->prop_id ());
+            write_edge (layer, datatype, m_sf, shape->edge_pair ().second (), layout, shape->prop_id ());
+          } else if (shape->is_path ()) {
+            if (m_no_zero_length_paths && (shape->path_length () - shape->path_extensions ().first - shape->path_extensions ().second) == 0) {
+              //  eliminate the zero-width path
+              db::Polygon poly;
+              shape->polygon (poly);
+              write_polygon (layer, datatype, m_sf, poly, m_multi_xy, m_max_vertex_count, layout, shape->prop_id (), false);
+            } else {
+              write_path (layer, datatype, m_sf, *shape, m_multi_xy, layout, shape->prop_id ());
+            }
+          } else if (shape->is_box ()) {
+            write_box (layer, datatype, m_sf, *shape, layout, shape->prop_id ());
           }
 
+          ++shape;
+
         }
 
       }
 
-      //  end of cell
+    }
 
-      write_record_size (4);
-      write_record (sENDSTR);
+    //  end of cell
 
-    }
+    write_record_size (4);
+    write_record (sENDSTR);
+
+  }
+}
+
+void
+GDS2WriterBase::begin_write (db::Layout &layout, tl::OutputStream &stream, const db::SaveLayoutOptions &options)
+{
+  set_stream (stream);
 
+  double dbu = (options.dbu () == 0.0) ? layout.dbu () : options.dbu ();
+  double sf = options.scale_factor () * (layout.dbu () / dbu);
+  if (fabs (sf - 1.0) < 1e-9) {
+    //  to avoid rounding problems, set to 1.0 exactly if possible.
+    sf = 1.0;
   }
 
+  db::GDS2WriterOptions gds2_options = options.get_options<db::GDS2WriterOptions> ();
+
+  init_time_data (gds2_options);
+  init_options (gds2_options, sf, dbu);
+
+  mp_incremental_layout = &layout;
+  m_layers.clear ();
+
+  write_lib_header (layout, gds2_options, dbu);
+}
+
+void
+GDS2WriterBase::write_cell (db::cell_index_type ci)
+{
+  tl_assert (mp_incremental_layout != 0);
+  const db::Layout &layout = *mp_incremental_layout;
+
+  progress_checkpoint ();
+
+  //  register new layers - layers without a number get the next free one
+  db::register_new_layers (layout, m_layers);
+
+  //  cell names are assigned in the order the cells appear - either written or referenced
+  const db::Cell &cref = layout.cell (ci);
+  if (! m_cell_name_map.has_cell_name (ci)) {
+    m_cell_name_map.insert (ci, layout.cell_name (ci));
+  }
+  for (db::Cell::const_iterator inst = cref.begin (); ! inst.at_end (); ++inst) {
+    if (! m_cell_name_map.has_cell_name (inst->cell_index ())) {
+      m_cell_name_map.insert (inst->cell_index (), layout.cell_name (inst->cell_index ()));
+    }
+  }
+
+  write_structure (layout, ci, 0, m_layers);
+}
+
+void
+GDS2WriterBase::end_write ()
+{
+  tl_assert (mp_incremental_layout != 0);
+
   write_record_size (4);
   write_record (sENDLIB);
 
   progress_checkpoint ();
+
+  mp_incremental_layout = 0;
+  m_layers.clear ();
 }
 
 void
-GDS2WriterBase::write_inst (double sf, const db::Instance &instance, bool normalize, const db::Layout &layout, db::properties_id_type prop_id)
+GDS2WriterBase::write_inst (double sf, const db::CellInstArray &instance, bool normalize, const db::Layout &layout, db::properties_id_type prop_id)
 {
   db::Vector a, b;
   unsigned long amax, bmax;
 
   bool is_reg = instance.is_regular_array (a, b, amax, bmax);
 
+  //  GDS2 knows regular arrays only: other arrays (i.e. iterated ones) are written as single references
+  if (! is_reg && instance.size () > 1) {
+    for (db::CellInstArray::iterator i = instance.begin (); ! i.at_end (); ++i) {
+      if (instance.is_complex ()) {
+        write_inst (sf, db::CellInstArray (instance.object (), instance.complex_trans (*i)), normalize, layout, prop_id);
+      } else {
+        write_inst (sf, db::CellInstArray (instance.object (), *i), normalize, layout, prop_id);
+      }
+    }
+    return;
+  }
+
   db::Trans t = instance.front ();
 
   if (normalize) {
@@ -420,7 +530,7 @@ GDS2WriterBase::write_inst (double sf, const db::Instance &instance, bool normal
   write_record_size (4);
   write_record (is_reg ? sAREF : sSREF);
 
-  write_string_record (sSNAME, m_cell_name_map.cell_name (instance.cell_index ()));
+  write_string_record (sSNAME, m_cell_name_map.cell_name (instance.object ().cell_index ()));
 
   if (t.rot () != 0 || instance.is_complex ()) {
 
@@ -27,8 +27,12 @@
 #include "dbPluginCommon.h"
 #include "dbWriter.h"
 #include "dbWriterTools.h"
+#include "dbLayerProperties.h"
 #include "tlProgress.h"
 
+#include <set>
+#include <vector>
+
 namespace tl
 {
   class OutputStream;
@@ -39,6 +43,7 @@ namespace db
 
 class Layout;
 class SaveLayoutOptions;
+class GDS2WriterOptions;
 
 /**
  *  @brief A GDS2 writer abstraction
@@ -58,6 +63,29 @@ public:
    */
   void write (db::Layout &layout, tl::OutputStream &stream, const db::SaveLayoutOptions &options);
 
+  /**
+   *  @brief Begins writing a layout incrementally
+   *
+   *  In incremental mode, the cells are written one by one with "write_cell" in the 
+   *  order the cells are given. The layout only needs to hold the cell currently written.
+   *  Cell names are assigned in the order of appearance (written or referenced) and 
+   *  name conflicts are resolved the same way than in "write".
+   */
+  void begin_write (db::Layout &layout, tl::OutputStream &stream, const db::SaveLayoutOptions &options);
+
+  /**
+   *  @brief Writes the given cell as a STRUCTURE in incremental mode
+   *
+   *  Layers created in the layout after "begin_write" are taken as well. Layers
+   *  without a layer number will be given the next free layer number.
+   */
+  void write_cell (db::cell_index_type ci);
+
+  /**
+   *  @brief Finishes the incremental write
+   */
+  void end_write ();
+
 protected:
   /**
    *  @brief Write a byte
@@ -122,7 +150,7 @@ protected:
   /**
    *  @brief Write an instance 
    */
-  void write_inst (double sf, const db::Instance &instance, bool normalize, const db::Layout &layout, db::properties_id_type prop_id);
+  void write_inst (double sf, const db::CellInstArray &instance, bool normalize, const db::Layout &layout, db::properties_id_type prop_id);
 
   /**
    *  @brief Write a shape as box
@@ -166,8 +194,21 @@ protected:
 
 private:
   db::WriterCellNameMap m_cell_name_map;
+  short m_time_data [6];
+  double m_sf;
+  double m_dbu;
+  bool m_multi_xy;
+  size_t m_max_vertex_count;
+  bool m_no_zero_length_paths;
+  bool m_write_cell_properties;
+  const db::Layout *mp_incremental_layout;
+  std::vector <std::pair <unsigned int, db::LayerProperties> > m_layers;
 
   void write_properties (const db::Layout &layout, db::properties_id_type prop_id);
+  void init_time_data (const db::GDS2WriterOptions &gds2_options);
+  void init_options (const db::GDS2WriterOptions &gds2_options, double sf, double dbu);
+  void write_lib_header (const db::Layout &layout, const db::GDS2WriterOptions &gds2_options, double dbu);
+  void write_structure (const db::Layout &layout, db::cell_index_type ci, const std::set <db::cell_index_type> *cell_set, const std::vector <std::pair <unsigned int, db::LayerProperties> > &layers);
 };
 
 } // namespace db
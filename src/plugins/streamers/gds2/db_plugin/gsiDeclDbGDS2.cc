@@ -325,5 +325,73 @@ gsi::ClassExt<db::LoadLayoutOptions> gds2_reader_options (
   ""
 );
 
+// ---------------------------------------------------------------
+//  gsi Implementation of the streaming GDS2 writer
+
+static db::GDS2StreamWriter *new_gds2_stream_writer (const std::string &path, double dbu, const db::SaveLayoutOptions &options)
+{
+  return new db::GDS2StreamWriter (path, dbu, options);
+}
+
+static db::Cell *open_cell (db::GDS2StreamWriter *writer, const std::string &name)
+{
+  return &writer->begin_cell (name);
+}
+
+Class<db::GDS2StreamWriter> decl_GDS2StreamWriter ("db", "GDS2StreamWriter",
+  gsi::constructor ("new", &new_gds2_stream_writer, gsi::arg ("path"), gsi::arg ("dbu", 0.001), gsi::arg ("options", db::SaveLayoutOptions (), "SaveLayoutOptions()"),
+    "@brief Creates a streaming GDS2 writer for the given file\n"
+    "The database unit is the unit of the integer coordinates of the shapes delivered. The options are "
+    "the usual GDS2 writer options (see \\SaveLayoutOptions)."
+  ) +
+  gsi::method ("layer", &db::GDS2StreamWriter::layer, gsi::arg ("info"),
+    "@brief Gets the layer index for the given layer\n"
+    "The layer is created if it does not exist yet. Use the layer index to put shapes into the cell returned by \\begin_cell."
+  ) +
+  gsi::method ("cell_index", &db::GDS2StreamWriter::cell_index, gsi::arg ("name"),
+    "@brief Gets the cell index for the cell with the given name\n"
+    "Use this method to obtain the cell index for instances of cells which are written later."
+  ) +
+  gsi::method_ext ("begin_cell", &open_cell, gsi::arg ("name"),
+    "@brief Opens a new cell\n"
+    "Shapes and instances can be put into the cell returned. The cell is written by \\end_cell. "
+    "Only one cell can be open at a time and each cell can be written only once."
+  ) +
+  gsi::method ("end_cell", &db::GDS2StreamWriter::end_cell,
+    "@brief Writes the open cell as a STRUCTURE\n"
+    "The content of the cell is discarded after the cell has been written."
+  ) +
+  gsi::method ("layout", &db::GDS2StreamWriter::layout,
+    "@brief Gets the scratch layout the writer uses\n"
+    "Use this layout to obtain property IDs for shapes with properties for example. "
+    "Don't manipulate cells other than the one currently open."
+  ) +
+  gsi::method ("close", &db::GDS2StreamWriter::close,
+    "@brief Finishes the file\n"
+    "After the writer has been closed, no more cells can be written."
+  ) +
+  gsi::method ("is_closed?", &db::GDS2StreamWriter::is_closed,
+    "@brief Gets a value indicating whether the writer has been closed\n"
+  ),
+  "@brief A streaming GDS2 writer\n"
+  "\n"
+  "This writer allows writing GDS2 files without having the complete layout in memory. "
+  "The cells are written one by one: \\begin_cell opens a new cell, shapes and instances are put into "
+  "this cell and \\end_cell writes it as a STRUCTURE. Cell names are adjusted to the GDS2 writer options "
+  "and made unique the same way the normal GDS2 writer does. "
+  "Layers without a layer number are given the next free layer number.\n"
+  "\n"
+  "@code\n"
+  "writer = RBA::GDS2StreamWriter::new(\"out.gds\", 0.001)\n"
+  "l1 = writer.layer(RBA::LayerInfo::new(1, 0))\n"
+  "top = writer.begin_cell(\"TOP\")\n"
+  "1000.times { |i| top.shapes(l1).insert(RBA::Box::new(i * 200, 0, i * 200 + 100, 100)) }\n"
+  "writer.end_cell\n"
+  "writer.close\n"
+  "@/code\n"
+  "\n"
+  "This class has been introduced in version 0.26."
+);
+
 }
 
@@ -21,6 +21,8 @@
 */
 
 #include "dbGDS2Reader.h"
+#include "dbGDS2Writer.h"
+#include "dbCommonReader.h"
 #include "dbLayoutDiff.h"
 #include "dbTestSupport.h"
 #include "tlUnitTest.h"
@@ -391,3 +393,179 @@ TEST(Bug_121_2)
   db::compare_layouts (_this, layout, fn_au, db::WriteGDS2, 1);
 }
 
+static std::string region_read_summary (const db::Layout &layout)
+{
+  //  sorted by cell name
+  std::map<std::string, std::string> cells;
+  for (db::Layout::const_iterator c = layout.begin (); c != layout.end (); ++c) {
+    size_t n = 0;
+    for (db::Layout::layer_iterator l = layout.begin_layers (); l != layout.end_layers (); ++l) {
+      n += c->shapes ((*l).first).size ();
+    }
+    cells [layout.cell_name (c->cell_index ())] = tl::sprintf ("i%d,s%d", int (c->cell_instances ()), int (n));
+  }
+
+  std::string s;
+  for (std::map<std::string, std::string>::const_iterator c = cells.begin (); c != cells.end (); ++c) {
+    if (! s.empty ()) {
+      s += ";";
+    }
+    s += c->first + ":" + c->second;
+  }
+  return s;
+}
+
+static std::string read_gds2_region (const std::string &fn, const db::DBox &region, bool through_pipe = false)
+{
+  db::Layout layout;
+  //  a pipe cannot be reset, so the reader needs to do with a single pass
+  tl::InputStream file (through_pipe ? "pipe:cat " + fn : fn);
+  db::GDS2Reader reader (file);
+
+  db::LoadLayoutOptions options;
+  db::CommonReaderOptions common_options;
+  common_options.region = region;
+  options.set_options (common_options);
+  reader.read (layout, options);
+
+  return region_read_summary (layout);
+}
+
+TEST(200_RegionFilter)
+{
+  db::Layout layout_org;
+  unsigned int l1 = layout_org.insert_layer (db::LayerProperties (1, 0));
+  unsigned int l2 = layout_org.insert_layer (db::LayerProperties (2, 0));
+
+  db::Cell &top = layout_org.cell (layout_org.add_cell ("TOP"));
+  db::Cell &a = layout_org.cell (layout_org.add_cell ("A"));
+  db::Cell &b = layout_org.cell (layout_org.add_cell ("B"));
+  db::Cell &c = layout_org.cell (layout_org.add_cell ("C"));
+
+  a.shapes (l1).insert (db::Box (0, 0, 1000, 2000));
+  a.shapes (l2).insert (db::Text ("A", db::Trans (db::Vector (500, 500))));
+  b.shapes (l2).insert (db::Polygon (db::Box (0, 0, 500, 500)));
+  c.shapes (l1).insert (db::Box (-100, -100, 100, 100));
+
+  top.insert (db::CellInstArray (db::CellInst (a.cell_index ()), db::Trans (db::Vector (0, 0))));
+  top.insert (db::CellInstArray (db::CellInst (a.cell_index ()), db::Trans (db::Vector (0, 10000)), db::Vector (2000, 0), db::Vector (0, 3000), 3, 2));
+  top.insert (db::CellInstArray (db::CellInst (b.cell_index ()), db::Trans (db::Vector (100000, 0))));
+  b.insert (db::CellInstArray (db::CellInst (c.cell_index ()), db::Trans (1, false, db::Vector (200, 200))));
+
+  std::string tmp_file = _this->tmp_file ("tmp_region.gds");
+
+  {
+    tl::OutputStream stream (tmp_file);
+    db::GDS2Writer writer;
+    writer.write (layout_org, stream, db::SaveLayoutOptions ());
+  }
+
+  //  a window around the origin: only the first instance of A and its box survive
+  EXPECT_EQ (read_gds2_region (tmp_file, db::DBox (-0.05, -0.05, 0.05, 0.05)), "A:i0,s1;TOP:i1,s0");
+  //  a window touching C: B and C are needed, A is not
+  EXPECT_EQ (read_gds2_region (tmp_file, db::DBox (100.15, 0.15, 100.16, 0.16)), "B:i1,s1;C:i0,s1;TOP:i1,s0");
+  //  a window touching the A array: the whole array is kept
+  EXPECT_EQ (read_gds2_region (tmp_file, db::DBox (4.5, 13.5, 4.6, 13.6)), "A:i0,s2;TOP:i1,s0");
+  //  outside everything: an empty top cell remains
+  EXPECT_EQ (read_gds2_region (tmp_file, db::DBox (-10, -10, -9, -9)), "TOP:i0,s0");
+  //  no region: everything is read
+  EXPECT_EQ (read_gds2_region (tmp_file, db::DBox ()), "A:i0,s2;B:i1,s1;C:i0,s1;TOP:i3,s0");
+
+  //  the same results from a stream which can be read once only
+  EXPECT_EQ (read_gds2_region (tmp_file, db::DBox (-0.05, -0.05, 0.05, 0.05), true), "A:i0,s1;TOP:i1,s0");
+  EXPECT_EQ (read_gds2_region (tmp_file, db::DBox (100.15, 0.15, 100.16, 0.16), true), "B:i1,s1;C:i0,s1;TOP:i1,s0");
+}
+
+namespace
+{
+
+//  A delegate which does not support reset like a pipe
+class NoResetInputStream
+  : public tl::InputStreamBase
+{
+public:
+  NoResetInputStream (tl::InputStreamBase *delegate)
+    : mp_delegate (delegate)
+  { }
+
+  virtual size_t read (char *b, size_t n)
+  {
+    return mp_delegate->read (b, n);
+  }
+
+  virtual void reset ()
+  {
+    throw tl::Exception ("reset not supported");
+  }
+
+  virtual void close () { mp_delegate->close (); }
+  virtual std::string source () const { return mp_delegate->source (); }
+  virtual std::string absolute_path () const { return mp_delegate->absolute_path (); }
+  virtual std::string filename () const { return mp_delegate->filename (); }
+
+private:
+  std::auto_ptr<tl::InputStreamBase> mp_delegate;
+};
+
+}
+
+TEST(201_DetectWithoutReset)
+{
+  db::Layout layout_org;
+  unsigned int l1 = layout_org.insert_layer (db::LayerProperties (1, 0));
+  db::Cell &top = layout_org.cell (layout_org.add_cell ("TOP"));
+  for (int i = 0; i < 10000; ++i) {
+    top.shapes (l1).insert (db::Box (i * 100, 0, i * 100 + 50, 1000));
+  }
+
+  //  the compressed file is inflated on the fly, so a reset would mean to start over
+  std::string tmp_file = _this->tmp_file ("tmp_detect.gds.gz");
+
+  {
+    tl::OutputStream stream (tmp_file);
+    db::GDS2Writer writer;
+    writer.write (layout_org, stream, db::SaveLayoutOptions ());
+  }
+
+  db::Layout layout;
+  tl::InputStream file (new NoResetInputStream (new tl::InputZLibFile (tmp_file)));
+  db::Reader reader (file);
+  reader.read (layout);
+
+  EXPECT_EQ (std::string (reader.format ()), "GDS2");
+  EXPECT_EQ (layout.cells (), size_t (1));
+  EXPECT_EQ (layout.cell (*layout.begin_top_down ()).shapes (0).size (), size_t (10000));
+}
+
+TEST(202_ReadAhead)
+{
+  db::Layout layout_org;
+  unsigned int l1 = layout_org.insert_layer (db::LayerProperties (1, 0));
+  db::Cell &top = layout_org.cell (layout_org.add_cell ("TOP"));
+  for (int i = 0; i < 10000; ++i) {
+    top.shapes (l1).insert (db::Box (i * 100, 0, i * 100 + 50, 1000));
+  }
+
+  std::string tmp_file = _this->tmp_file ("tmp_read_ahead.gds.gz");
+
+  {
+    tl::OutputStream stream (tmp_file);
+    db::GDS2Writer writer;
+    writer.write (layout_org, stream, db::SaveLayoutOptions ());
+  }
+
+  db::LoadLayoutOptions options;
+  db::CommonReaderOptions common_options;
+  common_options.read_ahead_buffers = 3;
+  common_options.read_ahead_buffer_size = 4096;
+  options.set_options (common_options);
+
+  db::Layout layout;
+  tl::InputStream file (tmp_file);
+  db::Reader reader (file);
+  reader.read (layout, options);
+
+  EXPECT_EQ (dynamic_cast<tl::InputReadAheadStream *> (file.base ()) != 0, true);
+  EXPECT_EQ (layout.cells (), size_t (1));
+  EXPECT_EQ (layout.cell (*layout.begin_top_down ()).shapes (0).size (), size_t (10000));
+}
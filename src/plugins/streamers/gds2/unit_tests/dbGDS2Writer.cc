@@ -30,6 +30,7 @@
 #include "tlUnitTest.h"
 
 #include <stdlib.h>
+#include <set>
 
 void run_test (tl::TestBase *_this, const char *file, const char *file_ref, bool priv = false, const db::GDS2WriterOptions &opt = db::GDS2WriterOptions ())
 {
@@ -1129,6 +1130,63 @@ TEST(117)
   EXPECT_EQ (pp == poly, true);
 }
 
+TEST(118)
+{
+  //  iterated instance arrays are written as single references
+
+  db::Layout g;
+
+  db::Cell &top (g.cell (g.add_cell ("TOP")));
+  db::Cell &a (g.cell (g.add_cell ("A")));
+  a.shapes (g.insert_layer (db::LayerProperties (1, 0))).insert (db::Box (0, 0, 10, 10));
+
+  std::vector<db::Vector> disp;
+  disp.push_back (db::Vector (0, 0));
+  disp.push_back (db::Vector (100, 17));
+  disp.push_back (db::Vector (-3000, 250));
+
+  db::CellInstArray::iterated_array_type array (disp.begin (), disp.end ());
+  array.sort ();
+  top.insert (db::CellInstArray (db::CellInst (a.cell_index ()), db::Trans (1, false, db::Vector (5, 5)), g.array_repository ().insert (array)));
+
+  db::ICplxTrans ct (2.0, 45.0, false, db::Vector (0, 10000));
+  db::CellInstArray::iterated_complex_array_type carray (ct.rcos (), ct.mag (), disp.begin (), disp.end ());
+  carray.sort ();
+  top.insert (db::CellInstArray (db::CellInst (a.cell_index ()), db::Trans (ct), g.array_repository ().insert (carray)));
+
+  std::string tmp_file = tl::TestBase::tmp_file ("tmp_GDS2Writer_118.gds");
+
+  {
+    tl::OutputStream out (tmp_file);
+    db::GDS2Writer writer;
+    writer.write (g, out, db::SaveLayoutOptions ());
+  }
+
+  db::Layout gg;
+
+  {
+    tl::InputStream file (tmp_file);
+    db::Reader reader (file);
+    reader.read (gg);
+  }
+
+  std::pair<bool, db::cell_index_type> t = gg.cell_by_name ("TOP");
+  EXPECT_EQ (t.first, true);
+  EXPECT_EQ (gg.cell (t.second).cell_instances (), size_t (6));
+
+  std::set<std::string> insts_org, insts;
+  for (db::Cell::const_iterator i = top.begin (); ! i.at_end (); ++i) {
+    for (db::CellInstArray::iterator m = i->cell_inst ().begin (); ! m.at_end (); ++m) {
+      insts_org.insert (i->cell_inst ().complex_trans (*m).to_string ());
+    }
+  }
+  for (db::Cell::const_iterator i = gg.cell (t.second).begin (); ! i.at_end (); ++i) {
+    insts.insert (i->cell_inst ().complex_trans ().to_string ());
+  }
+  EXPECT_EQ (insts_org.size (), size_t (6));
+  EXPECT_EQ (insts == insts_org, true);
+}
+
 //  Extreme fracturing by max. points
 TEST(120)
 {
@@ -1153,3 +1211,170 @@ TEST(166)
   opt.max_vertex_count = 4;
   run_test (_this, "t166.oas.gz", "t166_au.gds.gz", false, opt);
 }
+
+TEST(200_StreamWriter)
+{
+  std::string tmp_file = tl::TestBase::tmp_file ("tmp_GDS2Writer_200.gds");
+
+  {
+    db::SaveLayoutOptions options;
+    db::GDS2WriterOptions gds2_options;
+    gds2_options.max_cellname_length = 8;
+    gds2_options.write_timestamps = false;
+    options.set_options (gds2_options);
+
+    db::GDS2StreamWriter writer (tmp_file, 0.001, options);
+
+    unsigned int l1 = writer.layer (db::LayerProperties (1, 0));
+    unsigned int l2 = writer.layer (db::LayerProperties ("NAMED"));
+
+    db::Cell &a = writer.begin_cell ("CHILDCELL_A");
+    a.shapes (l1).insert (db::Box (0, 0, 100, 100));
+    a.shapes (l2).insert (db::Text ("A", db::Trans ()));
+    writer.end_cell ();
+
+    EXPECT_EQ (a.shapes (l1).empty (), true);
+
+    //  the top cell references a cell which is written later
+    db::Cell &top = writer.begin_cell ("TOP");
+    top.insert (db::CellInstArray (db::CellInst (writer.cell_index ("CHILDCELL_A")), db::Trans (db::Vector (1000, 0))));
+    top.insert (db::CellInstArray (db::CellInst (writer.cell_index ("CHILDCELL_B")), db::Trans (db::Vector (0, 0)), db::Vector (0, 500), db::Vector (200, 0), 2, 3));
+    writer.end_cell ();
+
+    db::Cell &b = writer.begin_cell ("CHILDCELL_B");
+    b.shapes (l1).insert (db::Box (-10, -10, 10, 10));
+    writer.end_cell ();
+
+    writer.close ();
+    EXPECT_EQ (writer.is_closed (), true);
+  }
+
+  db::Layout gg;
+
+  {
+    tl::InputStream file (tmp_file);
+    db::Reader reader (file);
+    reader.read (gg);
+  }
+
+  const char *expected = 
+    "begin_lib 0.001\n"
+    "begin_cell {CHILDC$1}\n"
+    "box 1 0 {-10 -10} {10 10}\n"
+    "end_cell\n"
+    "begin_cell {CHILDCEL}\n"
+    "box 1 0 {0 0} {100 100}\n"
+    "text 2 0 0 0 {0 0} {A}\n"
+    "end_cell\n"
+    "begin_cell {TOP}\n"
+    "aref {CHILDC$1} 0 0 1 2 3 {0 0} {0 1000} {600 0}\n"
+    "sref {CHILDCEL} 0 0 1 {1000 0}\n"
+    "end_cell\n"
+    "end_lib\n"
+  ;
+
+  tl::OutputStringStream os;
+  tl::OutputStream stream (os);
+  db::TextWriter textwriter (stream);
+  textwriter.write (gg);
+  EXPECT_EQ (std::string (os.string ()), std::string (expected))
+}
+
+TEST(201_WriteBehind)
+{
+  db::Manager m;
+  db::Layout layout_org (&m);
+  {
+    std::string fn (tl::testsrc ());
+    fn += "/testdata/gds/arefs.gds";
+    tl::InputStream stream (fn);
+    db::Reader reader (stream);
+    reader.read (layout_org);
+  }
+
+  std::string tmp_file = _this->tmp_file ("tmp_GDS2Writer_201.gds.gz");
+
+  {
+    tl::OutputStream stream (tmp_file);
+    db::SaveLayoutOptions options;
+    options.set_format ("GDS2");
+    options.set_write_behind_buffers (3);
+    options.set_write_behind_buffer_size (256);
+    options.set_compression_threads (2);
+    db::Writer writer (options);
+    writer.write (layout_org, stream);
+  }
+
+  db::Layout layout_read (&m);
+  {
+    tl::InputStream file (tmp_file);
+    db::Reader reader (file);
+    reader.read (layout_read);
+  }
+
+  db::Layout layout_ref (&m);
+  {
+    std::string fn (tl::testsrc ());
+    fn += "/testdata/gds/arefs_ref.gds";
+    tl::InputStream stream (fn);
+    db::Reader reader (stream);
+    reader.read (layout_ref);
+  }
+
+  EXPECT_EQ (db::compare_layouts (layout_read, layout_ref, db::layout_diff::f_verbose, 0), true);
+}
+
+//  named layers get numbers which don't collide with numbered layers
+TEST(202_StreamWriterLayerNumbers)
+{
+  std::string tmp_file = tl::TestBase::tmp_file ("tmp_GDS2Writer_202.gds");
+
+  {
+    db::GDS2StreamWriter writer (tmp_file, 0.001);
+
+    unsigned int l1 = writer.layer (db::LayerProperties ("NAMED"));
+    unsigned int l2 = writer.layer (db::LayerProperties (1, 0));
+
+    db::Cell &a = writer.begin_cell ("A");
+    a.shapes (l1).insert (db::Box (0, 0, 100, 100));
+    a.shapes (l2).insert (db::Box (0, 0, 200, 200));
+    writer.end_cell ();
+
+    //  2/0 has been given to the named layer already
+    unsigned int l3 = writer.layer (db::LayerProperties (2, 0));
+    db::Cell &b = writer.begin_cell ("B");
+    b.shapes (l3).insert (db::Box (0, 0, 300, 300));
+    try {
+      writer.end_cell ();
+      EXPECT_EQ (true, false);
+    } catch (tl::Exception &ex) {
+      EXPECT_EQ (ex.msg (), "Layer 2/0 uses the number already given to a named layer - create numbered layers before named ones");
+    }
+
+    writer.close ();
+  }
+
+  db::Layout gg;
+
+  {
+    tl::InputStream file (tmp_file);
+    db::Reader reader (file);
+    reader.read (gg);
+  }
+
+  const char *expected = 
+    "begin_lib 0.001\n"
+    "begin_cell {A}\n"
+    "box 2 0 {0 0} {100 100}\n"
+    "box 1 0 {0 0} {200 200}\n"
+    "end_cell\n"
+    "end_lib\n"
+  ;
+
+  tl::OutputStringStream os;
+  tl::OutputStream stream (os);
+  db::TextWriter textwriter (stream);
+  textwriter.write (gg);
+  EXPECT_EQ (std::string (os.string ()), std::string (expected))
+}
+
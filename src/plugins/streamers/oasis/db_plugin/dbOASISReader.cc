@@ -33,6 +33,8 @@
 #include "tlString.h"
 #include "tlClassRegistry.h"
 
+#include <algorithm>
+
 namespace db
 {
 
@@ -106,7 +108,11 @@ OASISReader::OASISReader (tl::InputStream &s)
     m_read_properties (true),
     m_read_all_properties (false),
     m_s_gds_property_name_id (0),
-    m_klayout_context_property_name_id (0)
+    m_klayout_context_property_name_id (0),
+    m_lazy_cell_bodies (false),
+    m_lazy_cell_bodies_requested (false),
+    m_skip_shapes (false),
+    m_body_only (false)
 {
   m_progress.set_format (tl::to_string (tr ("%.0f MB")));
   m_progress.set_unit (1024 * 1024);
@@ -143,6 +149,20 @@ OASISReader::read (db::Layout &layout, const db::LoadLayoutOptions &options)
   m_create_layers = common_options.create_other_layers;
   m_read_all_properties = oasis_options.read_all_properties;
   m_expect_strict_mode = oasis_options.expect_strict_mode;
+  if (m_lazy_cell_bodies_requested && ! common_options.region.empty ()) {
+    //  the region filter drops the cells not loaded, so there is nothing left to load later
+    throw tl::Exception (tl::to_string (tr ("Lazy cell body loading cannot be combined with a region of interest")));
+  }
+
+  //  a region of interest is implemented by lazy loading of the cells contributing to it
+  //  if the stream can be read again - otherwise everything is read and the region is applied afterwards
+  m_lazy_cell_bodies = m_lazy_cell_bodies_requested || (! common_options.region.empty () && m_stream.supports_reset ());
+
+  m_skip_shapes = false;
+  m_body_only = false;
+  m_cell_body_offsets.clear ();
+  m_declared_cell_bboxes.clear ();
+  m_cellname_sprops.clear ();
 
   layout.start_changes ();
   try {
@@ -153,9 +173,60 @@ OASISReader::read (db::Layout &layout, const db::LoadLayoutOptions &options)
     throw;
   }
 
+  if (! common_options.region.empty ()) {
+    read_region (layout, db::CplxTrans (layout.dbu ()).inverted () * common_options.region);
+  }
+
   return m_layer_map;
 }
 
+void
+OASISReader::read_region (db::Layout &layout, const db::Box &region)
+{
+  std::set<db::cell_index_type> cells;
+  for (std::map <unsigned long, db::cell_index_type>::const_iterator c = m_cells_by_id.begin (); c != m_cells_by_id.end (); ++c) {
+    if (layout.is_valid_cell_index (c->second)) {
+      cells.insert (c->second);
+    }
+  }
+  for (std::map <std::string, db::cell_index_type>::const_iterator c = m_cells_by_name.begin (); c != m_cells_by_name.end (); ++c) {
+    if (layout.is_valid_cell_index (c->second)) {
+      cells.insert (c->second);
+    }
+  }
+
+  if (m_lazy_cell_bodies) {
+
+    //  load the bodies of the cells contributing to the region, starting from the top cells
+    std::vector<db::cell_index_type> top_cells;
+    for (std::set<db::cell_index_type>::const_iterator c = cells.begin (); c != cells.end (); ++c) {
+      const db::Cell &cell = layout.cell (*c);
+      bool is_top = true;
+      for (db::Cell::parent_cell_iterator p = cell.begin_parent_cells (); p != cell.end_parent_cells () && is_top; ++p) {
+        is_top = (cells.find (*p) == cells.end ());
+      }
+      if (is_top) {
+        top_cells.push_back (*c);
+      }
+    }
+
+    load_cell_bodies (layout, top_cells, region);
+
+    //  cells whose bodies are still pending do not contribute to the region and will be removed
+    m_cell_body_offsets.clear ();
+
+  }
+
+  layout.start_changes ();
+  try {
+    restrict_to_region (layout, cells, region);
+    layout.end_changes ();
+  } catch (...) {
+    layout.end_changes ();
+    throw;
+  }
+}
+
 const LayerMap &
 OASISReader::read (db::Layout &layout)
 {
@@ -551,6 +622,12 @@ OASISReader::warn (const std::string &msg)
   }
 }
 
+db::ImportLayerMapping *
+OASISReader::create_proxy_layer_mapping (db::Layout &layout)
+{
+  return new OASISReaderLayerMapping (this, &layout, m_create_layers);
+}
+
 std::pair <bool, unsigned int> 
 OASISReader::open_dl (db::Layout &layout, const LDPair &dl, bool create)
 {
@@ -589,6 +666,19 @@ OASISReader::open_dl (db::Layout &layout, const LDPair &dl, bool create)
   }
 }
 
+std::pair <bool, unsigned int>
+OASISReader::open_geometry_dl (db::Layout &layout, const LDPair &dl)
+{
+  std::pair <bool, unsigned int> ll = open_dl (layout, dl, m_create_layers);
+
+  //  while reading the hierarchy skeleton, layers are created but no shapes are stored
+  if (m_skip_shapes) {
+    ll.first = false;
+  }
+
+  return ll;
+}
+
 /**
  *  @brief A helper class to join two datatype layer name map members
  */
@@ -834,7 +924,7 @@ OASISReader::do_read (db::Layout &layout)
 
       reset_modal_variables ();
 
-      std::pair<bool, db::properties_id_type> pp = read_element_properties (layout.properties_repository (), true);
+      std::pair<bool, db::properties_id_type> pp = read_element_properties (layout.properties_repository (), true, m_lazy_cell_bodies ? &m_cellname_sprops [id] : 0);
       if (pp.first) {
         m_cellname_properties.insert (std::make_pair (id, pp.second));
       }
@@ -1137,6 +1227,10 @@ OASISReader::do_read (db::Layout &layout)
 
     } else if (r == 13 || r == 14 /*CELL*/) {
 
+      //  the CELL record can be located again unless it is inside a CBLOCK
+      size_t cell_pos = m_stream.pos () - 1;
+      bool cell_pos_valid = ! m_stream.is_inflating ();
+
       m_in_table = NotInTable;
 
       //  there cannot be more file level properties .. store what we have
@@ -1213,8 +1307,16 @@ OASISReader::do_read (db::Layout &layout)
       reset_modal_variables ();
       mark_start_table ();
 
+      //  in lazy mode, only the hierarchy is read now and the body is loaded later
+      m_skip_shapes = m_lazy_cell_bodies && cell_pos_valid;
+      if (m_skip_shapes) {
+        m_cell_body_offsets [cell_index] = cell_pos;
+      }
+
       do_read_cell (cell_index, layout);
 
+      m_skip_shapes = false;
+
     } else if (r == 34 /*CBLOCK*/) {
 
       unsigned int type = get_uint ();
@@ -1373,6 +1475,13 @@ OASISReader::do_read (db::Layout &layout)
           layout.cell (p->first).replace (p->second, ia);
         }
 
+        //  a pending body now belongs to the original cell
+        std::map<db::cell_index_type, size_t>::iterator o = m_cell_body_offsets.find (new_cell.cell_index ());
+        if (o != m_cell_body_offsets.end ()) {
+          m_cell_body_offsets [org_cell.cell_index ()] = o->second;
+          m_cell_body_offsets.erase (o);
+        }
+
         //  finally delete the new cell
         layout.delete_cell (new_cell.cell_index ());
 
@@ -1405,6 +1514,10 @@ OASISReader::do_read (db::Layout &layout)
 
   }
 
+  if (m_lazy_cell_bodies) {
+    collect_declared_cell_info (layout);
+  }
+
   //  Check the table offsets vs. real occurance
   if (m_first_cellname != 0 && m_first_cellname != m_table_cellname && m_expect_strict_mode == 1) {
     warn (tl::sprintf (tl::to_string (tr ("CELLNAME table offset does not match first occurance of CELLNAME in strict mode - %s vs. %s")), m_table_cellname, m_first_cellname));
@@ -1454,7 +1567,7 @@ OASISReader::store_last_properties (db::PropertiesRepository &rep, db::Propertie
 }
 
 std::pair <bool, db::properties_id_type> 
-OASISReader::read_element_properties (db::PropertiesRepository &rep, bool ignore_special)
+OASISReader::read_element_properties (db::PropertiesRepository &rep, bool ignore_special, std::vector<std::pair<db::property_names_id_type, property_value_list> > *sprops)
 {
   db::PropertiesRepository::properties_set properties;
 
@@ -1486,12 +1599,18 @@ OASISReader::read_element_properties (db::PropertiesRepository &rep, bool ignore
 
       read_properties (rep);
       store_last_properties (rep, properties, ignore_special);
+      if (sprops && mm_last_property_is_sprop.get ()) {
+        sprops->push_back (std::make_pair (mm_last_property_name.get (), mm_last_value_list.get ()));
+      }
 
       mark_start_table ();
 
     } else if (m == 29 /*PROPERTY*/) {
 
       store_last_properties (rep, properties, ignore_special);
+      if (sprops && mm_last_property_is_sprop.get ()) {
+        sprops->push_back (std::make_pair (mm_last_property_name.get (), mm_last_value_list.get ()));
+      }
 
       mark_start_table ();
 
@@ -2022,6 +2141,8 @@ OASISReader::do_read_placement (unsigned char r,
 
     std::pair<bool, db::properties_id_type> pp = read_element_properties (layout.properties_repository (), false);
 
+    const std::vector<db::Vector> *points = 0;
+
     db::Vector a, b;
     size_t na, nb;
     if (mm_repetition.get ().is_regular (a, b, na, nb)) {
@@ -2042,6 +2163,43 @@ OASISReader::do_read_placement (unsigned char r,
         instances.push_back (inst);
       }
 
+    } else if (! layout.is_editable () && (points = mm_repetition.get ().is_iterated ()) != 0) {
+
+      //  Keep irregular repetitions as iterated arrays: the displacement lists are
+      //  shared through the array repository and only expanded when the members are
+      //  iterated. Editable layouts receive single instances as before.
+      db::CellInstArray inst;
+
+      if (mag_set || angle < 0) {
+
+        db::ICplxTrans ct (mag, angle_deg, mirror, pos);
+
+        db::CellInstArray::iterated_complex_array_type array (ct.rcos (), ct.mag ());
+        array.reserve (points->size () + 1);
+        array.insert (db::Vector ());
+        array.insert (points->begin (), points->end ());
+        array.sort ();
+
+        inst = db::CellInstArray (db::CellInst (mm_placement_cell.get ()), db::Trans (ct), layout.array_repository ().insert (array));
+
+      } else {
+
+        db::CellInstArray::iterated_array_type array;
+        array.reserve (points->size () + 1);
+        array.insert (db::Vector ());
+        array.insert (points->begin (), points->end ());
+        array.sort ();
+
+        inst = db::CellInstArray (db::CellInst (mm_placement_cell.get ()), db::Trans (angle, mirror, pos), layout.array_repository ().insert (array));
+
+      }
+
+      if (pp.first) {
+        instances_with_props.push_back (db::CellInstArrayWithProperties (inst, pp.second));
+      } else {
+        instances.push_back (inst);
+      }
+
     } else {
 
       RepetitionIterator p = mm_repetition.get ().begin ();
@@ -2168,7 +2326,7 @@ OASISReader::do_read_text (bool xy_absolute,
 
   std::pair<bool, unsigned int> ll (false, 0);
   if (m_read_texts) {
-    ll = open_dl (layout, LDPair (mm_textlayer.get (), mm_texttype.get ()), m_create_layers);
+    ll = open_geometry_dl (layout, LDPair (mm_textlayer.get (), mm_texttype.get ()));
   }
 
   if ((m & 0x4) && read_repetition ()) {
@@ -2310,7 +2468,7 @@ OASISReader::do_read_rectangle (bool xy_absolute,
   db::Box box (db::Point (mm_geometry_x.get (), mm_geometry_y.get ()),
                db::Point (mm_geometry_x.get () + mm_geometry_w.get (), mm_geometry_y.get () + mm_geometry_h.get ()));
 
-  std::pair<bool, unsigned int> ll = open_dl (layout, LDPair (mm_layer.get (), mm_datatype.get ()), m_create_layers);
+  std::pair<bool, unsigned int> ll = open_geometry_dl (layout, LDPair (mm_layer.get (), mm_datatype.get ()));
 
   if ((m & 0x4) && read_repetition ()) {
 
@@ -2424,7 +2582,7 @@ OASISReader::do_read_polygon (bool xy_absolute, db::cell_index_type cell_index,
 
   db::Vector pos (mm_geometry_x.get (), mm_geometry_y.get ());
 
-  std::pair<bool, unsigned int> ll = open_dl (layout, LDPair (mm_layer.get (), mm_datatype.get ()), m_create_layers);
+  std::pair<bool, unsigned int> ll = open_geometry_dl (layout, LDPair (mm_layer.get (), mm_datatype.get ()));
 
   if ((m & 0x4) && read_repetition ()) {
 
@@ -2591,7 +2749,7 @@ OASISReader::do_read_path (bool xy_absolute, db::cell_index_type cell_index, db:
 
   db::Vector pos (mm_geometry_x.get (), mm_geometry_y.get ());
 
-  std::pair<bool, unsigned int> ll = open_dl (layout, LDPair (mm_layer.get (), mm_datatype.get ()), m_create_layers);
+  std::pair<bool, unsigned int> ll = open_geometry_dl (layout, LDPair (mm_layer.get (), mm_datatype.get ()));
 
   if ((m & 0x4) && read_repetition ()) {
 
@@ -2750,7 +2908,7 @@ OASISReader::do_read_trapezoid (unsigned char r, bool xy_absolute,db::cell_index
 
   db::Vector pos (mm_geometry_x.get (), mm_geometry_y.get ());
 
-  std::pair<bool, unsigned int> ll = open_dl (layout, LDPair (mm_layer.get (), mm_datatype.get ()), m_create_layers);
+  std::pair<bool, unsigned int> ll = open_geometry_dl (layout, LDPair (mm_layer.get (), mm_datatype.get ()));
 
   db::Point pts [4];
 
@@ -2905,7 +3063,7 @@ OASISReader::do_read_ctrapezoid (bool xy_absolute,db::cell_index_type cell_index
 
   db::Vector pos (mm_geometry_x.get (), mm_geometry_y.get ());
 
-  std::pair<bool, unsigned int> ll = open_dl (layout, LDPair (mm_layer.get (), mm_datatype.get ()), m_create_layers);
+  std::pair<bool, unsigned int> ll = open_geometry_dl (layout, LDPair (mm_layer.get (), mm_datatype.get ()));
 
   db::Point pts [4];
 
@@ -3256,7 +3414,7 @@ OASISReader::do_read_circle (bool xy_absolute, db::cell_index_type cell_index, d
 
   db::Vector pos (mm_geometry_x.get (), mm_geometry_y.get ());
 
-  std::pair<bool, unsigned int> ll = open_dl (layout, LDPair (mm_layer.get (), mm_datatype.get ()), m_create_layers);
+  std::pair<bool, unsigned int> ll = open_geometry_dl (layout, LDPair (mm_layer.get (), mm_datatype.get ()));
 
   //  ignore this circle if the radius is zero
   if (mm_circle_radius.get () <= 0) {
@@ -3555,6 +3713,16 @@ OASISReader::do_read_cell (db::cell_index_type cell_index, db::Layout &layout)
 
   }
 
+  if (m_body_only) {
+
+    //  loading a pending body: instances, properties and the proxy context are present already
+    m_instances.clear ();
+    m_instances_with_props.clear ();
+    m_cellname = "";
+    return;
+
+  }
+
   if (! cell_properties.empty ()) {
     layout.cell (cell_index).prop_id (layout.properties_repository ().properties_id (cell_properties));
   }
@@ -3575,12 +3743,220 @@ OASISReader::do_read_cell (db::cell_index_type cell_index, db::Layout &layout)
 
   //  Restore proxy cell (link to PCell or Library)
   if (has_context) {
+    //  proxy cells are generated, so there is no need to load the body
+    m_cell_body_offsets.erase (cell_index);
     OASISReaderLayerMapping layer_mapping (this, &layout, m_create_layers);
-    layout.recover_proxy_as (cell_index, context_strings.begin (), context_strings.end (), &layer_mapping);
+    recover_proxy_as (layout, cell_index, context_strings, &layer_mapping);
   }
 
   m_cellname = "";
 }
 
+// ---------------------------------------------------------------
+//  Lazy cell body loading
+
+void
+OASISReader::collect_declared_cell_info (db::Layout &layout)
+{
+  const db::PropertiesRepository &rep = layout.properties_repository ();
+
+  for (std::map <unsigned long, std::vector<std::pair<db::property_names_id_type, property_value_list> > >::const_iterator cp = m_cellname_sprops.begin (); cp != m_cellname_sprops.end (); ++cp) {
+
+    std::map <unsigned long, db::cell_index_type>::const_iterator c = m_cells_by_id.find (cp->first);
+    if (c == m_cells_by_id.end () || ! layout.is_valid_cell_index (c->second)) {
+      continue;
+    }
+
+    for (std::vector<std::pair<db::property_names_id_type, property_value_list> >::const_iterator p = cp->second.begin (); p != cp->second.end (); ++p) {
+
+      std::string name = rep.prop_name (p->first).to_string ();
+      const property_value_list &values = p->second;
+
+      if (name == "S_BOUNDING_BOX" && values.size () == 5) {
+
+        //  flag bit 2 means the box depends on external cells and is not reliable
+        unsigned long flags = values [0].to_ulong ();
+        if ((flags & 0x4) == 0) {
+          db::Box box;
+          if ((flags & 0x2) == 0) {
+            db::Point p1 (values [1].to_long (), values [2].to_long ());
+            box = db::Box (p1, p1 + db::Vector (values [3].to_long (), values [4].to_long ()));
+          }
+          m_declared_cell_bboxes [c->second] = box;
+        }
+
+      } else if (name == "S_CELL_OFFSET" && values.size () == 1) {
+
+        std::map<db::cell_index_type, size_t>::const_iterator o = m_cell_body_offsets.find (c->second);
+        size_t offset = size_t (values [0].to_ulong ());
+        if (o != m_cell_body_offsets.end () && offset != 0 && offset != o->second) {
+          warn (tl::sprintf (tl::to_string (tr ("S_CELL_OFFSET of cell %s does not match actual location - %s vs. %s")), layout.cell_name (c->second), offset, o->second));
+        }
+
+      }
+
+    }
+
+  }
+
+  m_cellname_sprops.clear ();
 }
 
+bool
+OASISReader::is_cell_body_pending (db::cell_index_type cell_index) const
+{
+  return m_cell_body_offsets.find (cell_index) != m_cell_body_offsets.end ();
+}
+
+std::pair<bool, db::Box>
+OASISReader::declared_cell_bbox (db::cell_index_type cell_index) const
+{
+  std::map<db::cell_index_type, db::Box>::const_iterator b = m_declared_cell_bboxes.find (cell_index);
+  if (b != m_declared_cell_bboxes.end ()) {
+    return std::make_pair (true, b->second);
+  } else {
+    return std::make_pair (false, db::Box ());
+  }
+}
+
+void
+OASISReader::load_cell_body (db::Layout &layout, db::cell_index_type cell_index)
+{
+  std::map<db::cell_index_type, size_t>::iterator o = m_cell_body_offsets.find (cell_index);
+  if (o == m_cell_body_offsets.end ()) {
+    return;
+  }
+
+  size_t offset = o->second;
+  m_cell_body_offsets.erase (o);
+
+  m_stream.seek (offset);
+  m_cellname = layout.cell_name (cell_index);
+
+  //  read over the CELL record's header
+  unsigned char r = get_byte ();
+  if (r == 13) {
+    get_ulong ();
+  } else if (r == 14) {
+    get_str ();
+  } else {
+    error (tl::to_string (tr ("Format error (CELL record expected at cell body location)")));
+  }
+
+  layout.start_changes ();
+  try {
+
+    m_body_only = true;
+
+    reset_modal_variables ();
+    mark_start_table ();
+
+    do_read_cell (cell_index, layout);
+
+    m_body_only = false;
+    layout.end_changes ();
+
+  } catch (...) {
+    m_body_only = false;
+    layout.end_changes ();
+    throw;
+  }
+}
+
+namespace
+{
+
+/**
+ *  @brief A box converter for cell instances delivering the declared bounding boxes
+ */
+struct DeclaredCellBoxConverter
+{
+  DeclaredCellBoxConverter (const std::map<db::cell_index_type, db::Box> &boxes)
+    : mp_boxes (&boxes)
+  {
+    //  .. nothing yet ..
+  }
+
+  db::Box operator() (const db::CellInst &inst) const
+  {
+    std::map<db::cell_index_type, db::Box>::const_iterator b = mp_boxes->find (inst.cell_index ());
+    return b != mp_boxes->end () ? b->second : db::Box ();
+  }
+
+private:
+  const std::map<db::cell_index_type, db::Box> *mp_boxes;
+};
+
+}
+
+void
+OASISReader::load_cell_bodies (db::Layout &layout, db::cell_index_type cell_index, const db::Box &region)
+{
+  load_cell_bodies (layout, std::vector<db::cell_index_type> (1, cell_index), region);
+}
+
+void
+OASISReader::load_cell_bodies (db::Layout &layout, const std::vector<db::cell_index_type> &top_cells, const db::Box &region)
+{
+  layout.update ();
+
+  //  propagate the region top-down through the hierarchy, using the declared bounding boxes
+  std::map<db::cell_index_type, db::Box> regions;
+  for (std::vector<db::cell_index_type>::const_iterator t = top_cells.begin (); t != top_cells.end (); ++t) {
+    regions.insert (std::make_pair (*t, region));
+  }
+
+  std::vector<std::pair<size_t, db::cell_index_type> > to_load;
+  DeclaredCellBoxConverter bc (m_declared_cell_bboxes);
+
+  for (db::Layout::top_down_const_iterator c = layout.begin_top_down (); c != layout.end_top_down (); ++c) {
+
+    std::map<db::cell_index_type, db::Box>::const_iterator r = regions.find (*c);
+    if (r == regions.end () || r->second.empty ()) {
+      continue;
+    }
+
+    db::Box cell_region = r->second;
+
+    std::map<db::cell_index_type, size_t>::const_iterator o = m_cell_body_offsets.find (*c);
+    if (o != m_cell_body_offsets.end ()) {
+      to_load.push_back (std::make_pair (o->second, *c));
+    }
+
+    const db::Cell &cell = layout.cell (*c);
+    for (db::Cell::const_iterator i = cell.begin (); ! i.at_end (); ++i) {
+
+      const db::CellInstArray &inst = i->cell_inst ();
+      db::cell_index_type ci = inst.object ().cell_index ();
+
+      std::map<db::cell_index_type, db::Box>::const_iterator b = m_declared_cell_bboxes.find (ci);
+      bool declared = (b != m_declared_cell_bboxes.end ());
+
+      for (db::CellInstArray::iterator a = declared ? inst.begin_touching (cell_region, bc) : inst.begin (); ! a.at_end (); ++a) {
+
+        db::Box child_region = cell_region;
+        if (child_region != db::Box::world ()) {
+          child_region.transform (inst.complex_trans (*a).inverted ());
+        }
+        if (declared) {
+          child_region &= b->second;
+        }
+
+        if (! child_region.empty ()) {
+          regions [ci] += child_region;
+        }
+
+      }
+
+    }
+
+  }
+
+  //  load the bodies in file order
+  std::sort (to_load.begin (), to_load.end ());
+  for (std::vector<std::pair<size_t, db::cell_index_type> >::const_iterator l = to_load.begin (); l != to_load.end (); ++l) {
+    load_cell_body (layout, l->second);
+  }
+}
+
+}
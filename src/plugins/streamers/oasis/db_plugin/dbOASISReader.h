@@ -132,6 +132,64 @@ public:
    */
   virtual void warn (const std::string &txt);
 
+  /**
+   *  @brief Enables lazy loading of cell bodies
+   *
+   *  If this flag is set, "read" will only build the cell hierarchy.
+   *  The shapes are not stored. Instead the reader keeps the file offsets of the
+   *  cell bodies and the bounding boxes declared by S_BOUNDING_BOX properties.
+   *  The shapes can be loaded later on demand through load_cell_body
+   *  or load_cell_bodies. This requires the reader and its stream to stay alive.
+   *
+   *  This is a property of the reader rather than a reader option, as the 
+   *  generic read path (db::Reader, Layout::read) does not give access to the reader
+   *  and the cells would stay empty. To read a part of a layout only through this path,
+   *  use CommonReaderOptions::region.
+   */
+  void set_lazy_cell_bodies (bool f)
+  {
+    m_lazy_cell_bodies_requested = f;
+  }
+
+  /**
+   *  @brief Gets a value indicating whether lazy loading of cell bodies is enabled
+   */
+  bool lazy_cell_bodies () const
+  {
+    return m_lazy_cell_bodies_requested;
+  }
+
+  /**
+   *  @brief Returns a value indicating whether the body of the given cell still needs to be loaded
+   *
+   *  This is only the case if the layout has been read with lazy loading of cell bodies.
+   */
+  bool is_cell_body_pending (db::cell_index_type cell_index) const;
+
+  /**
+   *  @brief Gets the bounding box declared for the given cell by the S_BOUNDING_BOX property
+   *
+   *  The first member of the returned pair is false if no bounding box is declared.
+   *  Declared bounding boxes are only collected in lazy mode.
+   */
+  std::pair<bool, db::Box> declared_cell_bbox (db::cell_index_type cell_index) const;
+
+  /**
+   *  @brief Loads the shapes of a cell in lazy mode
+   *
+   *  If the body of the cell is not pending, this method does nothing.
+   */
+  void load_cell_body (db::Layout &layout, db::cell_index_type cell_index);
+
+  /**
+   *  @brief Loads the shapes of all cells contributing to the given region of a cell
+   *
+   *  This method will use the declared bounding boxes to determine which child cells
+   *  contribute to the region. Cells without a declared bounding box are always taken.
+   *  The bodies are loaded in file order.
+   */
+  void load_cell_bodies (db::Layout &layout, db::cell_index_type cell_index, const db::Box &region);
+
 private:
   friend class OASISReaderLayerMapping;
 
@@ -222,7 +280,17 @@ private:
   db::property_names_id_type m_s_gds_property_name_id;
   db::property_names_id_type m_klayout_context_property_name_id;
 
+  bool m_lazy_cell_bodies;
+  bool m_lazy_cell_bodies_requested;
+  bool m_skip_shapes;
+  bool m_body_only;
+  std::map <db::cell_index_type, size_t> m_cell_body_offsets;
+  std::map <db::cell_index_type, db::Box> m_declared_cell_bboxes;
+  std::map <unsigned long, std::vector<std::pair<db::property_names_id_type, property_value_list> > > m_cellname_sprops;
+
   void do_read (db::Layout &layout);
+  void read_region (db::Layout &layout, const db::Box &region);
+  void load_cell_bodies (db::Layout &layout, const std::vector<db::cell_index_type> &top_cells, const db::Box &region);
   void do_read_cell (db::cell_index_type cell_index, db::Layout &layout);
 
   void do_read_placement (unsigned char r,
@@ -249,7 +317,8 @@ private:
   void read_pointlist (modal_variable <std::vector <db::Point> > &pointlist, bool for_polygon);
   void read_properties (db::PropertiesRepository &rep);
   void store_last_properties (db::PropertiesRepository &rep, db::PropertiesRepository::properties_set &properties, bool ignore_special);
-  std::pair <bool, db::properties_id_type> read_element_properties (db::PropertiesRepository &rep, bool ignore_special);
+  std::pair <bool, db::properties_id_type> read_element_properties (db::PropertiesRepository &rep, bool ignore_special, std::vector<std::pair<db::property_names_id_type, property_value_list> > *sprops = 0);
+  void collect_declared_cell_info (db::Layout &layout);
 
   unsigned char get_byte ()
   {
@@ -316,6 +385,8 @@ private:
   distance_type get_ucoord_as_distance (unsigned long grid = 1);
 
   std::pair <bool, unsigned int> open_dl (db::Layout &layout, const LDPair &dl, bool create);
+  virtual db::ImportLayerMapping *create_proxy_layer_mapping (db::Layout &layout);
+  std::pair <bool, unsigned int> open_geometry_dl (db::Layout &layout, const LDPair &dl);
 };
 
 }
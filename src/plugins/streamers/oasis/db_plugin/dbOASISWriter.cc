@@ -670,6 +670,7 @@ OASISWriter::OASISWriter ()
     m_propname_id (0),
     m_propstring_id (0),
     m_proptables_written (false),
+    m_incremental (false),
     m_progress (tl::to_string (tr ("Writing OASIS file")), 10000)
 {
   m_progress.set_format (tl::to_string (tr ("%.0f MB")));
@@ -1150,11 +1151,9 @@ OASISWriter::reset_modal_variables ()
   mm_last_value_list.reset ();
 }
 
-void 
-OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::SaveLayoutOptions &options)
+void
+OASISWriter::begin_file (db::Layout &layout, tl::OutputStream &stream, const db::SaveLayoutOptions &options)
 {
-  typedef db::coord_traits<db::Coord>::distance_type coord_distance_type;
-
   mp_layout = &layout;
   mp_cell = 0;
   m_layer = m_datatype = 0;
@@ -1171,30 +1170,6 @@ OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::Save
     m_sf = 1.0;
   }
 
-  std::vector <std::pair <unsigned int, db::LayerProperties> > layers;
-  options.get_valid_layers (layout, layers, db::SaveLayoutOptions::LP_AssignNumber);
-
-  std::set <db::cell_index_type> cell_set;
-  options.get_cells (layout, cell_set, layers);
-
-  //  create a cell index vector sorted bottom-up
-  std::vector <db::cell_index_type> cells, cells_by_index;
-
-  cells.reserve (cell_set.size ());
-  cells_by_index.reserve (cell_set.size ());
-
-  for (db::Layout::bottom_up_const_iterator cell = layout.begin_bottom_up (); cell != layout.end_bottom_up (); ++cell) {
-    if (cell_set.find (*cell) != cell_set.end ()) {
-      cells.push_back (*cell);
-    }
-  }
-
-  for (db::Layout::const_iterator cell = layout.begin (); cell != layout.end (); ++cell) {
-    if (cell_set.find (cell->cell_index ()) != cell_set.end ()) {
-      cells_by_index.push_back (cell->cell_index ());
-    }
-  }
-
   //  write header
 
   char magic[] = "%SEMI-OASIS\015\012";
@@ -1206,12 +1181,12 @@ OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::Save
   write (1.0 / dbu);
   write_byte (m_options.strict_mode ? 1 : 0);  //  offset-flag (strict mode: at the end, non-strict mode: at the beginning)
 
-  size_t cellnames_table_pos = 0;
-  size_t textstrings_table_pos = 0;
-  size_t propnames_table_pos = 0;
-  size_t propstrings_table_pos = 0;
-  size_t layernames_table_pos = 0;
-  std::map<db::cell_index_type, size_t> cell_positions;
+  m_cellnames_table_pos = 0;
+  m_textstrings_table_pos = 0;
+  m_propnames_table_pos = 0;
+  m_propstrings_table_pos = 0;
+  m_layernames_table_pos = 0;
+  m_cell_positions.clear ();
 
   if (! m_options.strict_mode) {
 
@@ -1232,14 +1207,8 @@ OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::Save
   m_propnames.clear ();
   m_propstrings.clear ();
 
-  //  We will collect the standard properties here:
-  
   m_propstring_id = m_propname_id = 0;
   m_proptables_written = false;
-  std::vector<std::pair<std::string, unsigned int> > init_props;
-
-  //  write file properties (must happen before any other PROPNAME record since formally the
-  //  PROPERTY records are associated with the names rather than the file)
 
   //  prepare some property ID's in strict mode .. in non-strict mode we write strings to
   //  avoid forward references
@@ -1255,6 +1224,45 @@ OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::Save
       }
     }
   }
+}
+
+void 
+OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::SaveLayoutOptions &options)
+{
+  typedef db::coord_traits<db::Coord>::distance_type coord_distance_type;
+
+  m_incremental = false;
+
+  begin_file (layout, stream, options);
+
+  std::vector <std::pair <unsigned int, db::LayerProperties> > layers;
+  options.get_valid_layers (layout, layers, db::SaveLayoutOptions::LP_AssignNumber);
+
+  std::set <db::cell_index_type> cell_set;
+  options.get_cells (layout, cell_set, layers);
+
+  //  create a cell index vector sorted bottom-up
+  std::vector <db::cell_index_type> cells, cells_by_index;
+
+  cells.reserve (cell_set.size ());
+  cells_by_index.reserve (cell_set.size ());
+
+  for (db::Layout::bottom_up_const_iterator cell = layout.begin_bottom_up (); cell != layout.end_bottom_up (); ++cell) {
+    if (cell_set.find (*cell) != cell_set.end ()) {
+      cells.push_back (*cell);
+    }
+  }
+
+  for (db::Layout::const_iterator cell = layout.begin (); cell != layout.end (); ++cell) {
+    if (cell_set.find (cell->cell_index ()) != cell_set.end ()) {
+      cells_by_index.push_back (cell->cell_index ());
+    }
+  }
+
+  std::vector<std::pair<std::string, unsigned int> > init_props;
+
+  //  write file properties (must happen before any other PROPNAME record since formally the
+  //  PROPERTY records are associated with the names rather than the file)
 
   if (m_options.write_std_properties > 0) {
 
@@ -1301,7 +1309,7 @@ OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::Save
 
     for (std::vector<std::pair<unsigned long, std::string> >::const_iterator p = rev_pn.begin (); p != rev_pn.end (); ++p) {
       tl_assert (p->first == (unsigned long)(p - rev_pn.begin ()));
-      begin_table (propnames_table_pos);
+      begin_table (m_propnames_table_pos);
       write_record_id (7);
       write_nstring (p->second.c_str ());
     }
@@ -1315,14 +1323,14 @@ OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::Save
       const db::Cell &cref (layout.cell (*cell));
 
       if (cref.prop_id () != 0) {
-        begin_table (propnames_table_pos);
+        begin_table (m_propnames_table_pos);
         emit_propname_def (cref.prop_id ());
       }
 
       for (db::Cell::const_iterator inst = cref.begin (); ! inst.at_end (); ++inst) {
         if (inst->has_prop_id () && inst->prop_id () != 0 && prop_ids_done.find (inst->prop_id ()) == prop_ids_done.end ()) {
           prop_ids_done.insert (inst->prop_id ());
-          begin_table (propnames_table_pos);
+          begin_table (m_propnames_table_pos);
           emit_propname_def (inst->prop_id ());
           m_progress.set (mp_stream->pos ());
         }
@@ -1333,7 +1341,7 @@ OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::Save
         while (! shape.at_end ()) {
           if (shape->has_prop_id () && shape->prop_id () != 0 && prop_ids_done.find (shape->prop_id ()) == prop_ids_done.end ()) {
             prop_ids_done.insert (shape->prop_id ());
-            begin_table (propnames_table_pos);
+            begin_table (m_propnames_table_pos);
             emit_propname_def (shape->prop_id ());
             m_progress.set (mp_stream->pos ());
           }
@@ -1351,7 +1359,7 @@ OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::Save
       if (cref.is_proxy () && ! cref.is_top () && layout.get_context_info (*cell, context_prop_strings)) {
 
         if (m_propnames.insert (std::make_pair (std::string (klayout_context_name), m_propname_id)).second) {
-          begin_table (propnames_table_pos);
+          begin_table (m_propnames_table_pos);
           write_record_id (7);
           write_nstring (klayout_context_name);
           ++m_propname_id;
@@ -1362,7 +1370,7 @@ OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::Save
 
     }
 
-    end_table (propnames_table_pos);
+    end_table (m_propnames_table_pos);
 
   }
 
@@ -1379,7 +1387,7 @@ OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::Save
 
     for (std::vector<std::pair<unsigned long, std::string> >::const_iterator p = rev_ps.begin (); p != rev_ps.end (); ++p) {
       tl_assert (p->first == (unsigned long)(p - rev_ps.begin ()));
-      begin_table (propstrings_table_pos);
+      begin_table (m_propstrings_table_pos);
       write_record_id (9);
       write_nstring (p->second.c_str ());
     }
@@ -1394,14 +1402,14 @@ OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::Save
 
       if (cref.prop_id () != 0 && prop_ids_done.find (cref.prop_id ()) == prop_ids_done.end ()) {
         prop_ids_done.insert (cref.prop_id ());
-        begin_table (propnames_table_pos);
+        begin_table (m_propnames_table_pos);
         emit_propstring_def (cref.prop_id ());
       }
 
       for (db::Cell::const_iterator inst = cref.begin (); ! inst.at_end (); ++inst) {
         if (inst->has_prop_id () && inst->prop_id () != 0 && prop_ids_done.find (inst->prop_id ()) == prop_ids_done.end ()) {
           prop_ids_done.insert (inst->prop_id ());
-          begin_table (propstrings_table_pos);
+          begin_table (m_propstrings_table_pos);
           emit_propstring_def (inst->prop_id ());
           m_progress.set (mp_stream->pos ());
         }
@@ -1412,7 +1420,7 @@ OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::Save
         while (! shape.at_end ()) {
           if (shape->has_prop_id () && shape->prop_id () != 0 && prop_ids_done.find (shape->prop_id ()) == prop_ids_done.end ()) {
             prop_ids_done.insert (shape->prop_id ());
-            begin_table (propstrings_table_pos);
+            begin_table (m_propstrings_table_pos);
             emit_propstring_def (shape->prop_id ());
             m_progress.set (mp_stream->pos ());
           }
@@ -1436,7 +1444,7 @@ OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::Save
 
           for (std::vector <std::string>::const_iterator c = context_prop_strings.begin (); c != context_prop_strings.end (); ++c) {
             if (m_propstrings.insert (std::make_pair (*c, m_propstring_id)).second) {
-              begin_table (propstrings_table_pos);
+              begin_table (m_propstrings_table_pos);
               write_record_id (9);
               write_bstring (c->c_str ());
               ++m_propstring_id;
@@ -1449,7 +1457,7 @@ OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::Save
 
     }
 
-    end_table (propstrings_table_pos);
+    end_table (m_propstrings_table_pos);
 
   }
 
@@ -1480,30 +1488,8 @@ OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::Save
       }
 
       if (m_options.write_std_properties > 1) {
-
         reset_modal_variables ();
-
-        //  write S_BOUNDING_BOX entries
-
-        std::vector<tl::Variant> values;
-
-        //  TODO: how to set the "depends on external cells" flag?
-        db::Box bbox = layout.cell (*cell).bbox ();
-        if (bbox.empty ()) {
-          //  empty box 
-          values.push_back (tl::Variant ((unsigned int) 0x2)); 
-          bbox = db::Box (0, 0, 0, 0);
-        } else {
-          values.push_back (tl::Variant ((unsigned int) 0x0)); 
-        }
-
-        values.push_back (tl::Variant (bbox.left ())); 
-        values.push_back (tl::Variant (bbox.bottom ())); 
-        values.push_back (tl::Variant (bbox.width ()));
-        values.push_back (tl::Variant (bbox.height ()));
-
-        write_property_def (s_bounding_box_name, values, true);
-
+        write_bbox_property (*cell);
       }
 
     }
@@ -1525,7 +1511,7 @@ OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::Save
         db::ShapeIterator shape (cref.shapes (l->first).begin (db::ShapeIterator::Texts));
         while (! shape.at_end ()) {
           if (m_textstrings.insert (std::make_pair (shape->text_string (), id)).second) {
-            begin_table (textstrings_table_pos);
+            begin_table (m_textstrings_table_pos);
             write_record_id (5);
             write_astring (shape->text_string ());
             ++id;
@@ -1537,7 +1523,7 @@ OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::Save
 
     }
 
-    end_table (textstrings_table_pos);
+    end_table (m_textstrings_table_pos);
 
   }
 
@@ -1549,7 +1535,7 @@ OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::Save
 
       if (! l->second.name.empty ()) {
 
-        begin_table (layernames_table_pos);
+        begin_table (m_layernames_table_pos);
 
         //  write mappings to text layer and shape layers
         write_record_id (11);
@@ -1572,158 +1558,393 @@ OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::Save
 
     }
 
-    end_table (layernames_table_pos);
+    end_table (m_layernames_table_pos);
 
   }
 
-  std::vector <std::string> context_prop_strings;
-
   for (std::vector<db::cell_index_type>::const_iterator cell = cells.begin (); cell != cells.end (); ++cell) {
-
     m_progress.set (mp_stream->pos ());
+    write_cell_body (*cell, &cell_set, layers);
+  }
 
-    //  cell body 
-    const db::Cell &cref (layout.cell (*cell));
-    mp_cell = &cref;
+  //  write cell table at the end in strict mode (in that mode we need the cell positions
+  //  for the S_CELL_OFFSET properties)
+  
+  if (m_options.strict_mode) {
+    write_cellname_table (cells_by_index);
+  }
 
-    //  don't write ghost cells unless they are not empty (any more)
-    //  also don't write proxy cells which are not employed
-    if ((! cref.is_ghost_cell () || ! cref.empty ()) && (! cref.is_proxy () || ! cref.is_top ())) {
+  write_end_record ();
+}
 
-      //  cell header 
+namespace
+{
 
-      cell_positions.insert (std::make_pair (*cell, mp_stream->pos ()));
+/**
+ *  @brief A box converter for cell instances which takes the boxes of the cells written so far
+ */
+struct RecordedCellBoxConvert
+{
+  RecordedCellBoxConvert (const std::map<db::cell_index_type, std::pair<db::Box, bool> > &boxes)
+    : mp_boxes (&boxes), complete (true)
+  {
+    //  .. nothing yet ..
+  }
 
-      write_record_id (13);  // CELL
-      write ((unsigned long) *cell);
+  db::Box operator() (const db::CellInst &inst) const
+  {
+    std::map<db::cell_index_type, std::pair<db::Box, bool> >::const_iterator b = mp_boxes->find (inst.cell_index ());
+    if (b == mp_boxes->end ()) {
+      complete = false;
+      return db::Box ();
+    } else {
+      if (! b->second.second) {
+        complete = false;
+      }
+      return b->second.first;
+    }
+  }
+
+  const std::map<db::cell_index_type, std::pair<db::Box, bool> > *mp_boxes;
+  mutable bool complete;
+};
 
-      reset_modal_variables ();
+}
 
-      if (m_options.write_cblocks) {
-        begin_cblock ();
-      }
+void
+OASISWriter::begin_write (db::Layout &layout, tl::OutputStream &stream, const db::SaveLayoutOptions &options)
+{
+  typedef db::coord_traits<db::Coord>::distance_type coord_distance_type;
 
-      //  context information as property named KLAYOUT_CONTEXT
-      if (cref.is_proxy ()) {
+  m_incremental = true;
+  m_layers.clear ();
+  m_cell_bboxes.clear ();
 
-        context_prop_strings.clear ();
+  begin_file (layout, stream, options);
 
-        if (layout.get_context_info (*cell, context_prop_strings)) {
+  //  S_TOP_CELL cannot be given as the cells are not known in advance
+  if (m_options.write_std_properties > 0) {
+    write_property_def (s_max_signed_integer_width_name, tl::Variant (sizeof (db::Coord)), true);
+    write_property_def (s_max_unsigned_integer_width_name, tl::Variant (sizeof (coord_distance_type)), true);
+    if (m_options.write_std_properties > 1) {
+      //  "some" bounding boxes available - the ones of cells referencing cells not written yet are not
+      write_property_def (s_bounding_boxes_available_name, tl::Variant ((unsigned int) 1), true);
+    }
+  }
 
-          write_record_id (28);
-          write_byte (char (0xf6)); 
-          std::map <std::string, unsigned long>::const_iterator pni = m_propnames.find (klayout_context_name);
-          tl_assert (pni != m_propnames.end ());
-          write (pni->second);
+  if (m_options.write_std_properties > 1) {
+    m_propnames.insert (std::make_pair (s_bounding_box_name, m_propname_id++));
+  }
 
-          write ((unsigned long) context_prop_strings.size ());
+  if (layout.prop_id () != 0) {
+    write_props (layout.prop_id ());
+  }
+}
 
-          for (std::vector <std::string>::const_iterator c = context_prop_strings.begin (); c != context_prop_strings.end (); ++c) {
-            write_byte (14); // b-string by reference number
-            std::map <std::string, unsigned long>::const_iterator psi = m_propstrings.find (*c);
-            tl_assert (psi != m_propstrings.end ());
-            write (psi->second);
-          }
+void
+OASISWriter::write_cell (db::cell_index_type ci)
+{
+  tl_assert (m_incremental);
 
-          mm_last_property_name = klayout_context_name;
-          mm_last_property_is_sprop = false;
-          mm_last_value_list.reset ();
+  m_progress.set (mp_stream->pos ());
 
-        }
+  //  register new layers - layers without a number get the next free one
+  db::register_new_layers (*mp_layout, m_layers);
 
-      }
+  //  compute the bounding box from the shapes and the boxes of the child cells written so far
 
-      if (cref.prop_id () != 0) {
-        write_props (cref.prop_id ());
-      }
+  const db::Cell &cref (mp_layout->cell (ci));
 
-      //  instances
-      if (cref.cell_instances () > 0) {
-        write_insts (cell_set);
-      }
+  db::Box bbox;
+  for (std::vector <std::pair <unsigned int, db::LayerProperties> >::const_iterator l = m_layers.begin (); l != m_layers.end (); ++l) {
+    for (db::ShapeIterator shape = cref.shapes (l->first).begin (db::ShapeIterator::All); ! shape.at_end (); ++shape) {
+      bbox += shape->bbox ();
+    }
+  }
 
-      //  shapes
-      for (std::vector <std::pair <unsigned int, db::LayerProperties> >::const_iterator l = layers.begin (); l != layers.end (); ++l) {
-        const db::Shapes &shapes = cref.shapes (l->first);
-        if (! shapes.empty ()) {
-          write_shapes (l->second, shapes);
-          m_progress.set (mp_stream->pos ());
-        }
-      }
+  RecordedCellBoxConvert bc (m_cell_bboxes);
+  for (db::Cell::const_iterator inst = cref.begin (); ! inst.at_end (); ++inst) {
+    bbox += inst->cell_inst ().bbox (bc);
+  }
+
+  m_cell_bboxes [ci] = std::make_pair (bbox, bc.complete);
+
+  write_cell_body (ci, 0, m_layers);
+}
+
+void
+OASISWriter::end_write ()
+{
+  tl_assert (m_incremental);
+
+  //  all name tables are written at the end - the IDs have been assigned while the cells were written
+
+  std::vector<db::cell_index_type> cells_by_index;
+  for (db::Layout::const_iterator cell = mp_layout->begin (); cell != mp_layout->end (); ++cell) {
+    cells_by_index.push_back (cell->cell_index ());
+  }
 
-      //  end CBLOCK if required
-      if (m_options.write_cblocks) {
-        end_cblock ();
-      } 
+  write_cellname_table (cells_by_index);
 
-      //  end of cell
+  {
 
+    std::vector<std::pair<unsigned long, std::string> > rev_ts;
+    rev_ts.reserve (m_textstrings.size ());
+    for (std::map <std::string, unsigned long>::const_iterator t = m_textstrings.begin (); t != m_textstrings.end (); ++t) {
+      rev_ts.push_back (std::make_pair (t->second, t->first));
     }
+    std::sort (rev_ts.begin (), rev_ts.end ());
+
+    for (std::vector<std::pair<unsigned long, std::string> >::const_iterator t = rev_ts.begin (); t != rev_ts.end (); ++t) {
+      begin_table (m_textstrings_table_pos);
+      write_record_id (5);
+      write_astring (t->second.c_str ());
+    }
+
+    end_table (m_textstrings_table_pos);
 
   }
 
-  //  write cell table at the end in strict mode (in that mode we need the cell positions
-  //  for the S_CELL_OFFSET properties)
-  
-  if (m_options.strict_mode) {
+  for (std::vector <std::pair <unsigned int, db::LayerProperties> >::const_iterator l = m_layers.begin (); l != m_layers.end (); ++l) {
+
+    if (! l->second.name.empty ()) {
+
+      begin_table (m_layernames_table_pos);
+
+      //  write mappings to text layer and shape layers
+      write_record_id (11);
+      write_nstring (l->second.name.c_str ());
+      write_byte (3);
+      write ((unsigned long) l->second.layer);
+      write_byte (3);
+      write ((unsigned long) l->second.datatype);
+
+      write_record_id (12);
+      write_nstring (l->second.name.c_str ());
+      write_byte (3);
+      write ((unsigned long) l->second.layer);
+      write_byte (3);
+      write ((unsigned long) l->second.datatype);
 
-    bool sequential = true;
-    for (std::vector<db::cell_index_type>::const_iterator cell = cells_by_index.begin (); cell != cells_by_index.end () && sequential; ++cell) {
-      sequential = (*cell == db::cell_index_type (cell - cells_by_index.begin ()));
     }
 
-    for (std::vector<db::cell_index_type>::const_iterator cell = cells_by_index.begin (); cell != cells_by_index.end (); ++cell) {
-      
-      begin_table (cellnames_table_pos);
+  }
 
-      //  CELLNAME (explicit)
-      write_record_id (sequential ? 3 : 4);
-      write_nstring (layout.cell_name (*cell));
-      if (! sequential) {
-        write ((unsigned long) *cell);
+  end_table (m_layernames_table_pos);
+
+  {
+
+    std::vector<std::pair<unsigned long, std::string> > rev_pn;
+    rev_pn.reserve (m_propnames.size ());
+    for (std::map <std::string, unsigned long>::const_iterator p = m_propnames.begin (); p != m_propnames.end (); ++p) {
+      rev_pn.push_back (std::make_pair (p->second, p->first));
+    }
+    std::sort (rev_pn.begin (), rev_pn.end ());
+
+    for (std::vector<std::pair<unsigned long, std::string> >::const_iterator p = rev_pn.begin (); p != rev_pn.end (); ++p) {
+      begin_table (m_propnames_table_pos);
+      write_record_id (7);
+      write_nstring (p->second.c_str ());
+    }
+
+    end_table (m_propnames_table_pos);
+
+  }
+
+  {
+
+    std::vector<std::pair<unsigned long, std::string> > rev_ps;
+    rev_ps.reserve (m_propstrings.size ());
+    for (std::map <std::string, unsigned long>::const_iterator p = m_propstrings.begin (); p != m_propstrings.end (); ++p) {
+      rev_ps.push_back (std::make_pair (p->second, p->first));
+    }
+    std::sort (rev_ps.begin (), rev_ps.end ());
+
+    for (std::vector<std::pair<unsigned long, std::string> >::const_iterator p = rev_ps.begin (); p != rev_ps.end (); ++p) {
+      begin_table (m_propstrings_table_pos);
+      write_record_id (9);
+      write_bstring (p->second.c_str ());
+    }
+
+    end_table (m_propstrings_table_pos);
+
+  }
+
+  m_proptables_written = true;
+
+  write_end_record ();
+
+  m_incremental = false;
+  m_cell_bboxes.clear ();
+  m_layers.clear ();
+}
+
+void
+OASISWriter::write_bbox_property (db::cell_index_type ci)
+{
+  //  write S_BOUNDING_BOX entries
+
+  std::vector<tl::Variant> values;
+
+  db::Box bbox;
+  unsigned int flags = 0;
+
+  if (m_incremental) {
+    std::map<db::cell_index_type, std::pair<db::Box, bool> >::const_iterator b = m_cell_bboxes.find (ci);
+    if (b != m_cell_bboxes.end ()) {
+      bbox = b->second.first;
+      if (! b->second.second) {
+        //  some child cells were not written yet when the box was computed
+        flags |= 0x4;
       }
+    } else {
+      //  a cell referenced, but never written
+      flags |= 0x4;
+    }
+  } else {
+    //  TODO: how to set the "depends on external cells" flag?
+    bbox = mp_layout->cell (ci).bbox ();
+  }
 
-      reset_modal_variables ();
+  if (bbox.empty ()) {
+    //  empty box 
+    flags |= 0x2;
+    bbox = db::Box (0, 0, 0, 0);
+  }
 
-      if (m_options.write_std_properties > 1) {
+  values.push_back (tl::Variant (flags)); 
+  values.push_back (tl::Variant (bbox.left ())); 
+  values.push_back (tl::Variant (bbox.bottom ())); 
+  values.push_back (tl::Variant (bbox.width ()));
+  values.push_back (tl::Variant (bbox.height ()));
 
-        //  write S_BOUNDING_BOX entries
+  write_property_def (s_bounding_box_name, values, true);
+}
 
-        std::vector<tl::Variant> values;
+void
+OASISWriter::write_cell_body (db::cell_index_type ci, const std::set <db::cell_index_type> *cell_set, const std::vector <std::pair <unsigned int, db::LayerProperties> > &layers)
+{
+  std::vector <std::string> context_prop_strings;
 
-        //  TODO: how to set the "depends on external cells" flag?
-        db::Box bbox = layout.cell (*cell).bbox ();
-        if (bbox.empty ()) {
-          //  empty box 
-          values.push_back (tl::Variant ((unsigned int) 0x2)); 
-          bbox = db::Box (0, 0, 0, 0);
-        } else {
-          values.push_back (tl::Variant ((unsigned int) 0x0)); 
-        }
+  const db::Cell &cref (mp_layout->cell (ci));
+  mp_cell = &cref;
+
+  //  don't write ghost cells unless they are not empty (any more)
+  //  also don't write proxy cells which are not employed
+  if ((! cref.is_ghost_cell () || ! cref.empty ()) && (! cref.is_proxy () || ! cref.is_top ())) {
 
-        values.push_back (tl::Variant (bbox.left ())); 
-        values.push_back (tl::Variant (bbox.bottom ())); 
-        values.push_back (tl::Variant (bbox.width ()));
-        values.push_back (tl::Variant (bbox.height ()));
+    //  cell header 
 
-        write_property_def (s_bounding_box_name, values, true);
+    m_cell_positions.insert (std::make_pair (ci, mp_stream->pos ()));
+
+    write_record_id (13);  // CELL
+    write ((unsigned long) ci);
+
+    reset_modal_variables ();
+
+    if (m_options.write_cblocks) {
+      begin_cblock ();
+    }
+
+    //  context information as property named KLAYOUT_CONTEXT
+    if (cref.is_proxy ()) {
+
+      context_prop_strings.clear ();
+
+      if (mp_layout->get_context_info (ci, context_prop_strings)) {
+
+        write_record_id (28);
+        write_byte (char (0xf6)); 
+        std::map <std::string, unsigned long>::const_iterator pni = m_propnames.find (klayout_context_name);
+        tl_assert (pni != m_propnames.end ());
+        write (pni->second);
+
+        write ((unsigned long) context_prop_strings.size ());
+
+        for (std::vector <std::string>::const_iterator c = context_prop_strings.begin (); c != context_prop_strings.end (); ++c) {
+          write_byte (14); // b-string by reference number
+          std::map <std::string, unsigned long>::const_iterator psi = m_propstrings.find (*c);
+          tl_assert (psi != m_propstrings.end ());
+          write (psi->second);
+        }
+
+        mm_last_property_name = klayout_context_name;
+        mm_last_property_is_sprop = false;
+        mm_last_value_list.reset ();
 
       }
 
-      //  PROPERTY record with S_CELL_OFFSET
-      std::map<db::cell_index_type, size_t>::const_iterator pp = cell_positions.find (*cell);
-      if (pp != cell_positions.end ()) {
-        write_property_def (s_cell_offset_name, tl::Variant (pp->second), true);
-      } else {
-        write_property_def (s_cell_offset_name, tl::Variant (size_t (0)), true);
+    }
+
+    if (cref.prop_id () != 0) {
+      write_props (cref.prop_id ());
+    }
+
+    //  instances
+    if (cref.cell_instances () > 0) {
+      write_insts (cell_set);
+    }
+
+    //  shapes
+    for (std::vector <std::pair <unsigned int, db::LayerProperties> >::const_iterator l = layers.begin (); l != layers.end (); ++l) {
+      const db::Shapes &shapes = cref.shapes (l->first);
+      if (! shapes.empty ()) {
+        write_shapes (l->second, shapes);
+        m_progress.set (mp_stream->pos ());
       }
+    }
+
+    //  end CBLOCK if required
+    if (m_options.write_cblocks) {
+      end_cblock ();
+    } 
+
+    //  end of cell
+
+  }
+}
+
+void
+OASISWriter::write_cellname_table (const std::vector <db::cell_index_type> &cells_by_index)
+{
+  bool sequential = true;
+  for (std::vector<db::cell_index_type>::const_iterator cell = cells_by_index.begin (); cell != cells_by_index.end () && sequential; ++cell) {
+    sequential = (*cell == db::cell_index_type (cell - cells_by_index.begin ()));
+  }
 
+  for (std::vector<db::cell_index_type>::const_iterator cell = cells_by_index.begin (); cell != cells_by_index.end (); ++cell) {
+    
+    begin_table (m_cellnames_table_pos);
+
+    //  CELLNAME (explicit)
+    write_record_id (sequential ? 3 : 4);
+    write_nstring (mp_layout->cell_name (*cell));
+    if (! sequential) {
+      write ((unsigned long) *cell);
     }
 
-    end_table (cellnames_table_pos);
+    reset_modal_variables ();
+
+    if (m_options.write_std_properties > 1) {
+      write_bbox_property (*cell);
+    }
+
+    //  PROPERTY record with S_CELL_OFFSET
+    std::map<db::cell_index_type, size_t>::const_iterator pp = m_cell_positions.find (*cell);
+    if (pp != m_cell_positions.end ()) {
+      write_property_def (s_cell_offset_name, tl::Variant (pp->second), true);
+    } else {
+      write_property_def (s_cell_offset_name, tl::Variant (size_t (0)), true);
+    }
 
   }
 
+  end_table (m_cellnames_table_pos);
+}
+
+void
+OASISWriter::write_end_record ()
+{
   //  END record
 
   size_t end_record_pos = mp_stream->pos ();
@@ -1736,23 +1957,23 @@ OASISWriter::write (db::Layout &layout, tl::OutputStream &stream, const db::Save
 
     //  cellnames
     write_byte (1); 
-    write (cellnames_table_pos);
+    write (m_cellnames_table_pos);
 
     //  textstrings
     write_byte (1); 
-    write (textstrings_table_pos);
+    write (m_textstrings_table_pos);
 
     //  propnames
     write_byte (1); 
-    write (propnames_table_pos);
+    write (m_propnames_table_pos);
 
     //  propstrings
     write_byte (1); 
-    write (propstrings_table_pos);
+    write (m_propstrings_table_pos);
 
     //  layernames
     write_byte (1); 
-    write (layernames_table_pos);
+    write (m_layernames_table_pos);
 
     //  xnames (not used)
     write_byte (1); 
@@ -1961,7 +2182,33 @@ OASISWriter::write (const db::CellInstArray &inst, db::properties_id_type prop_i
   unsigned long amax, bmax;
   bool is_reg = inst.is_regular_array (a, b, amax, bmax);
 
-  if (is_reg && (amax > 1 || bmax > 1)) {
+  std::vector<db::Vector> pts;
+
+  if (! is_reg && inst.is_iterated_array (&pts) && pts.size () > 1) {
+
+    //  iterated arrays are written as irregular repetitions relative to the first displacement.
+    //  NOTE: "front" delivers the array's base transformation only. The displacements are sorted
+    //  into a box tree, so the zero displacement is not necessarily the first one.
+    db::Vector po = pts.front ();
+    std::vector<db::Vector>::iterator pw = pts.begin ();
+    for (std::vector<db::Vector>::iterator p = pw + 1; p != pts.end (); ++p) {
+      *pw++ = *p - po;
+    }
+    pts.erase (pw, pts.end ());
+
+    db::IrregularRepetition *rep_base = new db::IrregularRepetition ();
+    rep_base->points ().swap (pts);
+    db::Repetition array_rep (rep_base);
+
+    if (rep != db::Repetition ()) {
+      for (db::RepetitionIterator r = rep.begin (); ! r.at_end (); ++r) {
+        write_inst_with_rep (inst, prop_id, *r + po, array_rep);
+      }
+    } else {
+      write_inst_with_rep (inst, prop_id, po, array_rep);
+    }
+
+  } else if (is_reg && (amax > 1 || bmax > 1)) {
 
     //  we cannot use the repetition - instead we write every single instance and use the repetition 
     //  for the array information
@@ -1982,7 +2229,7 @@ OASISWriter::write (const db::CellInstArray &inst, db::properties_id_type prop_i
 }
 
 void 
-OASISWriter::write_insts (const std::set <db::cell_index_type> &cell_set)
+OASISWriter::write_insts (const std::set <db::cell_index_type> *cell_set)
 {
   int level = m_options.compression_level;
 
@@ -1996,7 +2243,7 @@ OASISWriter::write_insts (const std::set <db::cell_index_type> &cell_set)
   //  Collect all instances 
   for (db::Cell::const_iterator inst_iterator = mp_cell->begin (); ! inst_iterator.at_end (); ++inst_iterator) {
 
-    if (cell_set.find (inst_iterator->cell_index ()) != cell_set.end ()) {
+    if (! cell_set || cell_set->find (inst_iterator->cell_index ()) != cell_set->end ()) {
 
       db::properties_id_type prop_id = inst_iterator->prop_id ();
 
@@ -2294,6 +2541,10 @@ OASISWriter::write (const db::Text &text, db::properties_id_type prop_id, const
 
   db::Trans trans = text.trans ();
   std::map <std::string, unsigned long>::const_iterator ts = m_textstrings.find (text.string ());
+  if (ts == m_textstrings.end () && m_incremental) {
+    //  in incremental mode, the text string table is written at the end
+    ts = m_textstrings.insert (std::make_pair (std::string (text.string ()), (unsigned long) m_textstrings.size ())).first;
+  }
   tl_assert (ts != m_textstrings.end ());
   unsigned long text_id = ts->second;
 
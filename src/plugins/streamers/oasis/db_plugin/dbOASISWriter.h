@@ -29,12 +29,15 @@
 #include "dbOASIS.h"
 #include "dbOASISFormat.h"
 #include "dbSaveLayoutOptions.h"
+#include "dbLayout.h"
 #include "dbObjectWithProperties.h"
 #include "dbHash.h"
+#include "dbWriterTools.h"
 #include "tlProgress.h"
 #include "tlStream.h"
 
 #include <string>
+#include <memory>
 
 namespace tl
 {
@@ -112,6 +115,35 @@ public:
    */
   void write (db::Layout &layout, tl::OutputStream &stream, const db::SaveLayoutOptions &options);
 
+  /**
+   *  @brief Begins writing a layout incrementally
+   *
+   *  In incremental mode, the cells are written one by one with "write_cell". 
+   *  All name tables are written at the end by "end_write". Text strings and 
+   *  property names are assigned IDs while the cells are written.
+   *  The layout only needs to hold the cell currently written, so the 
+   *  cell's content can be discarded after "write_cell". Cell bounding boxes are
+   *  computed from the cells written before - cells referencing cells not written yet 
+   *  are marked as depending on external cells in S_BOUNDING_BOX.
+   *  No S_TOP_CELL property is written in this mode.
+   */
+  void begin_write (db::Layout &layout, tl::OutputStream &stream, const db::SaveLayoutOptions &options);
+
+  /**
+   *  @brief Writes the given cell in incremental mode
+   *
+   *  Layers created in the layout after "begin_write" are taken as well. Layers
+   *  without a layer number will be given the next free layer number.
+   */
+  void write_cell (db::cell_index_type ci);
+
+  /**
+   *  @brief Finishes the incremental write
+   *
+   *  This method writes the name tables and the END record.
+   */
+  void end_write ();
+
   void write (const db::CellInstArray &inst_array, const db::Repetition &rep)
   {
     write (inst_array, 0, rep);
@@ -210,6 +242,15 @@ private:
   unsigned long m_propname_id;
   unsigned long m_propstring_id;
   bool m_proptables_written;
+  bool m_incremental;
+  size_t m_cellnames_table_pos;
+  size_t m_textstrings_table_pos;
+  size_t m_propnames_table_pos;
+  size_t m_propstrings_table_pos;
+  size_t m_layernames_table_pos;
+  std::map<db::cell_index_type, size_t> m_cell_positions;
+  std::map<db::cell_index_type, std::pair<db::Box, bool> > m_cell_bboxes;
+  std::vector <std::pair <unsigned int, db::LayerProperties> > m_layers;
 
   std::map <std::string, unsigned long> m_textstrings;
   std::map <std::string, unsigned long> m_propnames;
@@ -298,7 +339,12 @@ private:
 
   void emit_propname_def (db::properties_id_type prop_id);
   void emit_propstring_def (db::properties_id_type prop_id);
-  void write_insts (const std::set <db::cell_index_type> &cell_set);
+  void write_insts (const std::set <db::cell_index_type> *cell_set);
+  void begin_file (db::Layout &layout, tl::OutputStream &stream, const db::SaveLayoutOptions &options);
+  void write_cell_body (db::cell_index_type ci, const std::set <db::cell_index_type> *cell_set, const std::vector <std::pair <unsigned int, db::LayerProperties> > &layers);
+  void write_bbox_property (db::cell_index_type ci);
+  void write_cellname_table (const std::vector <db::cell_index_type> &cells_by_index);
+  void write_end_record ();
 
   void write_shapes (const db::LayerProperties &lprops, const db::Shapes &shapes);
 
@@ -310,7 +356,53 @@ private:
   void write_inst_with_rep (const db::CellInstArray &inst, db::properties_id_type prop_id, const db::Vector &disp, const db::Repetition &rep);
 };
 
+/**
+ *  @brief A push-style streaming OASIS writer
+ *
+ *  This writer does not need the full layout in memory. Cells are built one at a time:
+ *  "begin_cell" opens a cell into which shapes and instances are inserted. "end_cell" 
+ *  writes this cell and discards its content. Cells can be referenced before they are
+ *  written by using "cell_index". "close" writes the name tables and finishes the file.
+ *
+ *  The writer holds a scratch layout which provides the layers, the property 
+ *  repository and the cell directory. Only the content of the open cell is kept in memory.
+ */
+class DB_PLUGIN_PUBLIC OASISStreamWriter
+  : public db::StreamWriterBase<db::OASISWriter>
+{
+public:
+  /**
+   *  @brief Creates a streaming writer for the given stream
+   *
+   *  The stream needs to stay valid until "close" has been called.
+   */
+  OASISStreamWriter (tl::OutputStream &stream, double dbu, const db::SaveLayoutOptions &options = db::SaveLayoutOptions ())
+    : db::StreamWriterBase<db::OASISWriter> (stream, dbu, options)
+  {
+    //  .. nothing yet ..
+  }
+
+  /**
+   *  @brief Creates a streaming writer for the given file
+   */
+  OASISStreamWriter (const std::string &path, double dbu, const db::SaveLayoutOptions &options = db::SaveLayoutOptions ())
+    : db::StreamWriterBase<db::OASISWriter> (path, dbu, options)
+  {
+    //  .. nothing yet ..
+  }
+};
+
 } // namespace db
 
+namespace tl
+{
+  template <>
+  struct type_traits<db::OASISStreamWriter> : public type_traits<void>
+  {
+    typedef tl::false_tag has_default_constructor;
+    typedef tl::false_tag has_copy_constructor;
+  };
+}
+
 #endif
 
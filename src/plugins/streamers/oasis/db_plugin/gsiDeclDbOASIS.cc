@@ -300,4 +300,73 @@ gsi::ClassExt<db::SaveLayoutOptions> oasis_writer_options (
   ""
 );
 
+// ---------------------------------------------------------------
+//  gsi Implementation of the streaming OASIS writer
+
+static db::OASISStreamWriter *new_oasis_stream_writer (const std::string &path, double dbu, const db::SaveLayoutOptions &options)
+{
+  return new db::OASISStreamWriter (path, dbu, options);
+}
+
+static db::Cell *open_cell (db::OASISStreamWriter *writer, const std::string &name)
+{
+  return &writer->begin_cell (name);
+}
+
+Class<db::OASISStreamWriter> decl_OASISStreamWriter ("db", "OASISStreamWriter",
+  gsi::constructor ("new", &new_oasis_stream_writer, gsi::arg ("path"), gsi::arg ("dbu", 0.001), gsi::arg ("options", db::SaveLayoutOptions (), "SaveLayoutOptions()"),
+    "@brief Creates a streaming OASIS writer for the given file\n"
+    "The database unit is the unit of the integer coordinates of the shapes delivered. The options are "
+    "the usual OASIS writer options (see \\SaveLayoutOptions)."
+  ) +
+  gsi::method ("layer", &db::OASISStreamWriter::layer, gsi::arg ("info"),
+    "@brief Gets the layer index for the given layer\n"
+    "The layer is created if it does not exist yet. Use the layer index to put shapes into the cell returned by \\begin_cell."
+  ) +
+  gsi::method ("cell_index", &db::OASISStreamWriter::cell_index, gsi::arg ("name"),
+    "@brief Gets the cell index for the cell with the given name\n"
+    "Use this method to obtain the cell index for instances of cells which are written later."
+  ) +
+  gsi::method_ext ("begin_cell", &open_cell, gsi::arg ("name"),
+    "@brief Opens a new cell\n"
+    "Shapes and instances can be put into the cell returned. The cell is written by \\end_cell. "
+    "Only one cell can be open at a time and each cell can be written only once."
+  ) +
+  gsi::method ("end_cell", &db::OASISStreamWriter::end_cell,
+    "@brief Writes the open cell\n"
+    "The content of the cell is discarded after the cell has been written."
+  ) +
+  gsi::method ("layout", &db::OASISStreamWriter::layout,
+    "@brief Gets the scratch layout the writer uses\n"
+    "Use this layout to obtain property IDs for shapes with properties for example. "
+    "Don't manipulate cells other than the one currently open."
+  ) +
+  gsi::method ("close", &db::OASISStreamWriter::close,
+    "@brief Writes the name tables and finishes the file\n"
+    "After the writer has been closed, no more cells can be written."
+  ) +
+  gsi::method ("is_closed?", &db::OASISStreamWriter::is_closed,
+    "@brief Gets a value indicating whether the writer has been closed\n"
+  ),
+  "@brief A streaming OASIS writer\n"
+  "\n"
+  "This writer allows writing OASIS files without having the complete layout in memory. "
+  "The cells are written one by one: \\begin_cell opens a new cell, shapes and instances are put into "
+  "this cell and \\end_cell writes it. The name tables are written at the end of the file by \\close.\n"
+  "\n"
+  "@code\n"
+  "writer = RBA::OASISStreamWriter::new(\"out.oas\", 0.001)\n"
+  "l1 = writer.layer(RBA::LayerInfo::new(1, 0))\n"
+  "child = writer.begin_cell(\"CHILD\")\n"
+  "child.shapes(l1).insert(RBA::Box::new(0, 0, 100, 100))\n"
+  "writer.end_cell\n"
+  "top = writer.begin_cell(\"TOP\")\n"
+  "top.insert(RBA::CellInstArray::new(writer.cell_index(\"CHILD\"), RBA::Trans::new))\n"
+  "writer.end_cell\n"
+  "writer.close\n"
+  "@/code\n"
+  "\n"
+  "This class has been introduced in version 0.26."
+);
+
 }
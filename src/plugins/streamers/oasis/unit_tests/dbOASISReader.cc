@@ -22,6 +22,10 @@
 
 
 #include "dbOASISReader.h"
+#include "dbOASISWriter.h"
+#include "dbOASISFormat.h"
+#include "dbCommonReader.h"
+#include "dbLayoutDiff.h"
 #include "dbTextWriter.h"
 #include "dbTestSupport.h"
 #include "tlLog.h"
@@ -30,6 +34,7 @@
 #include "tlFileUtils.h"
 
 #include <stdlib.h>
+#include <set>
 
 void
 compare_ref (tl::TestBase *_this, const char *test, const db::Layout &layout)
@@ -579,3 +584,321 @@ TEST(Bug_121_2)
   std::string fn_au (tl::testsrc () + "/testdata/oasis/bug_121_au2.gds");
   db::compare_layouts (_this, layout, fn_au, db::WriteGDS2, 1);
 }
+
+static void run_lazy_loading_test (tl::TestBase *_this, bool cblocks)
+{
+  db::Layout layout_org;
+  unsigned int l1 = layout_org.insert_layer (db::LayerProperties (1, 0));
+  unsigned int l2 = layout_org.insert_layer (db::LayerProperties (2, 0));
+
+  db::Cell &top = layout_org.cell (layout_org.add_cell ("TOP"));
+  db::Cell &a = layout_org.cell (layout_org.add_cell ("A"));
+  db::Cell &b = layout_org.cell (layout_org.add_cell ("B"));
+  db::Cell &c = layout_org.cell (layout_org.add_cell ("C"));
+
+  a.shapes (l1).insert (db::Box (0, 0, 1000, 2000));
+  a.shapes (l2).insert (db::Text ("A", db::Trans (db::Vector (500, 500))));
+  b.shapes (l2).insert (db::Polygon (db::Box (0, 0, 500, 500)));
+  c.shapes (l1).insert (db::Box (-100, -100, 100, 100));
+
+  top.insert (db::CellInstArray (db::CellInst (a.cell_index ()), db::Trans (db::Vector (0, 0))));
+  top.insert (db::CellInstArray (db::CellInst (a.cell_index ()), db::Trans (db::Vector (0, 10000)), db::Vector (2000, 0), db::Vector (0, 3000), 3, 2));
+  top.insert (db::CellInstArray (db::CellInst (b.cell_index ()), db::Trans (db::Vector (100000, 0))));
+  b.insert (db::CellInstArray (db::CellInst (c.cell_index ()), db::Trans (1, false, db::Vector (200, 200))));
+
+  std::string tmp_file = _this->tmp_file ("tmp_lazy.oas");
+
+  {
+    tl::OutputStream stream (tmp_file);
+    db::OASISWriter writer;
+    db::SaveLayoutOptions options;
+    db::OASISWriterOptions oasis_options;
+    oasis_options.strict_mode = true;
+    oasis_options.write_std_properties = 2;
+    oasis_options.write_cblocks = cblocks;
+    options.set_options (oasis_options);
+    writer.write (layout_org, stream, options);
+  }
+
+  db::Layout layout_lazy;
+  tl::InputStream file (tmp_file);
+  db::OASISReader reader (file);
+  reader.set_lazy_cell_bodies (true);
+
+  db::LoadLayoutOptions options;
+  reader.read (layout_lazy, options);
+
+  std::pair<bool, db::cell_index_type> ta = layout_lazy.cell_by_name ("TOP");
+  std::pair<bool, db::cell_index_type> ca = layout_lazy.cell_by_name ("A");
+  std::pair<bool, db::cell_index_type> cb = layout_lazy.cell_by_name ("B");
+  std::pair<bool, db::cell_index_type> cc = layout_lazy.cell_by_name ("C");
+  EXPECT_EQ (ta.first && ca.first && cb.first && cc.first, true);
+
+  //  the hierarchy is there, but no shapes yet
+  EXPECT_EQ (layout_lazy.cell (ta.second).cell_instances (), size_t (3));
+  EXPECT_EQ (layout_lazy.cell (cb.second).cell_instances (), size_t (1));
+  EXPECT_EQ (layout_lazy.cell (ca.second).shapes (l1).empty (), true);
+  EXPECT_EQ (reader.is_cell_body_pending (ca.second), true);
+  EXPECT_EQ (reader.is_cell_body_pending (cc.second), true);
+
+  EXPECT_EQ (reader.declared_cell_bbox (ca.second).first, true);
+  EXPECT_EQ (reader.declared_cell_bbox (ca.second).second.to_string (), "(0,0;1000,2000)");
+  EXPECT_EQ (reader.declared_cell_bbox (cb.second).second.to_string (), "(0,0;500,500)");
+
+  //  load the cells visible in a window around the origin: B and C are not needed
+  reader.load_cell_bodies (layout_lazy, ta.second, db::Box (-100, -100, 100, 100));
+  EXPECT_EQ (reader.is_cell_body_pending (ta.second), false);
+  EXPECT_EQ (reader.is_cell_body_pending (ca.second), false);
+  EXPECT_EQ (reader.is_cell_body_pending (cb.second), true);
+  EXPECT_EQ (reader.is_cell_body_pending (cc.second), true);
+  EXPECT_EQ (layout_lazy.cell (ca.second).shapes (l1).size (), size_t (1));
+  EXPECT_EQ (layout_lazy.cell (cb.second).shapes (l2).empty (), true);
+
+  //  a window touching C loads B and C
+  reader.load_cell_bodies (layout_lazy, ta.second, db::Box (100150, 150, 100160, 160));
+  EXPECT_EQ (reader.is_cell_body_pending (cb.second), false);
+  EXPECT_EQ (reader.is_cell_body_pending (cc.second), false);
+
+  //  the fully loaded layout is identical to the one read in one go
+  db::Layout layout_full;
+  {
+    tl::InputStream file (tmp_file);
+    db::OASISReader reader (file);
+    reader.read (layout_full);
+  }
+
+  EXPECT_EQ (db::compare_layouts (layout_lazy, layout_full, db::layout_diff::f_verbose, 0), true);
+}
+
+TEST(200_LazyCellBodies)
+{
+  run_lazy_loading_test (_this, false);
+}
+
+TEST(201_LazyCellBodiesWithCBlocks)
+{
+  run_lazy_loading_test (_this, true);
+}
+
+static std::string region_read_summary (const db::Layout &layout)
+{
+  //  sorted by cell name
+  std::map<std::string, std::string> cells;
+  for (db::Layout::const_iterator c = layout.begin (); c != layout.end (); ++c) {
+    size_t n = 0;
+    for (db::Layout::layer_iterator l = layout.begin_layers (); l != layout.end_layers (); ++l) {
+      n += c->shapes ((*l).first).size ();
+    }
+    cells [layout.cell_name (c->cell_index ())] = tl::sprintf ("i%d,s%d", int (c->cell_instances ()), int (n));
+  }
+
+  std::string s;
+  for (std::map<std::string, std::string>::const_iterator c = cells.begin (); c != cells.end (); ++c) {
+    if (! s.empty ()) {
+      s += ";";
+    }
+    s += c->first + ":" + c->second;
+  }
+  return s;
+}
+
+static std::string read_oasis_region (const std::string &fn, const db::DBox &region, bool through_pipe = false)
+{
+  db::Layout layout;
+  //  a pipe cannot be reset, so the reader needs to do with a single pass
+  tl::InputStream file (through_pipe ? "pipe:cat " + fn : fn);
+  db::OASISReader reader (file);
+
+  db::LoadLayoutOptions options;
+  db::CommonReaderOptions common_options;
+  common_options.region = region;
+  options.set_options (common_options);
+  reader.read (layout, options);
+
+  return region_read_summary (layout);
+}
+
+static void run_region_filter_test (tl::TestBase *_this, int std_properties, bool cblocks)
+{
+  db::Layout layout_org;
+  unsigned int l1 = layout_org.insert_layer (db::LayerProperties (1, 0));
+  unsigned int l2 = layout_org.insert_layer (db::LayerProperties (2, 0));
+
+  db::Cell &top = layout_org.cell (layout_org.add_cell ("TOP"));
+  db::Cell &a = layout_org.cell (layout_org.add_cell ("A"));
+  db::Cell &b = layout_org.cell (layout_org.add_cell ("B"));
+  db::Cell &c = layout_org.cell (layout_org.add_cell ("C"));
+
+  a.shapes (l1).insert (db::Box (0, 0, 1000, 2000));
+  a.shapes (l2).insert (db::Text ("A", db::Trans (db::Vector (500, 500))));
+  b.shapes (l2).insert (db::Polygon (db::Box (0, 0, 500, 500)));
+  c.shapes (l1).insert (db::Box (-100, -100, 100, 100));
+
+  top.insert (db::CellInstArray (db::CellInst (a.cell_index ()), db::Trans (db::Vector (0, 0))));
+  top.insert (db::CellInstArray (db::CellInst (a.cell_index ()), db::Trans (db::Vector (0, 10000)), db::Vector (2000, 0), db::Vector (0, 3000), 3, 2));
+  top.insert (db::CellInstArray (db::CellInst (b.cell_index ()), db::Trans (db::Vector (100000, 0))));
+  b.insert (db::CellInstArray (db::CellInst (c.cell_index ()), db::Trans (1, false, db::Vector (200, 200))));
+
+  std::string tmp_file = _this->tmp_file ("tmp_region.oas");
+
+  {
+    tl::OutputStream stream (tmp_file);
+    db::OASISWriter writer;
+    db::SaveLayoutOptions options;
+    db::OASISWriterOptions oasis_options;
+    oasis_options.strict_mode = true;
+    oasis_options.write_std_properties = std_properties;
+    oasis_options.write_cblocks = cblocks;
+    options.set_options (oasis_options);
+    writer.write (layout_org, stream, options);
+  }
+
+  //  a window around the origin: only the first instance of A and its box survive
+  EXPECT_EQ (read_oasis_region (tmp_file, db::DBox (-0.05, -0.05, 0.05, 0.05)), "A:i0,s1;TOP:i1,s0");
+  //  a window touching C: B and C are needed, A is not
+  EXPECT_EQ (read_oasis_region (tmp_file, db::DBox (100.15, 0.15, 100.16, 0.16)), "B:i1,s1;C:i0,s1;TOP:i1,s0");
+  //  a window touching the A array: the whole array is kept
+  EXPECT_EQ (read_oasis_region (tmp_file, db::DBox (4.5, 13.5, 4.6, 13.6)), "A:i0,s2;TOP:i1,s0");
+  //  outside everything: an empty top cell remains
+  EXPECT_EQ (read_oasis_region (tmp_file, db::DBox (-10, -10, -9, -9)), "TOP:i0,s0");
+  //  no region: everything is read
+  EXPECT_EQ (read_oasis_region (tmp_file, db::DBox ()), "A:i0,s2;B:i1,s1;C:i0,s1;TOP:i3,s0");
+
+  //  the same results from a stream which can be read once only
+  EXPECT_EQ (read_oasis_region (tmp_file, db::DBox (-0.05, -0.05, 0.05, 0.05), true), "A:i0,s1;TOP:i1,s0");
+  EXPECT_EQ (read_oasis_region (tmp_file, db::DBox (100.15, 0.15, 100.16, 0.16), true), "B:i1,s1;C:i0,s1;TOP:i1,s0");
+}
+
+TEST(210_RegionFilter)
+{
+  run_region_filter_test (_this, 2, false);
+}
+
+TEST(211_RegionFilterWithCBlocks)
+{
+  run_region_filter_test (_this, 2, true);
+}
+
+TEST(212_RegionFilterWithoutBoundingBoxes)
+{
+  run_region_filter_test (_this, 0, false);
+}
+
+TEST(213_RegionFilterAndLazyLoadingExcluded)
+{
+  db::Layout layout;
+  tl::InputStream file (tl::testsrc () + "/testdata/oasis/t10.1.oas");
+  db::OASISReader reader (file);
+  reader.set_lazy_cell_bodies (true);
+
+  db::LoadLayoutOptions options;
+  db::CommonReaderOptions common_options;
+  common_options.region = db::DBox (0, 0, 1, 1);
+  options.set_options (common_options);
+
+  bool error = false;
+  try {
+    reader.read (layout, options);
+  } catch (tl::Exception &) {
+    error = true;
+  }
+  EXPECT_EQ (error, true);
+}
+
+static std::string flat_instances (const db::Layout &layout, const db::Cell &cell)
+{
+  std::set<std::string> insts;
+  for (db::Cell::const_iterator i = cell.begin (); ! i.at_end (); ++i) {
+    for (db::CellInstArray::iterator a = i->cell_inst ().begin (); ! a.at_end (); ++a) {
+      insts.insert (std::string (layout.cell_name (i->cell_index ())) + " " + i->cell_inst ().complex_trans (*a).to_string ());
+    }
+  }
+  return tl::join (std::vector<std::string> (insts.begin (), insts.end ()), ";");
+}
+
+TEST(220_IrregularPlacementRepetitions)
+{
+  db::Layout layout_org;
+  unsigned int l1 = layout_org.insert_layer (db::LayerProperties (1, 0));
+
+  db::Cell &top = layout_org.cell (layout_org.add_cell ("TOP"));
+  db::Cell &a = layout_org.cell (layout_org.add_cell ("A"));
+  a.shapes (l1).insert (db::Box (0, 0, 10, 10));
+
+  //  more than 100 members make the array sort its displacements into a tree, so
+  //  the first displacement is no longer the origin
+  for (int i = 0; i < 300; ++i) {
+    db::Vector d (i * i * 7, ((i * 13) % 29) * 100);
+    top.insert (db::CellInstArray (db::CellInst (a.cell_index ()), db::Trans (d)));
+    top.insert (db::CellInstArray (db::CellInst (a.cell_index ()), db::ICplxTrans (2.0, 45.0, false, d + db::Vector (0, 100000))));
+  }
+
+  std::string tmp_file = _this->tmp_file ("tmp_irregular.oas");
+
+  {
+    tl::OutputStream stream (tmp_file);
+    db::OASISWriter writer;
+    writer.write (layout_org, stream, db::SaveLayoutOptions ());
+  }
+
+  //  editable layouts receive single instances
+  db::Layout layout_editable (true);
+  {
+    tl::InputStream file (tmp_file);
+    db::OASISReader reader (file);
+    reader.read (layout_editable);
+  }
+
+  std::pair<bool, db::cell_index_type> t = layout_editable.cell_by_name ("TOP");
+  EXPECT_EQ (t.first, true);
+  EXPECT_EQ (flat_instances (layout_editable, layout_editable.cell (t.second)), flat_instances (layout_org, top));
+  for (db::Cell::const_iterator i = layout_editable.cell (t.second).begin (); ! i.at_end (); ++i) {
+    EXPECT_EQ (i->cell_inst ().is_iterated_array (), false);
+  }
+
+  db::Layout layout (false);
+  {
+    tl::InputStream file (tmp_file);
+    db::OASISReader reader (file);
+    reader.read (layout);
+  }
+
+  //  the irregular repetitions are kept as arrays
+  t = layout.cell_by_name ("TOP");
+  EXPECT_EQ (t.first, true);
+  EXPECT_EQ (layout.cell (t.second).cell_instances () < size_t (10), true);
+  EXPECT_EQ (flat_instances (layout, layout.cell (t.second)), flat_instances (layout_org, top));
+
+  size_t iterated = 0;
+  for (db::Cell::const_iterator i = layout.cell (t.second).begin (); ! i.at_end (); ++i) {
+    if (i->cell_inst ().is_iterated_array ()) {
+      ++iterated;
+    }
+  }
+  EXPECT_EQ (iterated > 0, true);
+
+  //  writing the arrays back preserves them
+  std::string tmp_file2 = _this->tmp_file ("tmp_irregular2.oas");
+
+  {
+    tl::OutputStream stream (tmp_file2);
+    db::OASISWriter writer;
+    db::SaveLayoutOptions options;
+    db::OASISWriterOptions oasis_options;
+    oasis_options.compression_level = 0;
+    options.set_options (oasis_options);
+    writer.write (layout, stream, options);
+  }
+
+  db::Layout layout2 (false);
+  {
+    tl::InputStream file (tmp_file2);
+    db::OASISReader reader (file);
+    reader.read (layout2);
+  }
+
+  t = layout2.cell_by_name ("TOP");
+  EXPECT_EQ (t.first, true);
+  EXPECT_EQ (layout2.cell (t.second).cell_instances (), layout.cell (layout.cell_by_name ("TOP").second).cell_instances ());
+  EXPECT_EQ (flat_instances (layout2, layout2.cell (t.second)), flat_instances (layout_org, top));
+}
@@ -1728,3 +1728,105 @@ TEST(117)
   EXPECT_EQ (std::string (os.string ()), std::string (expected))
 }
 
+
+static void run_stream_writer_test (tl::TestBase *_this, bool strict, bool cblocks, int std_properties, bool write_behind = false)
+{
+  std::string tmp_file = _this->tmp_file (tl::sprintf ("tmp_stream_writer_%d_%d_%d_%d.oas", int (strict), int (cblocks), std_properties, int (write_behind)));
+
+  {
+    db::SaveLayoutOptions options;
+    db::OASISWriterOptions oasis_options;
+    oasis_options.strict_mode = strict;
+    oasis_options.write_cblocks = cblocks;
+    oasis_options.write_std_properties = std_properties;
+    options.set_options (oasis_options);
+    if (write_behind) {
+      options.set_write_behind_buffers (3);
+      options.set_write_behind_buffer_size (256);
+      options.set_compression_threads (2);
+    }
+
+    db::OASISStreamWriter writer (tmp_file, 0.001, options);
+
+    unsigned int l1 = writer.layer (db::LayerProperties (1, 0));
+    unsigned int l2 = writer.layer (db::LayerProperties (2, 5, "METAL"));
+    EXPECT_EQ (writer.layer (db::LayerProperties (1, 0)), l1);
+
+    db::PropertiesRepository::properties_set ps;
+    ps.insert (std::make_pair (writer.layout ().properties_repository ().prop_name_id (tl::Variant ("NAME")), tl::Variant ("value")));
+    db::properties_id_type pid = writer.layout ().properties_repository ().properties_id (ps);
+
+    //  the top cell is written before the child cell
+    db::Cell &top = writer.begin_cell ("TOP");
+    db::cell_index_type child_ci = writer.cell_index ("CHILD");
+    top.insert (db::CellInstArray (db::CellInst (child_ci), db::Trans (db::Vector (1000, 0))));
+    top.insert (db::CellInstArray (db::CellInst (child_ci), db::Trans (db::Vector (0, 0)), db::Vector (0, 500), db::Vector (200, 0), 2, 3));
+    top.shapes (l1).insert (db::Text ("TOPLABEL", db::Trans (db::Vector (10, 20))));
+    writer.end_cell ();
+
+    db::Cell &child = writer.begin_cell ("CHILD");
+    child.shapes (l1).insert (db::Box (0, 0, 100, 100));
+    child.shapes (l1).insert (db::BoxWithProperties (db::Box (200, 0, 300, 100), pid));
+    child.shapes (l2).insert (db::Text ("CHILDLABEL", db::Trans (db::Vector (50, 50))));
+    child.shapes (l2).insert (db::Text ("TOPLABEL", db::Trans (db::Vector (60, 60))));
+    writer.end_cell ();
+
+    EXPECT_EQ (child.shapes (l1).empty (), true);
+
+    db::Cell &other = writer.begin_cell ("OTHER");
+    other.shapes (l2).insert (db::Box (-100, -100, 0, 0));
+    other.insert (db::CellInstArray (db::CellInst (child_ci), db::Trans (db::Vector (-500, 0))));
+    writer.end_cell ();
+
+    writer.close ();
+    EXPECT_EQ (writer.is_closed (), true);
+  }
+
+  db::Layout gg;
+  {
+    tl::InputStream in (tmp_file);
+    db::Reader reader (in);
+    reader.set_warnings_as_errors (true);
+    reader.read (gg);
+  }
+
+  const char *expected = 
+    "begin_lib 0.001\n"
+    "begin_cell {CHILD}\n"
+    "box 1 0 {0 0} {100 100}\n"
+    "set props {\n"
+    "  {{NAME} {value}}\n"
+    "}\n"
+    "boxp $props 1 0 {200 0} {300 100}\n"
+    "text 2 5 0 0 {50 50} {CHILDLABEL}\n"
+    "text 2 5 0 0 {60 60} {TOPLABEL}\n"
+    "end_cell\n"
+    "begin_cell {OTHER}\n"
+    "sref {CHILD} 0 0 1 {-500 0}\n"
+    "box 2 5 {-100 -100} {0 0}\n"
+    "end_cell\n"
+    "begin_cell {TOP}\n"
+    "aref {CHILD} 0 0 1 3 2 {0 0} {600 0} {0 1000}\n"
+    "sref {CHILD} 0 0 1 {1000 0}\n"
+    "text 1 0 0 0 {10 20} {TOPLABEL}\n"
+    "end_cell\n"
+    "end_lib\n"
+  ;
+
+  tl::OutputStringStream os;
+  tl::OutputStream stream (os);
+  db::TextWriter textwriter (stream);
+  textwriter.write (gg);
+  EXPECT_EQ (std::string (os.string ()), std::string (expected))
+
+  EXPECT_EQ (gg.get_properties (gg.get_layer (db::LayerProperties (2, 5))).name, "METAL");
+}
+
+TEST(200_StreamWriter)
+{
+  run_stream_writer_test (_this, false, false, 0);
+  run_stream_writer_test (_this, true, false, 1);
+  run_stream_writer_test (_this, false, true, 2);
+  run_stream_writer_test (_this, true, true, 2);
+  run_stream_writer_test (_this, false, true, 2, true);
+}
@@ -62,7 +62,7 @@ BooleanOptionsDialog::cv_changed (int)
 }
 
 bool 
-BooleanOptionsDialog::exec_dialog (lay::LayoutView *view, int &cv_a, int &layer_a, int &cv_b, int &layer_b, int &cv_r, int &layer_r, int &mode, int &hier_mode, bool &min_coherence)
+BooleanOptionsDialog::exec_dialog (lay::LayoutView *view, int &cv_a, int &layer_a, int &cv_b, int &layer_b, int &cv_r, int &layer_r, int &mode, int &hier_mode, bool &min_coherence, int &threads)
 {
   mp_view = view;
 
@@ -85,6 +85,7 @@ BooleanOptionsDialog::exec_dialog (lay::LayoutView *view, int &cv_a, int &layer_
   hier_mode_cbx->setCurrentIndex (hier_mode);
   mode_cbx->setCurrentIndex (mode);
   min_coherence_cb->setChecked (min_coherence);
+  threads_sb->setValue (threads);
 
   if (QDialog::exec ()) {
 
@@ -98,6 +99,7 @@ BooleanOptionsDialog::exec_dialog (lay::LayoutView *view, int &cv_a, int &layer_
     hier_mode = hier_mode_cbx->currentIndex ();
     mode = mode_cbx->currentIndex ();
     min_coherence = min_coherence_cb->isChecked ();
+    threads = threads_sb->value ();
 
     res = true;
 
@@ -142,12 +144,18 @@ BEGIN_PROTECTED;
     throw tl::Exception (tl::to_string (QObject::tr ("No layer specified for result layer")));
   }
 
-  if (hier_mode_cbx->currentIndex () == 2 && 
+  if (hier_mode_cbx->currentIndex () == HierModeCellByCell && 
       cva_cbx->current_cv_index () != cvb_cbx->current_cv_index () &&
       cva_cbx->current_cv_index () != cvr_cbx->current_cv_index ()) {
     throw tl::Exception (tl::to_string (QObject::tr ("All source layouts and result layout must be same in 'cell by cell' mode")));
   }
 
+  if (hier_mode_cbx->currentIndex () == HierModeDeep && 
+      (cva_cbx->current_cv_index () != cvb_cbx->current_cv_index () ||
+       cva_cbx->current_cv_index () != cvr_cbx->current_cv_index ())) {
+    throw tl::Exception (tl::to_string (QObject::tr ("All source layouts and result layout must be same in 'hierarchical' mode")));
+  }
+
   QDialog::accept ();
 END_PROTECTED;
 }
@@ -183,7 +191,7 @@ SizingOptionsDialog::cv_changed (int)
 }
 
 bool 
-SizingOptionsDialog::exec_dialog (lay::LayoutView *view, int &cv, int &layer, int &cv_r, int &layer_r, double &dx, double &dy, unsigned int &size_mode, int &hier_mode, bool &min_coherence)
+SizingOptionsDialog::exec_dialog (lay::LayoutView *view, int &cv, int &layer, int &cv_r, int &layer_r, double &dx, double &dy, unsigned int &size_mode, int &hier_mode, bool &min_coherence, int &threads)
 {
   mp_view = view;
 
@@ -206,6 +214,7 @@ SizingOptionsDialog::exec_dialog (lay::LayoutView *view, int &cv, int &layer, in
     value_le->setText (tl::to_qstring (tl::sprintf ("%.12g,%.12g", dx, dy)));
   }
   min_coherence_cb->setChecked (min_coherence);
+  threads_sb->setValue (threads);
 
   if (QDialog::exec ()) {
 
@@ -216,6 +225,7 @@ SizingOptionsDialog::exec_dialog (lay::LayoutView *view, int &cv, int &layer, in
 
     hier_mode = hier_mode_cbx->currentIndex ();
     min_coherence = min_coherence_cb->isChecked ();
+    threads = threads_sb->value ();
     size_mode = cutoff_cbx->currentIndex ();
 
     tl::string t (tl::to_string (value_le->text ()));
@@ -261,11 +271,16 @@ BEGIN_PROTECTED;
     throw tl::Exception (tl::to_string (QObject::tr ("No layer specified for result layer")));
   }
 
-  if (hier_mode_cbx->currentIndex () == 2 && 
+  if (hier_mode_cbx->currentIndex () == HierModeCellByCell && 
       cv_cbx->current_cv_index () != cvr_cbx->current_cv_index ()) {
     throw tl::Exception (tl::to_string (QObject::tr ("Source layout and result layout must be same in 'cell by cell' mode")));
   }
 
+  if (hier_mode_cbx->currentIndex () == HierModeDeep && 
+      cv_cbx->current_cv_index () != cvr_cbx->current_cv_index ()) {
+    throw tl::Exception (tl::to_string (QObject::tr ("Source layout and result layout must be same in 'hierarchical' mode")));
+  }
+
   double x, y;
   tl::string t (tl::to_string (value_le->text ()));
   tl::Extractor ex (t.c_str ());
@@ -309,7 +324,7 @@ MergeOptionsDialog::cv_changed (int)
 }
 
 bool 
-MergeOptionsDialog::exec_dialog (lay::LayoutView *view, int &cv, int &layer, int &cv_r, int &layer_r, unsigned int &min_wc, int &hier_mode, bool &min_coherence)
+MergeOptionsDialog::exec_dialog (lay::LayoutView *view, int &cv, int &layer, int &cv_r, int &layer_r, unsigned int &min_wc, int &hier_mode, bool &min_coherence, int &threads)
 {
   mp_view = view;
 
@@ -327,6 +342,7 @@ MergeOptionsDialog::exec_dialog (lay::LayoutView *view, int &cv, int &layer, int
   hier_mode_cbx->setCurrentIndex (hier_mode);
   threshold_le->setText (tl::to_qstring (tl::sprintf ("%u", min_wc)));
   min_coherence_cb->setChecked (min_coherence);
+  threads_sb->setValue (threads);
 
   if (QDialog::exec ()) {
 
@@ -337,6 +353,7 @@ MergeOptionsDialog::exec_dialog (lay::LayoutView *view, int &cv, int &layer, int
 
     hier_mode = hier_mode_cbx->currentIndex ();
     min_coherence = min_coherence_cb->isChecked ();
+    threads = threads_sb->value ();
 
     std::string t (tl::to_string (threshold_le->text ()));
     tl::Extractor ex (t.c_str ());
@@ -376,11 +393,16 @@ BEGIN_PROTECTED;
     throw tl::Exception (tl::to_string (QObject::tr ("No layer specified for result")));
   }
 
-  if (hier_mode_cbx->currentIndex () == 2 && 
+  if (hier_mode_cbx->currentIndex () == HierModeCellByCell && 
       cv_cbx->current_cv_index () != cvr_cbx->current_cv_index ()) {
     throw tl::Exception (tl::to_string (QObject::tr ("Source layout and result layout must be same in 'cell by cell' mode")));
   }
 
+  if (hier_mode_cbx->currentIndex () == HierModeDeep && 
+      cv_cbx->current_cv_index () != cvr_cbx->current_cv_index ()) {
+    throw tl::Exception (tl::to_string (QObject::tr ("Source layout and result layout must be same in 'hierarchical' mode")));
+  }
+
   unsigned int min_wc = 0;
   std::string t (tl::to_string (threshold_le->text ()));
   tl::Extractor ex (t.c_str ());
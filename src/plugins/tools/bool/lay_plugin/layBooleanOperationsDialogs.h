@@ -39,6 +39,19 @@ namespace lay
 class CellView;
 class LayoutView;
 
+/**
+ *  @brief The hierarchy modes of the boolean, merge and sizing operations
+ *
+ *  The values correspond to the entries of the "hier_mode_cbx" combo boxes.
+ */
+enum BooleanHierMode
+{
+  HierModeFlat = 0,
+  HierModeTopCell = 1,
+  HierModeCellByCell = 2,
+  HierModeDeep = 3
+};
+
 /**
  *  @brief The boolean operation options
  */
@@ -52,7 +65,7 @@ public:
   BooleanOptionsDialog (QWidget *parent);
   virtual ~BooleanOptionsDialog ();
 
-  bool exec_dialog (lay::LayoutView *view, int &cv_a, int &layer_a, int &cv_b, int &layer_b, int &cv_res, int &layer_res, int &mode, int &hier_mode, bool &min_coherence);
+  bool exec_dialog (lay::LayoutView *view, int &cv_a, int &layer_a, int &cv_b, int &layer_b, int &cv_res, int &layer_res, int &mode, int &hier_mode, bool &min_coherence, int &threads);
 
 public slots:
   void cv_changed (int);
@@ -76,7 +89,7 @@ public:
   SizingOptionsDialog (QWidget *parent);
   virtual ~SizingOptionsDialog ();
 
-  bool exec_dialog (lay::LayoutView *view, int &cv, int &layer, int &cv_res, int &layer_res, double &dx, double &dy, unsigned int &size_mode, int &hier_mode, bool &min_coherence);
+  bool exec_dialog (lay::LayoutView *view, int &cv, int &layer, int &cv_res, int &layer_res, double &dx, double &dy, unsigned int &size_mode, int &hier_mode, bool &min_coherence, int &threads);
 
 public slots:
   void cv_changed (int);
@@ -100,7 +113,7 @@ public:
   MergeOptionsDialog (QWidget *parent);
   virtual ~MergeOptionsDialog ();
 
-  bool exec_dialog (lay::LayoutView *view, int &cv, int &layer, int &cv_res, int &layer_res, unsigned int &min_wc, int &hier_mode, bool &min_coherence);
+  bool exec_dialog (lay::LayoutView *view, int &cv, int &layer, int &cv_res, int &layer_res, unsigned int &min_wc, int &hier_mode, bool &min_coherence, int &threads);
 
 public slots:
   void cv_changed (int);
@@ -29,12 +29,265 @@
 #include "layLayoutView.h"
 
 #include "dbShapeProcessor.h"
+#include "dbDeepShapeStore.h"
+#include "dbRegion.h"
+#include "dbRecursiveShapeIterator.h"
+
+#include "tlThreadedWorkers.h"
+#include "tlProgress.h"
 
 #include <QApplication>
+#include <QThread>
+
+#include <algorithm>
 
 namespace lay
 {
 
+// -----------------------------------------------------------------------------
+//  A background job for the hierarchical operations
+
+class DeepOperationJob;
+
+/**
+ *  @brief Describes a hierarchical boolean, merge or sizing operation
+ */
+class DeepOperationTask
+  : public tl::Task
+{
+public:
+  enum op_type { Boolean = 0, Merge, Size };
+
+  DeepOperationTask (op_type op, unsigned int layer_a, unsigned int layer_b)
+    : m_op (op), m_layer_a (layer_a), m_layer_b (layer_b),
+      m_mode (0), m_min_coherence (true), m_min_wc (0), m_dx (0), m_dy (0)
+  {
+    //  .. nothing yet ..
+  }
+
+  op_type op () const { return m_op; }
+  unsigned int layer_a () const { return m_layer_a; }
+  unsigned int layer_b () const { return m_layer_b; }
+
+  //  The boolean operation mode (0: OR, 1: AND, 2: A NOT B, 3: B NOT A, 4: XOR) or the sizing mode
+  void set_mode (unsigned int mode) { m_mode = mode; }
+  unsigned int mode () const { return m_mode; }
+
+  void set_min_coherence (bool f) { m_min_coherence = f; }
+  bool min_coherence () const { return m_min_coherence; }
+
+  void set_min_wc (unsigned int min_wc) { m_min_wc = min_wc; }
+  unsigned int min_wc () const { return m_min_wc; }
+
+  void set_sizing (db::Coord dx, db::Coord dy) { m_dx = dx; m_dy = dy; }
+  db::Coord dx () const { return m_dx; }
+  db::Coord dy () const { return m_dy; }
+
+  //  The number of progress steps the operation reports
+  size_t steps () const
+  {
+    return m_op == Boolean ? 3 : 2;
+  }
+
+private:
+  op_type m_op;
+  unsigned int m_layer_a, m_layer_b;
+  unsigned int m_mode;
+  bool m_min_coherence;
+  unsigned int m_min_wc;
+  db::Coord m_dx, m_dy;
+};
+
+/**
+ *  @brief The worker computing a hierarchical operation
+ */
+class DeepOperationWorker
+  : public tl::Worker
+{
+public:
+  DeepOperationWorker (DeepOperationJob *job)
+    : tl::Worker (), mp_job (job)
+  {
+    //  .. nothing yet ..
+  }
+
+  void perform_task (tl::Task *task)
+  {
+    DeepOperationTask *op_task = dynamic_cast <DeepOperationTask *> (task);
+    if (op_task) {
+      do_perform (op_task);
+    }
+  }
+
+private:
+  DeepOperationJob *mp_job;
+
+  void do_perform (const DeepOperationTask *task);
+};
+
+/**
+ *  @brief A job running a hierarchical operation in the background
+ *
+ *  The operation is computed by a single worker into a deep shape store. The deep shape
+ *  store may employ further threads. The source layout is only read while the job is
+ *  running. "run" waits for the result while processing events, so the application
+ *  stays responsive and the operation can be cancelled. The result is delivered on
+ *  the calling thread afterwards.
+ */
+class DeepOperationJob
+  : public tl::JobBase
+{
+public:
+  DeepOperationJob (db::Layout &layout, db::cell_index_type ci, db::DeepShapeStore &dss)
+    : tl::JobBase (1), mp_layout (&layout), m_ci (ci), mp_dss (&dss), m_steps (0), m_progress (0)
+  {
+    //  .. nothing yet ..
+  }
+
+  const db::Layout &layout () const
+  {
+    return *mp_layout;
+  }
+
+  db::cell_index_type cell_index () const
+  {
+    return m_ci;
+  }
+
+  db::DeepShapeStore &dss () const
+  {
+    return *mp_dss;
+  }
+
+  void next_progress ()
+  {
+    tl::MutexLocker locker (&m_mutex);
+    ++m_progress;
+  }
+
+  void set_result (const db::Region &result)
+  {
+    tl::MutexLocker locker (&m_mutex);
+    m_result = result;
+  }
+
+  /**
+   *  @brief Gets the result
+   *  This method must be called after "run" has finished.
+   */
+  const db::Region &result () const
+  {
+    return m_result;
+  }
+
+  /**
+   *  @brief Executes the given task and waits for the result
+   *  Throws an exception if the operation failed or was cancelled.
+   */
+  void run (const std::string &desc, DeepOperationTask *task)
+  {
+    m_steps = task->steps ();
+    schedule (task);
+
+    //  make sure the source layout does not need to be updated while the worker reads it
+    mp_layout->update ();
+
+    tl::RelativeProgress progress (desc, m_steps, 1);
+
+    try {
+      start ();
+      while (is_running ()) {
+        //  This may throw an exception, if the cancel button has been pressed.
+        update_progress (progress);
+        wait (100);
+      }
+    } catch (...) {
+      terminate ();
+      throw;
+    }
+
+    if (has_error ()) {
+      throw tl::Exception (tl::to_string (QObject::tr ("Errors occured during processing. First error message says:\n")) + error_messages ().front ());
+    }
+  }
+
+  virtual tl::Worker *create_worker ()
+  {
+    return new DeepOperationWorker (this);
+  }
+
+private:
+  db::Layout *mp_layout;
+  db::cell_index_type m_ci;
+  db::DeepShapeStore *mp_dss;
+  size_t m_steps, m_progress;
+  db::Region m_result;
+  tl::Mutex m_mutex;
+
+  void update_progress (tl::RelativeProgress &progress)
+  {
+    size_t p;
+    {
+      tl::MutexLocker locker (&m_mutex);
+      p = m_progress;
+    }
+
+    progress.set (p, true /*force yield*/);
+  }
+};
+
+void
+DeepOperationWorker::do_perform (const DeepOperationTask *task)
+{
+  const db::Layout &layout = mp_job->layout ();
+  const db::Cell &cell = layout.cell (mp_job->cell_index ());
+
+  db::Region a (db::RecursiveShapeIterator (layout, cell, task->layer_a ()), mp_job->dss ());
+  a.set_min_coherence (task->min_coherence ());
+  mp_job->next_progress ();
+  checkpoint ();
+
+  db::Region r;
+
+  if (task->op () == DeepOperationTask::Boolean) {
+
+    db::Region b (db::RecursiveShapeIterator (layout, cell, task->layer_b ()), mp_job->dss ());
+    b.set_min_coherence (task->min_coherence ());
+    mp_job->next_progress ();
+    checkpoint ();
+
+    switch (task->mode ()) {
+    default:
+      r = a | b;
+      break;
+    case 1:
+      r = a & b;
+      break;
+    case 2:
+      r = a - b;
+      break;
+    case 3:
+      r = b - a;
+      break;
+    case 4:
+      r = a ^ b;
+      break;
+    }
+
+  } else if (task->op () == DeepOperationTask::Merge) {
+    r = a.merged (task->min_coherence (), task->min_wc ());
+  } else if (task->op () == DeepOperationTask::Size) {
+    r = a.sized (task->dx (), task->dy (), task->mode ());
+  }
+
+  checkpoint ();
+  mp_job->set_result (r);
+  mp_job->next_progress ();
+}
+
+// -----------------------------------------------------------------------------
+//  The plugin
+
 class BooleanOperationsPlugin
   : public lay::Plugin
 {
@@ -48,12 +301,13 @@ public:
     m_boolean_layera = -1;
     m_boolean_layerb = -1;
     m_boolean_layerr = -1;
-    m_boolean_hier_mode = 0;
+    m_boolean_hier_mode = HierModeFlat;
     m_boolean_mode = 0;
     m_boolean_mincoh = true;
     m_boolean_minwc = 0;
     m_boolean_sizex = m_boolean_sizey = 0.0;
     m_boolean_size_mode = 2;
+    m_boolean_threads = std::max (1, QThread::idealThreadCount ());
   }
 
   ~BooleanOperationsPlugin ()
@@ -101,7 +355,7 @@ public:
     }
 
     lay::BooleanOptionsDialog dialog (mp_view);
-    if (dialog.exec_dialog (mp_view, m_boolean_cva, m_boolean_layera, m_boolean_cvb, m_boolean_layerb, m_boolean_cvr, m_boolean_layerr, m_boolean_mode, m_boolean_hier_mode, m_boolean_mincoh)) {
+    if (dialog.exec_dialog (mp_view, m_boolean_cva, m_boolean_layera, m_boolean_cvb, m_boolean_layerb, m_boolean_cvr, m_boolean_layerr, m_boolean_mode, m_boolean_hier_mode, m_boolean_mincoh, m_boolean_threads)) {
 
       mp_view->cancel ();
 
@@ -155,7 +409,7 @@ public:
           break;
         }
 
-        if (m_boolean_hier_mode == 0) {
+        if (m_boolean_hier_mode == HierModeFlat) {
 
           //  flat mode
           db::ShapeProcessor p (true);
@@ -170,7 +424,7 @@ public:
             mp_view->cellview (m_boolean_cvr)->layout ().cell (*c).shapes (m_boolean_layerr).clear ();
           }
 
-        } else if (m_boolean_hier_mode == 1) {
+        } else if (m_boolean_hier_mode == HierModeTopCell) {
 
           //  top cell only mode
           db::ShapeProcessor p (true);
@@ -178,7 +432,7 @@ public:
                      mp_view->cellview (m_boolean_cvb)->layout (), *mp_view->cellview (m_boolean_cvb).cell (), m_boolean_layerb,
                      mp_view->cellview (m_boolean_cvr).cell ()->shapes (m_boolean_layerr), op_mode, false, true, m_boolean_mincoh);
           
-        } else if (m_boolean_hier_mode == 2) {
+        } else if (m_boolean_hier_mode == HierModeCellByCell) {
 
           //  subcells cell by cell
           std::set<db::cell_index_type> called_cells;
@@ -194,6 +448,24 @@ public:
                        cell.shapes (m_boolean_layerr), op_mode, false, true, m_boolean_mincoh);
           }
 
+        } else if (m_boolean_hier_mode == HierModeDeep) {
+
+          //  hierarchical mode: computed in the background, delivered when finished
+          const lay::CellView &cv = mp_view->cellview (m_boolean_cva);
+          db::Layout &layout = cv->layout ();
+
+          db::DeepShapeStore dss;
+          dss.set_threads (m_boolean_threads);
+
+          DeepOperationTask *task = new DeepOperationTask (DeepOperationTask::Boolean, (unsigned int) m_boolean_layera, (unsigned int) m_boolean_layerb);
+          task->set_mode (m_boolean_mode);
+          task->set_min_coherence (m_boolean_mincoh);
+
+          DeepOperationJob job (layout, cv.cell_index (), dss);
+          job.run (tl::to_string (QObject::tr ("Boolean operation")), task);
+
+          deliver_hierarchically (job.result (), layout, cv.cell_index (), (unsigned int) m_boolean_layerr);
+
         }
 
         if (supports_undo && mp_view->manager ()) {
@@ -238,7 +510,7 @@ public:
     }
 
     lay::MergeOptionsDialog dialog (mp_view);
-    if (dialog.exec_dialog (mp_view, m_boolean_cva, m_boolean_layera, m_boolean_cvr, m_boolean_layerr, m_boolean_minwc, m_boolean_hier_mode, m_boolean_mincoh)) {
+    if (dialog.exec_dialog (mp_view, m_boolean_cva, m_boolean_layera, m_boolean_cvr, m_boolean_layerr, m_boolean_minwc, m_boolean_hier_mode, m_boolean_mincoh, m_boolean_threads)) {
 
       mp_view->cancel ();
 
@@ -273,7 +545,7 @@ public:
 
       try {
 
-        if (m_boolean_hier_mode == 0) {
+        if (m_boolean_hier_mode == HierModeFlat) {
 
           //  flat mode
           db::ShapeProcessor p (true);
@@ -287,14 +559,14 @@ public:
             mp_view->cellview (m_boolean_cvr)->layout ().cell (*c).shapes (m_boolean_layerr).clear ();
           }
 
-        } else if (m_boolean_hier_mode == 1) {
+        } else if (m_boolean_hier_mode == HierModeTopCell) {
 
           //  top cell only mode
           db::ShapeProcessor p (true);
           p.merge (mp_view->cellview (m_boolean_cva)->layout (), *mp_view->cellview (m_boolean_cva).cell (), m_boolean_layera,
                    mp_view->cellview (m_boolean_cvr).cell ()->shapes (m_boolean_layerr), false, m_boolean_minwc, true, m_boolean_mincoh);
           
-        } else if (m_boolean_hier_mode == 2) {
+        } else if (m_boolean_hier_mode == HierModeCellByCell) {
 
           //  subcells cell by cell
           std::set<db::cell_index_type> called_cells;
@@ -309,6 +581,24 @@ public:
                      cell.shapes (m_boolean_layerr), false, m_boolean_minwc, true, m_boolean_mincoh);
           }
 
+        } else if (m_boolean_hier_mode == HierModeDeep) {
+
+          //  hierarchical mode: computed in the background, delivered when finished
+          const lay::CellView &cv = mp_view->cellview (m_boolean_cva);
+          db::Layout &layout = cv->layout ();
+
+          db::DeepShapeStore dss;
+          dss.set_threads (m_boolean_threads);
+
+          DeepOperationTask *task = new DeepOperationTask (DeepOperationTask::Merge, (unsigned int) m_boolean_layera, 0);
+          task->set_min_coherence (m_boolean_mincoh);
+          task->set_min_wc (m_boolean_minwc);
+
+          DeepOperationJob job (layout, cv.cell_index (), dss);
+          job.run (tl::to_string (QObject::tr ("Merge operation")), task);
+
+          deliver_hierarchically (job.result (), layout, cv.cell_index (), (unsigned int) m_boolean_layerr);
+
         }
 
         if (supports_undo && mp_view->manager ()) {
@@ -353,7 +643,7 @@ public:
     }
 
     lay::SizingOptionsDialog dialog (mp_view);
-    if (dialog.exec_dialog (mp_view, m_boolean_cva, m_boolean_layera, m_boolean_cvr, m_boolean_layerr, m_boolean_sizex, m_boolean_sizey, m_boolean_size_mode, m_boolean_hier_mode, m_boolean_mincoh)) {
+    if (dialog.exec_dialog (mp_view, m_boolean_cva, m_boolean_layera, m_boolean_cvr, m_boolean_layerr, m_boolean_sizex, m_boolean_sizey, m_boolean_size_mode, m_boolean_hier_mode, m_boolean_mincoh, m_boolean_threads)) {
 
       mp_view->cancel ();
 
@@ -392,7 +682,7 @@ public:
 
       try {
 
-        if (m_boolean_hier_mode == 0) {
+        if (m_boolean_hier_mode == HierModeFlat) {
 
           //  flat mode
           db::ShapeProcessor p (true);
@@ -406,14 +696,14 @@ public:
             mp_view->cellview (m_boolean_cvr)->layout ().cell (*c).shapes (m_boolean_layerr).clear ();
           }
 
-        } else if (m_boolean_hier_mode == 1) {
+        } else if (m_boolean_hier_mode == HierModeTopCell) {
 
           //  top cell only mode
           db::ShapeProcessor p (true);
           p.size (mp_view->cellview (m_boolean_cva)->layout (), *mp_view->cellview (m_boolean_cva).cell (), m_boolean_layera,
                   mp_view->cellview (m_boolean_cvr).cell ()->shapes (m_boolean_layerr), dx_int, dy_int, m_boolean_size_mode, false, true, m_boolean_mincoh);
           
-        } else if (m_boolean_hier_mode == 2) {
+        } else if (m_boolean_hier_mode == HierModeCellByCell) {
 
           //  subcells cell by cell
           std::set<db::cell_index_type> called_cells;
@@ -428,6 +718,25 @@ public:
                     cell.shapes (m_boolean_layerr), dx_int, dy_int, m_boolean_size_mode, false, true, m_boolean_mincoh);
           }
 
+        } else if (m_boolean_hier_mode == HierModeDeep) {
+
+          //  hierarchical mode: computed in the background, delivered when finished
+          const lay::CellView &cv = mp_view->cellview (m_boolean_cva);
+          db::Layout &layout = cv->layout ();
+
+          db::DeepShapeStore dss;
+          dss.set_threads (m_boolean_threads);
+
+          DeepOperationTask *task = new DeepOperationTask (DeepOperationTask::Size, (unsigned int) m_boolean_layera, 0);
+          task->set_mode (m_boolean_size_mode);
+          task->set_min_coherence (m_boolean_mincoh);
+          task->set_sizing (dx_int, dy_int);
+
+          DeepOperationJob job (layout, cv.cell_index (), dss);
+          job.run (tl::to_string (QObject::tr ("Sizing operation")), task);
+
+          deliver_hierarchically (job.result (), layout, cv.cell_index (), (unsigned int) m_boolean_layerr);
+
         }
 
         if (supports_undo && mp_view->manager ()) {
@@ -453,6 +762,26 @@ private:
   unsigned int m_boolean_minwc;
   double m_boolean_sizex, m_boolean_sizey;
   unsigned int m_boolean_size_mode;
+  int m_boolean_threads;
+
+  /**
+   *  @brief Writes a deep region into the given cell and layer, maintaining the hierarchy
+   *
+   *  The target layer is cleared in the cell and all its child cells before.
+   *  The source shapes have been copied into the deep shape store already, so the
+   *  target layer may be one of the source layers.
+   */
+  static void deliver_hierarchically (const db::Region &region, db::Layout &layout, db::cell_index_type ci, unsigned int layer)
+  {
+    std::set<db::cell_index_type> called_cells;
+    layout.cell (ci).collect_called_cells (called_cells);
+    called_cells.insert (ci);
+    for (std::set<db::cell_index_type>::const_iterator c = called_cells.begin (); c != called_cells.end (); ++c) {
+      layout.cell (*c).shapes (layer).clear ();
+    }
+
+    region.insert_into (&layout, ci, layer);
+  }
 };
 
 class BooleanOperationsPluginDeclaration
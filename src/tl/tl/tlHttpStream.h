@@ -161,6 +161,7 @@ public:
   virtual size_t read (char *b, size_t n);
 
   virtual void reset ();
+  virtual bool supports_reset () { return false; }
   virtual std::string source () const;
   virtual std::string absolute_path () const;
   virtual std::string filename () const;
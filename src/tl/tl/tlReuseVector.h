@@ -29,6 +29,8 @@
 #include <iterator>
 #include <vector>
 #include <cstring>
+#include <limits>
+#include <stdint.h>
 
 #include "tlAssert.h"
 #include "tlTypeTraits.h"
@@ -146,9 +148,7 @@ public:
    */
   reuse_vector_iterator &operator++ ()
   {
-    do {
-      ++m_n;
-    } while (! at_end () && ! mp_v->is_used (m_n));
+    m_n = mp_v->next_used (m_n + 1);
     return *this;
   }
 
@@ -181,7 +181,11 @@ public:
    */
   difference_type operator- (reuse_vector_iterator d) const
   {
-    //  KLUDGE: this is slow and can be optimized if the vector does not have deleted items
+    //  without deleted items, the distance is simply the index difference
+    if (! mp_v->reuse_data ()) {
+      return m_n - d.m_n;
+    }
+
     difference_type n = 0;
     while (d != *this) {
       ++d;
@@ -315,9 +319,7 @@ public:
    */
   reuse_vector_const_iterator &operator++ ()
   {
-    do {
-      ++m_n;
-    } while (! at_end () && ! mp_v->is_used (m_n));
+    m_n = mp_v->next_used (m_n + 1);
     return *this;
   }
 
@@ -350,7 +352,11 @@ public:
    */
   difference_type operator- (reuse_vector_const_iterator d) const
   {
-    //  KLUDGE: this is slow and can be optimized if the vector does not have deleted items
+    //  without deleted items, the distance is simply the index difference
+    if (! mp_v->reuse_data ()) {
+      return m_n - d.m_n;
+    }
+
     difference_type n = 0;
     while (d != *this) {
       ++d;
@@ -367,8 +373,54 @@ private:
 };
 
 
+/**
+ *  @brief Returns the index of the lowest set bit of a non-zero 64 bit word
+ */
+inline unsigned int reuse_vector_ctz64 (uint64_t w)
+{
+#if defined(__GNUC__)
+  return (unsigned int) __builtin_ctzll (w);
+#else
+  unsigned int n = 0;
+  while ((w & 0xffffffff) == 0) {
+    w >>= 32;
+    n += 32;
+  }
+  while ((w & 1) == 0) {
+    w >>= 1;
+    ++n;
+  }
+  return n;
+#endif
+}
+
+/**
+ *  @brief Returns the index of the highest set bit of a non-zero 64 bit word
+ */
+inline unsigned int reuse_vector_msb64 (uint64_t w)
+{
+#if defined(__GNUC__)
+  return 63 - (unsigned int) __builtin_clzll (w);
+#else
+  unsigned int n = 63;
+  while ((w & 0xffffffff00000000ull) == 0) {
+    w <<= 32;
+    n -= 32;
+  }
+  while ((w & 0x8000000000000000ull) == 0) {
+    w <<= 1;
+    --n;
+  }
+  return n;
+#endif
+}
+
 /**
  *  @brief A helper class describing the "unused" entries of a reuse_vector
+ *
+ *  The used flags are kept in a bitmap organized in 64 bit words. This allows
+ *  skipping runs of unused entries word by word, so iterating a heavily
+ *  fragmented vector does not need to visit every hole.
  */
 
 class ReuseData
@@ -377,13 +429,16 @@ public:
   typedef size_t size_type;
 
   ReuseData ()
-    : m_first_used (0), m_last_used (0), m_next_free (0), m_size (0)
+    : m_first_used (0), m_last_used (0), m_next_free (0), m_size (0), m_bits (0)
   { }
 
   ReuseData (size_type n)
-    : m_first_used (0), m_last_used (n), m_next_free (n), m_size (n)
+    : m_first_used (0), m_last_used (n), m_next_free (n), m_size (n), m_bits (n)
   { 
-    m_used.resize (n, true);
+    m_used.resize ((n + 63) / 64, ~uint64_t (0));
+    if ((n % 64) != 0) {
+      m_used.back () = (uint64_t (1) << (n % 64)) - 1;
+    }
   }
 
   size_type first () const
@@ -406,7 +461,7 @@ public:
     tl_assert (can_allocate ());
 
     size_type r = m_next_free;
-    m_used [r] = true;
+    set_used (r);
 
     if (r >= m_last_used) {
       m_last_used = r + 1;
@@ -415,9 +470,7 @@ public:
       m_first_used = r;
     }
 
-    while (m_next_free != m_used.size () && m_used [m_next_free]) {
-      ++m_next_free;
-    }
+    m_next_free = next_free (r + 1);
 
     ++m_size;
 
@@ -426,23 +479,19 @@ public:
 
   bool can_allocate () const
   {
-    return (m_next_free < m_used.size ());
+    return (m_next_free < m_bits);
   }
 
   void deallocate (size_type n) 
   {
-    m_used [n] = false;
+    set_unused (n);
 
     if (n == m_first_used) {
-      while (m_first_used < m_last_used && ! m_used [m_first_used]) {
-        ++m_first_used;
-      }
+      m_first_used = next_used (m_first_used);
     }
 
     if (n == m_last_used - 1) {
-      while (m_last_used > m_first_used && ! m_used [m_last_used - 1]) {
-        --m_last_used;
-      }
+      m_last_used = prev_used (m_last_used, m_first_used);
     }
 
     if (n < m_next_free) {
@@ -454,27 +503,105 @@ public:
 
   void reserve (size_type n) 
   {
-    m_used.reserve (n);
+    m_used.reserve ((n + 63) / 64);
   }
 
   bool is_used (size_type n) const
   {
-    return m_used [n];
+    return ((m_used [n / 64] >> (n % 64)) & 1) != 0;
+  }
+
+  /**
+   *  @brief Returns the first used index at or after n
+   *
+   *  If there is no such index, last () is returned. If n is beyond last (),
+   *  n is returned.
+   */
+  size_type next_used (size_type n) const
+  {
+    if (n >= m_last_used) {
+      return n;
+    }
+
+    size_type w = n / 64;
+    uint64_t bits = m_used [w] & (~uint64_t (0) << (n % 64));
+    while (bits == 0) {
+      ++w;
+      if (w * 64 >= m_last_used) {
+        return m_last_used;
+      }
+      bits = m_used [w];
+    }
+
+    size_type r = w * 64 + reuse_vector_ctz64 (bits);
+    return r < m_last_used ? r : m_last_used;
   }
 
   size_t mem_reqd () const
   {
-    return (m_used.size () + 7) / 8 + sizeof (*this);
+    return m_used.size () * sizeof (uint64_t) + sizeof (*this);
   }
 
   size_t mem_used () const
   {
-    return m_used.capacity () / 8 + sizeof (*this);
+    return m_used.capacity () * sizeof (uint64_t) + sizeof (*this);
   }
 
 private:
-  std::vector<bool> m_used;
-  size_type m_first_used, m_last_used, m_next_free, m_size;
+  std::vector<uint64_t> m_used;
+  size_type m_first_used, m_last_used, m_next_free, m_size, m_bits;
+
+  void set_used (size_type n)
+  {
+    m_used [n / 64] |= (uint64_t (1) << (n % 64));
+  }
+
+  void set_unused (size_type n)
+  {
+    m_used [n / 64] &= ~(uint64_t (1) << (n % 64));
+  }
+
+  size_type next_free (size_type n) const
+  {
+    if (n >= m_bits) {
+      return m_bits;
+    }
+
+    size_type w = n / 64;
+    uint64_t bits = ~m_used [w] & (~uint64_t (0) << (n % 64));
+    while (bits == 0) {
+      ++w;
+      if (w == m_used.size ()) {
+        return m_bits;
+      }
+      bits = ~m_used [w];
+    }
+
+    size_type r = w * 64 + reuse_vector_ctz64 (bits);
+    return r < m_bits ? r : m_bits;
+  }
+
+  size_type prev_used (size_type n, size_type lower) const
+  {
+    //  returns one past the last used index below n or "lower" if there is none
+    if (n <= lower) {
+      return lower;
+    }
+
+    size_type w = (n - 1) / 64;
+    unsigned int b = (unsigned int) ((n - 1) % 64);
+    uint64_t bits = m_used [w] & (b == 63 ? ~uint64_t (0) : ((uint64_t (1) << (b + 1)) - 1));
+    while (bits == 0) {
+      if (w == 0 || w * 64 <= lower) {
+        return lower;
+      }
+      --w;
+      bits = m_used [w];
+    }
+
+    size_type r = w * 64 + reuse_vector_msb64 (bits) + 1;
+    return r > lower ? r : lower;
+  }
 };
    
 /**
@@ -902,6 +1029,70 @@ public:
     return false;
   }
 
+  /**
+   *  @brief Gets the fraction of unused slots
+   *
+   *  This value is the number of holes left by erased elements relative to the
+   *  number of slots occupied in the storage. It is 0 for a vector without holes
+   *  and approaches 1 for a vector with many holes.
+   */
+  double fragmentation () const
+  {
+    size_type l = last ();
+    if (l == 0) {
+      return 0.0;
+    } else {
+      return double (l - size ()) / double (l);
+    }
+  }
+
+  /**
+   *  @brief Removes the holes left by erased elements
+   *
+   *  This method moves the elements to the front of the storage, maintaining
+   *  their order. After this operation, all iterators and pointers into the
+   *  container are invalid. The capacity is not changed.
+   *
+   *  If index_map is given, it will receive a map of old indexes to new indexes.
+   *  Indexes of unused slots are mapped to std::numeric_limits<size_type>::max ().
+   *  The map is only filled when the method returns true.
+   *
+   *  @return True, if elements have been moved
+   */
+  bool compact (std::vector<size_type> *index_map = 0)
+  {
+    if (! mp_rdata) {
+      return false;
+    }
+
+    size_type e = size_type (mp_finish - mp_start);
+    if (index_map) {
+      index_map->clear ();
+      index_map->resize (e, std::numeric_limits<size_type>::max ());
+    }
+
+    typename tl::type_traits<Value>::relocate_requirements relocate_requirements_tag;
+
+    size_type n = 0;
+    size_type l = last ();
+    for (size_type i = first (); i < l; i = mp_rdata->next_used (i + 1)) {
+      if (i != n) {
+        relocate (i, n, relocate_requirements_tag);
+      }
+      if (index_map) {
+        (*index_map) [i] = n;
+      }
+      ++n;
+    }
+
+    delete mp_rdata;
+    mp_rdata = 0;
+
+    mp_finish = mp_start + n;
+
+    return true;
+  }
+
   /**
    *  @brief For diagnostics purposes only
    */
@@ -923,6 +1114,15 @@ private:
     mp_rdata = 0;
   }
 
+  size_type next_used (size_type n) const
+  {
+    if (mp_rdata) {
+      return mp_rdata->next_used (n);
+    } else {
+      return n;
+    }
+  }
+
   size_type first () const
   {
     if (mp_rdata) {
@@ -941,6 +1141,17 @@ private:
     }
   }
 
+  void relocate (size_type from, size_type to, tl::complex_relocate_required)
+  {
+    new (mp_start + to) value_type (item (from));
+    item (from).~value_type ();
+  }
+
+  void relocate (size_type from, size_type to, tl::trivial_relocate_required)
+  {
+    memcpy ((void *)(mp_start + to), (void *)(mp_start + from), sizeof (Value));
+  }
+
   void internal_reserve (size_type n, tl::complex_relocate_required)
   {
     if (n > capacity ()) {
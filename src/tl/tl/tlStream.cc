@@ -227,6 +227,22 @@ InputStream::get (size_t n, bool bypass_inflate)
     }
   } 
 
+  fill_buffer (n);
+
+  if (m_blen >= n) {
+    const char *r = mp_bptr;
+    mp_bptr += n;
+    m_blen -= n;
+    m_pos += n;
+    return r;
+  } else {
+    return 0;
+  }
+}
+
+void
+InputStream::fill_buffer (size_t n)
+{
   if (m_blen < n) {
 
     //  to keep move activity low, allocate twice as much as required
@@ -251,16 +267,23 @@ InputStream::get (size_t n, bool bypass_inflate)
     mp_bptr = mp_buffer;
 
   }
+}
 
-  if (m_blen >= n) {
-    const char *r = mp_bptr;
-    mp_bptr += n;
-    m_blen -= n;
-    m_pos += n;
-    return r;
-  } else {
-    return 0;
-  }
+const char *
+InputStream::peek (size_t n, size_t &avail)
+{
+  tl_assert (mp_inflate == 0);
+
+  //  the delegate may deliver less than requested (i.e. pipes), so keep reading
+  //  until we have enough or the stream is exhausted
+  size_t blen_before;
+  do {
+    blen_before = m_blen;
+    fill_buffer (n);
+  } while (m_blen < n && m_blen > blen_before);
+
+  avail = std::min (n, m_blen);
+  return mp_bptr ? mp_bptr : mp_buffer;
 }
 
 void
@@ -325,6 +348,53 @@ InputStream::inflate ()
   mp_inflate = new tl::InflateFilter (*this);
 }
 
+void
+InputStream::seek (size_t pos)
+{
+  if (mp_inflate) {
+    delete mp_inflate;
+    mp_inflate = 0;
+  }
+
+  //  the buffer holds the data from m_pos - (mp_bptr - mp_buffer) to m_pos + m_blen
+  size_t before = mp_bptr ? size_t (mp_bptr - mp_buffer) : 0;
+  if (pos + before >= m_pos && pos <= m_pos + m_blen) {
+    mp_bptr = (mp_bptr ? mp_bptr : mp_buffer) + pos - m_pos;
+    m_blen = m_blen + m_pos - pos;
+    m_pos = pos;
+    return;
+  }
+
+  if (mp_delegate->supports_seek ()) {
+    mp_delegate->seek (pos);
+    mp_bptr = mp_buffer;
+    m_blen = 0;
+    m_pos = pos;
+    return;
+  }
+
+  //  fallback: read over the data in between, starting over if required
+  if (pos < m_pos) {
+    reset ();
+  }
+
+  //  NOTE: the delegate may deliver less than requested, so we step by what is available
+  while (m_pos < pos) {
+    if (! get (std::min (pos - m_pos, std::max (size_t (1), m_blen)))) {
+      break;
+    }
+  }
+}
+
+void
+InputStream::set_read_ahead (unsigned int buffers, size_t buffer_size)
+{
+  if (buffers > 0 && mp_delegate && mp_delegate->supports_read_ahead ()) {
+    mp_delegate = new InputReadAheadStream (mp_delegate, m_owns_delegate, buffers, buffer_size);
+    m_owns_delegate = true;
+  }
+}
+
 void
 InputStream::close ()
 {
@@ -342,9 +412,9 @@ InputStream::reset ()
     mp_inflate = 0;
   } 
 
-  //  optimize for a reset in the first m_bcap bytes
+  //  optimize for a reset while the buffer still holds the beginning of the stream
   //  -> this reduces the reset calls on mp_delegate which may not support this
-  if (m_pos < m_bcap) {
+  if (m_pos == 0 || (mp_bptr != 0 && size_t (mp_bptr - mp_buffer) == m_pos)) {
 
     m_blen += m_pos;
     mp_bptr = mp_buffer;
@@ -367,6 +437,308 @@ InputStream::reset ()
   }
 }
 
+// ---------------------------------------------------------------
+//  InputHeadStream implementation
+
+InputHeadStream::InputHeadStream (InputStream &stream, size_t n)
+  : mp_stream (&stream), mp_data (0), m_length (0), m_pos (0)
+{
+  mp_data = stream.peek (n, m_length);
+}
+
+size_t 
+InputHeadStream::read (char *b, size_t n)
+{
+  if (m_pos + n > m_length) {
+    n = m_length - m_pos;
+  }
+  memcpy (b, mp_data + m_pos, n);
+  m_pos += n;
+  return n;
+}
+
+void 
+InputHeadStream::reset ()
+{
+  m_pos = 0;
+}
+
+void 
+InputHeadStream::close ()
+{
+  //  .. nothing yet ..
+}
+
+std::string 
+InputHeadStream::source () const
+{
+  return mp_stream->source ();
+}
+
+std::string 
+InputHeadStream::absolute_path () const
+{
+  return mp_stream->absolute_path ();
+}
+
+std::string 
+InputHeadStream::filename () const
+{
+  return mp_stream->filename ();
+}
+
+// ---------------------------------------------------------------
+//  InputReadAheadStream implementation
+
+class ReadAheadThread
+  : public tl::Thread
+{
+public:
+  ReadAheadThread (InputReadAheadStream *stream)
+    : mp_stream (stream)
+  {
+    //  .. nothing yet ..
+  }
+
+protected:
+  virtual void run ()
+  {
+    mp_stream->fill ();
+  }
+
+private:
+  InputReadAheadStream *mp_stream;
+};
+
+InputReadAheadStream::InputReadAheadStream (InputStreamBase *delegate, bool owns_delegate, unsigned int buffers, size_t buffer_size)
+  : mp_delegate (delegate), m_owns_delegate (owns_delegate), m_buffer_size (std::max (buffer_size, size_t (1))),
+    m_fill (0), m_consume (0), m_ready (0), m_offset (0), m_at_end (false), m_stop (false), mp_thread (0)
+{
+  buffers = std::max (buffers, (unsigned int) 2);
+  m_buffers.resize (buffers, 0);
+  m_lengths.resize (buffers, 0);
+}
+
+InputReadAheadStream::~InputReadAheadStream ()
+{
+  stop ();
+
+  for (std::vector<char *>::const_iterator b = m_buffers.begin (); b != m_buffers.end (); ++b) {
+    delete [] *b;
+  }
+  m_buffers.clear ();
+
+  if (m_owns_delegate) {
+    delete mp_delegate;
+  }
+  mp_delegate = 0;
+}
+
+void
+InputReadAheadStream::start ()
+{
+  for (std::vector<char *>::iterator b = m_buffers.begin (); b != m_buffers.end (); ++b) {
+    if (! *b) {
+      *b = new char [m_buffer_size];
+    }
+  }
+
+  m_fill = m_consume = m_ready = 0;
+  m_offset = 0;
+  m_at_end = false;
+  m_stop = false;
+  m_error.clear ();
+
+  mp_thread = new ReadAheadThread (this);
+  mp_thread->start ();
+}
+
+void
+InputReadAheadStream::stop ()
+{
+  if (! mp_thread) {
+    return;
+  }
+
+  m_lock.lock ();
+  m_stop = true;
+  m_space_available.wakeAll ();
+  m_lock.unlock ();
+
+  mp_thread->wait ();
+  delete mp_thread;
+  mp_thread = 0;
+}
+
+void
+InputReadAheadStream::fill ()
+{
+  while (true) {
+
+    char *buffer = 0;
+
+    m_lock.lock ();
+    while (m_ready == (unsigned int) m_buffers.size () && ! m_stop) {
+      m_space_available.wait (&m_lock);
+    }
+    if (m_stop) {
+      m_lock.unlock ();
+      return;
+    }
+    buffer = m_buffers [m_fill];
+    m_lock.unlock ();
+
+    //  NOTE: the buffer is not touched by the consumer until it is marked ready
+    size_t n = 0;
+    std::string error;
+
+    try {
+      while (n < m_buffer_size) {
+        size_t nn = mp_delegate->read (buffer + n, m_buffer_size - n);
+        if (nn == 0) {
+          break;
+        }
+        n += nn;
+      }
+    } catch (tl::Exception &ex) {
+      error = ex.msg ();
+    } catch (std::exception &ex) {
+      error = ex.what ();
+    } catch (...) {
+      error = tl::to_string (tr ("Unspecific error"));
+    }
+
+    m_lock.lock ();
+
+    if (n > 0) {
+      m_lengths [m_fill] = n;
+      m_fill = (m_fill + 1) % (unsigned int) m_buffers.size ();
+      ++m_ready;
+    }
+
+    bool finished = false;
+    if (! error.empty ()) {
+      m_error = error;
+      finished = true;
+    } else if (n < m_buffer_size) {
+      m_at_end = true;
+      finished = true;
+    }
+
+    m_data_available.wakeAll ();
+    m_lock.unlock ();
+
+    if (finished) {
+      return;
+    }
+
+  }
+}
+
+size_t
+InputReadAheadStream::read (char *b, size_t n)
+{
+  if (! mp_thread) {
+    start ();
+  }
+
+  size_t nread = 0;
+
+  while (nread < n) {
+
+    m_lock.lock ();
+    while (m_ready == 0 && ! m_at_end && m_error.empty ()) {
+      m_data_available.wait (&m_lock);
+    }
+
+    if (m_ready == 0) {
+
+      std::string error = m_error;
+      m_lock.unlock ();
+
+      //  deliver the data read so far - the error is reported on the next read
+      if (! error.empty () && nread == 0) {
+        throw tl::Exception (error);
+      }
+      break;
+
+    }
+
+    const char *buffer = m_buffers [m_consume];
+    size_t length = m_lengths [m_consume];
+    m_lock.unlock ();
+
+    //  NOTE: the buffer is not touched by the producer until it is released
+    size_t nn = std::min (n - nread, length - m_offset);
+    memcpy (b + nread, buffer + m_offset, nn);
+    nread += nn;
+    m_offset += nn;
+
+    if (m_offset == length) {
+      m_offset = 0;
+      m_lock.lock ();
+      m_consume = (m_consume + 1) % (unsigned int) m_buffers.size ();
+      --m_ready;
+      m_space_available.wakeAll ();
+      m_lock.unlock ();
+    }
+
+  }
+
+  return nread;
+}
+
+void
+InputReadAheadStream::reset ()
+{
+  stop ();
+  mp_delegate->reset ();
+}
+
+bool
+InputReadAheadStream::supports_reset ()
+{
+  return mp_delegate->supports_reset ();
+}
+
+void
+InputReadAheadStream::seek (size_t s)
+{
+  stop ();
+  mp_delegate->seek (s);
+}
+
+bool
+InputReadAheadStream::supports_seek ()
+{
+  return mp_delegate->supports_seek ();
+}
+
+void
+InputReadAheadStream::close ()
+{
+  stop ();
+  mp_delegate->close ();
+}
+
+std::string
+InputReadAheadStream::source () const
+{
+  return mp_delegate->source ();
+}
+
+std::string
+InputReadAheadStream::absolute_path () const
+{
+  return mp_delegate->absolute_path ();
+}
+
+std::string
+InputReadAheadStream::filename () const
+{
+  return mp_delegate->filename ();
+}
+
 // ---------------------------------------------------------------
 //  TextInputStream implementation
 
@@ -512,6 +884,20 @@ InputFile::read (char *b, size_t n)
   return size_t (ret);
 }
 
+void 
+InputFile::seek (size_t s)
+{
+  if (m_fd >= 0) {
+#if defined(_WIN64)
+    _lseeki64 (m_fd, s, SEEK_SET);
+#elif defined(_WIN32)
+    _lseek (m_fd, s, SEEK_SET);
+#else
+    lseek (m_fd, s, SEEK_SET);
+#endif
+  }
+}
+
 void 
 InputFile::reset ()
 {
@@ -715,6 +1101,38 @@ OutputStream::flush ()
     mp_delegate->write (mp_buffer, m_buffer_pos);
     m_buffer_pos = 0;
   }
+  if (mp_delegate) {
+    mp_delegate->flush ();
+  }
+}
+
+void
+OutputStream::set_write_behind (unsigned int buffers, size_t buffer_size, unsigned int compression_threads)
+{
+  if (buffers == 0 || ! mp_delegate || dynamic_cast<OutputWriteBehindStream *> (mp_delegate)) {
+    return;
+  }
+
+  flush ();
+
+  if (compression_threads > 0) {
+
+    //  parallel compression replaces the zlib delegate by a plain file - this
+    //  is possible only if nothing has been written yet
+    OutputZLibFile *zfile = dynamic_cast<OutputZLibFile *> (mp_delegate);
+    if (zfile && m_owns_delegate && m_pos == 0) {
+      std::string path = zfile->path ();
+      delete zfile;
+      mp_delegate = 0;
+      mp_delegate = new OutputFile (path);
+    } else {
+      compression_threads = 0;
+    }
+
+  }
+
+  mp_delegate = new OutputWriteBehindStream (mp_delegate, m_owns_delegate, buffers, buffer_size, compression_threads);
+  m_owns_delegate = true;
 }
 
 void
@@ -751,6 +1169,340 @@ OutputStream::seek (size_t pos)
   m_pos = pos;
 }
 
+// ---------------------------------------------------------------
+//  OutputWriteBehindStream implementation
+
+class WriteBehindThread
+  : public tl::Thread
+{
+public:
+  WriteBehindThread (OutputWriteBehindStream *stream, bool compress)
+    : mp_stream (stream), m_compress (compress)
+  {
+    //  .. nothing yet ..
+  }
+
+protected:
+  virtual void run ()
+  {
+    if (m_compress) {
+      mp_stream->compress_buffers ();
+    } else {
+      mp_stream->write_buffers ();
+    }
+  }
+
+private:
+  OutputWriteBehindStream *mp_stream;
+  bool m_compress;
+};
+
+OutputWriteBehindStream::OutputWriteBehindStream (OutputStreamBase *delegate, bool owns_delegate, unsigned int buffers, size_t buffer_size, unsigned int compression_threads)
+  : mp_delegate (delegate), m_owns_delegate (owns_delegate), m_buffer_size (std::max (buffer_size, size_t (1))), m_compression_threads (compression_threads),
+    m_current (0), m_write (0), m_fill_pos (0), m_stop (false), m_error_reported (false)
+{
+  buffers = std::max (buffers, (unsigned int) 2);
+  m_buffers.resize (buffers, 0);
+  m_lengths.resize (buffers, 0);
+  m_compressed.resize (buffers);
+  m_states.resize (buffers, Free);
+}
+
+OutputWriteBehindStream::~OutputWriteBehindStream ()
+{
+  //  NOTE: errors cannot be reported from the destructor
+  try {
+    flush ();
+  } catch (...) {
+    //  .. ignore errors ..
+  }
+
+  stop ();
+
+  for (std::vector<char *>::const_iterator b = m_buffers.begin (); b != m_buffers.end (); ++b) {
+    delete [] *b;
+  }
+  m_buffers.clear ();
+
+  if (m_owns_delegate) {
+    delete mp_delegate;
+  }
+  mp_delegate = 0;
+}
+
+void
+OutputWriteBehindStream::start ()
+{
+  for (std::vector<char *>::iterator b = m_buffers.begin (); b != m_buffers.end (); ++b) {
+    if (! *b) {
+      *b = new char [m_buffer_size];
+    }
+  }
+
+  m_current = m_write = 0;
+  m_fill_pos = 0;
+  m_stop = false;
+  for (std::vector<BufferState>::iterator s = m_states.begin (); s != m_states.end (); ++s) {
+    *s = Free;
+  }
+
+  m_threads.push_back (new WriteBehindThread (this, false));
+  for (unsigned int i = 0; i < m_compression_threads; ++i) {
+    m_threads.push_back (new WriteBehindThread (this, true));
+  }
+
+  for (std::vector<WriteBehindThread *>::const_iterator t = m_threads.begin (); t != m_threads.end (); ++t) {
+    (*t)->start ();
+  }
+}
+
+void
+OutputWriteBehindStream::stop ()
+{
+  if (m_threads.empty ()) {
+    return;
+  }
+
+  m_lock.lock ();
+  m_stop = true;
+  m_state_changed.wakeAll ();
+  m_lock.unlock ();
+
+  for (std::vector<WriteBehindThread *>::const_iterator t = m_threads.begin (); t != m_threads.end (); ++t) {
+    (*t)->wait ();
+    delete *t;
+  }
+  m_threads.clear ();
+}
+
+void
+OutputWriteBehindStream::check_error ()
+{
+  m_lock.lock ();
+  std::string error;
+  if (! m_error.empty () && ! m_error_reported) {
+    m_error_reported = true;
+    error = m_error;
+  }
+  m_lock.unlock ();
+
+  if (! error.empty ()) {
+    throw tl::Exception (error);
+  }
+}
+
+void
+OutputWriteBehindStream::submit ()
+{
+  if (m_fill_pos == 0) {
+    return;
+  }
+
+  m_lock.lock ();
+
+  m_lengths [m_current] = m_fill_pos;
+  m_states [m_current] = Filled;
+  m_state_changed.wakeAll ();
+
+  m_current = (m_current + 1) % (unsigned int) m_buffers.size ();
+  while (m_states [m_current] != Free) {
+    m_state_changed.wait (&m_lock);
+  }
+
+  m_lock.unlock ();
+
+  m_fill_pos = 0;
+
+  check_error ();
+}
+
+void
+OutputWriteBehindStream::write (const char *b, size_t n)
+{
+  if (m_threads.empty ()) {
+    start ();
+  }
+
+  check_error ();
+
+  while (n > 0) {
+
+    //  NOTE: the current buffer is not touched by the threads until it is submitted
+    size_t nn = std::min (n, m_buffer_size - m_fill_pos);
+    memcpy (m_buffers [m_current] + m_fill_pos, b, nn);
+    m_fill_pos += nn;
+    b += nn;
+    n -= nn;
+
+    if (m_fill_pos == m_buffer_size) {
+      submit ();
+    }
+
+  }
+}
+
+void
+OutputWriteBehindStream::flush ()
+{
+  if (! m_threads.empty ()) {
+
+    submit ();
+
+    m_lock.lock ();
+    bool pending = true;
+    while (pending) {
+      pending = false;
+      for (std::vector<BufferState>::const_iterator s = m_states.begin (); s != m_states.end () && ! pending; ++s) {
+        pending = (*s != Free);
+      }
+      if (pending) {
+        m_state_changed.wait (&m_lock);
+      }
+    }
+    m_lock.unlock ();
+
+    check_error ();
+
+  }
+
+  mp_delegate->flush ();
+}
+
+void
+OutputWriteBehindStream::seek (size_t s)
+{
+  flush ();
+  mp_delegate->seek (s);
+}
+
+bool
+OutputWriteBehindStream::supports_seek ()
+{
+  return m_compression_threads == 0 && mp_delegate->supports_seek ();
+}
+
+void
+OutputWriteBehindStream::write_buffers ()
+{
+  while (true) {
+
+    BufferState ready_state = (m_compression_threads > 0 ? Ready : Filled);
+
+    m_lock.lock ();
+    while (m_states [m_write] != ready_state && ! (m_stop && m_states [m_write] == Free)) {
+      m_state_changed.wait (&m_lock);
+    }
+    if (m_states [m_write] == Free) {
+      m_lock.unlock ();
+      return;
+    }
+    bool skip = ! m_error.empty ();
+    m_lock.unlock ();
+
+    //  NOTE: the buffer is not touched by the producer until it is released.
+    //  After an error, the buffers are released without being written.
+    std::string error;
+
+    if (! skip) {
+      try {
+        if (m_compression_threads > 0) {
+          mp_delegate->write (m_compressed [m_write].c_str (), m_compressed [m_write].size ());
+        } else {
+          mp_delegate->write (m_buffers [m_write], m_lengths [m_write]);
+        }
+      } catch (tl::Exception &ex) {
+        error = ex.msg ();
+      } catch (std::exception &ex) {
+        error = ex.what ();
+      } catch (...) {
+        error = tl::to_string (tr ("Unspecific error"));
+      }
+    }
+
+    m_lock.lock ();
+    if (! error.empty () && m_error.empty ()) {
+      m_error = error;
+    }
+    m_compressed [m_write].clear ();
+    m_states [m_write] = Free;
+    m_write = (m_write + 1) % (unsigned int) m_buffers.size ();
+    m_state_changed.wakeAll ();
+    m_lock.unlock ();
+
+  }
+}
+
+void
+OutputWriteBehindStream::compress_buffers ()
+{
+  while (true) {
+
+    unsigned int index = 0;
+
+    m_lock.lock ();
+    bool found = false;
+    while (! found) {
+      //  pick the filled buffer closest to the write position
+      for (unsigned int i = 0; i < (unsigned int) m_buffers.size () && ! found; ++i) {
+        index = (m_write + i) % (unsigned int) m_buffers.size ();
+        found = (m_states [index] == Filled);
+      }
+      if (! found) {
+        if (m_stop) {
+          m_lock.unlock ();
+          return;
+        }
+        m_state_changed.wait (&m_lock);
+      }
+    }
+    m_states [index] = Compressing;
+    bool skip = ! m_error.empty ();
+    m_lock.unlock ();
+
+    //  Each buffer is compressed into a gzip member of its own
+    std::string out;
+    std::string error;
+
+    if (! skip) {
+
+      z_stream zs;
+      memset (&zs, 0, sizeof (zs));
+
+      if (deflateInit2 (&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16 /*gzip header*/, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        error = tl::to_string (tr ("Unable to initialize compression"));
+      } else {
+
+        out.resize (deflateBound (&zs, (uLong) m_lengths [index]));
+
+        zs.next_in = (Bytef *) m_buffers [index];
+        zs.avail_in = (uInt) m_lengths [index];
+        zs.next_out = (Bytef *) &out [0];
+        zs.avail_out = (uInt) out.size ();
+
+        if (deflate (&zs, Z_FINISH) != Z_STREAM_END) {
+          error = tl::to_string (tr ("Compression failed"));
+        } else {
+          out.resize (zs.total_out);
+        }
+
+        deflateEnd (&zs);
+
+      }
+
+    }
+
+    m_lock.lock ();
+    if (! error.empty () && m_error.empty ()) {
+      m_error = error;
+    }
+    m_compressed [index].swap (out);
+    m_states [index] = Ready;
+    m_state_changed.wakeAll ();
+    m_lock.unlock ();
+
+  }
+}
+
 // ---------------------------------------------------------------
 //  OutputFile implementation
 
@@ -28,8 +28,10 @@
 
 #include "tlException.h"
 #include "tlString.h"
+#include "tlThreads.h"
 
 #include <string>
+#include <vector>
 #include <sstream>
 #include <cstdio>
 #include <cstring>
@@ -82,6 +84,45 @@ public:
    */
   virtual void reset () = 0;
 
+  /**
+   *  @brief Returns a value indicating whether that stream supports reset
+   *
+   *  Streams which can only be read once (i.e. pipes) will return false.
+   */
+  virtual bool supports_reset ()
+  {
+    return true;
+  }
+
+  /**
+   *  @brief Seek to the specified position
+   *
+   *  Reading continues at that position after a seek.
+   */
+  virtual void seek (size_t /*s*/)
+  {
+    //  .. the default implementation does nothing ..
+  }
+
+  /**
+   *  @brief Returns a value indicating whether that stream supports seek
+   */
+  virtual bool supports_seek ()
+  {
+    return false;
+  }
+
+  /**
+   *  @brief Returns a value indicating whether that stream can be read from a separate thread
+   *
+   *  Only streams returning true are wrapped by InputStream::set_read_ahead.
+   *  Streams which depend on a particular thread (i.e. HTTP streams) must not be read ahead.
+   */
+  virtual bool supports_read_ahead ()
+  {
+    return false;
+  }
+
   /**
    *  @brief Closes the channel
    */
@@ -144,6 +185,16 @@ public:
     m_pos = 0;
   }
 
+  virtual void seek (size_t s)
+  {
+    m_pos = std::min (s, m_length);
+  }
+
+  virtual bool supports_seek ()
+  {
+    return true;
+  }
+
   virtual void close ()
   {
     //  .. nothing yet ..
@@ -210,6 +261,11 @@ public:
 
   virtual void reset ();
 
+  virtual bool supports_read_ahead ()
+  {
+    return true;
+  }
+
   virtual void close ();
 
   virtual std::string source () const
@@ -262,6 +318,18 @@ public:
 
   virtual void reset ();
 
+  virtual void seek (size_t s);
+
+  virtual bool supports_seek ()
+  {
+    return true;
+  }
+
+  virtual bool supports_read_ahead ()
+  {
+    return true;
+  }
+
   virtual void close ();
 
   virtual std::string source () const
@@ -324,6 +392,14 @@ public:
    */
   virtual void reset ();
 
+  /**
+   *  @brief Implementation of InputStreamBase: pipes cannot be reset
+   */
+  virtual bool supports_reset ()
+  {
+    return false;
+  }
+
   /**
    *  @brief Closes the pipe
    *  This method will wait for the child process to terminate.
@@ -427,6 +503,18 @@ public:
    */
   const char *get (size_t n, bool bypass_inflate = false);
 
+  /**
+   *  @brief Looks ahead on the raw stream without consuming data
+   *
+   *  This method delivers a pointer to the next n bytes of the raw (not inflated)
+   *  stream without advancing the read position. If less than n bytes are 
+   *  available, the pointer covers the remaining bytes. The number of bytes 
+   *  available is returned in "avail".
+   *  The pointer is valid until the next call of get, peek or reset.
+   *  The stream must not be in inflate state.
+   */
+  const char *peek (size_t n, size_t &avail);
+
   /** 
    *  @brief Undo a previous get call
    *  
@@ -518,6 +606,34 @@ public:
    */
   virtual void reset ();
 
+  /**
+   *  @brief Returns a value indicating whether the stream can be reset
+   *
+   *  If this method returns false, the stream can be read once only.
+   */
+  bool supports_reset () const
+  {
+    return mp_delegate->supports_reset ();
+  }
+
+  /**
+   *  @brief Moves the read position to the given location
+   *
+   *  If the delegate supports seeking, the position is set directly. Otherwise,
+   *  forward positions are reached by reading over the data in between and for
+   *  positions before the current one, the stream is reset first. If the stream
+   *  is inflating, inflating stops. The position is a raw stream position.
+   */
+  void seek (size_t pos);
+
+  /**
+   *  @brief Returns a value indicating whether the stream delivers inflated data currently
+   */
+  bool is_inflating () const
+  {
+    return mp_inflate != 0;
+  }
+
   /**
    *  @brief Closes the reader
    *  This method will finish reading and free resources
@@ -537,6 +653,20 @@ public:
   {
     return mp_delegate;
   }
+
+  /**
+   *  @brief Enables read-ahead on this stream
+   *
+   *  In read-ahead mode, a separate thread reads the data from the delegate 
+   *  into a ring of buffers while the consumer processes the data delivered before.
+   *  Decompression of .gz files happens in that thread too.
+   *  "buffers" is the number of buffers in the ring and "buffer_size" the size 
+   *  of each buffer. If "buffers" is 0 or the delegate does not support read-ahead
+   *  (see InputStreamBase::supports_read_ahead), this method does nothing.
+   *  This method can be called while the stream is read already. It does nothing 
+   *  if read-ahead is enabled already.
+   */
+  void set_read_ahead (unsigned int buffers, size_t buffer_size);
     
 protected:
   void reset_pos ()
@@ -559,6 +689,128 @@ private:
   //  No copying currently
   InputStream (const InputStream &);
   InputStream &operator= (const InputStream &);
+
+  void fill_buffer (size_t n);
+};
+
+// ---------------------------------------------------------------------------------
+
+/**
+ *  @brief A delegate delivering the head of another stream
+ *
+ *  This delegate peeks the first bytes of the given stream once and delivers
+ *  them as a stream of its own. The original stream is not advanced and does not
+ *  need to be reset, hence no data is read twice. Source and file names are 
+ *  taken from the original stream.
+ *  This is useful for format detection: all detectors can scan the head while the 
+ *  original stream is read only once. 
+ *  The original stream must not be read while this object is used.
+ */
+class TL_PUBLIC InputHeadStream
+  : public InputStreamBase
+{
+public:
+  /**
+   *  @brief Creates a stream delivering the next n bytes of the given stream
+   */
+  InputHeadStream (InputStream &stream, size_t n);
+
+  virtual size_t read (char *b, size_t n);
+  virtual void reset ();
+  virtual void close ();
+  virtual std::string source () const;
+  virtual std::string absolute_path () const;
+  virtual std::string filename () const;
+
+  /**
+   *  @brief Gets the number of bytes available in the head
+   */
+  size_t length () const
+  {
+    return m_length;
+  }
+
+private:
+  //  no copying
+  InputHeadStream (const InputHeadStream &);
+  InputHeadStream &operator= (const InputHeadStream &);
+
+  InputStream *mp_stream;
+  const char *mp_data;
+  size_t m_length, m_pos;
+};
+
+// ---------------------------------------------------------------------------------
+
+class ReadAheadThread;
+
+/**
+ *  @brief A delegate reading ahead of the consumer
+ *
+ *  This delegate employs a thread which reads the data from the given delegate
+ *  into a ring of buffers. The consumer takes the data from these buffers. Hence
+ *  reading (and decompression for example) overlaps with processing the data.
+ *  The thread is started on the first read. Errors occuring in the thread
+ *  are reported to the consumer when it reaches the respective position.
+ */
+class TL_PUBLIC InputReadAheadStream
+  : public InputStreamBase
+{
+public:
+  /**
+   *  @brief Creates a read-ahead stream on the given delegate
+   *
+   *  If "owns_delegate" is true, the delegate is deleted by this object.
+   */
+  InputReadAheadStream (InputStreamBase *delegate, bool owns_delegate, unsigned int buffers = 4, size_t buffer_size = 1024 * 1024);
+
+  /**
+   *  @brief Destructor
+   */
+  ~InputReadAheadStream ();
+
+  virtual size_t read (char *b, size_t n);
+  virtual void reset ();
+  virtual bool supports_reset ();
+  virtual void seek (size_t s);
+  virtual bool supports_seek ();
+  virtual void close ();
+  virtual std::string source () const;
+  virtual std::string absolute_path () const;
+  virtual std::string filename () const;
+
+  /**
+   *  @brief Gets the delegate
+   */
+  InputStreamBase *delegate ()
+  {
+    return mp_delegate;
+  }
+
+private:
+  friend class ReadAheadThread;
+
+  //  no copying
+  InputReadAheadStream (const InputReadAheadStream &);
+  InputReadAheadStream &operator= (const InputReadAheadStream &);
+
+  InputStreamBase *mp_delegate;
+  bool m_owns_delegate;
+  size_t m_buffer_size;
+  std::vector<char *> m_buffers;
+  std::vector<size_t> m_lengths;
+  unsigned int m_fill, m_consume, m_ready;
+  size_t m_offset;
+  bool m_at_end, m_stop;
+  std::string m_error;
+  ReadAheadThread *mp_thread;
+  tl::Mutex m_lock;
+  tl::WaitCondition m_data_available;
+  tl::WaitCondition m_space_available;
+
+  void start ();
+  void stop ();
+  void fill ();
 };
 
 // ---------------------------------------------------------------------------------
@@ -691,6 +943,17 @@ public:
     return false;
   }
 
+  /**
+   *  @brief Makes sure all data written so far is delivered to the target
+   *
+   *  Delegates buffering data internally need to implement this method.
+   *  May throw an exception if a write error occures.
+   */
+  virtual void flush ()
+  {
+    //  .. the default implementation does nothing ..
+  }
+
 private:
   //  No copying
   OutputStreamBase (const OutputStreamBase &);
@@ -854,6 +1117,14 @@ public:
    */
   virtual void write (const char *b, size_t n);
 
+  /**
+   *  @brief Gets the path of the file
+   */
+  const std::string &path () const
+  {
+    return m_source;
+  }
+
 private:
   //  No copying
   OutputZLibFile (const OutputZLibFile &);
@@ -971,6 +1242,107 @@ private:
 
 // ---------------------------------------------------------------------------------
 
+class WriteBehindThread;
+
+/**
+ *  @brief A delegate writing behind the producer
+ *
+ *  This delegate collects the data in a ring of buffers. A separate I/O thread 
+ *  writes the filled buffers to the given delegate while the producer continues 
+ *  with the next buffer. With two buffers, this is double buffering.
+ *
+ *  Optionally, the buffers are compressed by a number of compression threads 
+ *  before they are written. Each buffer becomes a gzip member of its own then.
+ *  The concatenation of gzip members is a valid gzip file. The delegate must
+ *  be a plain delegate in this case.
+ *
+ *  Errors occuring in the threads are reported on the next write or on flush. 
+ *  An error is reported once. The threads are started on the first write.
+ */
+class TL_PUBLIC OutputWriteBehindStream
+  : public OutputStreamBase
+{
+public:
+  /**
+   *  @brief Creates a write-behind stream on the given delegate
+   *
+   *  If "owns_delegate" is true, the delegate is deleted by this object.
+   *  If "compression_threads" is larger than 0, the data is written in gzip 
+   *  format using the given number of threads for compression.
+   */
+  OutputWriteBehindStream (OutputStreamBase *delegate, bool owns_delegate, unsigned int buffers = 2, size_t buffer_size = 1024 * 1024, unsigned int compression_threads = 0);
+
+  /**
+   *  @brief Destructor
+   *
+   *  The destructor will write the pending data but does not report errors.
+   *  Call flush before to receive them.
+   */
+  ~OutputWriteBehindStream ();
+
+  virtual void write (const char *b, size_t n);
+  virtual void seek (size_t s);
+  virtual bool supports_seek ();
+  virtual void flush ();
+
+  /**
+   *  @brief Gets the delegate
+   */
+  OutputStreamBase *delegate ()
+  {
+    return mp_delegate;
+  }
+
+  /**
+   *  @brief Gets the number of compression threads
+   */
+  unsigned int compression_threads () const
+  {
+    return m_compression_threads;
+  }
+
+private:
+  friend class WriteBehindThread;
+
+  enum BufferState
+  {
+    Free = 0,
+    Filled,
+    Compressing,
+    Ready
+  };
+
+  //  no copying
+  OutputWriteBehindStream (const OutputWriteBehindStream &);
+  OutputWriteBehindStream &operator= (const OutputWriteBehindStream &);
+
+  OutputStreamBase *mp_delegate;
+  bool m_owns_delegate;
+  size_t m_buffer_size;
+  unsigned int m_compression_threads;
+  std::vector<char *> m_buffers;
+  std::vector<size_t> m_lengths;
+  std::vector<std::string> m_compressed;
+  std::vector<BufferState> m_states;
+  unsigned int m_current, m_write;
+  size_t m_fill_pos;
+  bool m_stop;
+  std::string m_error;
+  bool m_error_reported;
+  std::vector<WriteBehindThread *> m_threads;
+  tl::Mutex m_lock;
+  tl::WaitCondition m_state_changed;
+
+  void start ();
+  void stop ();
+  void submit ();
+  void check_error ();
+  void write_buffers ();
+  void compress_buffers ();
+};
+
+// ---------------------------------------------------------------------------------
+
 /**
  *  @brief An output stream abstraction class
  *
@@ -1128,9 +1500,35 @@ public:
     
   /**
    *  @brief Flush buffered data
+   *
+   *  This will also flush the delegate. In write-behind mode, this method waits 
+   *  until all data is written and reports write errors.
    */
   void flush ();
 
+  /**
+   *  @brief Enables write-behind on this stream
+   *
+   *  In write-behind mode, a separate thread writes the data to the file
+   *  while the producer continues to fill the next buffer. "buffers" is the
+   *  number of buffers in the ring and "buffer_size" the size of each buffer.
+   *  If "buffers" is 0, this method does nothing. It also does nothing if
+   *  write-behind is enabled already.
+   *
+   *  If "compression_threads" is larger than 0 and the stream is a .gz file
+   *  not written yet, compression is done by the given number of threads
+   *  in parallel. Otherwise, compression happens in the I/O thread.
+   */
+  void set_write_behind (unsigned int buffers, size_t buffer_size, unsigned int compression_threads = 0);
+
+  /**
+   *  @brief Gets the base writer (delegate)
+   */
+  OutputStreamBase *base ()
+  {
+    return mp_delegate;
+  }
+
 protected:
   void reset_pos ()
   {
@@ -444,14 +444,22 @@ Variant::Variant (const QVariant &v)
 Variant::Variant (const std::string &s) 
   : m_type (t_stdstring), m_string (0)
 {
-  m_var.m_stdstring = new std::string (s);
+  new (m_var.m_stdstring) std::string (s);
 }
 
+#if __cplusplus >= 201103L
+Variant::Variant (std::string &&s)
+  : m_type (t_stdstring), m_string (0)
+{
+  new (m_var.m_stdstring) std::string ();
+  stdstring_ptr ()->swap (s);
+}
+#endif
+
 Variant::Variant (const char *s) 
-  : m_type (t_string)
+  : m_type (t_string), m_string (0)
 {
-  m_string = new char [strlen (s) + 1];
-  strcpy (m_string, s);
+  set_string (s);
 }
 
 Variant::Variant (double d)
@@ -571,7 +579,7 @@ Variant::reset ()
   }
   m_string = 0;
   if (m_type == t_list) {
-    delete m_var.m_list;
+    list_ptr ()->~vector ();
   } else if (m_type == t_array) {
     delete m_var.m_array;
 #if defined(HAVE_QT)
@@ -581,7 +589,7 @@ Variant::reset ()
     delete m_var.m_qbytearray;
 #endif
   } else if (m_type == t_stdstring) {
-    delete m_var.m_stdstring;
+    stdstring_ptr ()->~basic_string ();
   } else if (m_type == t_user_ref) {
     WeakOrSharedPtr *ptr = reinterpret_cast<WeakOrSharedPtr *> (m_var.mp_user_ref.ptr);
     ptr->~WeakOrSharedPtr();
@@ -596,14 +604,14 @@ Variant::reset ()
 Variant &
 Variant::operator= (const char *s)
 {
-  if (m_type == t_string && s == m_string) {
+  if (m_type == t_string && s == to_string ()) {
     //  we are assigning to ourselves
   } else {
-    char *snew = new char [strlen (s) + 1];
-    strcpy (snew, s);
-    reset ();
-    m_type = t_string;
-    m_string = snew;
+    //  s may point into our own content, hence we build the new value first
+    tl::Variant vv;
+    vv.m_type = t_string;
+    vv.set_string (s);
+    swap (vv);
   }
   return *this;
 }
@@ -611,13 +619,14 @@ Variant::operator= (const char *s)
 Variant &
 Variant::operator= (const std::string &s)
 {
-  if (m_type == t_stdstring && &s == m_var.m_stdstring) {
+  if (m_type == t_stdstring && &s == stdstring_ptr ()) {
     //  we are assigning to ourselves
   } else {
-    std::string *snew = new std::string (s);
+    std::string snew (s);
     reset ();
     m_type = t_stdstring;
-    m_var.m_stdstring = snew;
+    new (m_var.m_stdstring) std::string ();
+    stdstring_ptr ()->swap (snew);
   }
   return *this;
 }
@@ -844,12 +853,11 @@ Variant::operator= (const Variant &v)
       m_var.m_qbytearray = new QByteArray (*v.m_var.m_qbytearray);
 #endif
     } else if (m_type == t_stdstring) {
-      m_var.m_stdstring = new std::string (*v.m_var.m_stdstring);
+      new (m_var.m_stdstring) std::string (*v.stdstring_ptr ());
     } else if (m_type == t_string) {
-      m_string = new char [strlen (v.m_string) + 1];
-      strcpy (m_string, v.m_string);
+      set_string (v.to_string ());
     } else if (m_type == t_list) {
-      m_var.m_list = new std::vector<tl::Variant> (*v.m_var.m_list);
+      new (m_var.m_list) std::vector<tl::Variant> (*v.list_ptr ());
     } else if (m_type == t_array) {
       m_var.m_array = new std::map<tl::Variant, tl::Variant> (*v.m_var.m_array);
     } else if (m_type == t_user) {
@@ -996,7 +1004,7 @@ Variant::operator== (const tl::Variant &d) const
     return *m_var.m_qbytearray == *d.m_var.m_qbytearray;
 #endif
   } else if (t == t_list) {
-    return *m_var.m_list == *d.m_var.m_list;
+    return *list_ptr () == *d.list_ptr ();
   } else if (t == t_array) {
     return *m_var.m_array == *d.m_var.m_array;
   } else if (t == t_user) {
@@ -1049,7 +1057,7 @@ Variant::operator< (const tl::Variant &d) const
     return *m_var.m_qbytearray < *d.m_var.m_qbytearray;
 #endif
   } else if (t == t_list) {
-    return *m_var.m_list < *d.m_var.m_list;
+    return *list_ptr () < *d.list_ptr ();
   } else if (t == t_array) {
     return *m_var.m_array < *d.m_var.m_array;
   } else if (t == t_user) {
@@ -1529,7 +1537,7 @@ Variant::to_qbytearray () const
   } else if (m_type == t_qstring) {
     return m_var.m_qstring->toUtf8 ();
   } else if (m_type == t_stdstring) {
-    return QByteArray (m_var.m_stdstring->c_str (), int (m_var.m_stdstring->size ()));
+    return QByteArray (stdstring_ptr ()->c_str (), int (stdstring_ptr ()->size ()));
   } else {
     //  TODO: maybe some other conversion makes sense? I.e. byte representation of int?
     std::string s = to_string ();
@@ -1555,7 +1563,7 @@ std::string
 Variant::to_stdstring () const
 {
   if (m_type == t_stdstring) {
-    return *m_var.m_stdstring;
+    return *stdstring_ptr ();
 #if defined(HAVE_QT)
   } else if (m_type == t_qstring) {
     return tl::to_string (*m_var.m_qstring);
@@ -1570,9 +1578,13 @@ Variant::to_stdstring () const
 const char *
 Variant::to_string () const
 {
-  if (m_type == t_stdstring) {
+  if (m_type == t_string) {
+
+    return m_string ? m_string : m_var.m_chars;
+
+  } else if (m_type == t_stdstring) {
 
-    return m_var.m_stdstring->c_str ();
+    return stdstring_ptr ()->c_str ();
 
 #if defined(HAVE_QT)
   } else if (m_type == t_qbytearray) {
@@ -1627,8 +1639,8 @@ Variant::to_string () const
       r = std::string (m_var.m_qbytearray->constData (), m_var.m_qbytearray->size ());
 #endif
     } else if (m_type == t_list) {
-      for (std::vector<tl::Variant>::const_iterator v = m_var.m_list->begin (); v != m_var.m_list->end (); ++v) {
-        if (v != m_var.m_list->begin ()) {
+      for (std::vector<tl::Variant>::const_iterator v = list_ptr ()->begin (); v != list_ptr ()->end (); ++v) {
+        if (v != list_ptr ()->begin ()) {
           r += ",";
         }
         r += v->to_string ();
@@ -1722,7 +1734,7 @@ Variant::to_int128 () const
     return l;
 #endif
   } else if (m_type == t_stdstring) {
-    tl::Extractor ex (m_var.m_stdstring->c_str ());
+    tl::Extractor ex (stdstring_ptr ()->c_str ());
     __int128 l = 0;
     ex.read (l);
     return l;
@@ -1777,7 +1789,7 @@ Variant::to_ulonglong () const
     return m_var.m_bool;
   } else if (m_type == t_stdstring) {
     unsigned long long l = 0;
-    tl::from_string (*m_var.m_stdstring, l);
+    tl::from_string (*stdstring_ptr (), l);
     return l;
 #if defined(HAVE_QT)
   } else if (m_type == t_string || m_type == t_qstring || m_type == t_qbytearray) {
@@ -1831,7 +1843,7 @@ Variant::to_longlong () const
     return m_var.m_bool;
   } else if (m_type == t_stdstring) {
     long long l = 0;
-    tl::from_string (*m_var.m_stdstring, l);
+    tl::from_string (*stdstring_ptr (), l);
     return l;
 #if defined(HAVE_QT)
   } else if (m_type == t_string || m_type == t_qstring || m_type == t_qbytearray) {
@@ -1885,7 +1897,7 @@ Variant::to_ulong () const
     return m_var.m_bool;
   } else if (m_type == t_stdstring) {
     unsigned long l = 0;
-    tl::from_string (*m_var.m_stdstring, l);
+    tl::from_string (*stdstring_ptr (), l);
     return l;
 #if defined(HAVE_QT)
   } else if (m_type == t_string || m_type == t_qstring || m_type == t_qbytearray) {
@@ -1939,7 +1951,7 @@ Variant::to_long () const
     return m_var.m_bool;
   } else if (m_type == t_stdstring) {
     long l = 0;
-    tl::from_string (*m_var.m_stdstring, l);
+    tl::from_string (*stdstring_ptr (), l);
     return l;
 #if defined(HAVE_QT)
   } else if (m_type == t_string || m_type == t_qstring || m_type == t_qbytearray) {
@@ -2045,7 +2057,7 @@ Variant::to_double () const
     return m_var.m_bool;
   } else if (m_type == t_stdstring) {
     double d = 0;
-    tl::from_string (*m_var.m_stdstring, d);
+    tl::from_string (*stdstring_ptr (), d);
     return d;
 #if defined(HAVE_QT)
   } else if (m_type == t_string || m_type == t_qstring || m_type == t_qbytearray) {
@@ -2107,7 +2119,7 @@ Variant::native_ptr () const
   case t_uint:
     return &m_var.m_uint;
   case t_string:
-    return m_string;
+    return to_string ();
 #if defined(HAVE_QT)
   case t_qstring:
     return m_var.m_qstring;
@@ -2115,11 +2127,11 @@ Variant::native_ptr () const
     return m_var.m_qbytearray;
 #endif
   case t_stdstring:
-    return m_var.m_stdstring;
+    return stdstring_ptr ();
   case t_array:
     return m_var.m_array;
   case t_list:
-    return m_var.m_list;
+    return list_ptr ();
   case t_nil:
   default:
     return 0;
@@ -2196,7 +2208,7 @@ Variant::to_parsable_string () const
   } else if (is_nil ()) {
     return "nil";
   } else if (is_stdstring ()) {
-    return tl::to_quoted_string (*m_var.m_stdstring);
+    return tl::to_quoted_string (*stdstring_ptr ());
 #if defined(HAVE_QT)
   } else if (is_cstring () || is_qstring () || is_qbytearray ()) {
 #else
@@ -2239,24 +2251,49 @@ Variant::to_parsable_string () const
   }
 }
 
+void
+tl::Variant::set_string (const char *s)
+{
+  //  NOTE: m_type is expected to be t_string and the value holder is expected to be empty
+  size_t n = strlen (s);
+  if (n < sizeof (m_var.m_chars)) {
+    //  short strings are kept inside the value holder
+    memcpy (m_var.m_chars, s, n + 1);
+    m_string = 0;
+  } else {
+    m_string = new char [n + 1];
+    memcpy (m_string, s, n + 1);
+  }
+}
+
+void
+tl::Variant::move_value (type t, ValueHolder &to, ValueHolder &from)
+{
+  //  NOTE: "to" is expected to be uninitialized. "from" will be uninitialized afterwards.
+  if (t == t_stdstring) {
+    std::string *s = reinterpret_cast <std::string *> (from.m_stdstring);
+    (new (to.m_stdstring) std::string ())->swap (*s);
+    s->~basic_string ();
+  } else if (t == t_list) {
+    std::vector<tl::Variant> *l = reinterpret_cast <std::vector<tl::Variant> *> (from.m_list);
+    (new (to.m_list) std::vector<tl::Variant> ())->swap (*l);
+    l->~vector ();
+  } else if (t == t_user_ref) {
+    to.mp_user_ref.cls = from.mp_user_ref.cls;
+    new (to.mp_user_ref.ptr) tl::WeakOrSharedPtr (*reinterpret_cast <tl::WeakOrSharedPtr *> (from.mp_user_ref.ptr));
+    reinterpret_cast <tl::WeakOrSharedPtr *> (from.mp_user_ref.ptr)->~WeakOrSharedPtr ();
+  } else {
+    to = from;
+  }
+}
+
 void 
 tl::Variant::swap (tl::Variant &other)
 {
-  ValueHolder a = m_var;
-  if (m_type == t_user_ref) {
-    new (a.mp_user_ref.ptr) tl::WeakOrSharedPtr (*reinterpret_cast <tl::WeakOrSharedPtr *> (m_var.mp_user_ref.ptr));
-    reinterpret_cast <tl::WeakOrSharedPtr *> (m_var.mp_user_ref.ptr)->~WeakOrSharedPtr ();
-  }
-  m_var = other.m_var;
-  if (other.m_type == t_user_ref) {
-    new (m_var.mp_user_ref.ptr) tl::WeakOrSharedPtr (*reinterpret_cast <tl::WeakOrSharedPtr *> (other.m_var.mp_user_ref.ptr));
-    reinterpret_cast <tl::WeakOrSharedPtr *> (other.m_var.mp_user_ref.ptr)->~WeakOrSharedPtr ();
-  }
-  other.m_var = a;
-  if (m_type == t_user_ref) {
-    new (other.m_var.mp_user_ref.ptr) tl::WeakOrSharedPtr (*reinterpret_cast <tl::WeakOrSharedPtr *> (a.mp_user_ref.ptr));
-    reinterpret_cast <tl::WeakOrSharedPtr *> (a.mp_user_ref.ptr)->~WeakOrSharedPtr ();
-  }
+  ValueHolder a;
+  move_value (m_type, a, m_var);
+  move_value (other.m_type, m_var, other.m_var);
+  move_value (m_type, other.m_var, a);
 
   std::swap (m_type, other.m_type);
   std::swap (m_string, other.m_string);
@@ -2305,9 +2342,9 @@ QVariant Variant::to_qvariant () const
   case t_bool:
     return QVariant (m_var.m_bool);
   case t_stdstring:
-    return QVariant (tl::to_qstring (*m_var.m_stdstring));
+    return QVariant (tl::to_qstring (*stdstring_ptr ()));
   case t_string:
-    return QVariant (tl::to_qstring (m_string));
+    return QVariant (tl::to_qstring (to_string ()));
 #if defined(HAVE_QT)
   case t_qstring:
     return QVariant (*m_var.m_qstring);
@@ -2317,7 +2354,7 @@ QVariant Variant::to_qvariant () const
   case t_list:
     {
       QList<QVariant> l;
-      for (std::vector<tl::Variant>::const_iterator v = m_var.m_list->begin (); v != m_var.m_list->end (); ++v) {
+      for (std::vector<tl::Variant>::const_iterator v = list_ptr ()->begin (); v != list_ptr ()->end (); ++v) {
         l.append (v->to_qvariant ());
       }
       return QVariant (l);
@@ -351,7 +351,7 @@ public:
   Variant (const std::vector<tl::Variant> &list)
     : m_type (t_list), m_string (0)
   {
-    m_var.m_list = new std::vector<tl::Variant> (list);
+    new (m_var.m_list) std::vector<tl::Variant> (list);
   }
 
   /**
@@ -361,9 +361,27 @@ public:
   Variant (Iter from, Iter to)
     : m_type (t_list), m_string (0)
   {
-    m_var.m_list = new std::vector<tl::Variant> (from, to);
+    new (m_var.m_list) std::vector<tl::Variant> (from, to);
   }
 
+#if __cplusplus >= 201103L
+  /**
+   *  @brief Move constructor
+   *
+   *  The source variant will be nil afterwards.
+   */
+  Variant (Variant &&other) noexcept
+    : m_type (t_nil), m_string (0)
+  {
+    swap (other);
+  }
+
+  /**
+   *  @brief Initialize the Variant with a std::string by moving the string
+   */
+  Variant (std::string &&s);
+#endif
+
   /**
    *  @brief Destructor
    */
@@ -425,6 +443,25 @@ public:
    */
   Variant &operator= (const Variant &v);
 
+#if __cplusplus >= 201103L
+  /**
+   *  @brief Move assignment
+   *
+   *  The source variant will be nil afterwards.
+   */
+  Variant &operator= (Variant &&v) noexcept
+  {
+    if (this != &v) {
+      //  Taking over the value before releasing our own content is important
+      //  in case v is a member of our own list (see operator= (const Variant &)).
+      tl::Variant vv;
+      vv.swap (v);
+      swap (vv);
+    }
+    return *this;
+  }
+#endif
+
   /**
    *  @brief Assignment of a string
    */
@@ -559,9 +596,9 @@ public:
   {
     reset ();
     m_type = t_list;
-    m_var.m_list = new std::vector<tl::Variant> ();
+    new (m_var.m_list) std::vector<tl::Variant> ();
     if (reserve > 0) {
-      m_var.m_list->reserve (reserve);
+      list_ptr ()->reserve (reserve);
     }
   }
 
@@ -950,7 +987,7 @@ public:
   const_iterator begin () const
   {
     tl_assert (m_type == t_list);
-    return m_var.m_list->begin ();
+    return list_ptr ()->begin ();
   }
 
   /**
@@ -959,7 +996,7 @@ public:
   const_iterator end () const
   {
     tl_assert (m_type == t_list);
-    return m_var.m_list->end ();
+    return list_ptr ()->end ();
   }
 
   /**
@@ -968,7 +1005,7 @@ public:
   iterator begin () 
   {
     tl_assert (m_type == t_list);
-    return m_var.m_list->begin ();
+    return list_ptr ()->begin ();
   }
 
   /**
@@ -977,7 +1014,7 @@ public:
   iterator end () 
   {
     tl_assert (m_type == t_list);
-    return m_var.m_list->end ();
+    return list_ptr ()->end ();
   }
 
   /**
@@ -986,7 +1023,7 @@ public:
   void reserve (size_t n) 
   {
     tl_assert (m_type == t_list);
-    m_var.m_list->reserve (n);
+    list_ptr ()->reserve (n);
   }
 
   /**
@@ -994,7 +1031,7 @@ public:
    */ 
   size_t size () const
   {
-    return m_type == t_list ? m_var.m_list->size () : 0;
+    return m_type == t_list ? list_ptr ()->size () : 0;
   }
 
   /**
@@ -1003,16 +1040,27 @@ public:
   void push (const tl::Variant &v)
   {
     tl_assert (m_type == t_list);
-    m_var.m_list->push_back (v);
+    list_ptr ()->push_back (v);
   }
 
+#if __cplusplus >= 201103L
+  /**
+   *  @brief Add a element to the list by moving the value
+   */
+  void push (tl::Variant &&v)
+  {
+    tl_assert (m_type == t_list);
+    list_ptr ()->push_back (std::move (v));
+  }
+#endif
+
   /**
    *  @brief Get the back element of the list
    */
   tl::Variant &back ()
   {
     tl_assert (m_type == t_list);
-    return m_var.m_list->back ();
+    return list_ptr ()->back ();
   }
 
   /**
@@ -1021,7 +1069,7 @@ public:
   const tl::Variant &back () const
   {
     tl_assert (m_type == t_list);
-    return m_var.m_list->back ();
+    return list_ptr ()->back ();
   }
 
   /**
@@ -1030,7 +1078,7 @@ public:
   tl::Variant &front ()
   {
     tl_assert (m_type == t_list);
-    return m_var.m_list->front ();
+    return list_ptr ()->front ();
   }
 
   /**
@@ -1039,7 +1087,7 @@ public:
   const tl::Variant &front () const
   {
     tl_assert (m_type == t_list);
-    return m_var.m_list->front ();
+    return list_ptr ()->front ();
   }
 
   /**
@@ -1048,7 +1096,7 @@ public:
   std::vector<tl::Variant> &get_list ()
   {
     tl_assert (m_type == t_list);
-    return *m_var.m_list;
+    return *list_ptr ();
   }
 
   /**
@@ -1057,7 +1105,7 @@ public:
   const std::vector<tl::Variant> &get_list () const
   {
     tl_assert (m_type == t_list);
-    return *m_var.m_list;
+    return *list_ptr ();
   }
 
   /**
@@ -1491,8 +1539,10 @@ public:
 private:
   type m_type;
 
+  //  Strings, std::string objects and lists are kept inside the value holder.
+  //  Short C strings are stored directly in m_chars, longer ones in m_string.
   union ValueHolder {
-    std::vector<tl::Variant> *m_list;
+    char m_list [sizeof (std::vector<tl::Variant>)];
     std::map<tl::Variant, tl::Variant> *m_array;
     double m_double;
     float m_float;
@@ -1525,13 +1575,36 @@ private:
     QString *m_qstring;
     QByteArray *m_qbytearray;
 #endif
-    std::string *m_stdstring;
+    char m_stdstring [sizeof (std::string)];
+    char m_chars [sizeof (WeakOrSharedPtr) + sizeof (void *)];
   } m_var;
 
   //  this will hold the string if it is valid
   mutable char *m_string;
 
   void set_user_object (void *obj, bool shared);
+  void set_string (const char *s);
+  static void move_value (type t, ValueHolder &to, ValueHolder &from);
+
+  std::string *stdstring_ptr ()
+  {
+    return reinterpret_cast<std::string *> (m_var.m_stdstring);
+  }
+
+  const std::string *stdstring_ptr () const
+  {
+    return reinterpret_cast<const std::string *> (m_var.m_stdstring);
+  }
+
+  std::vector<tl::Variant> *list_ptr ()
+  {
+    return reinterpret_cast<std::vector<tl::Variant> *> (m_var.m_list);
+  }
+
+  const std::vector<tl::Variant> *list_ptr () const
+  {
+    return reinterpret_cast<const std::vector<tl::Variant> *> (m_var.m_list);
+  }
 };
 
 //  specializations of the to ... methods
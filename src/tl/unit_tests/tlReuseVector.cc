@@ -23,6 +23,7 @@
 
 #include "tlUnitTest.h"
 #include "tlReuseVector.h"
+#include "tlString.h"
 
 #include <string>
 #include <vector>
@@ -386,3 +387,64 @@ TEST(5)
   EXPECT_EQ (v.empty (), true);
 }
 
+
+//  iteration over large holes and compaction
+TEST(6)
+{
+  tl::reuse_vector<std::string> v;
+
+  std::vector<tl::reuse_vector<std::string>::iterator> iters;
+  for (int i = 0; i < 1000; ++i) {
+    iters.push_back (v.insert (tl::to_string (i)));
+  }
+
+  EXPECT_EQ (v.fragmentation (), 0.0);
+  EXPECT_EQ (v.compact (), false);
+
+  //  leave a few elements spread over several bitmap words
+  for (int i = 0; i < 1000; ++i) {
+    if (i != 3 && i != 64 && i != 65 && i != 500 && i != 998) {
+      v.erase (iters [i]);
+    }
+  }
+
+  EXPECT_EQ (v.size (), size_t (5));
+  EXPECT_EQ (to_string (v), "3,64,65,500,998");
+  EXPECT_EQ (v.begin ().index (), size_t (3));
+  EXPECT_EQ (size_t (v.end () - v.begin ()), size_t (5));
+  EXPECT_EQ (v.fragmentation () > 0.99, true);
+
+  std::vector<size_t> index_map;
+  EXPECT_EQ (v.compact (&index_map), true);
+  EXPECT_EQ (v.fragmentation (), 0.0);
+  EXPECT_EQ (v.reuse_data () == 0, true);
+  EXPECT_EQ (to_string (v), "3,64,65,500,998");
+  EXPECT_EQ (index_map.size (), size_t (1000));
+  EXPECT_EQ (index_map [3], size_t (0));
+  EXPECT_EQ (index_map [64], size_t (1));
+  EXPECT_EQ (index_map [65], size_t (2));
+  EXPECT_EQ (index_map [500], size_t (3));
+  EXPECT_EQ (index_map [998], size_t (4));
+  EXPECT_EQ (index_map [4] == std::numeric_limits<size_t>::max (), true);
+  EXPECT_EQ (v.item (4), "998");
+
+  v.insert ("x");
+  EXPECT_EQ (to_string (v), "3,64,65,500,998,x");
+
+  //  erasing everything but the first and last element
+  tl::reuse_vector<std::string>::iterator i = v.begin ();
+  ++i;
+  v.erase (i);
+  ++i;
+  v.erase (i);
+  ++i;
+  v.erase (i);
+  EXPECT_EQ (to_string (v), "3,998,x");
+  v.erase (v.begin ());
+  EXPECT_EQ (to_string (v), "998,x");
+  v.insert ("y");
+  EXPECT_EQ (to_string (v), "y,998,x");
+
+  EXPECT_EQ (v.compact (), true);
+  EXPECT_EQ (to_string (v), "y,998,x");
+}
@@ -23,6 +23,10 @@
 #include "tlStream.h"
 #include "tlUnitTest.h"
 
+#include <string.h>
+#include <algorithm>
+#include <limits>
+
 TEST(InputPipe1)
 {
   tl::InputPipe pipe ("echo HELLOWORLD");
@@ -42,3 +46,415 @@ TEST(InputPipe2)
   tl::info << "Process exit code: " << ret;
   EXPECT_NE (ret, 0);
 }
+
+namespace
+{
+
+//  A delegate which delivers the data in small chunks and counts the resets
+class ChunkedInputStream
+  : public tl::InputStreamBase
+{
+public:
+  ChunkedInputStream (const std::string &data, size_t chunk)
+    : m_data (data), m_chunk (chunk), m_pos (0), m_resets (0)
+  { }
+
+  virtual size_t read (char *b, size_t n)
+  {
+    n = std::min (n, std::min (m_chunk, m_data.size () - m_pos));
+    memcpy (b, m_data.c_str () + m_pos, n);
+    m_pos += n;
+    return n;
+  }
+
+  virtual void reset ()
+  {
+    m_pos = 0;
+    ++m_resets;
+  }
+
+  virtual bool supports_read_ahead ()
+  {
+    return true;
+  }
+
+  virtual void close () { }
+  virtual std::string source () const { return "chunked"; }
+  virtual std::string absolute_path () const { return "chunked"; }
+  virtual std::string filename () const { return "chunked.txt"; }
+
+  int resets () const
+  {
+    return m_resets;
+  }
+
+private:
+  std::string m_data;
+  size_t m_chunk, m_pos;
+  int m_resets;
+};
+
+}
+
+TEST(InputStreamPeek)
+{
+  std::string data;
+  for (int i = 0; i < 1000; ++i) {
+    data += tl::to_string (i) + "\n";
+  }
+
+  ChunkedInputStream delegate (data, 100);
+  tl::InputStream str (delegate);
+
+  size_t avail = 0;
+  const char *h = str.peek (1000, avail);
+  EXPECT_EQ (avail, size_t (1000));
+  EXPECT_EQ (std::string (h, 10), "0\n1\n2\n3\n4\n");
+  EXPECT_EQ (str.pos (), size_t (0));
+
+  h = str.peek (100000, avail);
+  EXPECT_EQ (avail, data.size ());
+
+  EXPECT_EQ (str.read_all (), data);
+  EXPECT_EQ (delegate.resets (), 0);
+}
+
+TEST(InputHeadStream)
+{
+  std::string data;
+  for (int i = 0; i < 1000; ++i) {
+    data += tl::to_string (i) + "\n";
+  }
+
+  ChunkedInputStream delegate (data, 100);
+  tl::InputStream str (delegate);
+
+  {
+    tl::InputHeadStream head_delegate (str, 20);
+    EXPECT_EQ (head_delegate.length (), size_t (20));
+    EXPECT_EQ (head_delegate.filename (), "chunked.txt");
+
+    tl::InputStream head (head_delegate);
+    for (int pass = 0; pass < 2; ++pass) {
+      head.reset ();
+      tl::TextInputStream text (head);
+      EXPECT_EQ (text.get_line (), "0");
+      EXPECT_EQ (text.get_line (), "1");
+      EXPECT_EQ (head.read_all (), "2\n3\n4\n5\n6\n7\n8\n9\n");
+    }
+  }
+
+  //  the original stream was not advanced and not reset
+  EXPECT_EQ (str.pos (), size_t (0));
+  EXPECT_EQ (str.read_all (), data);
+  EXPECT_EQ (delegate.resets (), 0);
+}
+
+TEST(InputStreamResetAfterBufferShift)
+{
+  std::string data;
+  for (int i = 0; i < 1000; ++i) {
+    data += tl::to_string (i) + "\n";
+  }
+
+  ChunkedInputStream delegate (data, 100);
+  tl::InputStream str (delegate);
+
+  //  the second get shifts the buffer, so the beginning of the stream is no
+  //  longer available and the reset needs to go through the delegate
+  EXPECT_EQ (std::string (str.get (50), 4), "0\n1\n");
+  EXPECT_EQ (std::string (str.get (100), 4), "20\n2");
+  str.reset ();
+  EXPECT_EQ (delegate.resets (), 1);
+  EXPECT_EQ (std::string (str.get (4), 4), "0\n1\n");
+
+  //  inside the buffer, no delegate reset is required
+  str.reset ();
+  EXPECT_EQ (delegate.resets (), 1);
+  EXPECT_EQ (std::string (str.get (4), 4), "0\n1\n");
+}
+
+TEST(InputStreamSeek)
+{
+  std::string data;
+  for (int i = 0; i < 10000; ++i) {
+    data += tl::to_string (i) + "\n";
+  }
+
+  size_t p500 = data.find ("\n500\n") + 1;
+  size_t p9000 = data.find ("\n9000\n") + 1;
+
+  //  a delegate which can seek is positioned directly
+  for (int read_ahead = 0; read_ahead < 2; ++read_ahead) {
+
+    tl::InputMemoryStream mem (data.c_str (), data.size ());
+    tl::InputReadAheadStream ra (&mem, false, 2, 100);
+    tl::InputStream str (read_ahead ? (tl::InputStreamBase &) ra : (tl::InputStreamBase &) mem);
+    EXPECT_EQ (str.base ()->supports_seek (), true);
+
+    str.seek (p9000);
+    EXPECT_EQ (str.pos (), p9000);
+    EXPECT_EQ (std::string (str.get (5), 5), "9000\n");
+    str.seek (p500);
+    EXPECT_EQ (std::string (str.get (4), 4), "500\n");
+    //  inside the buffer
+    str.seek (p500 + 1);
+    EXPECT_EQ (std::string (str.get (3), 3), "00\n");
+    EXPECT_EQ (str.read_all (), data.substr (p500 + 4));
+
+  }
+
+  //  other delegates are read over or reset
+  ChunkedInputStream delegate (data, 100);
+  tl::InputStream str (delegate);
+  EXPECT_EQ (str.base ()->supports_seek (), false);
+
+  str.seek (p9000);
+  EXPECT_EQ (std::string (str.get (5), 5), "9000\n");
+  EXPECT_EQ (delegate.resets (), 0);
+  str.seek (p500);
+  EXPECT_EQ (delegate.resets (), 1);
+  EXPECT_EQ (std::string (str.get (4), 4), "500\n");
+}
+
+namespace
+{
+
+//  A delegate which fails after delivering a certain number of bytes
+class FailingInputStream
+  : public tl::InputStreamBase
+{
+public:
+  FailingInputStream (size_t fail_at)
+    : m_fail_at (fail_at), m_pos (0)
+  { }
+
+  virtual size_t read (char *b, size_t n)
+  {
+    if (m_pos >= m_fail_at) {
+      throw tl::Exception ("read error");
+    }
+    n = std::min (n, m_fail_at - m_pos);
+    memset (b, 'x', n);
+    m_pos += n;
+    return n;
+  }
+
+  virtual void reset () { m_pos = 0; }
+  virtual void close () { }
+  virtual std::string source () const { return "failing"; }
+  virtual std::string absolute_path () const { return "failing"; }
+  virtual std::string filename () const { return "failing"; }
+
+private:
+  size_t m_fail_at, m_pos;
+};
+
+}
+
+TEST(InputReadAheadStream)
+{
+  std::string data;
+  for (int i = 0; i < 10000; ++i) {
+    data += tl::to_string (i) + "\n";
+  }
+
+  ChunkedInputStream delegate (data, 77);
+
+  {
+    tl::InputStream str (new tl::InputReadAheadStream (&delegate, false, 3, 1000));
+    EXPECT_EQ (str.filename (), "chunked.txt");
+    EXPECT_EQ (str.read_all (), data);
+  }
+
+  {
+    delegate.reset ();
+    tl::InputStream str (new tl::InputReadAheadStream (&delegate, false, 2, 100));
+    tl::TextInputStream text (str);
+    EXPECT_EQ (text.get_line (), "0");
+    EXPECT_EQ (text.get_line (), "1");
+
+    //  a reset far behind the beginning needs to restart the read-ahead
+    str.seek (30000);
+    str.reset ();
+    EXPECT_EQ (str.read_all (), data);
+  }
+
+  {
+    //  read-ahead can be enabled on a stream already in use
+    delegate.reset ();
+    tl::InputStream str (delegate);
+    EXPECT_EQ (std::string (str.get (6), 6), "0\n1\n2\n");
+    str.set_read_ahead (4, 256);
+    EXPECT_EQ (dynamic_cast<tl::InputReadAheadStream *> (str.base ()) != 0, true);
+    EXPECT_EQ (str.read_all (), data.substr (6));
+    //  no double wrapping
+    tl::InputStreamBase *base = str.base ();
+    str.set_read_ahead (4, 256);
+    EXPECT_EQ (str.base () == base, true);
+  }
+
+  {
+    //  delegates which don't support read-ahead are not wrapped
+    tl::InputMemoryStream mem (data.c_str (), data.size ());
+    tl::InputStream str (mem);
+    str.set_read_ahead (4, 256);
+    EXPECT_EQ (str.base () == &mem, true);
+    EXPECT_EQ (str.read_all (), data);
+  }
+}
+
+TEST(InputReadAheadStreamErrors)
+{
+  tl::InputStream str (new tl::InputReadAheadStream (new FailingInputStream (2500), true, 2, 1000));
+
+  //  the data before the error is delivered
+  EXPECT_EQ (str.get (2000) != 0, true);
+
+  std::string error;
+  try {
+    str.read_all ();
+  } catch (tl::Exception &ex) {
+    error = ex.msg ();
+  }
+  EXPECT_EQ (error, "read error");
+}
+
+namespace
+{
+
+//  A delegate collecting the data in a string and failing optionally
+class StringOutputStream
+  : public tl::OutputStreamBase
+{
+public:
+  StringOutputStream (size_t fail_at = std::numeric_limits<size_t>::max ())
+    : m_fail_at (fail_at), m_flushes (0)
+  { }
+
+  virtual void write (const char *b, size_t n)
+  {
+    if (m_data.size () + n > m_fail_at) {
+      throw tl::Exception ("write error");
+    }
+    m_data += std::string (b, n);
+  }
+
+  virtual void flush ()
+  {
+    ++m_flushes;
+  }
+
+  const std::string &data () const { return m_data; }
+  int flushes () const { return m_flushes; }
+
+private:
+  std::string m_data;
+  size_t m_fail_at;
+  int m_flushes;
+};
+
+}
+
+TEST(OutputWriteBehindStream)
+{
+  std::string data;
+  for (int i = 0; i < 10000; ++i) {
+    data += tl::to_string (i) + "\n";
+  }
+
+  {
+    StringOutputStream delegate;
+    {
+      tl::OutputWriteBehindStream wb (&delegate, false, 3, 1000);
+      tl::OutputStream str (wb);
+      for (size_t i = 0; i < data.size (); i += 77) {
+        str.put (data.c_str () + i, std::min (size_t (77), data.size () - i));
+      }
+      str.flush ();
+      EXPECT_EQ (delegate.data (), data);
+      EXPECT_EQ (delegate.flushes (), 1);
+    }
+  }
+
+  {
+    //  write-behind can be enabled on a stream already in use
+    StringOutputStream delegate;
+    {
+      tl::OutputStream str (delegate);
+      str << "0\n1\n2\n";
+      str.set_write_behind (2, 100);
+      EXPECT_EQ (dynamic_cast<tl::OutputWriteBehindStream *> (str.base ()) != 0, true);
+      str << data.substr (6);
+    }
+    EXPECT_EQ (delegate.data (), data);
+  }
+}
+
+TEST(OutputWriteBehindStreamCompressed)
+{
+  std::string data;
+  for (int i = 0; i < 100000; ++i) {
+    data += tl::to_string (i) + "\n";
+  }
+
+  std::string path = tmp_file ("write_behind.txt.gz");
+
+  {
+    tl::OutputStream str (path);
+    str.set_write_behind (4, 10000, 3);
+
+    //  the compression is done by the threads now
+    tl::OutputWriteBehindStream *wb = dynamic_cast<tl::OutputWriteBehindStream *> (str.base ());
+    EXPECT_EQ (wb != 0, true);
+    EXPECT_EQ (wb->compression_threads (), (unsigned int) 3);
+    EXPECT_EQ (dynamic_cast<tl::OutputFile *> (wb->delegate ()) != 0, true);
+    EXPECT_EQ (str.supports_seek (), false);
+
+    str << data;
+  }
+
+  {
+    //  the gzip members are read as a single file
+    tl::InputStream str (path);
+    EXPECT_EQ (str.read_all (), data);
+  }
+
+  {
+    //  parallel compression is not possible once the zlib stream has been written to
+    tl::OutputStream str (path);
+    str << data.substr (0, 10);
+    str.set_write_behind (2, 1000, 2);
+    tl::OutputWriteBehindStream *wb = dynamic_cast<tl::OutputWriteBehindStream *> (str.base ());
+    EXPECT_EQ (wb != 0, true);
+    EXPECT_EQ (wb->compression_threads (), (unsigned int) 0);
+    str << data.substr (10);
+  }
+
+  {
+    tl::InputStream str (path);
+    EXPECT_EQ (str.read_all (), data);
+  }
+}
+
+TEST(OutputWriteBehindStreamErrors)
+{
+  StringOutputStream delegate (2500);
+
+  std::string error;
+  {
+    tl::OutputWriteBehindStream wb (&delegate, false, 2, 1000);
+    tl::OutputStream str (wb);
+    try {
+      for (int i = 0; i < 100; ++i) {
+        str << std::string (100, 'x');
+      }
+      str.flush ();
+    } catch (tl::Exception &ex) {
+      error = ex.msg ();
+    }
+  }
+
+  EXPECT_EQ (error, "write error");
+  EXPECT_EQ (delegate.data (), std::string (2000, 'x'));
+}
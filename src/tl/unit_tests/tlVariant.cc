@@ -1085,6 +1085,65 @@ TEST(5)
   EXPECT_EQ (m [" 3"], 0);
 }
 
+//  short and long strings, in-place lists and swap
+TEST(6)
+{
+  tl::Variant a ("abc");
+  tl::Variant b (std::string (100, 'x').c_str ());
+  EXPECT_EQ (a.is_cstring (), true);
+  EXPECT_EQ (b.is_cstring (), true);
+  EXPECT_EQ (std::string (a.to_string ()), "abc");
+  EXPECT_EQ (std::string (b.to_string ()), std::string (100, 'x'));
+
+  a.swap (b);
+  EXPECT_EQ (std::string (b.to_string ()), "abc");
+  EXPECT_EQ (std::string (a.to_string ()), std::string (100, 'x'));
+
+  tl::Variant c (b);
+  EXPECT_EQ (c == b, true);
+  c = a;
+  EXPECT_EQ (c == a, true);
+  c = c.to_string ();
+  EXPECT_EQ (std::string (c.to_string ()), std::string (100, 'x'));
+  b = b.to_string ();
+  EXPECT_EQ (std::string (b.to_string ()), "abc");
+
+  tl::Variant l = tl::Variant::empty_list ();
+  l.push (tl::Variant (std::string ("a string that does not fit into the small buffer")));
+  l.push (tl::Variant ("short"));
+  l.push (tl::Variant (17));
+  EXPECT_EQ (l.to_parsable_string (), "('a string that does not fit into the small buffer','short',#17)");
+
+  tl::Variant s (std::string ("s"));
+  s.swap (l);
+  EXPECT_EQ (l.to_parsable_string (), "'s'");
+  EXPECT_EQ (s.to_parsable_string (), "('a string that does not fit into the small buffer','short',#17)");
+
+  //  assigning a list member to the list itself
+  tl::Variant e = s.get_list ().front ();
+  s = s.get_list ().front ();
+  EXPECT_EQ (s == e, true);
+  EXPECT_EQ (s.to_parsable_string (), "'a string that does not fit into the small buffer'");
+
+#if __cplusplus >= 201103L
+  tl::Variant m (std::move (e));
+  EXPECT_EQ (e.is_nil (), true);
+  EXPECT_EQ (m.to_parsable_string (), "'a string that does not fit into the small buffer'");
+
+  tl::Variant ll = tl::Variant::empty_list ();
+  ll.push (std::move (m));
+  EXPECT_EQ (m.is_nil (), true);
+  ll = std::move (ll.get_list ().front ());
+  EXPECT_EQ (ll.to_parsable_string (), "'a string that does not fit into the small buffer'");
+
+  std::vector<tl::Variant> v;
+  for (int i = 0; i < 100; ++i) {
+    v.push_back (tl::Variant (tl::sprintf ("a long string that does not fit - number %d", i)));
+  }
+  EXPECT_EQ (v [42].to_parsable_string (), "'a long string that does not fit - number 42'");
+#endif
+}
+
 }
 
 
@@ -74,6 +74,72 @@ class DBGlyph_TestClass < TestBase
 
   end
 
+  # GlyphCellLibrary
+  def test_2_GlyphCellLibrary
+
+    ly = RBA::Layout::new
+    l1 = ly.layer(1, 0)
+    top = ly.create_cell("TOP")
+
+    lib = RBA::GlyphCellLibrary::new(ly, l1)
+    assert_equal(lib.layer, l1)
+    assert_equal(lib.size, 0)
+
+    lib.hershey_text(0, "ABA", 1.0, 0.0, top)
+    assert_equal(lib.size, 2)
+    assert_equal(top.child_instances, 3)
+
+    ci = lib.hershey_glyph_cell(0, 65, 1.0)
+    assert_equal(ly.cell_name(ci), "HERSHEY0_065")
+    assert_equal(lib.size, 2)
+
+    flat = ly.create_cell("FLAT")
+    lib.hershey_text(0, "A", 1.0, 0.0, flat, RBA::Trans::new, true)
+    assert_equal(flat.child_instances, 0)
+    assert_equal(flat.shapes(l1).size, ly.cell(ci).shapes(l1).size)
+
+    other = RBA::Layout::new
+    other_top = other.create_cell("TOP")
+    begin
+      lib.hershey_text(0, "A", 1.0, 0.0, other_top)
+      assert_equal(false, true)
+    rescue => ex
+      assert_equal(ex.to_s, "The target cell must be a cell of the glyph cell library's layout unless 'flat' is true in GlyphCellLibrary#hershey_text")
+    end
+
+    lib.clear
+    assert_equal(lib.size, 0)
+
+    tg = RBA::TextGenerator.default_generator
+
+    # TODO: no default generator in non-Qt mode (no resources)
+    tg || return
+
+    ly.dbu = 0.001
+    gen = ly.create_cell("GEN")
+    lib.text(tg, "HH", 1.0, 0.0, 0.0, gen)
+    assert_equal(lib.size, 1)
+    assert_equal(gen.child_instances, 2)
+    assert_equal(ly.cell_name(lib.glyph_cell(tg, 72)), "GLYPH_std_font_072")
+
+  end
+
+  # GlyphCellLibrary with a destroyed layout
+  def test_3_GlyphCellLibraryLayoutDestroyed
+
+    ly = RBA::Layout::new
+    lib = RBA::GlyphCellLibrary::new(ly, ly.layer(1, 0))
+    ly._destroy
+
+    begin
+      lib.hershey_glyph_cell(0, 65, 1.0)
+      assert_equal(false, true)
+    rescue => ex
+      assert_equal(ex.to_s, "The layout of the glyph cell library has been destroyed in GlyphCellLibrary#hershey_glyph_cell")
+    end
+
+  end
+
 end
 
 load("test_epilogue.rb")
@@ -23,6 +23,8 @@ end
 
 load("test_prologue.rb")
 
+require "fileutils"
+
 module RBA
   class LayoutView
     def main_window
@@ -399,6 +401,131 @@ class LAYLayoutView_TestClass < TestBase
 
   end
 
+
+  # Creates a standalone view showing a small hierarchical layout with several layers
+  def make_test_view
+
+    lv = RBA::LayoutView::new
+
+    cv = lv.cellview(lv.create_layout(1))
+    ly = cv.layout
+
+    l1 = ly.layer(1, 0)
+    l2 = ly.layer(2, 0)
+    l3 = ly.layer(3, 0)
+
+    a = ly.create_cell("A")
+    a.shapes(l1).insert(RBA::Box::new(0, 0, 800, 400))
+    a.shapes(l2).insert(RBA::Polygon::new([ RBA::Point::new(0, 0), RBA::Point::new(400, 800), RBA::Point::new(800, 0) ]))
+    a.shapes(l3).insert(RBA::Path::new([ RBA::Point::new(0, 600), RBA::Point::new(800, 600) ], 100))
+    a.shapes(l1).insert(RBA::Text::new("A", RBA::Trans::new(100, 100)))
+
+    b = ly.create_cell("B")
+    b.shapes(l2).insert(RBA::Box::new(-100, -100, 2100, 1100))
+    b.insert(RBA::CellInstArray::new(a.cell_index, RBA::Trans::new))
+    b.insert(RBA::CellInstArray::new(a.cell_index, RBA::Trans::new(RBA::Trans::R90, 2000, 0)))
+
+    c = ly.create_cell("C")
+    c.shapes(l1).insert(RBA::Box::new(0, 0, 20, 20))
+    c.shapes(l3).insert(RBA::Box::new(10, 10, 30, 30))
+
+    top = ly.create_cell("TOP")
+    top.shapes(l1).insert(RBA::Box::new(-1000, -1000, 0, 16000))
+    # many identical instances: drawn from the bitmap caches
+    top.insert(RBA::CellInstArray::new(b.cell_index, RBA::Trans::new, RBA::Vector::new(2500, 0), RBA::Vector::new(0, 1500), 20, 10))
+    # a dense array of small cells: drawn as micro instances
+    top.insert(RBA::CellInstArray::new(c.cell_index, RBA::Trans::new(0, -20000), RBA::Vector::new(40, 0), RBA::Vector::new(0, 40), 300, 100))
+    # a rotated and magnified instance
+    top.insert(RBA::CellInstArray::new(b.cell_index, RBA::ICplxTrans::new(2.5, 45.0, false, 60000, 0)))
+
+    cv.cell = top
+
+    # layers with different hierarchy levels or transformations are drawn in different groups
+    [ [ "1/0@1", 0xffff0000 ], [ "2/0@1", 0xff00ff00 ], [ "3/0@1", 0xff0000ff ], [ "3/0@1 #1..2", 0xffffff00 ], [ "1/0@1 (0,0 r90 *0.5)", 0xffff00ff ] ].each do |src, color|
+      lp = RBA::LayerProperties::new
+      lp.source = src
+      lp.fill_color = color
+      lp.frame_color = color
+      lp.dither_pattern = 5
+      lv.insert_layer(lv.end_layers, lp)
+    end
+
+    lv
+
+  end
+
+  # Multi-layer redraw mode renders the same images as the layer by layer mode
+  def test_4
+
+    if !RBA.constants.member?(:QImage)
+      return
+    end
+
+    lv = make_test_view
+    box = RBA::DBox::new(-2.0, -25.0, 85.0, 20.0)
+
+    images = []
+
+    [ [ 0, 0 ], [ 0, 1 ], [ 1, 2 ], [ 0, 10 ] ].each do |min_levels, max_levels|
+
+      lv.min_hier_levels = min_levels
+      lv.max_hier_levels = max_levels
+
+      [ 1, 3 ].each do |oversampling|
+
+        lv.set_config("multi-layer-redraw", "false")
+        img_single = lv.get_image_with_options(500, 300, 1, oversampling, 0.0, box, false)
+
+        lv.set_config("multi-layer-redraw", "true")
+        img_multi = lv.get_image_with_options(500, 300, 1, oversampling, 0.0, box, false)
+
+        assert_equal(img_single == img_multi, true)
+
+        images << img_single
+
+      end
+
+    end
+
+    # sanity check: the hierarchy levels make a difference
+    assert_equal(images[0] == images[-1], false)
+
+  end
+
+
+  # Tile pyramid
+  def test_5
+
+    if !RBA.constants.member?(:QImage)
+      return
+    end
+
+    lv = make_test_view
+
+    dir = File::join($ut_testtmp, "tiles")
+    if File.exist?(dir)
+      FileUtils.rm_rf(dir)
+    end
+
+    # 30x10 um: 1 tile on level 0, 2x1 tiles on level 1 and 4x2 tiles on level 2
+    region = RBA::DBox::new(0.0, 0.0, 30.0, 10.0)
+    n = lv.save_tiles(dir, 2, 64, 0, 1, 1, 2, region)
+    assert_equal(n, 11)
+
+    tiles = Dir.glob(File::join(dir, "**", "*.png")).collect { |f| f[(dir.size + 1)..-1] }.sort
+    assert_equal(tiles.join(" "), "0/0/0.png 1/0/0.png 1/1/0.png 2/0/0.png 2/0/1.png 2/1/0.png 2/1/1.png 2/2/0.png 2/2/1.png 2/3/0.png 2/3/1.png")
+
+    # the tile at x = 1, y = 1 of level 2 covers 7.5..15 um horizontally and -5..2.5 um vertically
+    # (the rows are counted from the top of the region)
+    ref = lv.get_image_with_options(64, 64, 1, 1, 0.0, RBA::DBox::new(7.5, -5.0, 15.0, 2.5), false)
+    ref_file = File::join($ut_testtmp, "tile_ref.png")
+    ref.save(ref_file, "PNG")
+
+    assert_equal(RBA::QImage::new(File::join(dir, "2", "1", "1.png")) == RBA::QImage::new(ref_file), true)
+    assert_equal(RBA::QImage::new(File::join(dir, "2", "1", "0.png")) == RBA::QImage::new(ref_file), false)
+
+  end
+
 end
 
 load("test_epilogue.rb")